@@ -0,0 +1,115 @@
+import os
+
+from paraview import servermanager
+from paraview import smtesting
+import paraview.simple as smp
+
+# Make sure the test driver know that process has properly started
+print ("Process started")
+
+smtesting.ProcessCommandLineArguments()
+
+# Builds a pipeline within a batch, first on the built-in session and then on
+# a remote one, and checks that the servers end up in the same state as
+# without a batch. One of the batched messages calls a method that does not
+# exist: the servers must report it without affecting the other messages.
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+# A sphere source with a property whose command does not exist. It has no
+# values by default, so it is only pushed once it is set.
+plugin = """
+<ServerManagerConfiguration>
+  <ProxyGroup name="sources">
+    <SourceProxy name="BatchedMessagesSource"
+                 class="vtkSphereSource"
+                 label="Batched Messages Source">
+      <StringVectorProperty name="Broken"
+                            command="NoSuchMethod"
+                            number_of_elements_per_command="1"
+                            repeat_command="1" />
+    </SourceProxy>
+  </ProxyGroup>
+</ServerManagerConfiguration>
+"""
+
+# Keeps the messages of the server's output window, so that the test can
+# count the reports of the failed message.
+captureScript = """
+vtk.vtkOutputWindow.SetInstance(vtk.vtkStringOutputWindow())
+"""
+
+countScript = """
+text = vtk.vtkOutputWindow.GetInstance().GetOutput()
+vtk.vtkOutputWindow.SetInstance(None)
+patterns = { "FailedItems" : "Error pushing property state",
+             "BrokenItems" : "Error pushing property state: Broken",
+             "FailedCalls" : "could not find requested method",
+             "SkippedItems" : "Skipping batched message" }
+for name, pattern in patterns.items():
+    count = vtk.vtkIntArray()
+    count.SetName(name)
+    count.InsertNextValue(text.count(pattern))
+    self.GetOutput().GetFieldData().AddArray(count)
+"""
+
+def getCount(source, name):
+    return int(source.FieldData[name].GetRange()[0])
+
+def runTest(pluginFile):
+    smp.LoadPlugin(pluginFile, remote=True)
+    capture = smp.ProgrammableSource(Script=captureScript)
+    capture.UpdatePipeline()
+
+    with servermanager.Batch():
+        sphere = smp.Sphere(ThetaResolution=8, PhiResolution=8)
+        shrink = smp.Shrink(Input=sphere, ShrinkFactor=0.5)
+
+        # Gathering information sends the queued messages first.
+        shrink.UpdatePipeline()
+        assert shrink.GetDataInformation().GetNumberOfPoints() == 2 * 8 * 6 * 3, \
+            "the messages queued before gathering information were not sent"
+
+        broken = smp.BatchedMessagesSource()
+        broken.Broken = ["item"]
+
+        sphere.ThetaResolution = 16
+        cone = smp.Cone(Resolution=12)
+
+    # The messages after the one that failed were processed.
+    shrink.UpdatePipeline()
+    assert shrink.GetDataInformation().GetNumberOfPoints() == 2 * 16 * 6 * 3, \
+        "the sphere was not modified"
+    cone.UpdatePipeline()
+    assert cone.GetDataInformation().GetNumberOfPoints() == 13, "the cone was not created"
+
+    # The failed message was reported, and only that one.
+    counter = smp.ProgrammableSource(Script=countScript)
+    counter.UpdatePipeline()
+    assert getCount(counter, "FailedItems") == 1, "wrong number of failed messages"
+    assert getCount(counter, "BrokenItems") == 1, "the wrong message failed"
+    assert getCount(counter, "FailedCalls") == 1, "wrong number of failed calls"
+    assert getCount(counter, "SkippedItems") == 0, "batched messages were skipped"
+
+    for source in (counter, cone, broken, shrink, sphere, capture):
+        smp.Delete(source)
+
+pluginFile = os.path.join(smtesting.TempDir, "TestBatchedMessages.xml")
+with open(pluginFile, "w") as f:
+    f.write(plugin)
+
+# Built-in session: the batch does not change how messages are processed.
+runTest(pluginFile)
+
+# Remote session: the messages are sent to the server together.
+options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+url = options.GetServerURL()
+smp.Connect(getHost(url), getPort(url))
+runTest(pluginFile)
+smp.Disconnect()
+
+print ("Batched messages were processed as expected.")
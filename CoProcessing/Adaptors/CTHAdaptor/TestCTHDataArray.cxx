@@ -0,0 +1,188 @@
+// Checks that vtkCTHDataArray reads CTH strips in place and only copies the
+// chunks that are written to, and reports the peak memory the array copied
+// while a pipeline like the ones run during co-processing executes.
+
+#include "vtkCTHDataArray.h"
+
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace
+{
+// A CTH block field: one strip of nx values for each (k, j).
+struct Block
+{
+  int Nx, Ny, Nz;
+  std::vector<double> Values;
+
+  Block(int nx, int ny, int nz, double offset)
+    : Nx(nx)
+    , Ny(ny)
+    , Nz(nz)
+    , Values(static_cast<size_t>(nx) * ny * nz)
+  {
+    for (size_t i = 0; i < this->Values.size(); i++)
+    {
+      this->Values[i] = offset + static_cast<double>(i);
+    }
+  }
+
+  void SetDataPointers(vtkCTHDataArray* array)
+  {
+    for (int k = 0; k < this->Nz; k++)
+    {
+      for (int j = 0; j < this->Ny; j++)
+      {
+        array->SetDataPointer(0, k, j, &this->Values[(k * this->Ny + j) * this->Nx]);
+      }
+    }
+  }
+
+  double Value(int i, int j, int k) { return this->Values[(k * this->Ny + j) * this->Nx + i]; }
+};
+
+bool Check(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    cerr << "ERROR: " << message << endl;
+  }
+  return condition;
+}
+}
+
+int main(int, char* [])
+{
+  const int nx = 64, ny = 64, nz = 64;
+  Block block(nx, ny, nz, 0.0);
+  vtkNew<vtkCTHDataArray> array;
+  array->SetName("density");
+  array->SetDimensions(nx, ny, nz);
+  block.SetDataPointers(array.GetPointer());
+
+  // Only the interior cells, as vtkCTHSource does for blocks with ghost cells.
+  array->SetExtents(1, nx - 2, 1, ny - 2, 1, nz - 2);
+  const vtkIdType numTuples = static_cast<vtkIdType>(nx - 2) * (ny - 2) * (nz - 2);
+  bool ok = Check(array->GetNumberOfTuples() == numTuples, "wrong number of tuples");
+  ok &= Check(array->GetTuple1(0) == block.Value(1, 1, 1), "wrong first tuple");
+  ok &= Check(array->GetTuple1(numTuples - 1) == block.Value(nx - 2, ny - 2, nz - 2),
+    "wrong last tuple");
+
+  // Ranges and id lists of tuples.
+  vtkNew<vtkDoubleArray> range;
+  range->SetNumberOfTuples(3 * (nx - 2));
+  array->GetTuples(nx - 2, 4 * (nx - 2) - 1, range.GetPointer());
+  for (int j = 0; ok && j < 3; j++)
+  {
+    for (int i = 0; ok && i < nx - 2; i++)
+    {
+      ok &= Check(range->GetValue(j * (nx - 2) + i) == block.Value(i + 1, j + 2, 1),
+        "wrong tuple range");
+    }
+  }
+  vtkNew<vtkIdList> ids;
+  vtkNew<vtkFloatArray> floats;
+  for (vtkIdType i = numTuples - 1; i >= 0; i -= 997)
+  {
+    ids->InsertNextId(i);
+  }
+  floats->SetNumberOfTuples(ids->GetNumberOfIds());
+  array->GetTuples(ids.GetPointer(), floats.GetPointer());
+  for (vtkIdType n = 0; ok && n < ids->GetNumberOfIds(); n++)
+  {
+    ok &= Check(floats->GetValue(n) == static_cast<float>(array->GetTuple1(ids->GetId(n))),
+      "wrong tuples from id list");
+  }
+  // Runs of consecutive ids across strips and chunks, then a lone id.
+  const vtkIdType runs[][2] = { { 5, 3 * (nx - 2) + 4 },
+    { vtkCTHDataArray::GetChunkSize() - 3, vtkCTHDataArray::GetChunkSize() + 2 }, { 7, 7 } };
+  ids->Reset();
+  for (int r = 0; r < 3; r++)
+  {
+    for (vtkIdType i = runs[r][0]; i <= runs[r][1]; i++)
+    {
+      ids->InsertNextId(i);
+    }
+  }
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetNumberOfTuples(ids->GetNumberOfIds());
+  array->GetTuples(ids.GetPointer(), doubles.GetPointer());
+  for (vtkIdType n = 0; ok && n < ids->GetNumberOfIds(); n++)
+  {
+    ok &= Check(doubles->GetValue(n) == array->GetTuple1(ids->GetId(n)),
+      "wrong tuples from id runs");
+  }
+  ok &= Check(array->GetCopiedMemorySize() == 0, "reading copied values");
+
+  // Run a pipeline on the field, keeping track of the memory the array copied.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(nx - 1, ny - 1, nz - 1);
+  image->GetCellData()->SetScalars(array.GetPointer());
+  vtkNew<vtkCellDataToPointData> cellToPoint;
+  cellToPoint->SetInputData(image.GetPointer());
+  cellToPoint->PassCellDataOn();
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(image.GetPointer());
+  threshold->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, "density");
+  threshold->ThresholdByUpper(numTuples / 2);
+  unsigned long peak = 0;
+  cellToPoint->Update();
+  peak = std::max(peak, array->GetCopiedMemorySize());
+  threshold->Update();
+  peak = std::max(peak, array->GetCopiedMemorySize());
+  ok &= Check(threshold->GetOutput()->GetNumberOfCells() > 0, "empty threshold");
+
+  // Modify a few tuples in place and append one: only their chunks are copied.
+  const vtkIdType chunkSize = vtkCTHDataArray::GetChunkSize();
+  array->SetTuple1(10, -1.0);
+  array->SetTuple1(11, -2.0);
+  array->SetTuple1(numTuples / 2, -3.0);
+  vtkIdType appended = array->InsertNextTuple1(-4.0);
+  peak = std::max(peak, array->GetCopiedMemorySize());
+  std::set<vtkIdType> chunks = { 10 / chunkSize, numTuples / 2 / chunkSize,
+    numTuples / chunkSize };
+  ok &= Check(array->GetNumberOfCopiedChunks() == static_cast<vtkIdType>(chunks.size()),
+    "wrong number of copied chunks");
+  ok &= Check(appended == numTuples && array->GetNumberOfTuples() == numTuples + 1,
+    "wrong appended tuple");
+  ok &= Check(array->GetTuple1(10) == -1.0 && array->GetTuple1(11) == -2.0 &&
+      array->GetTuple1(numTuples / 2) == -3.0 && array->GetTuple1(numTuples) == -4.0,
+    "wrong modified values");
+  ok &= Check(array->GetTuple1(12) == block.Value(13, 1, 1), "wrong value next to modified ones");
+  ok &= Check(block.Value(11, 1, 1) == (1 * ny + 1) * nx + 11, "CTH data modified");
+  vtkNew<vtkDoubleArray> exported;
+  exported->SetNumberOfTuples(array->GetNumberOfTuples());
+  array->ExportToVoidPointer(exported->GetVoidPointer(0));
+  ok &= Check(exported->GetValue(11) == -2.0 && exported->GetValue(12) == array->GetTuple1(12) &&
+      exported->GetValue(numTuples) == -4.0,
+    "wrong exported values");
+
+  // Unlike in place modifications, contiguous access copies the whole array.
+  double* pointer = array->GetPointer(0);
+  ok &= Check(pointer[11] == -2.0 && pointer[numTuples] == -4.0, "wrong contiguous values");
+  unsigned long fullCopy = array->GetCopiedMemorySize();
+
+  // The next time step releases the copies.
+  Block next(nx, ny, nz, 1.0);
+  next.SetDataPointers(array.GetPointer());
+  array->SetExtents(1, nx - 2, 1, ny - 2, 1, nz - 2);
+  ok &= Check(array->GetCopiedMemorySize() == 0 && array->GetNumberOfTuples() == numTuples &&
+      array->GetTuple1(1) == next.Value(2, 1, 1),
+    "copies not released for the next time step");
+
+  unsigned long wrapped = static_cast<unsigned long>(numTuples * sizeof(double) / 1024);
+  cout << "CTH field: " << wrapped << " KiB, peak copied while co-processing: " << peak
+       << " KiB, full copy: " << fullCopy << " KiB" << endl;
+  ok &= Check(peak < wrapped / 10, "too much memory copied while co-processing");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,8 +1,28 @@
 #include "vtkCTHDataArray.h"
 #include "vtkArrayIteratorTemplate.h"
 #include "vtkIdList.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Chunks of 4096 tuples, i.e. 32 KiB for CTH's scalar fields.
+const int ChunkShift = 12;
+const vtkIdType ChunkSize = static_cast<vtkIdType>(1) << ChunkShift;
+
+void DeleteChunks(std::vector<double*>& chunks)
+{
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    delete[] chunks[i];
+  }
+  chunks.clear();
+}
+}
+
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCTHDataArray);
 
@@ -10,20 +30,25 @@ vtkStandardNewMacro(vtkCTHDataArray);
 
 vtkCTHDataArray::vtkCTHDataArray()
 {
+  for (int i = 0; i < 3; i++)
+  {
+    this->Dimensions[i] = 0;
+    this->Extents[2 * i] = this->Extents[2 * i + 1] = 0;
+  }
   this->ExtentsSet = false;
-  this->PointerTime = 0;
+  this->Dx = this->Dy = this->Dz = 0;
 
   this->Data = 0;
-  this->CopiedData = 0;
   this->Tuple = 0;
   this->TupleSize = 0;
+  this->NumberOfDataTuples = 0;
 
   this->Fallback = vtkDoubleArray::New();
 }
 
 vtkCTHDataArray::~vtkCTHDataArray()
 {
-  this->Initialize();
+  this->ReleaseData();
 }
 
 void vtkCTHDataArray::PrintSelf(ostream& os, vtkIndent indent)
@@ -31,10 +56,24 @@ void vtkCTHDataArray::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Dimensions " << this->Dimensions[0] << " " << this->Dimensions[1] << " "
      << this->Dimensions[2] << endl;
+  os << indent << "NumberOfCopiedChunks " << this->GetNumberOfCopiedChunks() << endl;
+  os << indent << "Fallback " << (this->Fallback ? "yes" : "no") << endl;
 }
 
 void vtkCTHDataArray::Initialize()
 {
+  this->ReleaseData();
+  this->ExtentsSet = false;
+  this->NumberOfDataTuples = 0;
+  this->MaxId = -1;
+  this->Size = 0;
+  this->ResetFallback();
+}
+
+void vtkCTHDataArray::ReleaseData()
+{
+  DeleteChunks(this->Chunks);
+
   if (this->Fallback)
   {
     this->Fallback->Delete();
@@ -54,38 +93,27 @@ void vtkCTHDataArray::Initialize()
   }
   this->Data = 0;
 
-  if (this->CopiedData)
-  {
-    delete[] this->CopiedData;
-  }
-  this->CopiedData = 0;
-
   if (this->Tuple)
   {
     delete[] this->Tuple;
   }
+  this->Tuple = 0;
+  this->TupleSize = 0;
 }
 
 // This one sets the size for the data pointers
 void vtkCTHDataArray::SetDimensions(int x, int y, int z)
 {
-  if (this->Fallback)
-  {
-    this->Fallback->Delete();
-    this->Fallback = 0;
-  }
+  this->ReleaseData();
 
   this->Dimensions[0] = x;
   this->Dimensions[1] = y;
   this->Dimensions[2] = z;
-  this->MaxId = x * y * z - 1;
   int numComp = this->GetNumberOfComponents();
-  this->Size = (MaxId + 1) * numComp;
+  this->NumberOfDataTuples = static_cast<vtkIdType>(x) * y * z;
+  this->MaxId = this->NumberOfDataTuples * numComp - 1;
+  this->Size = this->MaxId + 1;
 
-  if (this->Data)
-  {
-    this->Initialize();
-  }
   this->Data = new double**[numComp];
   for (int i = 0; i < numComp; i++)
   {
@@ -106,25 +134,138 @@ void vtkCTHDataArray::SetExtents(int x0, int x1, int y0, int y1, int z0, int z1)
   this->Extents[3] = y1;
   this->Extents[4] = z0;
   this->Extents[5] = z1;
-  this->MaxId = this->Dx * this->Dy * this->Dz - 1;
-
-  int numComp = this->GetNumberOfComponents();
-  this->Size = (MaxId + 1) * numComp;
+  this->NumberOfDataTuples = static_cast<vtkIdType>(this->Dx) * this->Dy * this->Dz;
   this->ExtentsSet = true;
+  this->ReleaseCopies();
 }
 
 void vtkCTHDataArray::UnsetExtents()
 {
-  this->MaxId = this->Dimensions[0] * this->Dimensions[1] * this->Dimensions[2] - 1;
-  this->Size = (MaxId + 1) * this->GetNumberOfComponents();
+  this->NumberOfDataTuples =
+    static_cast<vtkIdType>(this->Dimensions[0]) * this->Dimensions[1] * this->Dimensions[2];
   this->ExtentsSet = false;
+  this->ReleaseCopies();
 }
 
 void vtkCTHDataArray::SetDataPointer(int comp, int k, int j, double* istrip)
 {
+  // The copies are of the previous data.
+  if (this->Fallback || !this->Chunks.empty())
+  {
+    this->ReleaseCopies();
+  }
   this->Data[comp][k * this->Dimensions[1] + j] = istrip;
 }
 
+void vtkCTHDataArray::ReleaseCopies()
+{
+  DeleteChunks(this->Chunks);
+  if (this->Data)
+  {
+    if (this->Fallback)
+    {
+      this->Fallback->Delete();
+      this->Fallback = 0;
+    }
+    this->MaxId = this->NumberOfDataTuples * this->GetNumberOfComponents() - 1;
+    this->Size = this->MaxId + 1;
+  }
+}
+
+void vtkCTHDataArray::ReadDataTuples(vtkIdType first, vtkIdType last, double* tuples)
+{
+  int numComp = this->GetNumberOfComponents();
+  int stripLength = this->ExtentsSet ? this->Dx : this->Dimensions[0];
+  vtkIdType i = first;
+  while (i <= last)
+  {
+    // Copy the part of the strip tuple i is in that is in the range.
+    vtkIdType strip = i / stripLength;
+    int offset = static_cast<int>(i % stripLength);
+    vtkIdType count = std::min<vtkIdType>(stripLength - offset, last - i + 1);
+    vtkIdType plane = strip;
+    if (this->ExtentsSet)
+    {
+      plane = (strip / this->Dy + this->Extents[4]) * this->Dimensions[1] + strip % this->Dy +
+        this->Extents[2];
+      offset += this->Extents[0];
+    }
+    if (numComp == 1)
+    {
+      memcpy(tuples, this->Data[0][plane] + offset, count * sizeof(double));
+    }
+    else
+    {
+      for (int c = 0; c < numComp; c++)
+      {
+        const double* values = this->Data[c][plane] + offset;
+        for (vtkIdType t = 0; t < count; t++)
+        {
+          tuples[t * numComp + c] = values[t];
+        }
+      }
+    }
+    tuples += count * numComp;
+    i += count;
+  }
+}
+
+void vtkCTHDataArray::ReadTuples(vtkIdType first, vtkIdType last, double* tuples)
+{
+  int numComp = this->GetNumberOfComponents();
+  vtkIdType i = first;
+  while (i <= last)
+  {
+    size_t chunk = static_cast<size_t>(i >> ChunkShift);
+    vtkIdType end = std::min(last, ((i >> ChunkShift) + 1) * ChunkSize - 1);
+    vtkIdType count = end - i + 1;
+    if (chunk < this->Chunks.size() && this->Chunks[chunk])
+    {
+      memcpy(tuples, this->Chunks[chunk] + (i & (ChunkSize - 1)) * numComp,
+        count * numComp * sizeof(double));
+    }
+    else
+    {
+      vtkIdType dataEnd = std::min(end, this->NumberOfDataTuples - 1);
+      vtkIdType dataCount = std::max<vtkIdType>(0, dataEnd - i + 1);
+      if (dataCount > 0)
+      {
+        this->ReadDataTuples(i, dataEnd, tuples);
+      }
+      // Tuples inserted past the CTH data but never set are zero.
+      std::fill(tuples + dataCount * numComp, tuples + count * numComp, 0.0);
+    }
+    tuples += count * numComp;
+    i = end + 1;
+  }
+}
+
+double* vtkCTHDataArray::WriteTuple(vtkIdType i)
+{
+  int numComp = this->GetNumberOfComponents();
+  if (i >= this->GetNumberOfTuples())
+  {
+    this->MaxId = (i + 1) * numComp - 1;
+    if (this->Size <= this->MaxId)
+    {
+      this->Size = this->MaxId + 1;
+    }
+  }
+  size_t chunk = static_cast<size_t>(i >> ChunkShift);
+  if (chunk >= this->Chunks.size())
+  {
+    this->Chunks.resize(chunk + 1, 0);
+  }
+  if (!this->Chunks[chunk])
+  {
+    double* copy = new double[ChunkSize * numComp];
+    vtkIdType first = static_cast<vtkIdType>(chunk) << ChunkShift;
+    this->ReadTuples(first, first + ChunkSize - 1, copy);
+    this->Chunks[chunk] = copy;
+  }
+  return this->Chunks[chunk] + (i & (ChunkSize - 1)) * numComp;
+}
+
 void vtkCTHDataArray::GetTuple(vtkIdType i, double* tuple)
 {
   if (this->Fallback)
@@ -132,26 +273,20 @@ void vtkCTHDataArray::GetTuple(vtkIdType i, double* tuple)
     Fallback->GetTuple(i, tuple);
     return;
   }
-  if (this->ExtentsSet)
+  int numComp = this->GetNumberOfComponents();
+  size_t chunk = static_cast<size_t>(i >> ChunkShift);
+  if (chunk < this->Chunks.size() && this->Chunks[chunk])
   {
-    int P = i / this->Dx;
-    int Pk = P / this->Dy + this->Extents[4];
-    int Pj = P % this->Dy + this->Extents[2];
-    int plane = Pk * this->Dimensions[1] + Pj;
-    int offset = i % this->Dx + this->Extents[0];
-    for (int c = 0; c < this->GetNumberOfComponents(); c++)
-    {
-      tuple[c] = this->Data[c][plane][offset];
-    }
+    const double* values = this->Chunks[chunk] + (i & (ChunkSize - 1)) * numComp;
+    std::copy(values, values + numComp, tuple);
+  }
+  else if (i < this->NumberOfDataTuples)
+  {
+    this->ReadDataTuples(i, i, tuple);
   }
   else
   {
-    int plane = i / this->Dimensions[0];
-    int offset = i % this->Dimensions[0];
-    for (int c = 0; c < this->GetNumberOfComponents(); c++)
-    {
-      tuple[c] = this->Data[c][plane][offset];
-    }
+    std::fill(tuple, tuple + numComp, 0.0);
   }
 }
 
@@ -180,43 +315,102 @@ double* vtkCTHDataArray::GetTuple(vtkIdType i)
   return this->Tuple;
 }
 
-double* vtkCTHDataArray::GetPointer(vtkIdType id)
+void vtkCTHDataArray::GetTuples(vtkIdList* ptIds, vtkAbstractArray* output)
 {
   if (this->Fallback)
   {
-    return this->Fallback->GetPointer(id);
+    this->Fallback->GetTuples(ptIds, output);
+    return;
   }
-  if (this->PointerTime < this->GetMTime())
+  vtkDataArray* da = vtkDataArray::SafeDownCast(output);
+  int numComp = this->GetNumberOfComponents();
+  if (!da || da->GetNumberOfComponents() != numComp)
   {
-    int numComp = this->GetNumberOfComponents();
-    int size;
-    if (this->ExtentsSet)
+    this->Superclass::GetTuples(ptIds, output);
+    return;
+  }
+  // Ids usually come in increasing runs, e.g. the points of a strip, so read
+  // each run of consecutive ids at once.
+  vtkIdType numIds = ptIds->GetNumberOfIds();
+  const vtkIdType* ids = ptIds->GetPointer(0);
+  vtkDoubleArray* doubles = vtkDoubleArray::SafeDownCast(output);
+  if (doubles && doubles->GetNumberOfTuples() >= numIds)
+  {
+    double* tuples = doubles->GetPointer(0);
+    vtkIdType n = 0;
+    while (n < numIds)
     {
-      size = numComp * Dx * Dy * Dz;
+      vtkIdType count = 1;
+      while (n + count < numIds && ids[n + count] == ids[n] + count)
+      {
+        count++;
+      }
+      this->ReadTuples(ids[n], ids[n] + count - 1, tuples + n * numComp);
+      n += count;
     }
-    else
+    return;
+  }
+  // Read at most a chunk at a time to convert the values to the type of the
+  // output.
+  std::vector<double> tuples(ChunkSize * numComp);
+  vtkIdType n = 0;
+  while (n < numIds)
+  {
+    vtkIdType count = 1;
+    while (n + count < numIds && count < ChunkSize && ids[n + count] == ids[n] + count)
     {
-      int plane = this->Dimensions[2] * this->Dimensions[1];
-      size = numComp * plane * this->Dimensions[0];
+      count++;
     }
-    if (this->CopiedData)
+    this->ReadTuples(ids[n], ids[n] + count - 1, &tuples[0]);
+    for (vtkIdType t = 0; t < count; t++)
     {
-      if (this->CopiedSize < size)
-      {
-        delete[] this->CopiedData;
-        this->CopiedSize = size;
-        this->CopiedData = new double[this->CopiedSize];
-      }
+      da->SetTuple(n + t, &tuples[t * numComp]);
     }
-    else
+    n += count;
+  }
+}
+
+void vtkCTHDataArray::GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray* output)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->GetTuples(p1, p2, output);
+    return;
+  }
+  vtkDataArray* da = vtkDataArray::SafeDownCast(output);
+  int numComp = this->GetNumberOfComponents();
+  if (!da || da->GetNumberOfComponents() != numComp)
+  {
+    this->Superclass::GetTuples(p1, p2, output);
+    return;
+  }
+  if (p2 < p1)
+  {
+    return;
+  }
+  vtkDoubleArray* doubles = vtkDoubleArray::SafeDownCast(output);
+  if (doubles && doubles->GetNumberOfTuples() > p2 - p1)
+  {
+    this->ReadTuples(p1, p2, doubles->GetPointer(0));
+    return;
+  }
+  // Read a chunk at a time to convert the values to the type of the output.
+  std::vector<double> tuples(ChunkSize * numComp);
+  for (vtkIdType first = p1; first <= p2; first += ChunkSize)
+  {
+    vtkIdType last = std::min(p2, first + ChunkSize - 1);
+    this->ReadTuples(first, last, &tuples[0]);
+    for (vtkIdType i = first; i <= last; i++)
     {
-      this->CopiedSize = size;
-      this->CopiedData = new double[this->CopiedSize];
+      da->SetTuple(i - p1, &tuples[(i - first) * numComp]);
     }
-    this->ExportToVoidPointer(this->CopiedData);
-    this->PointerTime = this->GetMTime();
   }
-  return this->CopiedData + id;
+}
+
+double* vtkCTHDataArray::GetPointer(vtkIdType id)
+{
+  this->BuildFallback();
+  return this->Fallback->GetPointer(id);
 }
 
 void vtkCTHDataArray::ExportToVoidPointer(void* out_ptr)
@@ -225,41 +419,209 @@ void vtkCTHDataArray::ExportToVoidPointer(void* out_ptr)
   {
     return this->Fallback->ExportToVoidPointer(out_ptr);
   }
-  if (!out_ptr)
+  if (!out_ptr || this->GetNumberOfTuples() == 0)
+    return;
+  this->ReadTuples(0, this->GetNumberOfTuples() - 1, static_cast<double*>(out_ptr));
+}
+
+int vtkCTHDataArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  this->ResetFallback();
+  int ret = this->Fallback->Allocate(sz, ext);
+  this->UpdateFromFallback();
+  return ret;
+}
+
+void vtkCTHDataArray::SetNumberOfTuples(vtkIdType number)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->SetNumberOfTuples(number);
+    this->UpdateFromFallback();
+    return;
+  }
+  this->MaxId = number * this->GetNumberOfComponents() - 1;
+  if (this->Size <= this->MaxId)
+  {
+    this->Size = this->MaxId + 1;
+  }
+}
+
+int vtkCTHDataArray::Resize(vtkIdType numTuples)
+{
+  if (this->Fallback)
+  {
+    int ret = this->Fallback->Resize(numTuples);
+    this->UpdateFromFallback();
+    return ret;
+  }
+  // Nothing is allocated until tuples are written.
+  vtkIdType size = numTuples * this->GetNumberOfComponents();
+  if (size <= this->MaxId)
+  {
+    this->MaxId = size - 1;
+  }
+  this->Size = size;
+  return 1;
+}
+
+void vtkCTHDataArray::SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa)
+{
+  vtkDataArray* da = vtkDataArray::SafeDownCast(aa);
+  if (this->Fallback || !da || da->GetNumberOfComponents() != this->GetNumberOfComponents())
+  {
+    this->BuildFallback();
+    this->Fallback->SetTuple(i, j, aa);
+    this->UpdateFromFallback();
+    return;
+  }
+  da->GetTuple(j, this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::SetTuple(vtkIdType i, const float* f)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->SetTuple(i, f);
+    return;
+  }
+  std::copy(f, f + this->GetNumberOfComponents(), this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::SetTuple(vtkIdType i, const double* d)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->SetTuple(i, d);
+    return;
+  }
+  std::copy(d, d + this->GetNumberOfComponents(), this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa)
+{
+  vtkDataArray* da = vtkDataArray::SafeDownCast(aa);
+  if (this->Fallback || !da || da->GetNumberOfComponents() != this->GetNumberOfComponents())
+  {
+    this->BuildFallback();
+    this->Fallback->InsertTuple(i, j, aa);
+    this->UpdateFromFallback();
+    return;
+  }
+  da->GetTuple(j, this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::InsertTuple(vtkIdType i, const float* f)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->InsertTuple(i, f);
+    this->UpdateFromFallback();
+    return;
+  }
+  std::copy(f, f + this->GetNumberOfComponents(), this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::InsertTuple(vtkIdType i, const double* d)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->InsertTuple(i, d);
+    this->UpdateFromFallback();
+    return;
+  }
+  std::copy(d, d + this->GetNumberOfComponents(), this->WriteTuple(i));
+}
+
+void vtkCTHDataArray::InsertTuples(vtkIdList* dstIds, vtkIdList* srcIds, vtkAbstractArray* source)
+{
+  vtkDataArray* da = vtkDataArray::SafeDownCast(source);
+  if (this->Fallback || !da || da->GetNumberOfComponents() != this->GetNumberOfComponents() ||
+    dstIds->GetNumberOfIds() != srcIds->GetNumberOfIds())
+  {
+    this->BuildFallback();
+    this->Fallback->InsertTuples(dstIds, srcIds, source);
+    this->UpdateFromFallback();
+    return;
+  }
+  for (vtkIdType n = 0; n < dstIds->GetNumberOfIds(); n++)
+  {
+    da->GetTuple(srcIds->GetId(n), this->WriteTuple(dstIds->GetId(n)));
+  }
+}
+
+void vtkCTHDataArray::InsertTuples(
+  vtkIdType dstStart, vtkIdType n, vtkIdType srcStart, vtkAbstractArray* source)
+{
+  vtkDataArray* da = vtkDataArray::SafeDownCast(source);
+  if (this->Fallback || !da || da->GetNumberOfComponents() != this->GetNumberOfComponents())
+  {
+    this->BuildFallback();
+    this->Fallback->InsertTuples(dstStart, n, srcStart, source);
+    this->UpdateFromFallback();
     return;
-  double* out_data = static_cast<double*>(out_ptr);
-  int rawIndex = 0;
+  }
+  for (vtkIdType i = 0; i < n; i++)
+  {
+    da->GetTuple(srcStart + i, this->WriteTuple(dstStart + i));
+  }
+}
+
+vtkIdType vtkCTHDataArray::InsertNextTuple(vtkIdType i, vtkAbstractArray* aa)
+{
+  vtkIdType id = this->GetNumberOfTuples();
+  this->InsertTuple(id, i, aa);
+  return id;
+}
+
+vtkIdType vtkCTHDataArray::InsertNextTuple(const float* f)
+{
+  vtkIdType id = this->GetNumberOfTuples();
+  this->InsertTuple(id, f);
+  return id;
+}
+
+vtkIdType vtkCTHDataArray::InsertNextTuple(const double* d)
+{
+  vtkIdType id = this->GetNumberOfTuples();
+  this->InsertTuple(id, d);
+  return id;
+}
+
+void vtkCTHDataArray::InsertVariantValue(vtkIdType idx, vtkVariant value)
+{
+  if (this->Fallback)
+  {
+    this->Fallback->InsertVariantValue(idx, value);
+    this->UpdateFromFallback();
+    return;
+  }
   int numComp = this->GetNumberOfComponents();
-  if (this->ExtentsSet)
+  this->WriteTuple(idx / numComp)[idx % numComp] = value.ToDouble();
+}
+
+void vtkCTHDataArray::SetVariantValue(vtkIdType idx, vtkVariant value)
+{
+  if (this->Fallback)
   {
-    for (int c = 0; c < numComp; c++)
-    {
-      for (int k = this->Extents[4]; k <= this->Extents[5]; k++)
-      {
-        for (int j = this->Extents[2]; j <= this->Extents[3]; j++)
-        {
-          int plane = k * this->Dimensions[1] + j;
-          for (int i = this->Extents[0]; i <= this->Extents[1]; i++)
-          {
-            out_data[rawIndex++] = this->Data[c][plane][i];
-          }
-        }
-      }
-    }
+    this->Fallback->SetVariantValue(idx, value);
+    return;
   }
-  else
+  int numComp = this->GetNumberOfComponents();
+  this->WriteTuple(idx / numComp)[idx % numComp] = value.ToDouble();
+}
+
+void vtkCTHDataArray::RemoveLastTuple()
+{
+  if (this->Fallback)
   {
-    int plane = this->Dimensions[2] * this->Dimensions[1];
-    for (int c = 0; c < numComp; c++)
-    {
-      for (int kj = 0; kj < plane; kj++)
-      {
-        for (int i = 0; i < this->Dimensions[0]; i++)
-        {
-          out_data[rawIndex++] = this->Data[c][kj][i];
-        }
-      }
-    }
+    this->Fallback->RemoveLastTuple();
+    this->UpdateFromFallback();
+    return;
+  }
+  if (this->MaxId >= 0)
+  {
+    this->MaxId -= this->GetNumberOfComponents();
   }
 }
 
@@ -269,50 +631,9 @@ vtkIdType vtkCTHDataArray::LookupValue(vtkVariant var)
   {
     return this->Fallback->LookupValue(var);
   }
-  bool valid = true;
-  double val = var.ToDouble(&valid);
-  if (valid)
-  {
-    int numComp = this->GetNumberOfComponents();
-    if (this->ExtentsSet)
-    {
-      for (int c = 0; c < numComp; c++)
-      {
-        for (int k = this->Extents[4]; k <= this->Extents[5]; k++)
-        {
-          for (int j = this->Extents[2]; k <= this->Extents[3]; k++)
-          {
-            int plane = k * this->Dy + j;
-            for (int i = this->Extents[0]; i <= this->Extents[1]; i++)
-            {
-              if (this->Data[c][plane][i] == val)
-              {
-                return c * this->Dz * this->Dy * this->Dz + plane * this->Dx + i;
-              }
-            }
-          }
-        }
-      }
-    }
-    else
-    {
-      int plane = this->Dimensions[2] * this->Dimensions[1];
-      for (int c = 0; c < numComp; c++)
-      {
-        for (int kj = 0; kj < plane; kj++)
-        {
-          for (int i = 0; i < this->Dimensions[0]; i++)
-          {
-            if (this->Data[c][kj][i] == val)
-            {
-              return c * plane * this->Dimensions[0] + kj * this->Dimensions[0] + i;
-            }
-          }
-        }
-      }
-    }
-  }
-  return -1;
+  vtkNew<vtkIdList> ids;
+  this->LookupValue(var, ids.GetPointer());
+  return ids->GetNumberOfIds() > 0 ? ids->GetId(0) : -1;
 }
 
 void vtkCTHDataArray::LookupValue(vtkVariant var, vtkIdList* ids)
@@ -328,40 +649,18 @@ void vtkCTHDataArray::LookupValue(vtkVariant var, vtkIdList* ids)
   if (valid)
   {
     int numComp = this->GetNumberOfComponents();
-    if (this->ExtentsSet)
+    vtkIdType numTuples = this->GetNumberOfTuples();
+    std::vector<double> tuples(ChunkSize * numComp);
+    for (vtkIdType first = 0; first < numTuples; first += ChunkSize)
     {
-      for (int c = 0; c < numComp; c++)
+      vtkIdType last = std::min(numTuples - 1, first + ChunkSize - 1);
+      this->ReadTuples(first, last, &tuples[0]);
+      vtkIdType numValues = (last - first + 1) * numComp;
+      for (vtkIdType v = 0; v < numValues; v++)
       {
-        for (int k = this->Extents[4]; k <= this->Extents[5]; k++)
+        if (tuples[v] == val)
         {
-          for (int j = this->Extents[2]; k <= this->Extents[3]; k++)
-          {
-            int plane = k * this->Dy + j;
-            for (int i = this->Extents[0]; i <= this->Extents[1]; i++)
-            {
-              if (this->Data[c][plane][i] == val)
-              {
-                ids->InsertNextId(c * this->Dx * this->Dy * this->Dz + plane * this->Dx + i);
-              }
-            }
-          }
-        }
-      }
-    }
-    else
-    {
-      int plane = this->Dimensions[2] * this->Dimensions[1];
-      for (int c = 0; c < numComp; c++)
-      {
-        for (int kj = 0; kj < plane; kj++)
-        {
-          for (int i = 0; i < this->Dimensions[0]; i++)
-          {
-            if (this->Data[c][kj][i] == val)
-            {
-              ids->InsertNextId(c * plane * this->Dimensions[0] + kj * this->Dimensions[0] + i);
-            }
-          }
+          ids->InsertNextId(first * numComp + v);
         }
       }
     }
@@ -370,11 +669,31 @@ void vtkCTHDataArray::LookupValue(vtkVariant var, vtkIdList* ids)
 
 vtkArrayIterator* vtkCTHDataArray::NewIterator()
 {
-  if (!this->Fallback)
+  this->BuildFallback();
+  return this->Fallback->NewIterator();
+}
+
+vtkIdType vtkCTHDataArray::GetChunkSize()
+{
+  return ChunkSize;
+}
+
+vtkIdType vtkCTHDataArray::GetNumberOfCopiedChunks()
+{
+  return static_cast<vtkIdType>(
+    this->Chunks.size() - std::count(this->Chunks.begin(), this->Chunks.end(), nullptr));
+}
+
+unsigned long vtkCTHDataArray::GetCopiedMemorySize()
+{
+  vtkIdType chunkBytes = ChunkSize * this->GetNumberOfComponents() * sizeof(double);
+  unsigned long size =
+    static_cast<unsigned long>(this->GetNumberOfCopiedChunks() * chunkBytes / 1024);
+  if (this->Fallback)
   {
-    this->BuildFallback();
+    size += this->Fallback->GetActualMemorySize();
   }
-  return this->Fallback->NewIterator();
+  return size;
 }
 
 void vtkCTHDataArray::BuildFallback()
@@ -382,13 +701,33 @@ void vtkCTHDataArray::BuildFallback()
   if (!Fallback)
   {
     vtkDoubleArray* da = vtkDoubleArray::New();
-    da->SetNumberOfTuples(this->GetNumberOfTuples());
     da->SetNumberOfComponents(this->GetNumberOfComponents());
+    vtkIdType numTuples = this->GetNumberOfTuples();
+    da->SetNumberOfTuples(numTuples);
     // Avoid calling GetPointer so that we don't make an unnecessary copy.
-    for (vtkIdType i = 0; i < this->Size; i++)
+    if (numTuples > 0)
     {
-      da->SetTypedTuple(i, this->GetTuple(i));
+      this->ReadTuples(0, numTuples - 1, da->GetPointer(0));
     }
+    DeleteChunks(this->Chunks);
     this->Fallback = da;
   }
 }
+
+void vtkCTHDataArray::ResetFallback()
+{
+  DeleteChunks(this->Chunks);
+  if (this->Fallback)
+  {
+    this->Fallback->Delete();
+  }
+  this->Fallback = vtkDoubleArray::New();
+  this->Fallback->SetNumberOfComponents(this->GetNumberOfComponents());
+}
+
+void vtkCTHDataArray::UpdateFromFallback()
+{
+  this->NumberOfComponents = this->Fallback->GetNumberOfComponents();
+  this->Size = this->Fallback->GetSize();
+  this->MaxId = this->Fallback->GetMaxId();
+}
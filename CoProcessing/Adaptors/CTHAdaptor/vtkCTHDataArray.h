@@ -6,6 +6,16 @@
 #include "vtkDataArray.h"
 #include "vtkDoubleArray.h"
 
+#include <vector>
+
+// Description:
+// vtkCTHDataArray wraps the strips CTH stores its block fields in. Tuples are
+// read straight from the strips. Modifying tuples copies the chunks of
+// GetChunkSize() tuples they are in, on write, and the modified tuples are
+// then read from those copies. Only the calls that need the values to be
+// contiguous in memory, such as GetPointer(), copy the whole array into a
+// vtkDoubleArray, the Fallback, that the array then delegates to. The copies
+// are released when the data pointers or the extents are set again.
 class VTK_EXPORT vtkCTHDataArray : public vtkDataArray
 {
 public:
@@ -55,27 +65,31 @@ public:
   void GetTuple(vtkIdType i, double* tuple) VTK_OVERRIDE;
   double* GetTuple(vtkIdType i) VTK_OVERRIDE;
 
+  // Description:
+  // Copy the given tuples into output, reading whole strip segments at a
+  // time for ranges and runs of consecutive ids.
+  void GetTuples(vtkIdList* ptIds, vtkAbstractArray* output) VTK_OVERRIDE;
+  void GetTuples(vtkIdType p1, vtkIdType p2, vtkAbstractArray* output) VTK_OVERRIDE;
+
   // Description:
   // Returns an ArrayIterator over doubles, this will end up with a deep copy
   vtkArrayIterator* NewIterator() VTK_OVERRIDE;
 
   vtkIdType LookupValue(vtkVariant value) VTK_OVERRIDE;
   void LookupValue(vtkVariant value, vtkIdList* ids) VTK_OVERRIDE;
-  void SetVariantValue(vtkIdType vtkNotUsed(index), vtkVariant vtkNotUsed(value)) VTK_OVERRIDE
-  { /* TODO */}
+  void SetVariantValue(vtkIdType index, vtkVariant value) VTK_OVERRIDE;
 
   // Description:
   // Get the address of a particular data index. Performs no checks
   // to verify that the memory has been allocated etc.
+  // This copies the whole array into the Fallback.
   double* GetPointer(vtkIdType id);
   void* GetVoidPointer(vtkIdType id) VTK_OVERRIDE { return this->GetPointer(id); }
   void ExportToVoidPointer(void* out_ptr) VTK_OVERRIDE;
 
-  int Allocate(vtkIdType sz, vtkIdType ext = 1000) VTK_OVERRIDE
-  {
-    BuildFallback();
-    return Fallback->Allocate(sz, ext);
-  }
+  // Description:
+  // Allocating discards the current values so it does not copy them.
+  int Allocate(vtkIdType sz, vtkIdType ext = 1000) VTK_OVERRIDE;
 
   void SetNumberOfComponents(int number) VTK_OVERRIDE
   {
@@ -86,116 +100,57 @@ public:
     }
   }
 
-  void SetNumberOfTuples(vtkIdType number) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->SetNumberOfTuples(number);
-    this->Size = this->Fallback->GetSize();
-    this->MaxId = this->Fallback->GetMaxId();
-  }
+  void SetNumberOfTuples(vtkIdType number) VTK_OVERRIDE;
 
   // Description:
-  // A number of abstract functions from the super class that must not be called
-  void SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->SetTuple(i, j, aa);
-  }
-  void SetTuple(vtkIdType i, const float* f) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->SetTuple(i, f);
-  }
-  void SetTuple(vtkIdType i, const double* d) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->SetTuple(i, d);
-  }
-
-  void InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->InsertTuple(i, j, aa);
-  }
-  void InsertTuple(vtkIdType i, const float* f) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->InsertTuple(i, f);
-  }
-  void InsertTuple(vtkIdType i, const double* d) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->InsertTuple(i, d);
-  }
-  void InsertTuples(vtkIdList* dstIds, vtkIdList* srcIds, vtkAbstractArray* source) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->InsertTuples(dstIds, srcIds, source);
-  }
+  // The modifying functions of the super class. They copy the chunks of the
+  // tuples they modify, or write to the Fallback if there is one.
+  void SetTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa) VTK_OVERRIDE;
+  void SetTuple(vtkIdType i, const float* f) VTK_OVERRIDE;
+  void SetTuple(vtkIdType i, const double* d) VTK_OVERRIDE;
+
+  void InsertTuple(vtkIdType i, vtkIdType j, vtkAbstractArray* aa) VTK_OVERRIDE;
+  void InsertTuple(vtkIdType i, const float* f) VTK_OVERRIDE;
+  void InsertTuple(vtkIdType i, const double* d) VTK_OVERRIDE;
+  void InsertTuples(vtkIdList* dstIds, vtkIdList* srcIds, vtkAbstractArray* source) VTK_OVERRIDE;
   virtual void InsertTuples(
-    vtkIdType dstStart, vtkIdType n, vtkIdType srcStart, vtkAbstractArray* source) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->InsertTuples(dstStart, n, srcStart, source);
-  }
+    vtkIdType dstStart, vtkIdType n, vtkIdType srcStart, vtkAbstractArray* source) VTK_OVERRIDE;
 
-  vtkIdType InsertNextTuple(vtkIdType i, vtkAbstractArray* aa) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    vtkIdType ret = this->Fallback->InsertNextTuple(i, aa);
-    this->Size = this->Fallback->GetSize();
-    this->MaxId = this->Fallback->GetMaxId();
-    return ret;
-  }
-  vtkIdType InsertNextTuple(const float* f) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    vtkIdType ret = this->Fallback->InsertNextTuple(f);
-    this->Size = this->Fallback->GetSize();
-    this->MaxId = this->Fallback->GetMaxId();
-    return ret;
-  }
-  vtkIdType InsertNextTuple(const double* d) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    vtkIdType ret = this->Fallback->InsertNextTuple(d);
-    this->Size = this->Fallback->GetSize();
-    this->MaxId = this->Fallback->GetMaxId();
-    return ret;
-  }
+  vtkIdType InsertNextTuple(vtkIdType i, vtkAbstractArray* aa) VTK_OVERRIDE;
+  vtkIdType InsertNextTuple(const float* f) VTK_OVERRIDE;
+  vtkIdType InsertNextTuple(const double* d) VTK_OVERRIDE;
 
-  void InsertVariantValue(vtkIdType idx, vtkVariant value) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    return this->Fallback->InsertVariantValue(idx, value);
-  }
+  void InsertVariantValue(vtkIdType idx, vtkVariant value) VTK_OVERRIDE;
 
   void RemoveTuple(vtkIdType id) VTK_OVERRIDE
   {
     this->BuildFallback();
     this->Fallback->RemoveTuple(id);
+    this->UpdateFromFallback();
   }
   void RemoveFirstTuple() VTK_OVERRIDE
   {
     this->BuildFallback();
     this->Fallback->RemoveFirstTuple();
+    this->UpdateFromFallback();
   }
-  void RemoveLastTuple() VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    this->Fallback->RemoveLastTuple();
-  }
+  void RemoveLastTuple() VTK_OVERRIDE;
 
   void* WriteVoidPointer(vtkIdType i, vtkIdType j) VTK_OVERRIDE
   {
     this->BuildFallback();
-    return this->Fallback->WriteVoidPointer(i, j);
+    void* ptr = this->Fallback->WriteVoidPointer(i, j);
+    this->UpdateFromFallback();
+    return ptr;
   }
 
+  // Description:
+  // These replace the values so they do not copy the current ones.
   virtual void DeepCopy(vtkAbstractArray* aa) VTK_OVERRIDE
   {
-    this->BuildFallback();
-    return this->Fallback->DeepCopy(aa);
+    this->ResetFallback();
+    this->Fallback->DeepCopy(aa);
+    this->UpdateFromFallback();
   }
 
   virtual void DeepCopy(vtkDataArray* da) VTK_OVERRIDE
@@ -205,13 +160,15 @@ public:
 
   void SetVoidArray(void* p, vtkIdType id, int i, int j) VTK_OVERRIDE
   {
-    this->BuildFallback();
-    return this->Fallback->SetVoidArray(p, id, i, j);
+    this->ResetFallback();
+    this->Fallback->SetVoidArray(p, id, i, j);
+    this->UpdateFromFallback();
   }
   void SetVoidArray(void* p, vtkIdType id, int i) VTK_OVERRIDE
   {
-    this->BuildFallback();
-    return this->Fallback->SetVoidArray(p, id, i);
+    this->ResetFallback();
+    this->Fallback->SetVoidArray(p, id, i);
+    this->UpdateFromFallback();
   }
   void SetArrayFreeFunction(void (*)(void*)) override {}
 
@@ -222,31 +179,41 @@ public:
   {
     if (this->Fallback)
     {
-      this->Size = this->Fallback->GetSize();
-      this->MaxId = this->Fallback->GetMaxId();
       this->Fallback->Squeeze();
+      this->UpdateFromFallback();
     }
   }
 
   // Description:
-  int Resize(vtkIdType numTuples) VTK_OVERRIDE
-  {
-    this->BuildFallback();
-    return this->Fallback->Resize(numTuples);
-  }
+  int Resize(vtkIdType numTuples) VTK_OVERRIDE;
 
   void DataChanged() VTK_OVERRIDE
   {
-    this->BuildFallback();
-    return this->Fallback->DataChanged();
+    if (this->Fallback)
+    {
+      this->Fallback->DataChanged();
+    }
   }
 
   void ClearLookup() VTK_OVERRIDE
   {
-    this->BuildFallback();
-    return this->Fallback->ClearLookup();
+    if (this->Fallback)
+    {
+      this->Fallback->ClearLookup();
+    }
   }
 
+  // Description:
+  // Number of tuples in the chunks copied on write.
+  static vtkIdType GetChunkSize();
+
+  // Description:
+  // Returns the number of chunks copied on write and the memory, in
+  // kibibytes, the array allocated for values, i.e. the chunks and the
+  // Fallback, as opposed to the CTH strips it wraps.
+  vtkIdType GetNumberOfCopiedChunks();
+  unsigned long GetCopiedMemorySize();
+
 protected:
   vtkCTHDataArray();
   ~vtkCTHDataArray();
@@ -259,15 +226,39 @@ protected:
   int Dy;
   int Dz;
 
-  vtkMTimeType PointerTime;
-
   double*** Data;
-  double* CopiedData;
-  int CopiedSize;
   double* Tuple;
   int TupleSize;
 
+  // Number of tuples in the CTH strips.
+  vtkIdType NumberOfDataTuples;
+
+  // Copies of the chunks that were written to, in the tuple order, or null
+  // for the chunks that are read from the CTH strips.
+  std::vector<double*> Chunks;
+
+  // Copy the tuples first to last into tuples, from the chunks or the strips.
+  void ReadTuples(vtkIdType first, vtkIdType last, double* tuples);
+
+  // Copy tuples first to last from the strips into tuples.
+  void ReadDataTuples(vtkIdType first, vtkIdType last, double* tuples);
+
+  // Returns the address of tuple i for writing, copying its chunk and
+  // inserting the tuple if needed.
+  double* WriteTuple(vtkIdType i);
+
+  // Release the chunks and the Fallback so that the array wraps the CTH
+  // strips again.
+  void ReleaseCopies();
+
+  // Release all the memory owned by the array.
+  void ReleaseData();
+
   void BuildFallback();
+  // Replace the values by an empty Fallback.
+  void ResetFallback();
+  // Update MaxId, Size and the number of components from the Fallback.
+  void UpdateFromFallback();
   // A writable version of this array, delegated.
   vtkDoubleArray* Fallback;
 
@@ -3,14 +3,14 @@
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
 #include "vtkCPProcessor.h"
-#include "vtkCellType.h"
 #include "vtkDoubleArray.h"
 #include "vtkMPI.h"
 #include "vtkMPICommunicator.h"
 #include "vtkMPIController.h"
 #include "vtkParticlePipeline.h"
 #include "vtkPointData.h"
-#include "vtkUnstructuredGrid.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 
 namespace
 {
@@ -70,31 +70,25 @@ void coprocessorcreateimage(int timestep, double time, char* filename, int n, do
   coProcessorData->SetTimeData(time, timestep);
   if (coProcessor->RequestDataDescription(coProcessorData))
   {
-    vtkUnstructuredGrid* grid = vtkUnstructuredGrid::New();
+    // The particles are only rendered as glyphs so the grid needs no cells,
+    // which avoids building one vertex cell per particle.
+    vtkPolyData* grid = vtkPolyData::New();
     coProcessorData->GetInputDescriptionByName("input")->SetGrid(grid);
     grid->Delete();
 
     vtkPoints* points = vtkPoints::New();
-    points->SetNumberOfPoints(n);
     grid->SetPoints(points);
     points->Delete();
 
     vtkDoubleArray* coords = vtkDoubleArray::New();
     coords->SetNumberOfComponents(3);
-    coords->SetNumberOfTuples(n);
     coords->SetArray(xyz, n * 3, 1);
     points->SetData(coords);
     coords->Delete();
 
-    for (vtkIdType i = 0; i < n; i++)
-    {
-      grid->InsertNextCell(VTK_VERTEX, (vtkIdType)1, &i);
-    }
-
     vtkDoubleArray* attribute = vtkDoubleArray::New();
     attribute->SetName("Attribute");
     attribute->SetNumberOfComponents(1);
-    attribute->SetNumberOfTuples(n);
     attribute->SetArray(attr, n, 1);
     grid->GetPointData()->AddArray(attribute);
     attribute->Delete();
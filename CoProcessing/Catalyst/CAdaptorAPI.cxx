@@ -16,6 +16,8 @@
 
 #include "vtkCPAdaptorAPI.h"
 
+#include <string>
+
 // call at the start of the simulation
 void coprocessorinitialize()
 {
@@ -49,3 +51,25 @@ void coprocess()
 {
   vtkCPAdaptorAPI::CoProcess();
 }
+
+// sets the grid to a point cloud using the x, y and z arrays without copying
+// them.
+void setpointcloud(int* numberOfPoints, double* x, double* y, double* z, int* polyVertex)
+{
+  vtkCPAdaptorAPI::SetPointCloud(numberOfPoints, x, y, z, polyVertex);
+}
+
+// adds a scalar point field to the point cloud without copying it.
+void addpointcloudscalarfield(char* name, int* nameLength, double* values)
+{
+  std::string fieldName(name, *nameLength);
+  vtkCPAdaptorAPI::AddPointCloudField(fieldName.c_str(), 1, &values);
+}
+
+// adds a vector point field to the point cloud without copying it.
+void addpointcloudvectorfield(char* name, int* nameLength, double* x, double* y, double* z)
+{
+  std::string fieldName(name, *nameLength);
+  double* components[3] = { x, y, z };
+  vtkCPAdaptorAPI::AddPointCloudField(fieldName.c_str(), 3, components);
+}
@@ -47,6 +47,24 @@ void VTKPVCATALYST_EXPORT needtocreategrid(int* needGrid);
 // has been filled in elsewhere.
 void VTKPVCATALYST_EXPORT coprocess();
 
+// sets the grid to a point cloud of numberOfPoints points whose coordinates
+// are in the separate x, y and z arrays. the arrays are used directly, without
+// copying, and must remain valid until coprocess() returns. if polyVertex is 0
+// the point cloud has no cells, otherwise it has a single poly-vertex cell.
+// call after requestdatadescription() for every time step that is coprocessed.
+void VTKPVCATALYST_EXPORT setpointcloud(
+  int* numberOfPoints, double* x, double* y, double* z, int* polyVertex);
+
+// adds a scalar point field named by the nameLength first characters of name
+// to the point cloud. values is used directly, without copying.
+void VTKPVCATALYST_EXPORT addpointcloudscalarfield(char* name, int* nameLength, double* values);
+
+// adds a 3 component point field named by the nameLength first characters of
+// name to the point cloud with one array per component. the arrays are used
+// directly, without copying.
+void VTKPVCATALYST_EXPORT addpointcloudvectorfield(
+  char* name, int* nameLength, double* x, double* y, double* z);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
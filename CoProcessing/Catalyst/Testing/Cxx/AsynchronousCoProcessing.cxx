@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    AsynchronousCoProcessing.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that asynchronous co-processing executes the pipelines on a
+// snapshot of the input taken by CoProcess(), and that time steps are skipped
+// or waited for when the analysis is behind.
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+class vtkSlowPipeline : public vtkCPPipeline
+{
+public:
+  static vtkSlowPipeline* New();
+  vtkTypeMacro(vtkSlowPipeline, vtkCPPipeline);
+
+  int RequestDataDescription(vtkCPDataDescription* dataDescription) override
+  {
+    dataDescription->GetInputDescriptionByName("input")->AddField("f", vtkDataObject::POINT);
+    return 1;
+  }
+
+  int CoProcess(vtkCPDataDescription* dataDescription) override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    vtkDataSet* grid =
+      vtkDataSet::SafeDownCast(dataDescription->GetInputDescriptionByName("input")->GetGrid());
+    vtkDataArray* f = grid ? grid->GetPointData()->GetArray("f") : nullptr;
+    if (!f || grid->GetPointData()->GetArray("g") ||
+      f->GetTuple1(0) != dataDescription->GetTimeStep())
+    {
+      this->Failed = true;
+    }
+    this->TimeSteps.push_back(dataDescription->GetTimeStep());
+    return 1;
+  }
+
+  std::vector<vtkIdType> TimeSteps;
+  bool Failed = false;
+};
+vtkStandardNewMacro(vtkSlowPipeline);
+
+// Runs numberOfTimeSteps time steps, modifying the field as soon as
+// CoProcess() returns, and returns the pipeline.
+vtkSlowPipeline* Run(vtkCPProcessor* processor, int numberOfTimeSteps)
+{
+  vtkSlowPipeline* pipeline = vtkSlowPipeline::New();
+  processor->AddPipeline(pipeline);
+
+  vtkNew<vtkImageData> grid;
+  grid->SetDimensions(2, 2, 2);
+  vtkNew<vtkDoubleArray> f;
+  f->SetName("f");
+  f->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(f);
+  vtkNew<vtkDoubleArray> g;
+  g->SetName("g");
+  g->SetNumberOfTuples(grid->GetNumberOfPoints());
+  grid->GetPointData()->AddArray(g);
+
+  vtkNew<vtkCPDataDescription> dataDescription;
+  dataDescription->AddInput("input");
+  for (int step = 0; step < numberOfTimeSteps; ++step)
+  {
+    dataDescription->SetTimeData(step, step);
+    if (processor->RequestDataDescription(dataDescription))
+    {
+      f->FillComponent(0, step);
+      dataDescription->GetInputDescriptionByName("input")->SetGrid(grid);
+      processor->CoProcess(dataDescription);
+      f->FillComponent(0, -1);
+    }
+  }
+  processor->Finalize();
+  return pipeline;
+}
+}
+
+int AsynchronousCoProcessing(int, char* [])
+{
+  const int numberOfTimeSteps = 10;
+
+  // Waiting for the analysis executes all the time steps, in order.
+  vtkNew<vtkCPProcessor> waiting;
+  waiting->Initialize();
+  waiting->AsynchronousOn();
+  waiting->SetAsynchronousPolicy(vtkCPProcessor::WAIT_FOR_ANALYSIS);
+  waiting->SetMaximumNumberOfPendingTimeSteps(2);
+  vtkSlowPipeline* pipeline = Run(waiting, numberOfTimeSteps);
+  bool success = !pipeline->Failed &&
+    pipeline->TimeSteps.size() == static_cast<size_t>(numberOfTimeSteps) &&
+    waiting->GetNumberOfSkippedTimeSteps() == 0;
+  for (size_t cc = 0; success && cc < pipeline->TimeSteps.size(); ++cc)
+  {
+    success = pipeline->TimeSteps[cc] == static_cast<vtkIdType>(cc);
+  }
+  pipeline->Delete();
+  if (!success)
+  {
+    cerr << "ERROR: wrong time steps executed while waiting for the analysis." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The simulation is much faster than the analysis so time steps get skipped.
+  vtkNew<vtkCPProcessor> skipping;
+  skipping->Initialize();
+  skipping->AsynchronousOn();
+  pipeline = Run(skipping, numberOfTimeSteps);
+  success = !pipeline->Failed && skipping->GetNumberOfSkippedTimeSteps() > 0 &&
+    pipeline->TimeSteps.size() + skipping->GetNumberOfSkippedTimeSteps() ==
+      static_cast<size_t>(numberOfTimeSteps);
+  pipeline->Delete();
+  if (!success)
+  {
+    cerr << "ERROR: wrong time steps executed while skipping time steps." << endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
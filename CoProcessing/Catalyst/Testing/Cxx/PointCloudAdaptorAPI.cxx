@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    PointCloudAdaptorAPI.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the point cloud entry points of the C adaptor API wrap the
+// simulation's separate coordinate and field arrays without copying them.
+
+#include "CAdaptorAPI.h"
+#include "vtkCPAdaptorAPI.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkDataArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+
+#include <vector>
+
+namespace
+{
+class vtkPointCloudPipeline : public vtkCPPipeline
+{
+public:
+  static vtkPointCloudPipeline* New();
+  vtkTypeMacro(vtkPointCloudPipeline, vtkCPPipeline);
+
+  int RequestDataDescription(vtkCPDataDescription* dataDescription) override
+  {
+    dataDescription->GetInputDescriptionByName("input")->AddField("v", vtkDataObject::POINT);
+    return 1;
+  }
+
+  int CoProcess(vtkCPDataDescription* dataDescription) override
+  {
+    vtkPolyData* grid =
+      vtkPolyData::SafeDownCast(dataDescription->GetInputDescriptionByName("input")->GetGrid());
+    if (!grid)
+    {
+      this->Failed = true;
+      return 1;
+    }
+    this->NumberOfPoints = grid->GetNumberOfPoints();
+    this->NumberOfCells = grid->GetNumberOfCells();
+    this->NumberOfArrays = grid->GetPointData()->GetNumberOfArrays();
+    vtkDataArray* v = grid->GetPointData()->GetArray("v");
+    for (vtkIdType cc = 0; cc < this->NumberOfPoints; ++cc)
+    {
+      double pt[3];
+      grid->GetPoint(cc, pt);
+      if (pt[0] != cc || pt[1] != 2 * cc || pt[2] != 3 * cc || !v ||
+        v->GetComponent(cc, 1) != -cc)
+      {
+        this->Failed = true;
+      }
+    }
+    return 1;
+  }
+
+  vtkIdType NumberOfPoints = 0;
+  vtkIdType NumberOfCells = 0;
+  int NumberOfArrays = 0;
+  bool Failed = false;
+};
+vtkStandardNewMacro(vtkPointCloudPipeline);
+}
+
+int PointCloudAdaptorAPI(int, char* [])
+{
+  int numberOfPoints = 100;
+  std::vector<double> x(numberOfPoints), y(numberOfPoints), z(numberOfPoints);
+  std::vector<double> vx(numberOfPoints), vy(numberOfPoints), vz(numberOfPoints);
+  std::vector<double> s(numberOfPoints);
+
+  coprocessorinitialize();
+  vtkNew<vtkPointCloudPipeline> pipeline;
+  vtkCPAdaptorAPI::GetCoProcessor()->AddPipeline(pipeline.GetPointer());
+
+  int status = EXIT_SUCCESS;
+  for (int step = 0; step < 2; ++step)
+  {
+    int timeStep = step;
+    double time = step;
+    int coprocessThisTimeStep = 0;
+    requestdatadescription(&timeStep, &time, &coprocessThisTimeStep);
+    if (!coprocessThisTimeStep)
+    {
+      cerr << "ERROR: no co-processing requested." << endl;
+      status = EXIT_FAILURE;
+      break;
+    }
+    int polyVertex = step;
+    setpointcloud(&numberOfPoints, &x[0], &y[0], &z[0], &polyVertex);
+    char vname[] = "v";
+    int vnameLength = 1;
+    addpointcloudvectorfield(vname, &vnameLength, &vx[0], &vy[0], &vz[0]);
+    // "s" is not requested by the pipeline so it is not added.
+    char sname[] = "s";
+    int snameLength = 1;
+    addpointcloudscalarfield(sname, &snameLength, &s[0]);
+
+    // The values are only set now: the grid refers to the simulation's memory.
+    for (int cc = 0; cc < numberOfPoints; ++cc)
+    {
+      x[cc] = cc;
+      y[cc] = 2 * cc;
+      z[cc] = 3 * cc;
+      vx[cc] = vz[cc] = s[cc] = 0;
+      vy[cc] = -cc;
+    }
+    coprocess();
+
+    if (pipeline->Failed || pipeline->NumberOfPoints != numberOfPoints ||
+      pipeline->NumberOfCells != step || pipeline->NumberOfArrays != 1)
+    {
+      cerr << "ERROR: wrong point cloud at step " << step << endl;
+      status = EXIT_FAILURE;
+      break;
+    }
+  }
+  coprocessorfinalize();
+  return status;
+}
@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    SharedArraySubsets.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that pipelines requesting the same arrays share the array subset of
+// the input built by vtkCPProcessor::CoProcess(), and that the subsets only
+// have the requested arrays without modifying the input.
+
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPPipeline.h"
+#include "vtkCPProcessor.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <string>
+
+namespace
+{
+class vtkArrayPipeline : public vtkCPPipeline
+{
+public:
+  static vtkArrayPipeline* New();
+  vtkTypeMacro(vtkArrayPipeline, vtkCPPipeline);
+
+  int RequestDataDescription(vtkCPDataDescription* dataDescription) override
+  {
+    dataDescription->GetInputDescriptionByName("input")->AddField(
+      this->ArrayName.c_str(), vtkDataObject::POINT);
+    return 1;
+  }
+
+  int CoProcess(vtkCPDataDescription* dataDescription) override
+  {
+    this->Grid = dataDescription->GetInputDescriptionByName("input")->GetGrid();
+    vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(this->Grid);
+    vtkDataSet* block = mb ? vtkDataSet::SafeDownCast(mb->GetBlock(0)) : nullptr;
+    if (!block || block->GetPointData()->GetNumberOfArrays() != 1 ||
+      !block->GetPointData()->GetArray(this->ArrayName.c_str()) ||
+      block->GetCellData()->GetNumberOfArrays() != 0 ||
+      !mb->GetFieldData()->GetAbstractArray(vtkCPProcessor::GetInputArrayName()))
+    {
+      this->Failed = true;
+    }
+    return 1;
+  }
+
+  std::string ArrayName;
+  vtkSmartPointer<vtkDataObject> Grid;
+  bool Failed = false;
+};
+vtkStandardNewMacro(vtkArrayPipeline);
+
+void AddArray(vtkFieldData* fieldData, const char* name, vtkIdType numberOfTuples)
+{
+  vtkNew<vtkDoubleArray> array;
+  array->SetName(name);
+  array->SetNumberOfTuples(numberOfTuples);
+  array->FillComponent(0, 0);
+  fieldData->AddArray(array);
+}
+}
+
+int SharedArraySubsets(int, char* [])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(3, 3, 3);
+  AddArray(image->GetPointData(), "a", image->GetNumberOfPoints());
+  AddArray(image->GetPointData(), "b", image->GetNumberOfPoints());
+  AddArray(image->GetCellData(), "c", image->GetNumberOfCells());
+  vtkNew<vtkMultiBlockDataSet> grid;
+  grid->SetBlock(0, image);
+
+  vtkNew<vtkCPProcessor> processor;
+  processor->Initialize();
+  processor->ReportTimingsOn();
+  const char* arrayNames[] = { "a", "a", "b" };
+  vtkNew<vtkArrayPipeline> pipelines[3];
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    pipelines[cc]->ArrayName = arrayNames[cc];
+    processor->AddPipeline(pipelines[cc]);
+  }
+
+  vtkNew<vtkCPDataDescription> dataDescription;
+  dataDescription->AddInput("input");
+  dataDescription->SetTimeData(0, 0);
+  if (!processor->RequestDataDescription(dataDescription))
+  {
+    cerr << "ERROR: no co-processing requested." << endl;
+    return EXIT_FAILURE;
+  }
+  dataDescription->GetInputDescriptionByName("input")->SetGrid(grid);
+  processor->CoProcess(dataDescription);
+
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    if (pipelines[cc]->Failed || pipelines[cc]->Grid == grid.GetPointer())
+    {
+      cerr << "ERROR: wrong arrays for pipeline " << cc << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (pipelines[0]->Grid != pipelines[1]->Grid || pipelines[0]->Grid == pipelines[2]->Grid)
+  {
+    cerr << "ERROR: array subsets are not shared as expected." << endl;
+    return EXIT_FAILURE;
+  }
+  if (image->GetPointData()->GetNumberOfArrays() != 2 ||
+    image->GetCellData()->GetNumberOfArrays() != 1)
+  {
+    cerr << "ERROR: the input grid was modified." << endl;
+    return EXIT_FAILURE;
+  }
+  processor->Finalize();
+  return EXIT_SUCCESS;
+}
@@ -17,11 +17,17 @@
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
 #include "vtkCPProcessor.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataSet.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSOADataArrayTemplate.h"
 
 #include <iostream>
 
@@ -40,6 +46,20 @@ void ClearFieldDataFromGrid(vtkDataSet* grid)
     grid->GetFieldData()->Initialize();
   }
 }
+
+/// Wrap the component arrays into a vtkSOADataArrayTemplate without copying
+/// them nor freeing them when the array is deleted.
+vtkSOADataArrayTemplate<double>* NewSOAArray(
+  int numberOfComponents, double** components, vtkIdType numberOfTuples)
+{
+  vtkSOADataArrayTemplate<double>* array = vtkSOADataArrayTemplate<double>::New();
+  array->SetNumberOfComponents(numberOfComponents);
+  for (int cc = 0; cc < numberOfComponents; ++cc)
+  {
+    array->SetArray(cc, components[cc], numberOfTuples, cc == numberOfComponents - 1, true);
+  }
+  return array;
+}
 } // end namespace
 
 vtkCPDataDescription* vtkCPAdaptorAPI::CoProcessorData = NULL;
@@ -164,3 +184,73 @@ void vtkCPAdaptorAPI::CoProcess()
   // Reset time data.
   vtkCPAdaptorAPI::IsTimeDataSet = false;
 }
+
+//-----------------------------------------------------------------------------
+void vtkCPAdaptorAPI::SetPointCloud(
+  int* numberOfPoints, double* x, double* y, double* z, int* polyVertex)
+{
+  if (!vtkCPAdaptorAPI::IsTimeDataSet)
+  {
+    vtkGenericWarningMacro("Time data not set.");
+    return;
+  }
+
+  vtkIdType numPts = *numberOfPoints;
+  double* coordinates[3] = { x, y, z };
+  vtkSOADataArrayTemplate<double>* coords =
+    ParaViewCoProcessing::NewSOAArray(3, coordinates, numPts);
+  vtkNew<vtkPoints> points;
+  points->SetData(coords);
+  coords->Delete();
+
+  vtkNew<vtkPolyData> grid;
+  grid->SetPoints(points.GetPointer());
+  if (*polyVertex && numPts > 0)
+  {
+    // A single cell using all of the points, i.e. the connectivity is the
+    // number of points followed by the point ids.
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(numPts + 1);
+    vtkIdType* ids = connectivity->GetPointer(0);
+    ids[0] = numPts;
+    for (vtkIdType cc = 0; cc < numPts; ++cc)
+    {
+      ids[cc + 1] = cc;
+    }
+    vtkNew<vtkCellArray> verts;
+    verts->SetCells(1, connectivity.GetPointer());
+    grid->SetVerts(verts.GetPointer());
+  }
+  vtkCPAdaptorAPI::CoProcessorData->GetInputDescriptionByName("input")->SetGrid(
+    grid.GetPointer());
+}
+
+//-----------------------------------------------------------------------------
+void vtkCPAdaptorAPI::AddPointCloudField(
+  const char* name, int numberOfComponents, double** components)
+{
+  if (!vtkCPAdaptorAPI::IsTimeDataSet)
+  {
+    vtkGenericWarningMacro("Time data not set.");
+    return;
+  }
+
+  vtkCPInputDataDescription* idd =
+    vtkCPAdaptorAPI::CoProcessorData->GetInputDescriptionByName("input");
+  vtkPolyData* grid = vtkPolyData::SafeDownCast(idd->GetGrid());
+  if (!grid || !grid->GetPoints())
+  {
+    vtkGenericWarningMacro("No point cloud. Call setpointcloud first.");
+    return;
+  }
+  if (numberOfComponents < 1 || !idd->IsFieldNeeded(name, vtkDataObject::POINT))
+  {
+    return;
+  }
+
+  vtkSOADataArrayTemplate<double>* array =
+    ParaViewCoProcessing::NewSOAArray(numberOfComponents, components, grid->GetNumberOfPoints());
+  array->SetName(name);
+  grid->GetPointData()->AddArray(array);
+  array->Delete();
+}
@@ -48,6 +48,22 @@ public:
   /// has been filled in elsewhere.
   static void CoProcess();
 
+  /// sets the grid of the "input" to a point cloud of numberOfPoints points
+  /// whose coordinates are given as separate x, y and z arrays. The arrays
+  /// are wrapped, not copied, and so must remain valid until coprocess()
+  /// returns. If polyVertex is 0 the grid has no cells and its vertices are
+  /// implicit, which is enough for point based filters and representations
+  /// such as glyphs or point gaussians. Otherwise the grid has a single
+  /// VTK_POLY_VERTEX cell using all of the points. Either way no per-point
+  /// cell needs to be built. Must be called after RequestDataDescription().
+  static void SetPointCloud(int* numberOfPoints, double* x, double* y, double* z, int* polyVertex);
+
+  /// adds a point field to the point cloud set with SetPointCloud() with one
+  /// array per component, each of the point cloud's number of points. As for
+  /// the coordinates, the arrays are wrapped and not copied. The field is
+  /// ignored if no pipeline requested it.
+  static void AddPointCloudField(const char* name, int numberOfComponents, double** components);
+
   /// provides access to the vtkCPDataDescription instance.
   static vtkCPDataDescription* GetCoProcessorData() { return vtkCPAdaptorAPI::CoProcessorData; }
 
@@ -16,11 +16,18 @@
 
 #include "vtkPVConfig.h" // need ParaView defines before MPI stuff
 
+#include "vtkAbstractArray.h"
 #include "vtkCPCxxHelper.h"
 #include "vtkCPDataDescription.h"
 #include "vtkCPInputDataDescription.h"
 #include "vtkCPPipeline.h"
+#include "vtkCellData.h"
+#include "vtkCommunicator.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkDataObject.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetAttributes.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
 #ifdef PARAVIEW_USE_MPI
@@ -31,7 +38,8 @@
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
-#include "vtkPassArrays.h"
+#include "vtkOutputWindow.h"
+#include "vtkPointData.h"
 #include "vtkSMIntVectorProperty.h"
 #include "vtkSMProxy.h"
 #include "vtkSMProxyManager.h"
@@ -39,7 +47,17 @@
 #include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 struct vtkCPProcessorInternals
@@ -47,8 +65,127 @@ struct vtkCPProcessorInternals
   typedef std::list<vtkSmartPointer<vtkCPPipeline> > PipelineList;
   typedef PipelineList::iterator PipelineListIterator;
   PipelineList Pipelines;
+
+  // Held while the pipelines are modified, queried or executed since the
+  // analysis thread executes them in asynchronous mode. It is recursive since
+  // pipelines may access the processor while they execute.
+  std::recursive_mutex PipelinesMutex;
+
+  // Time spent by each pipeline, reported by Finalize(). Guarded by
+  // PipelinesMutex.
+  struct PipelineTimings
+  {
+    int NumberOfRequests = 0;
+    double RequestTime = 0.0;
+    // The requests CoProcess() repeats to find the pipelines to execute.
+    int NumberOfCoProcessRequests = 0;
+    double CoProcessRequestTime = 0.0;
+    int NumberOfExecutions = 0;
+    double CoProcessTime = 0.0;
+  };
+  std::map<vtkCPPipeline*, PipelineTimings> Timings;
+
+  // Time steps waiting for the analysis thread. QueueMutex guards all the
+  // members below, except for AsynchronousController.
+  std::thread AnalysisThread;
+  std::mutex QueueMutex;
+  std::condition_variable QueueCondition;
+  std::deque<vtkSmartPointer<vtkCPDataDescription> > Queue;
+  int NumberOfPendingTimeSteps = 0;
+  bool StopRequested = false;
+  bool AsynchronousFailure = false;
+
+  // A duplicate of the global controller used by the simulation thread to
+  // agree on skipped time steps, so that it does not interfere with the
+  // collectives the pipelines run on the analysis thread.
+  bool AsynchronousInitialized = false;
+  vtkSmartPointer<vtkMultiProcessController> AsynchronousController;
 };
 
+namespace
+{
+// The arrays requested for an input, as (field type, array name) pairs.
+typedef std::set<std::pair<int, std::string> > ArraySet;
+
+// Removes the arrays of the given field type that are not requested. Ghost
+// arrays, as well as the field data arrays added by CoProcess(), are kept.
+void RemoveUnrequestedArrays(vtkFieldData* fieldData, int type, const ArraySet& requested)
+{
+  std::vector<std::string> names;
+  for (int cc = 0; cc < fieldData->GetNumberOfArrays(); ++cc)
+  {
+    vtkAbstractArray* array = fieldData->GetAbstractArray(cc);
+    const char* name = array ? array->GetName() : nullptr;
+    if (name && strcmp(name, vtkDataSetAttributes::GhostArrayName()) != 0 &&
+      (type != vtkDataObject::FIELD ||
+        (strcmp(name, vtkCPProcessor::GetInputArrayName()) != 0 &&
+          strcmp(name, "TimeValue") != 0)) &&
+      requested.find(std::make_pair(type, std::string(name))) == requested.end())
+    {
+      names.push_back(name);
+    }
+  }
+  for (size_t cc = 0; cc < names.size(); ++cc)
+  {
+    fieldData->RemoveArray(names[cc].c_str());
+  }
+}
+
+// Returns a shallow copy of the data object with only the requested arrays.
+// Field data arrays are all kept when passFieldData is true.
+vtkSmartPointer<vtkDataObject> NewArraySubset(
+  vtkDataObject* dataObject, const ArraySet& requested, bool passFieldData)
+{
+  vtkSmartPointer<vtkDataObject> subset;
+  subset.TakeReference(dataObject->NewInstance());
+  if (vtkCompositeDataSet* input = vtkCompositeDataSet::SafeDownCast(dataObject))
+  {
+    // A shallow copy would share the leaves, so the leaves are subset too.
+    vtkCompositeDataSet* output = vtkCompositeDataSet::SafeDownCast(subset);
+    output->CopyStructure(input);
+    output->GetFieldData()->ShallowCopy(input->GetFieldData());
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(input->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      output->SetDataSet(
+        iter, NewArraySubset(iter->GetCurrentDataObject(), requested, passFieldData));
+    }
+  }
+  else
+  {
+    subset->ShallowCopy(dataObject);
+  }
+
+  if (!passFieldData)
+  {
+    RemoveUnrequestedArrays(subset->GetFieldData(), vtkDataObject::FIELD, requested);
+  }
+  if (vtkDataSet* dataSet = vtkDataSet::SafeDownCast(subset))
+  {
+    RemoveUnrequestedArrays(dataSet->GetPointData(), vtkDataObject::POINT, requested);
+    RemoveUnrequestedArrays(dataSet->GetCellData(), vtkDataObject::CELL, requested);
+  }
+  return subset;
+}
+
+ArraySet GetRequestedArrays(vtkCPInputDataDescription* idd)
+{
+  ArraySet requested;
+  for (unsigned int j = 0; j < idd->GetNumberOfFields(); j++)
+  {
+    requested.insert(std::make_pair(idd->GetFieldType(j), std::string(idd->GetFieldName(j))));
+  }
+  return requested;
+}
+
+double GetTime()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+}
+
 vtkStandardNewMacro(vtkCPProcessor);
 vtkMultiProcessController* vtkCPProcessor::Controller = nullptr;
 //----------------------------------------------------------------------------
@@ -57,11 +194,18 @@ vtkCPProcessor::vtkCPProcessor()
   this->Internal = new vtkCPProcessorInternals;
   this->InitializationHelper = nullptr;
   this->WorkingDirectory = nullptr;
+  this->Asynchronous = false;
+  this->MaximumNumberOfPendingTimeSteps = 1;
+  this->AsynchronousPolicy = SKIP_TIME_STEP;
+  this->AsynchronousShallowCopy = false;
+  this->NumberOfSkippedTimeSteps = 0;
+  this->ReportTimings = false;
 }
 
 //----------------------------------------------------------------------------
 vtkCPProcessor::~vtkCPProcessor()
 {
+  this->StopAnalysisThread();
   if (this->Internal)
   {
     delete this->Internal;
@@ -85,6 +229,7 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
     return 0;
   }
 
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
   this->Internal->Pipelines.push_back(pipeline);
   return 1;
 }
@@ -92,6 +237,7 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
 //----------------------------------------------------------------------------
 int vtkCPProcessor::GetNumberOfPipelines()
 {
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
   return static_cast<int>(this->Internal->Pipelines.size());
 }
 
@@ -102,6 +248,7 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
   {
     return nullptr;
   }
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
   int counter = 0;
   vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
   while (counter <= which)
@@ -119,12 +266,16 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemovePipeline(vtkCPPipeline* pipeline)
 {
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
+  this->Internal->Timings.erase(pipeline);
   this->Internal->Pipelines.remove(pipeline);
 }
 
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemoveAllPipelines()
 {
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
+  this->Internal->Timings.clear();
   this->Internal->Pipelines.clear();
 }
 
@@ -214,11 +365,25 @@ int vtkCPProcessor::RequestDataDescription(vtkCPDataDescription* dataDescription
   }
 
   dataDescription->ResetInputDescriptions();
+
+  if (this->Asynchronous && this->InitializeAsynchronous() &&
+    !this->WaitForAnalysis(dataDescription))
+  {
+    this->NumberOfSkippedTimeSteps++;
+    return 0;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
   int doCoProcessing = 0;
   for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
        iter != this->Internal->Pipelines.end(); iter++)
   {
-    if (iter->GetPointer()->RequestDataDescription(dataDescription))
+    double start = GetTime();
+    int request = iter->GetPointer()->RequestDataDescription(dataDescription);
+    vtkCPProcessorInternals::PipelineTimings& timings = this->Internal->Timings[*iter];
+    timings.NumberOfRequests++;
+    timings.RequestTime += GetTime() - start;
+    if (request)
     {
       doCoProcessing = 1;
     }
@@ -259,6 +424,80 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     }
   }
 
+  if (this->Asynchronous && this->InitializeAsynchronous())
+  {
+    // Take a snapshot of what the pipelines need so that the simulation can
+    // go on while they execute.
+    vtkNew<vtkCPDataDescription> snapshot;
+    snapshot->Copy(dataDescription);
+    if (dataDescription->GetUserData() && !this->AsynchronousShallowCopy)
+    {
+      vtkNew<vtkFieldData> userData;
+      userData->DeepCopy(dataDescription->GetUserData());
+      snapshot->SetUserData(userData);
+    }
+    for (unsigned int i = 0; i < snapshot->GetNumberOfInputDescriptions(); i++)
+    {
+      vtkCPInputDataDescription* idd = snapshot->GetInputDescription(i);
+      vtkSmartPointer<vtkDataObject> copy;
+      if (idd->GetIfGridIsNecessary() && idd->GetGrid())
+      {
+        // Keep the field data, e.g. the channel name, as in synchronous mode.
+        vtkSmartPointer<vtkDataObject> grid = idd->GetGrid();
+        if (!idd->GetAllFields())
+        {
+          grid = NewArraySubset(grid, GetRequestedArrays(idd), true);
+        }
+        copy.TakeReference(grid->NewInstance());
+        if (this->AsynchronousShallowCopy)
+        {
+          copy->ShallowCopy(grid);
+        }
+        else
+        {
+          copy->DeepCopy(grid);
+        }
+      }
+      idd->SetGrid(copy);
+    }
+    dataDescription->ResetAll();
+
+    vtkCPProcessorInternals* internals = this->Internal;
+    std::unique_lock<std::mutex> lock(internals->QueueMutex);
+    // RequestDataDescription() already waited unless it was not called.
+    internals->QueueCondition.wait(lock, [this, internals] {
+      return internals->NumberOfPendingTimeSteps < this->MaximumNumberOfPendingTimeSteps;
+    });
+    internals->Queue.push_back(snapshot.GetPointer());
+    internals->NumberOfPendingTimeSteps++;
+    success = internals->AsynchronousFailure ? 0 : 1;
+    internals->AsynchronousFailure = false;
+    if (!internals->AnalysisThread.joinable())
+    {
+      internals->AnalysisThread = std::thread(&vtkCPProcessor::AnalysisThreadLoop, this);
+    }
+    lock.unlock();
+    internals->QueueCondition.notify_all();
+    return success;
+  }
+
+  success = this->ExecutePipelines(dataDescription);
+  // we want to reset everything here to make sure that new information
+  // is properly passed in the next time.
+  dataDescription->ResetAll();
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::ExecutePipelines(vtkCPDataDescription* dataDescription)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
+  int success = 1;
+
+  // The array subsets of the inputs, built once for all the pipelines that
+  // request the same arrays of an input.
+  std::map<std::pair<unsigned int, ArraySet>, vtkSmartPointer<vtkDataObject> > subsets;
+
   std::string originalWorkingDirectory;
   if (this->WorkingDirectory)
   {
@@ -275,7 +514,12 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     {
       dataDescription->GetInputDescription(i)->Reset();
     }
-    if (iter->GetPointer()->RequestDataDescription(dataDescription))
+    double start = GetTime();
+    int request = iter->GetPointer()->RequestDataDescription(dataDescription);
+    vtkCPProcessorInternals::PipelineTimings& timings = this->Internal->Timings[*iter];
+    timings.NumberOfCoProcessRequests++;
+    timings.CoProcessRequestTime += GetTime() - start;
+    if (request)
     {
       // now we need to filter out arrays that are not needed by this pipeline
       // but were requested by other pipelines at this time step
@@ -289,43 +533,46 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
         for (unsigned int i = 0; i < dataDescription->GetNumberOfInputDescriptions(); i++)
         {
           vtkCPInputDataDescription* idd = dataDescriptionCopy->GetInputDescription(i);
-          if (idd->GetIfGridIsNecessary() == true && idd->GetAllFields() == false)
+          if (idd->GetIfGridIsNecessary() == true && idd->GetAllFields() == false &&
+            idd->GetGrid())
           {
-            vtkNew<vtkPassArrays> passArrays;
-            passArrays->UseFieldTypesOn();
-            passArrays->AddFieldType(vtkDataObject::FIELD);
-            passArrays->AddFieldType(vtkDataObject::POINT);
-            passArrays->AddFieldType(vtkDataObject::CELL);
-            passArrays->SetInputData(idd->GetGrid());
-            for (unsigned int j = 0; j < idd->GetNumberOfFields(); j++)
+            ArraySet requested = GetRequestedArrays(idd);
+            vtkSmartPointer<vtkDataObject>& subset = subsets[std::make_pair(i, requested)];
+            if (!subset)
             {
-              int type = idd->GetFieldType(j);
-              passArrays->AddArray(type, idd->GetFieldName(j));
+              subset = NewArraySubset(idd->GetGrid(), requested, false);
             }
-            passArrays->Update();
-            idd->SetGrid(passArrays->GetOutput());
+            idd->SetGrid(subset);
           }
         }
       }
+      start = GetTime();
       if (!iter->GetPointer()->CoProcess(dataDescriptionCopy))
       {
         success = 0;
       }
+      timings.NumberOfExecutions++;
+      timings.CoProcessTime += GetTime() - start;
     }
   }
   if (originalWorkingDirectory.empty() == false)
   {
     vtksys::SystemTools::ChangeDirectory(originalWorkingDirectory);
   }
-  // we want to reset everything here to make sure that new information
-  // is properly passed in the next time.
-  dataDescription->ResetAll();
   return success;
 }
 
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  this->StopAnalysisThread();
+  this->Internal->AsynchronousController = nullptr;
+
+  if (this->ReportTimings)
+  {
+    this->ReportPipelineTimings();
+  }
+
   if (this->Controller)
   {
     this->Controller->SetGlobalController(nullptr);
@@ -346,8 +593,197 @@ int vtkCPProcessor::Finalize()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPProcessor::ReportPipelineTimings()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->PipelinesMutex);
+  if (this->Internal->Pipelines.empty())
+  {
+    return;
+  }
+
+  // Report the maximum over the processes since the slowest one sets the pace.
+  std::vector<double> timings;
+  for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
+       iter != this->Internal->Pipelines.end(); iter++)
+  {
+    const vtkCPProcessorInternals::PipelineTimings& pipelineTimings =
+      this->Internal->Timings[*iter];
+    timings.push_back(pipelineTimings.NumberOfRequests);
+    timings.push_back(pipelineTimings.RequestTime);
+    timings.push_back(pipelineTimings.NumberOfExecutions);
+    timings.push_back(pipelineTimings.CoProcessTime);
+    timings.push_back(pipelineTimings.NumberOfCoProcessRequests);
+    timings.push_back(pipelineTimings.CoProcessRequestTime);
+  }
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  if (controller && controller->GetNumberOfProcesses() > 1)
+  {
+    std::vector<double> maxTimings(timings.size());
+    controller->Reduce(&timings[0], &maxTimings[0], static_cast<vtkIdType>(timings.size()),
+      vtkCommunicator::MAX_OP, 0);
+    if (controller->GetLocalProcessId() > 0)
+    {
+      return;
+    }
+    timings.swap(maxTimings);
+  }
+
+  std::ostringstream report;
+  report << "Catalyst pipeline timings (maximum over processes):\n";
+  size_t index = 0;
+  for (vtkCPProcessorInternals::PipelineListIterator iter = this->Internal->Pipelines.begin();
+       iter != this->Internal->Pipelines.end(); iter++, index += 6)
+  {
+    report << "  " << iter->GetPointer()->GetClassName() << " (" << iter->GetPointer()
+           << "): RequestDataDescription " << timings[index] << " calls, "
+           << timings[index + 1] << " s; CoProcess " << timings[index + 2] << " calls, "
+           << timings[index + 3] << " s\n"
+           << "    RequestDataDescription from CoProcess " << timings[index + 4] << " calls, "
+           << timings[index + 5] << " s\n";
+  }
+  vtkOutputWindowDisplayText(report.str().c_str());
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetAsynchronous(bool asynchronous)
+{
+  if (this->Asynchronous == asynchronous)
+  {
+    return;
+  }
+  if (!asynchronous)
+  {
+    this->StopAnalysisThread();
+  }
+  this->Asynchronous = asynchronous;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPProcessor::InitializeAsynchronous()
+{
+  vtkCPProcessorInternals* internals = this->Internal;
+  if (internals->AsynchronousInitialized)
+  {
+    return this->Asynchronous;
+  }
+  internals->AsynchronousInitialized = true;
+
+  vtkMultiProcessController* controller = vtkMultiProcessController::GetGlobalController();
+  if (controller && controller->GetNumberOfProcesses() > 1)
+  {
+#ifdef PARAVIEW_USE_MPI
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE)
+    {
+      vtkWarningMacro("Asynchronous co-processing needs MPI to be initialized with "
+                      "MPI_THREAD_MULTIPLE. Co-processing will be synchronous.");
+      this->Asynchronous = false;
+      return false;
+    }
+#endif
+    internals->AsynchronousController.TakeReference(
+      controller->PartitionController(1, controller->GetLocalProcessId()));
+    if (!internals->AsynchronousController)
+    {
+      vtkWarningMacro("Asynchronous co-processing is not supported by "
+        << controller->GetClassName() << ". Co-processing will be synchronous.");
+      this->Asynchronous = false;
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCPProcessor::WaitForAnalysis(vtkCPDataDescription* dataDescription)
+{
+  vtkCPProcessorInternals* internals = this->Internal;
+  std::unique_lock<std::mutex> lock(internals->QueueMutex);
+  if (this->AsynchronousPolicy == SKIP_TIME_STEP && !dataDescription->GetForceOutput())
+  {
+    int behind =
+      internals->NumberOfPendingTimeSteps >= this->MaximumNumberOfPendingTimeSteps ? 1 : 0;
+    lock.unlock();
+    if (internals->AsynchronousController)
+    {
+      int anyBehind = behind;
+      internals->AsynchronousController->AllReduce(
+        &behind, &anyBehind, 1, vtkCommunicator::MAX_OP);
+      behind = anyBehind;
+    }
+    return behind == 0;
+  }
+
+  internals->QueueCondition.wait(lock, [this, internals] {
+    return internals->NumberOfPendingTimeSteps < this->MaximumNumberOfPendingTimeSteps;
+  });
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::AnalysisThreadLoop()
+{
+  vtkCPProcessorInternals* internals = this->Internal;
+  std::unique_lock<std::mutex> lock(internals->QueueMutex);
+  while (true)
+  {
+    internals->QueueCondition.wait(
+      lock, [internals] { return internals->StopRequested || !internals->Queue.empty(); });
+    if (internals->Queue.empty())
+    {
+      // Stop was requested and all the time steps are done.
+      break;
+    }
+    vtkSmartPointer<vtkCPDataDescription> dataDescription = internals->Queue.front();
+    internals->Queue.pop_front();
+    lock.unlock();
+
+    int success = this->ExecutePipelines(dataDescription);
+
+    lock.lock();
+    if (!success)
+    {
+      internals->AsynchronousFailure = true;
+    }
+    internals->NumberOfPendingTimeSteps--;
+    internals->QueueCondition.notify_all();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::StopAnalysisThread()
+{
+  vtkCPProcessorInternals* internals = this->Internal;
+  if (!internals || !internals->AnalysisThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(internals->QueueMutex);
+    internals->StopRequested = true;
+  }
+  internals->QueueCondition.notify_all();
+  internals->AnalysisThread.join();
+  internals->StopRequested = false;
+  if (internals->AsynchronousFailure)
+  {
+    vtkWarningMacro("Problems executing asynchronous Catalyst pipelines.");
+    internals->AsynchronousFailure = false;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Asynchronous: " << this->Asynchronous << "\n";
+  os << indent << "MaximumNumberOfPendingTimeSteps: " << this->MaximumNumberOfPendingTimeSteps
+     << "\n";
+  os << indent << "AsynchronousPolicy: " << this->AsynchronousPolicy << "\n";
+  os << indent << "AsynchronousShallowCopy: " << this->AsynchronousShallowCopy << "\n";
+  os << indent << "NumberOfSkippedTimeSteps: " << this->NumberOfSkippedTimeSteps << "\n";
+  os << indent << "ReportTimings: " << this->ReportTimings << "\n";
 }
@@ -54,6 +54,13 @@ class vtkMultiProcessController;
 /// actual data that it has been asked to provide, if any. If no data was
 /// selected during the Configuration Step than the priovided vtkDataObject
 /// may be NULL.
+///
+/// Asynchronous mode:\n
+/// When Asynchronous is on, CoProcess() takes a snapshot of the input grids
+/// and returns right away while the pipelines execute on a dedicated analysis
+/// thread, so the simulation computes its next time steps in the meantime.
+/// At most MaximumNumberOfPendingTimeSteps time steps are queued or executing;
+/// AsynchronousPolicy decides whether later time steps are skipped or wait.
 class VTKPVCATALYST_EXPORT vtkCPProcessor : public vtkObject
 {
 public:
@@ -107,12 +114,25 @@ public:
   /// Processing Step:
   /// Provides the grid and the field data for the co-procesor to process.
   /// Return value is 1 for success and 0 for failure.
+  /// In asynchronous mode, the return value reports the failure of the
+  /// time steps executed since the previous call instead.
   virtual int CoProcess(vtkCPDataDescription* dataDescription);
 
   /// Called after all co-processing is complete giving the Co-Processor
   /// implementation an opportunity to clean up, before it is destroyed.
+  /// Reports the pipeline timings first if ReportTimings is on.
   virtual int Finalize();
 
+  /// When on, Finalize() reports the number of calls to and the time spent in
+  /// RequestDataDescription() and CoProcess() of each pipeline, as the
+  /// maximum over the processes, through vtkOutputWindow on the first
+  /// process. The requests CoProcess() makes itself to select the pipelines
+  /// to execute are reported on their own line. It must be the same on all
+  /// processes. Off by default.
+  vtkSetMacro(ReportTimings, bool);
+  vtkGetMacro(ReportTimings, bool);
+  vtkBooleanMacro(ReportTimings, bool);
+
   /// Get the current working directory for outputting Catalyst files.
   /// If not set then Catalyst output files will be relative to the
   /// current working directory. This will not affect where Catalyst
@@ -120,6 +140,54 @@ public:
   /// the *Initialize()* methods.
   vtkGetStringMacro(WorkingDirectory);
 
+  /// Execute the pipelines on a dedicated analysis thread. The pipelines are
+  /// still queried by RequestDataDescription() on the calling thread, after
+  /// the analysis thread is done with the time step it is executing. The
+  /// pipelines must be safe to execute off the simulation thread, which for
+  /// Python pipelines requires a thread-safe Python build, and the working
+  /// directory is changed for the whole process while a time step executes.
+  /// When running in parallel, MPI must provide MPI_THREAD_MULTIPLE,
+  /// otherwise co-processing stays synchronous, and the flag must be the
+  /// same on all processes. Turning it off waits for the pending time steps.
+  /// Off by default.
+  virtual void SetAsynchronous(bool);
+  vtkGetMacro(Asynchronous, bool);
+  vtkBooleanMacro(Asynchronous, bool);
+
+  /// The maximum number of time steps queued or executing in asynchronous
+  /// mode. Default is 1.
+  vtkSetClampMacro(MaximumNumberOfPendingTimeSteps, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfPendingTimeSteps, int);
+
+  enum AsynchronousPolicies
+  {
+    SKIP_TIME_STEP = 0,
+    WAIT_FOR_ANALYSIS = 1
+  };
+
+  /// What RequestDataDescription() does in asynchronous mode when the maximum
+  /// number of time steps are pending: SKIP_TIME_STEP returns 0 without
+  /// querying the pipelines and WAIT_FOR_ANALYSIS waits for a pending time
+  /// step to finish. Time steps with ForceOutput set always wait. When
+  /// running in parallel, a time step is skipped on all processes as soon as
+  /// one of them is behind so that the pipelines stay in step. Default is
+  /// SKIP_TIME_STEP.
+  vtkSetClampMacro(AsynchronousPolicy, int, SKIP_TIME_STEP, WAIT_FOR_ANALYSIS);
+  vtkGetMacro(AsynchronousPolicy, int);
+
+  /// In asynchronous mode, the input grids are deep copied, with only the
+  /// requested arrays, so that the simulation can modify its data once
+  /// CoProcess() returns. Set this to true to shallow copy them instead when
+  /// the adaptor creates new grids and arrays every time step. Default is
+  /// false.
+  vtkSetMacro(AsynchronousShallowCopy, bool);
+  vtkGetMacro(AsynchronousShallowCopy, bool);
+  vtkBooleanMacro(AsynchronousShallowCopy, bool);
+
+  /// The number of time steps skipped by RequestDataDescription() because
+  /// the analysis was behind.
+  vtkGetMacro(NumberOfSkippedTimeSteps, int);
+
 protected:
   vtkCPProcessor();
   virtual ~vtkCPProcessor();
@@ -132,10 +200,35 @@ protected:
   /// set this through the *Initialize()* methods.
   vtkSetStringMacro(WorkingDirectory);
 
+  bool Asynchronous;
+  int MaximumNumberOfPendingTimeSteps;
+  int AsynchronousPolicy;
+  bool AsynchronousShallowCopy;
+  int NumberOfSkippedTimeSteps;
+  bool ReportTimings;
+
 private:
   vtkCPProcessor(const vtkCPProcessor&) = delete;
   void operator=(const vtkCPProcessor&) = delete;
 
+  /// Executes the pipelines that need to for the given time step.
+  int ExecutePipelines(vtkCPDataDescription* dataDescription);
+
+  /// Reports the time spent by each pipeline.
+  void ReportPipelineTimings();
+
+  /// Checks that asynchronous mode is supported, the first time it is used.
+  /// Returns false, and turns Asynchronous off, if it is not.
+  bool InitializeAsynchronous();
+
+  /// Waits until a time step can be queued, or returns false if it has to be
+  /// skipped.
+  bool WaitForAnalysis(vtkCPDataDescription* dataDescription);
+
+  /// Analysis thread main loop and the method to wait for it to finish.
+  void AnalysisThreadLoop();
+  void StopAnalysisThread();
+
   vtkCPProcessorInternals* Internal;
   vtkObject* InitializationHelper;
   static vtkMultiProcessController* Controller;
@@ -15,20 +15,28 @@
 #include "vtkPVArrayInformation.h"
 
 #include "vtkAbstractArray.h"
+#include "vtkArrayDispatch.h"
 #include "vtkClientServerStream.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkInformation.h"
+#include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationInformationVectorKey.h"
 #include "vtkInformationIterator.h"
 #include "vtkInformationKey.h"
+#include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVPostFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStringArray.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <set>
 #include <sstream>
@@ -45,6 +53,217 @@ struct vtkPVArrayInformationInformationKey
 };
 
 typedef std::vector<vtkPVArrayInformationInformationKey> vtkInternalInformationKeysBase;
+
+// Computes the ranges, the finite ranges and the (squared) L2 norm ranges of
+// all the components of an array in a single pass. Each thread accumulates
+// into its own `numComps + 1` sets of [min, max, finite min, finite max],
+// the last set being for the squared norm. std::min/std::max ignore NaN when
+// it is the second argument, like vtkDataArray::GetRange.
+class vtkPVArrayInformationRangeWorker
+{
+public:
+  vtkPVArrayInformationRangeWorker()
+    : NumberOfComponents(0)
+  {
+  }
+
+  template <typename ArrayT>
+  class vtkFunctor
+  {
+  public:
+    vtkFunctor(ArrayT* array, vtkSMPThreadLocal<std::vector<double> >& ranges)
+      : Array(array)
+      , Ranges(ranges)
+      , NumberOfComponents(array->GetNumberOfComponents())
+    {
+    }
+
+    void Initialize()
+    {
+      std::vector<double>& ranges = this->Ranges.Local();
+      ranges.resize(4 * (this->NumberOfComponents + 1));
+      for (size_t cc = 0; cc < ranges.size(); cc += 2)
+      {
+        ranges[cc] = VTK_DOUBLE_MAX;
+        ranges[cc + 1] = -VTK_DOUBLE_MAX;
+      }
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkDataArrayAccessor<ArrayT> accessor(this->Array);
+      double* ranges = &this->Ranges.Local()[0];
+      double* normRange = ranges + 4 * this->NumberOfComponents;
+      for (vtkIdType tuple = begin; tuple < end; ++tuple)
+      {
+        double squaredNorm = 0.0;
+        double* range = ranges;
+        for (int comp = 0; comp < this->NumberOfComponents; ++comp, range += 4)
+        {
+          const double value = static_cast<double>(accessor.Get(tuple, comp));
+          range[0] = std::min(range[0], value);
+          range[1] = std::max(range[1], value);
+          // `value - value` is NaN for infinite and NaN values.
+          if (value - value == 0.0)
+          {
+            range[2] = std::min(range[2], value);
+            range[3] = std::max(range[3], value);
+          }
+          squaredNorm += value * value;
+        }
+        normRange[0] = std::min(normRange[0], squaredNorm);
+        normRange[1] = std::max(normRange[1], squaredNorm);
+        if (squaredNorm - squaredNorm == 0.0)
+        {
+          normRange[2] = std::min(normRange[2], squaredNorm);
+          normRange[3] = std::max(normRange[3], squaredNorm);
+        }
+      }
+    }
+
+    void Reduce() {}
+
+  private:
+    ArrayT* Array;
+    vtkSMPThreadLocal<std::vector<double> >& Ranges;
+    int NumberOfComponents;
+  };
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    this->NumberOfComponents = array->GetNumberOfComponents();
+    vtkFunctor<ArrayT> functor(array, this->ThreadRanges);
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), functor);
+  }
+
+  // Merges the ranges computed by the threads. `ranges` and `finiteRanges`
+  // are laid out like vtkPVArrayInformation::Ranges.
+  void GetRanges(double* ranges, double* finiteRanges)
+  {
+    const int numComps = this->NumberOfComponents;
+    std::vector<double> merged(4 * (numComps + 1));
+    for (size_t cc = 0; cc < merged.size(); cc += 2)
+    {
+      merged[cc] = VTK_DOUBLE_MAX;
+      merged[cc + 1] = -VTK_DOUBLE_MAX;
+    }
+    for (vtkSMPThreadLocal<std::vector<double> >::iterator iter = this->ThreadRanges.begin();
+         iter != this->ThreadRanges.end(); ++iter)
+    {
+      for (size_t cc = 0; cc < iter->size(); cc += 2)
+      {
+        merged[cc] = std::min(merged[cc], (*iter)[cc]);
+        merged[cc + 1] = std::max(merged[cc + 1], (*iter)[cc + 1]);
+      }
+    }
+
+    if (numComps > 1)
+    {
+      // First store range of vector magnitude.
+      const double* normRange = &merged[4 * numComps];
+      for (int cc = 0; cc < 2; ++cc)
+      {
+        // Empty ranges are left as they are.
+        ranges[cc] = normRange[0] <= normRange[1] ? std::sqrt(normRange[cc]) : normRange[cc];
+        finiteRanges[cc] =
+          normRange[2] <= normRange[3] ? std::sqrt(normRange[2 + cc]) : normRange[2 + cc];
+      }
+      ranges += 2;
+      finiteRanges += 2;
+    }
+    for (int comp = 0; comp < numComps; ++comp)
+    {
+      ranges[2 * comp] = merged[4 * comp];
+      ranges[2 * comp + 1] = merged[4 * comp + 1];
+      finiteRanges[2 * comp] = merged[4 * comp + 2];
+      finiteRanges[2 * comp + 1] = merged[4 * comp + 3];
+    }
+  }
+
+private:
+  int NumberOfComponents;
+  vtkSMPThreadLocal<std::vector<double> > ThreadRanges;
+};
+
+// vtkDataArray caches its ranges in its information, so that they are only
+// recomputed when the array is modified. These functions check and fill that
+// cache the same way vtkDataArray::GetRange/GetFiniteRange do.
+vtkInformation* vtkGetComponentRangeInformation(
+  vtkDataArray* array, vtkInformationInformationVectorKey* key, int comp, bool create)
+{
+  vtkInformation* info = array->GetInformation();
+  vtkInformationVector* infoVec = info->Get(key);
+  if (!infoVec)
+  {
+    if (!create)
+    {
+      return NULL;
+    }
+    vtkNew<vtkInformationVector> newInfoVec;
+    info->Set(key, newInfoVec.Get());
+    infoVec = newInfoVec.Get();
+  }
+  if (infoVec->GetNumberOfInformationObjects() <= comp)
+  {
+    if (!create)
+    {
+      return NULL;
+    }
+    infoVec->SetNumberOfInformationObjects(array->GetNumberOfComponents());
+  }
+  return infoVec->GetInformationObject(comp);
+}
+
+bool vtkHasCachedRanges(vtkDataArray* array)
+{
+  if (!array->HasInformation())
+  {
+    return false;
+  }
+  const vtkMTimeType mtime = array->GetMTime();
+  const int numComps = array->GetNumberOfComponents();
+  vtkInformation* info = array->GetInformation();
+  if (numComps > 1 &&
+    (!info->Has(vtkDataArray::L2_NORM_RANGE()) || !info->Has(vtkDataArray::L2_NORM_FINITE_RANGE()) ||
+        mtime > info->GetMTime()))
+  {
+    return false;
+  }
+  for (int comp = 0; comp < numComps; ++comp)
+  {
+    vtkInformation* compInfo =
+      vtkGetComponentRangeInformation(array, vtkDataArray::PER_COMPONENT(), comp, false);
+    vtkInformation* finiteInfo =
+      vtkGetComponentRangeInformation(array, vtkDataArray::PER_FINITE_COMPONENT(), comp, false);
+    if (!compInfo || !compInfo->Has(vtkDataArray::COMPONENT_RANGE()) ||
+      mtime > compInfo->GetMTime() || !finiteInfo ||
+      !finiteInfo->Has(vtkDataArray::COMPONENT_RANGE()) || mtime > finiteInfo->GetMTime())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void vtkCacheRanges(vtkDataArray* array, double* ranges, double* finiteRanges)
+{
+  const int numComps = array->GetNumberOfComponents();
+  if (numComps > 1)
+  {
+    array->GetInformation()->Set(vtkDataArray::L2_NORM_RANGE(), ranges, 2);
+    array->GetInformation()->Set(vtkDataArray::L2_NORM_FINITE_RANGE(), finiteRanges, 2);
+    ranges += 2;
+    finiteRanges += 2;
+  }
+  for (int comp = 0; comp < numComps; ++comp)
+  {
+    vtkGetComponentRangeInformation(array, vtkDataArray::PER_COMPONENT(), comp, true)
+      ->Set(vtkDataArray::COMPONENT_RANGE(), ranges + 2 * comp, 2);
+    vtkGetComponentRangeInformation(array, vtkDataArray::PER_FINITE_COMPONENT(), comp, true)
+      ->Set(vtkDataArray::COMPONENT_RANGE(), finiteRanges + 2 * comp, 2);
+  }
+}
 }
 
 class vtkPVArrayInformation::vtkInternalComponentNames : public vtkInternalComponentNameBase
@@ -67,6 +286,7 @@ vtkPVArrayInformation::vtkPVArrayInformation()
   this->DefaultComponentName = NULL;
   this->InformationKeys = NULL;
   this->IsPartial = 0;
+  this->HasRanges = 1;
   this->Initialize();
 }
 
@@ -116,6 +336,7 @@ void vtkPVArrayInformation::Initialize()
   }
 
   this->IsPartial = 0;
+  this->HasRanges = 1;
 
   if (this->InformationKeys)
   {
@@ -148,6 +369,7 @@ void vtkPVArrayInformation::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "NumberOfTuples: " << this->NumberOfTuples << endl;
   os << indent << "IsPartial: " << this->IsPartial << endl;
+  os << indent << "HasRanges: " << this->HasRanges << endl;
 
   os << indent << "Ranges :" << endl;
   num = this->NumberOfComponents;
@@ -518,6 +740,7 @@ void vtkPVArrayInformation::DeepCopy(vtkPVArrayInformation* info)
   this->SetNumberOfComponents(info->GetNumberOfComponents());
   this->SetNumberOfTuples(info->GetNumberOfTuples());
   this->IsPartial = info->IsPartial;
+  this->HasRanges = info->HasRanges;
 
   num = 2 * this->NumberOfComponents;
   if (this->NumberOfComponents > 1)
@@ -613,6 +836,18 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
     return;
   }
 
+  this->CopyFromArray(array, true);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVArrayInformation::CopyFromArray(vtkAbstractArray* array, bool computeRanges)
+{
+  if (!array)
+  {
+    this->Initialize();
+    return;
+  }
+
   this->SetName(array->GetName());
   this->DataType = array->GetDataType();
   this->SetNumberOfComponents(array->GetNumberOfComponents());
@@ -633,8 +868,29 @@ void vtkPVArrayInformation::CopyFromObject(vtkObject* obj)
     }
   }
 
-  if (vtkDataArray* const data_array = vtkDataArray::SafeDownCast(obj))
+  // Reset the ranges in case the number of components did not change.
+  int numRanges =
+    this->NumberOfComponents > 1 ? this->NumberOfComponents + 1 : this->NumberOfComponents;
+  for (int idx = 0; idx < numRanges; ++idx)
+  {
+    this->Ranges[2 * idx] = this->FiniteRanges[2 * idx] = VTK_DOUBLE_MAX;
+    this->Ranges[2 * idx + 1] = this->FiniteRanges[2 * idx + 1] = -VTK_DOUBLE_MAX;
+  }
+
+  vtkDataArray* const data_array = vtkDataArray::SafeDownCast(array);
+  this->HasRanges = (data_array == NULL || computeRanges) ? 1 : 0;
+  vtkPVArrayInformationRangeWorker worker;
+  if (data_array && computeRanges && !vtkHasCachedRanges(data_array) &&
+    vtkArrayDispatch::Dispatch::Execute(data_array, worker))
   {
+    // Compute all the ranges in a single pass over the array.
+    worker.GetRanges(this->Ranges, this->FiniteRanges);
+    vtkCacheRanges(data_array, this->Ranges, this->FiniteRanges);
+  }
+  else if (data_array && computeRanges)
+  {
+    // Cached ranges, or arrays that cannot be dispatched (e.g. vtkBitArray
+    // or mapped arrays, that may not be read concurrently).
     double range[2];
     double* ptr;
     int idx;
@@ -717,6 +973,7 @@ void vtkPVArrayInformation::AddInformation(vtkPVInformation* info)
       // Leave everything but ranges and unique values as original, add ranges and unique values.
       this->AddRanges(aInfo);
       this->AddFiniteRanges(aInfo);
+      this->HasRanges = (this->HasRanges && aInfo->HasRanges) ? 1 : 0;
       this->AddInformationKeys(aInfo);
     }
   }
@@ -734,6 +991,7 @@ void vtkPVArrayInformation::CopyToStream(vtkClientServerStream* css)
   *css << this->NumberOfTuples;
   *css << this->NumberOfComponents;
   *css << this->IsPartial;
+  *css << this->HasRanges;
 
   // Range of each component.
   int num = this->NumberOfComponents;
@@ -819,10 +1077,16 @@ void vtkPVArrayInformation::CopyFromStream(const vtkClientServerStream* css)
     return;
   }
 
+  if (!css->GetArgument(0, 5, &this->HasRanges))
+  {
+    vtkErrorMacro("Error parsing HasRanges from message.");
+    return;
+  }
+
   // Range of each component.
   for (int i = 0; i < num; ++i)
   {
-    if (!css->GetArgument(0, 5 + i, this->Ranges + 2 * i, 2))
+    if (!css->GetArgument(0, 6 + i, this->Ranges + 2 * i, 2))
     {
       vtkErrorMacro("Error parsing range of component.");
       return;
@@ -832,13 +1096,13 @@ void vtkPVArrayInformation::CopyFromStream(const vtkClientServerStream* css)
   // Range of each component.
   for (int i = 0; i < num; ++i)
   {
-    if (!css->GetArgument(0, 5 + num + i, this->FiniteRanges + 2 * i, 2))
+    if (!css->GetArgument(0, 6 + num + i, this->FiniteRanges + 2 * i, 2))
     {
       vtkErrorMacro("Error parsing range of component.");
       return;
     }
   }
-  int pos = 5 + 2 * num;
+  int pos = 6 + 2 * num;
   int numOfComponentNames;
   if (!css->GetArgument(0, pos++, &numOfComponentNames))
   {
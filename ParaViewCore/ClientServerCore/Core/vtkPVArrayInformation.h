@@ -143,6 +143,13 @@ public:
    */
   void CopyFromObject(vtkObject*) VTK_OVERRIDE;
 
+  /**
+   * Transfer information about an array into this object. When computeRanges
+   * is false, the component ranges are not computed: they are left empty and
+   * HasRanges is set to 0.
+   */
+  void CopyFromArray(vtkAbstractArray* array, bool computeRanges);
+
   /**
    * Merge another information object.
    */
@@ -166,6 +173,17 @@ public:
   vtkGetMacro(IsPartial, int);
   //@}
 
+  //@{
+  /**
+   * HasRanges is 0 when the component ranges were not computed, on any of
+   * the processes or blocks this information was merged from (see
+   * vtkPVDataInformation::SetComputeArrayRanges). By default, HasRanges is
+   * set to 1.
+   */
+  vtkSetMacro(HasRanges, int);
+  vtkGetMacro(HasRanges, int);
+  //@}
+
   /**
    * Remove all infommation. Next add will be like a copy.
    */
@@ -195,6 +213,7 @@ protected:
   ~vtkPVArrayInformation() override;
 
   int IsPartial;
+  int HasRanges;
   int DataType;
   int NumberOfComponents;
   vtkTypeInt64 NumberOfTuples;
@@ -50,6 +50,8 @@ vtkPVCompositeDataInformation::vtkPVCompositeDataInformation()
   this->DataIsComposite = 0;
   this->DataIsMultiPiece = 0;
   this->NumberOfPieces = 0;
+  this->ComputeArrayRanges = true;
+  this->RangeArrayName = NULL;
   // DON'T FORGET TO UPDATE Initialize().
 }
 
@@ -57,6 +59,7 @@ vtkPVCompositeDataInformation::vtkPVCompositeDataInformation()
 vtkPVCompositeDataInformation::~vtkPVCompositeDataInformation()
 {
   delete this->Internal;
+  this->SetRangeArrayName(NULL);
 }
 
 //----------------------------------------------------------------------------
@@ -65,6 +68,9 @@ void vtkPVCompositeDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "DataIsMultiPiece: " << this->DataIsMultiPiece << endl;
   os << indent << "DataIsComposite: " << this->DataIsComposite << endl;
+  os << indent << "ComputeArrayRanges: " << this->ComputeArrayRanges << endl;
+  os << indent << "RangeArrayName: " << (this->RangeArrayName ? this->RangeArrayName : "(none)")
+     << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -206,6 +212,8 @@ void vtkPVCompositeDataInformation::CopyFromObject(vtkObject* object)
     if (curDO)
     {
       childInfo = vtkSmartPointer<vtkPVDataInformation>::New();
+      childInfo->SetComputeArrayRanges(this->ComputeArrayRanges);
+      childInfo->SetRangeArrayName(this->RangeArrayName);
       childInfo->CopyFromObject(curDO);
     }
     this->Internal->ChildrenInformation.resize(index + 1);
@@ -243,6 +251,8 @@ void vtkPVCompositeDataInformation::CopyFromAMR(vtkUniformGridAMR* amr)
   // we use this to "simulate" a composite tree from AMR
   vtkNew<vtkMultiPieceDataSet> tempMultiPiece;
   vtkNew<vtkPVDataInformation> tempDSInfo;
+  tempDSInfo->SetComputeArrayRanges(this->ComputeArrayRanges);
+  tempDSInfo->SetRangeArrayName(this->RangeArrayName);
 
   for (unsigned int level = 0; level < num_levels; level++)
   {
@@ -100,6 +100,17 @@ public:
   vtkGetMacro(DataIsComposite, int);
   //@}
 
+  //@{
+  /**
+   * Controls the computation of the array ranges in the information of the
+   * children. See vtkPVDataInformation::SetComputeArrayRanges.
+   */
+  vtkSetMacro(ComputeArrayRanges, bool);
+  vtkGetMacro(ComputeArrayRanges, bool);
+  vtkSetStringMacro(RangeArrayName);
+  vtkGetStringMacro(RangeArrayName);
+  //@}
+
   // TODO:
   // Add API to obtain meta data information for each of the children.
 
@@ -115,6 +126,8 @@ protected:
   int DataIsMultiPiece;
   int DataIsComposite;
   unsigned int FlatIndexMax;
+  bool ComputeArrayRanges;
+  char* RangeArrayName;
 
   unsigned int NumberOfPieces;
   vtkSetMacro(NumberOfPieces, unsigned int);
@@ -100,6 +100,8 @@ vtkPVDataInformation::vtkPVDataInformation()
   this->TimeLabel = NULL;
 
   this->PortNumber = -1;
+  this->ComputeArrayRanges = true;
+  this->RangeArrayName = NULL;
 
   // Update field association information on the all the
   // vtkPVDataSetAttributesInformation instances.
@@ -135,23 +137,29 @@ vtkPVDataInformation::~vtkPVDataInformation()
   this->SetCompositeDataClassName(0);
   this->SetCompositeDataSetName(0);
   this->SetTimeLabel(NULL);
+  this->SetRangeArrayName(NULL);
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersToStream(vtkMultiProcessStream& str)
 {
-  str << 828792 << this->PortNumber;
+  str << 828792 << this->PortNumber << (this->ComputeArrayRanges ? 1 : 0)
+      << std::string(this->RangeArrayName ? this->RangeArrayName : "");
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyParametersFromStream(vtkMultiProcessStream& str)
 {
   int magic_number;
-  str >> magic_number >> this->PortNumber;
+  int computeArrayRanges;
+  std::string rangeArrayName;
+  str >> magic_number >> this->PortNumber >> computeArrayRanges >> rangeArrayName;
   if (magic_number != 828792)
   {
     vtkErrorMacro("Magic number mismatch.");
   }
+  this->ComputeArrayRanges = (computeArrayRanges != 0);
+  this->SetRangeArrayName(rangeArrayName.empty() ? NULL : rangeArrayName.c_str());
 }
 
 //----------------------------------------------------------------------------
@@ -161,6 +169,9 @@ void vtkPVDataInformation::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "PortNumber: " << this->PortNumber << endl;
+  os << indent << "ComputeArrayRanges: " << this->ComputeArrayRanges << endl;
+  os << indent << "RangeArrayName: " << (this->RangeArrayName ? this->RangeArrayName : "(none)")
+     << endl;
   os << indent << "DataSetType: " << this->DataSetType << endl;
   os << indent << "CompositeDataSetType: " << this->CompositeDataSetType << endl;
   os << indent << "NumberOfPoints: " << this->NumberOfPoints << endl;
@@ -344,6 +355,8 @@ void vtkPVDataInformation::AddFromMultiPieceDataSet(vtkCompositeDataSet* data)
     if (dobj)
     {
       vtkPVDataInformation* dinf = vtkPVDataInformation::New();
+      dinf->SetComputeArrayRanges(this->ComputeArrayRanges);
+      dinf->SetRangeArrayName(this->RangeArrayName);
       dinf->CopyFromObject(dobj);
       dinf->SetDataClassName(dobj->GetClassName());
       dinf->DataSetType = dobj->GetDataObjectType();
@@ -706,6 +719,17 @@ void vtkPVDataInformation::CopyFromHyperTreeGrid(vtkHyperTreeGrid* data)
 //----------------------------------------------------------------------------
 void vtkPVDataInformation::CopyFromObject(vtkObject* object)
 {
+  for (int cc = 0; cc < vtkDataObject::NUMBER_OF_ASSOCIATIONS; cc++)
+  {
+    if (vtkPVDataSetAttributesInformation* dsa = this->GetAttributeInformation(cc))
+    {
+      dsa->SetComputeArrayRanges(this->ComputeArrayRanges);
+      dsa->SetRangeArrayName(this->RangeArrayName);
+    }
+  }
+  this->CompositeDataInformation->SetComputeArrayRanges(this->ComputeArrayRanges);
+  this->CompositeDataInformation->SetRangeArrayName(this->RangeArrayName);
+
   vtkDataObject* dobj = vtkDataObject::SafeDownCast(object);
   vtkInformation* info = NULL;
   // Handle the case where the a vtkAlgorithmOutput is passed instead of
@@ -1451,103 +1475,67 @@ void vtkPVDataInformation::CopyFromStream(const vtkClientServerStream* css)
     return;
   }
 
-  vtkTypeUInt32 length;
-  std::vector<unsigned char> data;
+  // The nested streams are parsed directly from this stream's data.
+  vtkClientServerStream::ArraySpan<unsigned char> data;
   vtkClientServerStream dcss;
 
   // Point array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of point data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing point data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->PointArrayInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
   // Point data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of point data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing point data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->PointDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
   // Cell data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of cell data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing cell data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->CellDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
   // Vertex data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of cell data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing cell data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->VertexDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
   // Edge data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of cell data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing cell data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->EdgeDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
   // Row data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of cell data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing cell data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->RowDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
@@ -1574,18 +1562,12 @@ void vtkPVDataInformation::CopyFromStream(const vtkClientServerStream* css)
   this->SetCompositeDataSetName(compositedatasetname);
 
   // Composite data information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of cell data information.");
-    return;
-  }
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing cell data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   if (dcss.GetNumberOfMessages() > 0)
   {
     this->CompositeDataInformation->CopyFromStream(&dcss);
@@ -1597,19 +1579,12 @@ void vtkPVDataInformation::CopyFromStream(const vtkClientServerStream* css)
   CSS_GET_CUR_INDEX()++;
 
   // Field data array information.
-  if (!css->GetArgumentLength(0, CSS_GET_CUR_INDEX(), &length))
-  {
-    vtkErrorMacro("Error parsing length of field data information.");
-    return;
-  }
-
-  data.resize(length);
-  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &*data.begin(), length))
+  if (!css->GetArgument(0, CSS_GET_CUR_INDEX(), &data))
   {
     vtkErrorMacro("Error parsing field data information.");
     return;
   }
-  dcss.SetData(&*data.begin(), length);
+  dcss.SetData(data.GetBytes(), data.GetLength());
   this->FieldDataInformation->CopyFromStream(&dcss);
   CSS_GET_CUR_INDEX()++;
 
@@ -69,13 +69,32 @@ public:
   //@{
   /**
    * Port number controls which output port the information is gathered from.
-   * This is the only parameter that can be set on  the client-side before
-   * gathering the information.
+   * This parameter can be set on the client-side before gathering the
+   * information.
    */
   vtkSetMacro(PortNumber, int);
   vtkGetMacro(PortNumber, int);
   //@}
 
+  //@{
+  /**
+   * When ComputeArrayRanges is false, the ranges of the arrays are not
+   * computed, except for the arrays named RangeArrayName (if any), and the
+   * vtkPVArrayInformation for the other arrays report HasRanges() 0. This
+   * makes gathering the information of datasets with many arrays much
+   * cheaper when only the array meta-data, bounds and counts are needed. The
+   * range of an array can then be obtained when it is needed, e.g. for
+   * coloring, by gathering the information again with RangeArrayName set.
+   * Ranges of arrays that were not modified are cached by the arrays
+   * themselves. These parameters can be set on the client-side before
+   * gathering the information. Default is true.
+   */
+  vtkSetMacro(ComputeArrayRanges, bool);
+  vtkGetMacro(ComputeArrayRanges, bool);
+  vtkSetStringMacro(RangeArrayName);
+  vtkGetStringMacro(RangeArrayName);
+  //@}
+
   /**
    * Transfer information about a single object into this object.
    */
@@ -333,6 +352,9 @@ protected:
   char* CompositeDataSetName;
   vtkSetStringMacro(CompositeDataSetName);
 
+  bool ComputeArrayRanges;
+  char* RangeArrayName;
+
   vtkPVDataSetAttributesInformation* PointDataInformation;
   vtkPVDataSetAttributesInformation* CellDataInformation;
   vtkPVDataSetAttributesInformation* FieldDataInformation;
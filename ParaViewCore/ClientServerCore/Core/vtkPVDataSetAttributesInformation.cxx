@@ -79,18 +79,24 @@ vtkPVDataSetAttributesInformation::vtkPVDataSetAttributesInformation()
   : Internals(new vtkPVDataSetAttributesInformation::vtkInternals())
 {
   this->FieldAssociation = vtkDataObject::NUMBER_OF_ASSOCIATIONS;
+  this->ComputeArrayRanges = true;
+  this->RangeArrayName = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkPVDataSetAttributesInformation::~vtkPVDataSetAttributesInformation()
 {
   delete this->Internals;
+  this->SetRangeArrayName(NULL);
 }
 
 //----------------------------------------------------------------------------
 void vtkPVDataSetAttributesInformation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ComputeArrayRanges: " << this->ComputeArrayRanges << endl;
+  os << indent << "RangeArrayName: " << (this->RangeArrayName ? this->RangeArrayName : "(none)")
+     << endl;
   os << indent << "ArrayInformation, number of arrays: " << this->GetNumberOfArrays() << endl;
   for (vtkInternals::ArrayInformationType::const_iterator iter =
          this->Internals->ArrayInformation.begin();
@@ -150,8 +156,10 @@ void vtkPVDataSetAttributesInformation::CopyFromFieldData(vtkFieldData* da)
     vtkAbstractArray* const array = da->GetAbstractArray(idx);
     if (array != NULL && !vtkSkipArray(array->GetName()))
     {
+      const bool computeRanges = this->ComputeArrayRanges ||
+        (this->RangeArrayName && strcmp(array->GetName(), this->RangeArrayName) == 0);
       vtkNew<vtkPVArrayInformation> info;
-      info->CopyFromObject(array);
+      info->CopyFromArray(array, computeRanges);
       internals.ArrayInformation[array->GetName()] = info.Get();
     }
   }
@@ -53,6 +53,18 @@ public:
   vtkSetMacro(FieldAssociation, int);
   //@}
 
+  //@{
+  /**
+   * When ComputeArrayRanges is false, the ranges are only computed for the
+   * array named RangeArrayName, if any, when copying from field data. Default
+   * is true. These are usually set by vtkPVDataInformation.
+   */
+  vtkSetMacro(ComputeArrayRanges, bool);
+  vtkGetMacro(ComputeArrayRanges, bool);
+  vtkSetStringMacro(RangeArrayName);
+  vtkGetStringMacro(RangeArrayName);
+  //@}
+
   //@{
   /**
    * Transfer information about a single vtk data object into
@@ -119,6 +131,8 @@ protected:
 
   // Standard cell attributes.
   int FieldAssociation;
+  bool ComputeArrayRanges;
+  char* RangeArrayName;
 
 private:
   vtkPVDataSetAttributesInformation(const vtkPVDataSetAttributesInformation&) = delete;
@@ -14,6 +14,12 @@
 =========================================================================*/
 #include "vtkPVInformation.h"
 
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessController.h"
+#include "vtkSmartPointer.h"
+
+#include <vector>
+
 //----------------------------------------------------------------------------
 vtkPVInformation::vtkPVInformation()
 {
@@ -49,3 +55,78 @@ void vtkPVInformation::CopyFromStream(const vtkClientServerStream*)
 {
   vtkErrorMacro("CopyFromStream not implemented.");
 }
+
+//----------------------------------------------------------------------------
+void vtkPVInformation::ReduceInformation(
+  vtkMultiProcessController* controller, vtkPVInformation* info, int tag)
+{
+  const int rank = controller->GetLocalProcessId();
+  const int nranks = controller->GetNumberOfProcesses();
+
+  // At each level, the processes that have the level bit set send what they
+  // have to `rank - level` and are done, while the others receive from
+  // `rank + level`. A process only receives from the subtrees of the
+  // processes following it, so the information is merged in process order.
+  // Each message is a number of serialized information objects: one, unless
+  // the sender could not merge what it received because its `info` is NULL.
+  typedef std::vector<unsigned char> Buffer;
+  std::vector<Buffer> unmerged;
+  vtkClientServerStream stream;
+  for (int level = 1; level < nranks; level <<= 1)
+  {
+    if ((rank & level) != 0)
+    {
+      if (info)
+      {
+        const unsigned char* data;
+        size_t length;
+        info->CopyToStream(&stream);
+        // Get pointer to the raw stream data. Note, this is a shallow copy,
+        // no need to delete the data.
+        stream.GetData(&data, &length);
+        unmerged.push_back(Buffer(data, data + length));
+      }
+      vtkIdType count = static_cast<vtkIdType>(unmerged.size());
+      controller->Send(&count, 1, rank - level, tag);
+      for (size_t cc = 0; cc < unmerged.size(); ++cc)
+      {
+        vtkIdType length = static_cast<vtkIdType>(unmerged[cc].size());
+        controller->Send(&length, 1, rank - level, tag);
+        if (length > 0)
+        {
+          controller->Send(&unmerged[cc][0], length, rank - level, tag);
+        }
+      }
+      return;
+    }
+    if (rank + level >= nranks)
+    {
+      continue;
+    }
+
+    vtkIdType count = 0;
+    controller->Receive(&count, 1, rank + level, tag);
+    for (vtkIdType cc = 0; cc < count; ++cc)
+    {
+      vtkIdType length = 0;
+      controller->Receive(&length, 1, rank + level, tag);
+      Buffer buffer(static_cast<size_t>(length));
+      if (length > 0)
+      {
+        controller->Receive(&buffer[0], length, rank + level, tag);
+      }
+      if (!info)
+      {
+        unmerged.push_back(buffer);
+      }
+      else if (length > 0)
+      {
+        stream.SetData(&buffer[0], buffer.size());
+        vtkSmartPointer<vtkPVInformation> tempInfo;
+        tempInfo.TakeReference(info->NewInstance());
+        tempInfo->CopyFromStream(&stream);
+        info->AddInformation(tempInfo);
+      }
+    }
+  }
+}
@@ -26,6 +26,7 @@
 #include "vtkPVClientServerCoreCoreModule.h" //needed for exports
 
 class vtkClientServerStream;
+class vtkMultiProcessController;
 class vtkMultiProcessStream;
 
 class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVInformation : public vtkObject
@@ -70,6 +71,17 @@ public:
   vtkGetMacro(RootOnly, int);
   //@}
 
+  /**
+   * Merges the information of all the processes of the controller into the
+   * information of process 0. The information is merged along a binomial
+   * tree, so that no process merges more than log2(N) information objects,
+   * and still in process order. `info` may be NULL on a satellite where the
+   * information could not be gathered, the satellite then only forwards what
+   * it receives. `tag` is the tag of the point-to-point messages.
+   */
+  static void ReduceInformation(
+    vtkMultiProcessController* controller, vtkPVInformation* info, int tag);
+
 protected:
   vtkPVInformation();
   ~vtkPVInformation() override;
@@ -21,6 +21,7 @@
 #include "vtkOutlineRepresentation.h"
 #include "vtkPVAlgorithmPortsInformation.h"
 #include "vtkPVArrayInformation.h"
+#include "vtkPVBufferCompressor.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVCacheKeeperPipeline.h"
 #include "vtkPVCacheSizeInformation.h"
@@ -31,6 +32,7 @@
 #include "vtkPVCompositeRepresentation.h"
 #include "vtkPVContextView.h"
 #include "vtkPVDataInformation.h"
+#include "vtkPVDataObjectMarshaler.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVDataRepresentationPipeline.h"
 #include "vtkPVDataSetAttributesInformation.h"
@@ -123,6 +125,7 @@ int ParaViewCoreClientServerCorePrintSelf(int, char* [])
   PRINT_SELF(vtkOutlineRepresentation);
   PRINT_SELF(vtkPVAlgorithmPortsInformation);
   PRINT_SELF(vtkPVArrayInformation);
+  PRINT_SELF(vtkPVBufferCompressor);
   PRINT_SELF(vtkPVCacheKeeper);
   PRINT_SELF(vtkPVCacheKeeperPipeline);
   PRINT_SELF(vtkPVCacheSizeInformation);
@@ -133,6 +136,7 @@ int ParaViewCoreClientServerCorePrintSelf(int, char* [])
   PRINT_SELF(vtkPVCompositeRepresentation);
   // PRINT_SELF(vtkPVContextView);
   PRINT_SELF(vtkPVDataInformation);
+  PRINT_SELF(vtkPVDataObjectMarshaler);
   PRINT_SELF(vtkPVDataRepresentation);
   PRINT_SELF(vtkPVDataRepresentationPipeline);
   PRINT_SELF(vtkPVDataSetAttributesInformation);
@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestDataObjectMarshaling.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares vtkPVDataObjectMarshaler against the legacy writer based
+// marshaling used by vtkCommunicator. Use `--resolution` and `--repeat` to use
+// this test for benchmarking.
+
+#include "vtkAMRGaussianPulseSource.h"
+#include "vtkCharArray.h"
+#include "vtkCommunicator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkNew.h"
+#include "vtkOverlappingAMR.h"
+#include "vtkPVDataObjectMarshaler.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtksys/CommandLineArguments.hxx>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+bool SameDataSet(vtkDataSet* a, vtkDataSet* b)
+{
+  if (!a || !b || a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells() ||
+    a->GetPointData()->GetNumberOfArrays() != b->GetPointData()->GetNumberOfArrays())
+  {
+    return false;
+  }
+  double ba[6], bb[6];
+  a->GetBounds(ba);
+  b->GetBounds(bb);
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    if (ba[cc] != bb[cc])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameDataObject(vtkDataObject* a, vtkDataObject* b)
+{
+  vtkOverlappingAMR* amrA = vtkOverlappingAMR::SafeDownCast(a);
+  vtkOverlappingAMR* amrB = vtkOverlappingAMR::SafeDownCast(b);
+  if (amrA && amrB)
+  {
+    if (amrA->GetNumberOfLevels() != amrB->GetNumberOfLevels() ||
+      amrA->GetTotalNumberOfBlocks() != amrB->GetTotalNumberOfBlocks())
+    {
+      return false;
+    }
+    for (unsigned int level = 0; level < amrA->GetNumberOfLevels(); ++level)
+    {
+      for (unsigned int idx = 0; idx < amrA->GetNumberOfDataSets(level); ++idx)
+      {
+        vtkDataSet* blockA = amrA->GetDataSet(level, idx);
+        vtkDataSet* blockB = amrB->GetDataSet(level, idx);
+        if ((blockA || blockB) && !SameDataSet(blockA, blockB))
+        {
+          return false;
+        }
+        if (!(amrA->GetAMRBox(level, idx) == amrB->GetAMRBox(level, idx)))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+  return SameDataSet(vtkDataSet::SafeDownCast(a), vtkDataSet::SafeDownCast(b));
+}
+
+bool Compare(const char* label, vtkDataObject* data, int repeat)
+{
+  double legacyMarshal = 0, legacyUnmarshal = 0;
+  double binaryMarshal = 0, binaryUnmarshal = 0;
+  vtkIdType legacySize = 0, binarySize = 0;
+
+  vtkNew<vtkTimerLog> timer;
+  for (int cc = 0; cc < repeat; ++cc)
+  {
+    vtkNew<vtkCharArray> legacyBuffer;
+    timer->StartTimer();
+    vtkCommunicator::MarshalDataObject(data, legacyBuffer.GetPointer());
+    timer->StopTimer();
+    legacyMarshal += timer->GetElapsedTime();
+    legacySize = legacyBuffer->GetNumberOfTuples();
+
+    vtkSmartPointer<vtkDataObject> legacyResult;
+    legacyResult.TakeReference(data->NewInstance());
+    timer->StartTimer();
+    vtkCommunicator::UnMarshalDataObject(legacyBuffer.GetPointer(), legacyResult);
+    timer->StopTimer();
+    legacyUnmarshal += timer->GetElapsedTime();
+
+    timer->StartTimer();
+    char* buffer = vtkPVDataObjectMarshaler::Marshal(data, binarySize);
+    timer->StopTimer();
+    binaryMarshal += timer->GetElapsedTime();
+    if (!buffer)
+    {
+      cerr << "ERROR: failed to marshal " << label << endl;
+      return false;
+    }
+
+    vtkSmartPointer<vtkDataObject> binaryResult;
+    timer->StartTimer();
+    binaryResult.TakeReference(vtkPVDataObjectMarshaler::Unmarshal(buffer, binarySize));
+    timer->StopTimer();
+    binaryUnmarshal += timer->GetElapsedTime();
+    delete[] buffer;
+
+    if (!binaryResult || !SameDataObject(data, binaryResult))
+    {
+      cerr << "ERROR: binary marshaling did not reproduce " << label << endl;
+      return false;
+    }
+  }
+
+  cout << label << ":" << endl
+       << "  legacy: marshal " << (legacyMarshal / repeat) << "s, unmarshal "
+       << (legacyUnmarshal / repeat) << "s, size " << legacySize << endl
+       << "  binary: marshal " << (binaryMarshal / repeat) << "s, unmarshal "
+       << (binaryUnmarshal / repeat) << "s, size " << binarySize << endl;
+  return true;
+}
+}
+
+int TestDataObjectMarshaling(int argc, char* argv[])
+{
+  int resolution = 32;
+  int repeat = 1;
+
+  vtksys::CommandLineArguments arg;
+  arg.Initialize(argc, argv);
+  typedef vtksys::CommandLineArguments argT;
+  arg.AddArgument(
+    "--resolution", argT::EQUAL_ARGUMENT, &resolution, "Resolution of the generated datasets.");
+  arg.AddArgument("--repeat", argT::EQUAL_ARGUMENT, &repeat, "Number of iterations to average.");
+  arg.StoreUnusedArguments(true);
+  if (!arg.Parse() || resolution < 2 || repeat < 1)
+  {
+    cerr << "Problem parsing arguments" << endl;
+    return TEST_FAILED;
+  }
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(resolution * 8);
+  sphere->SetPhiResolution(resolution * 8);
+  sphere->Update();
+  if (!vtkPVDataObjectMarshaler::CanMarshal(sphere->GetOutputDataObject(0)) ||
+    !Compare("vtkPolyData", sphere->GetOutputDataObject(0), repeat))
+  {
+    return TEST_FAILED;
+  }
+
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(0, resolution, 0, resolution, 0, resolution);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(wavelet->GetOutputPort());
+  tetrahedralize->Update();
+  if (!Compare("vtkUnstructuredGrid", tetrahedralize->GetOutputDataObject(0), repeat))
+  {
+    return TEST_FAILED;
+  }
+
+  vtkNew<vtkAMRGaussianPulseSource> amr;
+  amr->SetRefinementRatio(2);
+  amr->SetNumberOfLevels(3);
+  amr->Update();
+  if (!Compare("vtkOverlappingAMR", amr->GetOutputDataObject(0), repeat))
+  {
+    return TEST_FAILED;
+  }
+
+  return TEST_SUCCESS;
+}
@@ -138,5 +138,43 @@ int TestPVArrayInformation(int, char* [])
     return EXIT_FAILURE;
   }
 
+  // Compare the ranges of a large multi-component array, including the
+  // magnitude, with the ones computed by vtkDataArray on a copy of the array.
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(100000);
+  for (vtkIdType cc = 0; cc < vectors->GetNumberOfTuples(); ++cc)
+  {
+    vectors->SetTypedComponent(cc, 0, static_cast<float>(cc % 1000) - 500.0f);
+    vectors->SetTypedComponent(cc, 1, static_cast<float>(cc) * 0.25f);
+    vectors->SetTypedComponent(cc, 2, static_cast<float>((cc * 7919) % 4001) / 7.0f);
+  }
+  vectors->SetTypedComponent(1234, 1, vtkMath::Nan());
+  vectors->SetTypedComponent(5678, 2, -vtkMath::Inf());
+  vtkNew<vtkFloatArray> reference;
+  reference->DeepCopy(vectors.Get());
+
+  info->CopyFromObject(vectors.Get());
+  for (int comp = -1; comp < 3; ++comp)
+  {
+    double expected[2], expectedFinite[2], actual[2], actualFinite[2];
+    reference->GetRange(expected, comp);
+    reference->GetFiniteRange(expectedFinite, comp);
+    info->GetComponentRange(comp, actual);
+    info->GetComponentFiniteRange(comp, actualFinite);
+    for (int cc = 0; cc < 2; ++cc)
+    {
+      if (!(actual[cc] == expected[cc] || vtkMathUtilities::FuzzyCompare(actual[cc], expected[cc])) ||
+        !vtkMathUtilities::FuzzyCompare(actualFinite[cc], expectedFinite[cc]))
+      {
+        cerr << "ERROR: range mismatch for component " << comp << ": " << actual[0] << ", "
+             << actual[1] << " (finite " << actualFinite[0] << ", " << actualFinite[1]
+             << ") instead of " << expected[0] << ", " << expected[1] << " (finite "
+             << expectedFinite[0] << ", " << expectedFinite[1] << ")" << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
   return EXIT_SUCCESS;
 }
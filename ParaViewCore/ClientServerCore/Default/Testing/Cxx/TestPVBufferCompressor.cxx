@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVBufferCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkNew.h"
+#include "vtkPVBufferCompressor.h"
+#include "vtkTimerLog.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+bool RoundTrip(int method, const std::vector<char>& input, vtkIdType chunkSize)
+{
+  vtkNew<vtkTimerLog> timer;
+  vtkIdType compressedLength = 0;
+  timer->StartTimer();
+  char* compressed = vtkPVBufferCompressor::Compress(&input[0],
+    static_cast<vtkIdType>(input.size()), method, 6, compressedLength, chunkSize);
+  timer->StopTimer();
+  double compressTime = timer->GetElapsedTime();
+  if (!compressed || !vtkPVBufferCompressor::IsCompressedBuffer(compressed, compressedLength))
+  {
+    cerr << "ERROR: failed to compress using " << vtkPVBufferCompressor::GetMethodAsString(method)
+         << endl;
+    delete[] compressed;
+    return false;
+  }
+
+  vtkIdType decompressedLength = 0;
+  timer->StartTimer();
+  char* decompressed =
+    vtkPVBufferCompressor::Decompress(compressed, compressedLength, decompressedLength);
+  timer->StopTimer();
+  delete[] compressed;
+
+  bool status = decompressed != NULL &&
+    decompressedLength == static_cast<vtkIdType>(input.size()) &&
+    memcmp(decompressed, &input[0], input.size()) == 0;
+  delete[] decompressed;
+  if (!status)
+  {
+    cerr << "ERROR: round trip failed using " << vtkPVBufferCompressor::GetMethodAsString(method)
+         << endl;
+    return false;
+  }
+
+  cout << vtkPVBufferCompressor::GetMethodAsString(method) << " (chunk size " << chunkSize
+       << "): compress " << compressTime << "s, decompress " << timer->GetElapsedTime()
+       << "s, ratio " << (static_cast<double>(input.size()) / compressedLength) << endl;
+  return true;
+}
+}
+
+int TestPVBufferCompressor(int, char* [])
+{
+  // Generate a buffer that looks like geometry: slowly varying floats.
+  std::vector<char> input(8 * 1024 * 1024 + 123);
+  float* values = reinterpret_cast<float*>(&input[0]);
+  for (size_t cc = 0, max = input.size() / sizeof(float); cc < max; ++cc)
+  {
+    values[cc] = static_cast<float>(cc % 1024) * 0.5f;
+  }
+
+  vtkIdType length = 0;
+  if (vtkPVBufferCompressor::Compress(&input[0], static_cast<vtkIdType>(input.size()),
+        vtkPVBufferCompressor::NONE, 6, length) != NULL)
+  {
+    cerr << "ERROR: NONE must not generate a compressed buffer." << endl;
+    return EXIT_FAILURE;
+  }
+
+  const vtkIdType chunkSizes[] = { 4096, vtkPVBufferCompressor::DEFAULT_CHUNK_SIZE,
+    static_cast<vtkIdType>(input.size()) };
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    if (!RoundTrip(vtkPVBufferCompressor::ZLIB, input, chunkSizes[cc]) ||
+      !RoundTrip(vtkPVBufferCompressor::LZ4, input, chunkSizes[cc]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVDataInformationArrayRanges.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPVDataInformation only computes the requested array ranges
+// when ComputeArrayRanges is off.
+
+#include "vtkClientServerStream.h"
+#include "vtkDoubleArray.h"
+#include "vtkMathUtilities.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+namespace
+{
+vtkSmartPointer<vtkPolyData> GetSphere(double offset)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->Update();
+  vtkSmartPointer<vtkPolyData> pd = sphere->GetOutput();
+
+  const char* names[] = { "a", "b", "c" };
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    vtkNew<vtkDoubleArray> array;
+    array->SetName(names[cc]);
+    array->SetNumberOfTuples(pd->GetNumberOfPoints());
+    for (vtkIdType kk = 0; kk < pd->GetNumberOfPoints(); ++kk)
+    {
+      array->SetValue(kk, offset + cc + kk);
+    }
+    pd->GetPointData()->AddArray(array.Get());
+  }
+  return pd;
+}
+
+bool CheckArray(vtkPVDataInformation* info, const char* name, bool hasRanges, double min)
+{
+  vtkPVArrayInformation* ainfo = info->GetArrayInformation(name, vtkDataObject::POINT);
+  if (!ainfo || ainfo->GetHasRanges() != (hasRanges ? 1 : 0))
+  {
+    cerr << "ERROR: unexpected ranges for array " << name << "." << endl;
+    return false;
+  }
+  if (hasRanges && !vtkMathUtilities::FuzzyCompare(ainfo->GetComponentRange(0)[0], min))
+  {
+    cerr << "ERROR: wrong range for array " << name << ": " << ainfo->GetComponentRange(0)[0]
+         << " instead of " << min << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestPVDataInformationArrayRanges(int, char* [])
+{
+  vtkNew<vtkMultiBlockDataSet> data;
+  data->SetBlock(0, GetSphere(0.0));
+  data->SetBlock(1, GetSphere(-10.0));
+
+  // Parameters are set on the client and sent with the gather request.
+  vtkNew<vtkPVDataInformation> clientInfo;
+  clientInfo->SetComputeArrayRanges(false);
+  clientInfo->SetRangeArrayName("b");
+  vtkMultiProcessStream parameters;
+  clientInfo->CopyParametersToStream(parameters);
+
+  vtkNew<vtkPVDataInformation> info;
+  info->CopyParametersFromStream(parameters);
+  info->CopyFromObject(data.Get());
+
+  vtkClientServerStream stream;
+  info->CopyToStream(&stream);
+  vtkNew<vtkPVDataInformation> received;
+  received->CopyFromStream(&stream);
+
+  vtkPVDataInformation* infos[] = { info.Get(), received.Get() };
+  for (int cc = 0; cc < 2; ++cc)
+  {
+    if (!CheckArray(infos[cc], "a", false, 0.0) || !CheckArray(infos[cc], "b", true, -9.0) ||
+      !CheckArray(infos[cc], "c", false, 0.0) ||
+      infos[cc]->GetNumberOfPoints() != 2 * GetSphere(0.0)->GetNumberOfPoints())
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // By default, all ranges are computed.
+  vtkNew<vtkPVDataInformation> fullInfo;
+  fullInfo->CopyFromObject(data.Get());
+  if (!CheckArray(fullInfo.Get(), "a", true, -10.0) || !CheckArray(fullInfo.Get(), "c", true, -8.0))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Merging information without ranges makes the result lack ranges too.
+  fullInfo->AddInformation(info.Get());
+  if (!CheckArray(fullInfo.Get(), "a", false, 0.0) || !CheckArray(fullInfo.Get(), "b", true, -10.0))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
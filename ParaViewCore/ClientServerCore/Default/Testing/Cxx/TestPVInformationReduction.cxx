@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVInformationReduction.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests vtkPVInformation::ReduceInformation, which merges the information
+// gathered by vtkPVSessionCore on all the ranks. Ranks 1, 4, 7... have no data
+// and ranks 2, 6, 10... could not gather their information at all, the root
+// must still end up with the information of all the ranks that have data.
+// The reduction is then timed for increasing numbers of ranks, up to the
+// number of processes, reporting the time and memory the root needs to merge.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkMPIController.h"
+#include "vtkMathUtilities.h"
+#include "vtkNew.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVDataSetAttributesInformation.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <algorithm>
+
+namespace
+{
+const int REDUCTION_TAG = 887823;
+
+bool HasData(int rank)
+{
+  return rank % 3 != 1;
+}
+
+// Even ranks have children in the reduction tree, so the ones without
+// information forward the information of rank + 1 with 4 ranks or more.
+bool HasInformation(int rank)
+{
+  return rank % 4 != 2;
+}
+
+vtkSmartPointer<vtkPVDataInformation> GetRankInformation(int rank)
+{
+  vtkSmartPointer<vtkPVDataInformation> info = vtkSmartPointer<vtkPVDataInformation>::New();
+  if (!HasData(rank))
+  {
+    info->CopyFromObject(NULL);
+    return info;
+  }
+
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("rank");
+  for (int cc = 0; cc < 4; ++cc)
+  {
+    vtkIdType id = points->InsertNextPoint(rank, cc, 0);
+    verts->InsertNextCell(1, &id);
+    values->InsertNextValue(rank + 0.5 * cc);
+  }
+  vtkNew<vtkPolyData> pd;
+  pd->SetPoints(points.Get());
+  pd->SetVerts(verts.Get());
+  pd->GetPointData()->AddArray(values.Get());
+  info->CopyFromObject(pd.Get());
+  return info;
+}
+
+bool Check(vtkPVDataInformation* info, int nranks)
+{
+  int count = 0;
+  int lastRank = 0;
+  for (int rank = 0; rank < nranks; ++rank)
+  {
+    if (HasData(rank) && HasInformation(rank))
+    {
+      ++count;
+      lastRank = rank;
+    }
+  }
+
+  double bounds[6];
+  info->GetBounds(bounds);
+  vtkPVArrayInformation* ainfo = info->GetPointDataInformation()->GetArrayInformation("rank");
+  if (info->GetNumberOfPoints() != 4 * count || info->GetNumberOfCells() != 4 * count ||
+    !vtkMathUtilities::FuzzyCompare(bounds[0], 0.0) ||
+    !vtkMathUtilities::FuzzyCompare(bounds[1], static_cast<double>(lastRank)) || !ainfo ||
+    !vtkMathUtilities::FuzzyCompare(ainfo->GetComponentRange(0)[0], 0.0) ||
+    !vtkMathUtilities::FuzzyCompare(ainfo->GetComponentRange(0)[1], lastRank + 1.5))
+  {
+    cerr << "ERROR: unexpected information for " << nranks << " ranks: "
+         << info->GetNumberOfPoints() << " points instead of " << 4 * count << endl;
+    return false;
+  }
+  return true;
+}
+
+// Reduces the information of the first nranks processes, and reports how long
+// it took the root and how much memory it used.
+void Benchmark(vtkMPIController* controller, int nranks)
+{
+  const int rank = controller->GetLocalProcessId();
+  vtkMPIController* subController = controller->PartitionController(rank < nranks ? 0 : 1, rank);
+  if (rank < nranks)
+  {
+    vtksys::SystemInformation sysInfo;
+    const vtksys::SystemInformation::LongLong memoryBefore = sysInfo.GetProcMemoryUsed();
+    vtkSmartPointer<vtkPVDataInformation> info = GetRankInformation(rank);
+    subController->Barrier();
+    vtkNew<vtkTimerLog> timer;
+    timer->StartTimer();
+    vtkPVInformation::ReduceInformation(subController, info, REDUCTION_TAG);
+    timer->StopTimer();
+    if (rank == 0)
+    {
+      cout << nranks << " ranks: root merged in " << timer->GetElapsedTime() << " s, using "
+           << sysInfo.GetProcMemoryUsed() - memoryBefore << " KiB" << endl;
+    }
+  }
+  subController->Delete();
+  controller->Barrier();
+}
+}
+
+int TestPVInformationReduction(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 0);
+
+  const int rank = controller->GetLocalProcessId();
+  const int nranks = controller->GetNumberOfProcesses();
+  int success = 1;
+  if (rank == 0 && nranks < 3)
+  {
+    cout << "Run with 3 ranks or more to test ranks without information." << endl;
+  }
+
+  // Reduce twice, to check that the messages of a reduction do not leak into
+  // the next one.
+  for (int iteration = 0; iteration < 2; ++iteration)
+  {
+    vtkSmartPointer<vtkPVDataInformation> info;
+    if (HasInformation(rank))
+    {
+      info = GetRankInformation(rank);
+    }
+    vtkPVInformation::ReduceInformation(controller.Get(), info, REDUCTION_TAG);
+    if (rank == 0 && !Check(info, nranks))
+    {
+      success = 0;
+    }
+    controller->Barrier();
+  }
+
+  for (int count = 2; count < 2 * nranks; count *= 2)
+  {
+    Benchmark(controller.Get(), std::min(count, nranks));
+  }
+
+  controller->Broadcast(&success, 1, 0);
+  controller->Finalize();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
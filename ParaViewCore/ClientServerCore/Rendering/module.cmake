@@ -31,6 +31,7 @@ vtk_module(vtkPVClientServerCoreRendering
     vtkViewsCore
     ${__dependencies}
   PRIVATE_DEPENDS
+    vtklz4
     vtksys
     vtkzlib
     ${__private_dependencies}
@@ -50,6 +50,10 @@ vtkCacheSizeKeeper::vtkCacheSizeKeeper()
   this->CacheSize = 0;
   this->CacheFull = 0;
   this->CacheLimit = 100 * 1024; // 100 MBs.
+  this->EvictionPolicy = vtkCacheSizeKeeper::LRU;
+  this->MaximumNumberOfCachedEntries = 0;
+  this->NumberOfEvictions = 0;
+  this->EvictedSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -64,4 +68,8 @@ void vtkCacheSizeKeeper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CacheSize: " << this->CacheSize << endl;
   os << indent << "CacheFull: " << this->CacheFull << endl;
   os << indent << "CacheLimit: " << this->CacheLimit << endl;
+  os << indent << "EvictionPolicy: " << this->EvictionPolicy << endl;
+  os << indent << "MaximumNumberOfCachedEntries: " << this->MaximumNumberOfCachedEntries << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
+  os << indent << "EvictedSize: " << this->EvictedSize << endl;
 }
@@ -19,6 +19,12 @@
  *
  * vtkCacheSizeKeeper keeps track of the amount of memory cached
  * by several vtkPVUpdateSuppressor objects.
+ *
+ * The EvictionPolicy determines what happens once the cache size exceeds the
+ * CacheLimit. With NO_EVICTION, nothing more is cached. With LRU (the
+ * default), vtkPVView::Update evicts the least recently used cached entries
+ * (see vtkPVCacheKeeper::EvictLeastRecentlyUsed) so that caching can
+ * continue.
 */
 
 #ifndef vtkCacheSizeKeeper_h
@@ -88,6 +94,54 @@ public:
   vtkSetMacro(CacheFull, int);
   //@}
 
+  enum EvictionPolicies
+  {
+    NO_EVICTION = 0,
+    LRU = 1
+  };
+
+  //@{
+  /**
+   * Get/Set the policy applied when the cache is full. Default is LRU.
+   */
+  vtkSetClampMacro(EvictionPolicy, int, NO_EVICTION, LRU);
+  vtkGetMacro(EvictionPolicy, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the maximum number of entries (time steps) cached by each of the
+   * vtkPVCacheKeeper reporting to this keeper, unless they set their own.
+   * 0, the default, means no limit other than CacheLimit.
+   */
+  vtkSetClampMacro(MaximumNumberOfCachedEntries, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedEntries, int);
+  //@}
+
+  /**
+   * Report the eviction of a cached entry of the given size (in kbytes).
+   */
+  void RecordEviction(unsigned long kbytes)
+  {
+    this->FreeCacheSize(kbytes);
+    this->NumberOfEvictions++;
+    this->EvictedSize += kbytes;
+  }
+
+  //@{
+  /**
+   * Get the number of entries evicted and their total size (in kbytes) since
+   * the last call to ResetEvictionStatistics().
+   */
+  vtkGetMacro(NumberOfEvictions, vtkTypeUInt64);
+  vtkGetMacro(EvictedSize, vtkTypeUInt64);
+  void ResetEvictionStatistics()
+  {
+    this->NumberOfEvictions = 0;
+    this->EvictedSize = 0;
+  }
+  //@}
+
 protected:
   static vtkCacheSizeKeeper* New();
   vtkCacheSizeKeeper();
@@ -96,6 +150,10 @@ protected:
   unsigned long CacheSize;
   unsigned long CacheLimit;
   int CacheFull;
+  int EvictionPolicy;
+  int MaximumNumberOfCachedEntries;
+  vtkTypeUInt64 NumberOfEvictions;
+  vtkTypeUInt64 EvictedSize;
 
 private:
   vtkCacheSizeKeeper(const vtkCacheSizeKeeper&) = delete;
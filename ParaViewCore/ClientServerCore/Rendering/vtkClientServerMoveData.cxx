@@ -23,7 +23,10 @@
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMPIMoveData.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVBufferCompressor.h"
+#include "vtkPVDataObjectMarshaler.h"
 #include "vtkPVSession.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
@@ -48,6 +51,7 @@ vtkClientServerMoveData::vtkClientServerMoveData()
   this->WholeExtent[5] = -1;
   this->Controller = 0;
   this->ProcessType = AUTO;
+  this->UseBinaryMarshaling = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -210,7 +214,36 @@ int vtkClientServerMoveData::SendData(vtkDataObject* input, vtkMultiProcessContr
     }
   }
 
-  return controller->Send(input, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  vtkIdType length = 0;
+  char* buffer = NULL;
+  if (this->UseBinaryMarshaling && vtkPVDataObjectMarshaler::CanMarshal(input))
+  {
+    buffer = vtkPVDataObjectMarshaler::Marshal(input, length);
+  }
+
+  int format = buffer ? BINARY_FORMAT : LEGACY_FORMAT;
+  controller->Send(&format, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  if (format == LEGACY_FORMAT)
+  {
+    return controller->Send(input, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  }
+
+  // Compress using the same settings as vtkMPIMoveData.
+  vtkIdType compressedLength = 0;
+  char* compressed = vtkPVBufferCompressor::Compress(buffer, length,
+    vtkMPIMoveData::GetCompressionMethod(), vtkMPIMoveData::GetCompressionLevel(),
+    compressedLength);
+  if (compressed)
+  {
+    delete[] buffer;
+    buffer = compressed;
+    length = compressedLength;
+  }
+
+  controller->Send(&length, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  int ret = controller->Send(buffer, length, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  delete[] buffer;
+  return ret;
 }
 
 //-----------------------------------------------------------------------------
@@ -239,7 +272,27 @@ vtkDataObject* vtkClientServerMoveData::ReceiveData(vtkMultiProcessController* c
   }
   else
   {
-    data = controller->ReceiveDataObject(1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    int format = LEGACY_FORMAT;
+    controller->Receive(&format, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    if (format == BINARY_FORMAT)
+    {
+      vtkIdType length = 0;
+      controller->Receive(&length, 1, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+      char* buffer = new char[length];
+      controller->Receive(buffer, length, 1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+      if (vtkPVBufferCompressor::IsCompressedBuffer(buffer, length))
+      {
+        char* decompressed = vtkPVBufferCompressor::Decompress(buffer, length, length);
+        delete[] buffer;
+        buffer = decompressed;
+      }
+      data = buffer ? vtkPVDataObjectMarshaler::Unmarshal(buffer, length) : NULL;
+      delete[] buffer;
+    }
+    else
+    {
+      data = controller->ReceiveDataObject(1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
   }
   return data;
 }
@@ -253,5 +306,6 @@ void vtkClientServerMoveData::PrintSelf(ostream& os, vtkIndent indent)
      << this->WholeExtent[5] << endl;
   os << indent << "OutputDataType: " << this->OutputDataType << endl;
   os << indent << "ProcessType: " << this->ProcessType << endl;
+  os << indent << "UseBinaryMarshaling: " << this->UseBinaryMarshaling << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
@@ -88,6 +88,18 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   //@}
 
+  //@{
+  /**
+   * When set to true (default), datasets supported by vtkPVDataObjectMarshaler
+   * are sent as raw binary arrays instead of being serialized by the
+   * controller's legacy writer. Only affects the sending process; the
+   * receiver is told which format was used.
+   */
+  vtkSetMacro(UseBinaryMarshaling, bool);
+  vtkGetMacro(UseBinaryMarshaling, bool);
+  vtkBooleanMacro(UseBinaryMarshaling, bool);
+  //@}
+
   enum ProcessTypes
   {
     AUTO = 0,
@@ -123,9 +135,16 @@ protected:
     TRANSMIT_DATA_OBJECT = 23483
   };
 
+  enum MarshalingFormats
+  {
+    LEGACY_FORMAT = 0,
+    BINARY_FORMAT = 1
+  };
+
   int OutputDataType;
   int WholeExtent[6];
   int ProcessType;
+  bool UseBinaryMarshaling;
   vtkMultiProcessController* Controller;
 
 private:
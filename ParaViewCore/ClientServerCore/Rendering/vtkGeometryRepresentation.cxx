@@ -16,12 +16,15 @@
 #include "vtkGeometryRepresentationInternal.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkAppendPolyData.h"
 #include "vtkBoundingBox.h"
 #include "vtkCallbackCommand.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataDisplayAttributes.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkCompositePolyDataMapper2.h"
+#include "vtkDataSet.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -36,9 +39,11 @@
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
 #include "vtkProcessModule.h"
 #include "vtkProperty.h"
 #include "vtkRenderer.h"
@@ -46,6 +51,7 @@
 #include "vtkSelectionConverter.h"
 #include "vtkSelectionNode.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
 #include "vtkTransform.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -95,6 +101,23 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+//*****************************************************************************
+class vtkGeometryRepresentation::vtkStreamingInternals
+{
+public:
+  // Structure of the geometry, delivered before any block is streamed.
+  vtkSmartPointer<vtkMultiBlockDataSet> Structure;
+
+  // Geometry whose blocks are streamed.
+  vtkSmartPointer<vtkMultiBlockDataSet> Geometry;
+
+  // Blocks left to stream, identified by their flat index.
+  vtkStreamingPriorityQueue<> Blocks;
+
+  // Last piece returned by GetNextStreamedPiece().
+  vtkSmartPointer<vtkMultiBlockDataSet> Piece;
+};
+
 //*****************************************************************************
 
 vtkStandardNewMacro(vtkGeometryRepresentation);
@@ -144,6 +167,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->MultiBlockMaker = vtkGeometryRepresentationMultiBlockMaker::New();
   this->Decimator = vtkGeometryRepresentation_detail::DecimationFilterType::New();
   this->LODOutlineFilter = vtkPVGeometryFilter::New();
+  this->StreamingInternals = new vtkStreamingInternals();
 
   // connect progress bar
   this->GeometryFilter->AddObserver(vtkCommand::ProgressEvent, this,
@@ -203,6 +227,7 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
   this->MultiBlockMaker->Delete();
   this->Decimator->Delete();
   this->LODOutlineFilter->Delete();
+  delete this->StreamingInternals;
   this->Mapper->Delete();
   this->LODMapper->Delete();
   this->Actor->Delete();
@@ -296,12 +321,25 @@ int vtkGeometryRepresentation::ProcessViewRequest(
     // to provide a place-holder dataset of the right type. This is essential
     // since the vtkPVRenderView uses the type specified to decide on the
     // delivery mechanism, among other things.
-    vtkPVRenderView::SetPiece(inInfo, this, this->CacheKeeper->GetOutputDataObject(0));
+    vtkDataObject* geometry = this->CacheKeeper->GetOutputDataObject(0);
+    if (this->StreamingInternals->Structure)
+    {
+      // When streaming, only the structure is delivered now. The size of the
+      // whole geometry is still reported so that the view can decide on
+      // remote and LOD rendering.
+      vtkPVRenderView::SetPiece(inInfo, this, this->StreamingInternals->Structure,
+        geometry ? geometry->GetActualMemorySize() : 0);
+      vtkPVRenderView::SetStreamable(inInfo, this, true);
+    }
+    else
+    {
+      vtkPVRenderView::SetPiece(inInfo, this, geometry);
 
-    // Since we are rendering polydata, it can be redistributed when ordered
-    // compositing is needed. So let the view know that it can feel free to
-    // redistribute data as and when needed.
-    vtkPVRenderView::MarkAsRedistributable(inInfo, this);
+      // Since we are rendering polydata, it can be redistributed when ordered
+      // compositing is needed. So let the view know that it can feel free to
+      // redistribute data as and when needed.
+      vtkPVRenderView::MarkAsRedistributable(inInfo, this);
+    }
 
     this->ComputeVisibleDataBounds();
 
@@ -352,20 +390,65 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         // new geometry.
         this->LODOutlineFilter->Modified();
 
-        if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
-        {
-          // We handle this number differently depending on decimator
-          // implementation.
-          const double factor = inInfo->Get(vtkPVRenderView::LOD_RESOLUTION());
-          this->Decimator->SetLODFactor(factor);
-        }
-
-        this->Decimator->Update();
+        // We handle this number differently depending on decimator
+        // implementation.
+        const double factor = inInfo->Has(vtkPVRenderView::LOD_RESOLUTION())
+          ? inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())
+          : this->Decimator->GetLODFactor();
 
         // Pass along the LOD geometry to the view so that it can deliver it to
         // the rendering node as and when needed.
-        vtkPVRenderView::SetPieceLOD(inInfo, this, this->Decimator->GetOutputDataObject(0));
+        vtkPVRenderView::SetPieceLOD(inInfo, this, this->GetLODLevel(factor));
+      }
+    }
+  }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+  {
+    double view_planes[24];
+    inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+    if (vtkDataObject* piece = this->GetNextStreamedPiece(view_planes))
+    {
+      vtkPVRenderView::SetNextStreamedPiece(inInfo, this, piece);
+    }
+  }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+  {
+    vtkDataObject* piece = vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this);
+    vtkAlgorithmOutput* producerPort = vtkPVRenderView::GetPieceProducer(inInfo, this);
+    vtkCompositeDataSet* pieceCD = vtkCompositeDataSet::SafeDownCast(piece);
+    vtkMultiBlockDataSet* rendered = vtkMultiBlockDataSet::SafeDownCast(
+      producerPort->GetProducer()->GetOutputDataObject(producerPort->GetIndex()));
+    if (pieceCD && rendered)
+    {
+      vtkStreamingStatusMacro(<< this << ": received new piece.");
+
+      // the piece has the structure of what we are rendering, hence only its
+      // non-empty leaves are merged, each into its own block. A block is
+      // appended to when several processes stream parts of it.
+      vtkSmartPointer<vtkCompositeDataIterator> iter;
+      iter.TakeReference(pieceCD->NewIterator());
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+        vtkPolyData* leaf = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+        if (leaf == nullptr || leaf->GetNumberOfCells() == 0)
+        {
+          continue;
+        }
+        vtkPolyData* current = vtkPolyData::SafeDownCast(rendered->GetDataSet(iter));
+        if (current == nullptr || current->GetNumberOfCells() == 0)
+        {
+          rendered->SetDataSet(iter, leaf);
+        }
+        else
+        {
+          vtkNew<vtkAppendPolyData> appender;
+          appender->AddInputData(current);
+          appender->AddInputData(leaf);
+          appender->Update();
+          rendered->SetDataSet(iter, appender->GetOutput());
+        }
       }
+      rendered->Modified();
     }
   }
   else if (request_type == vtkPVView::REQUEST_RENDER())
@@ -438,6 +521,138 @@ int vtkGeometryRepresentation::RequestUpdateExtent(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkGeometryRepresentation::InitializeStreaming()
+{
+  vtkStreamingInternals& internals = *this->StreamingInternals;
+  internals.Structure = nullptr;
+  internals.Geometry = nullptr;
+  internals.Piece = nullptr;
+  internals.Blocks = vtkStreamingPriorityQueue<>();
+
+  vtkMultiBlockDataSet* geometry =
+    vtkMultiBlockDataSet::SafeDownCast(this->CacheKeeper->GetOutputDataObject(0));
+  if (!vtkPVView::GetEnableStreaming() || geometry == nullptr)
+  {
+    return;
+  }
+
+  internals.Geometry = geometry;
+  internals.Structure = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  internals.Structure->CopyStructure(geometry);
+
+  // The view planes are in world coordinates, hence the bounds of the blocks
+  // include the transformation of the actor.
+  vtkNew<vtkMatrix4x4> matrix;
+  this->Actor->GetMatrix(matrix.GetPointer());
+
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(geometry->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet* block = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (block == nullptr || block->GetNumberOfCells() == 0)
+    {
+      continue;
+    }
+    double bounds[6];
+    block->GetBounds(bounds);
+
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = iter->GetCurrentFlatIndex();
+    for (int corner = 0; corner < 8; ++corner)
+    {
+      double point[4] = { bounds[corner & 1], bounds[2 + ((corner >> 1) & 1)],
+        bounds[4 + ((corner >> 2) & 1)], 1.0 };
+      matrix->MultiplyPoint(point, point);
+      item.Bounds.AddPoint(point);
+    }
+    internals.Blocks.push(item);
+  }
+  vtkStreamingStatusMacro(<< this << ": blocks to stream: " << internals.Blocks.size());
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetNextStreamedPiece(const double view_planes[24])
+{
+  vtkStreamingInternals& internals = *this->StreamingInternals;
+  internals.Piece = nullptr;
+  if (internals.Blocks.empty())
+  {
+    return nullptr;
+  }
+
+  // blocks outside the view frustum get no priority and are streamed last.
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  internals.Blocks.UpdatePriorities(view_planes, clamp_bounds);
+  if (internals.Blocks.empty())
+  {
+    return nullptr;
+  }
+
+  const unsigned int flatIndex = internals.Blocks.top().Identifier;
+  internals.Blocks.pop();
+
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(internals.Geometry->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    if (iter->GetCurrentFlatIndex() == flatIndex)
+    {
+      internals.Piece = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+      internals.Piece->CopyStructure(internals.Geometry);
+      internals.Piece->SetDataSet(iter, iter->GetCurrentDataObject());
+      break;
+    }
+  }
+  vtkStreamingStatusMacro(<< this << ": streaming block " << flatIndex << ", "
+                          << internals.Blocks.size() << " left.");
+  return internals.Piece;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetLODLevel(double factor)
+{
+  this->CacheKeeper->Update();
+  vtkDataObject* geometry = this->CacheKeeper->GetOutputDataObject(0);
+  if (this->LODLevelsTime < this->CacheKeeper->GetMTime() ||
+    (geometry && this->LODLevelsTime < geometry->GetMTime()))
+  {
+    this->LODLevels.clear();
+    this->LODLevelsTime.Modified();
+  }
+
+  auto iter = this->LODLevels.begin();
+  while (iter != this->LODLevels.end() && iter->first != factor)
+  {
+    ++iter;
+  }
+  if (iter != this->LODLevels.end())
+  {
+    this->LODLevels.splice(this->LODLevels.begin(), this->LODLevels, iter);
+    return this->LODLevels.front().second;
+  }
+
+  this->Decimator->SetLODFactor(factor);
+  this->Decimator->Update();
+
+  // the decimator reuses its output, hence keep a copy of each level.
+  vtkDataObject* output = this->Decimator->GetOutputDataObject(0);
+  vtkSmartPointer<vtkDataObject> level;
+  level.TakeReference(output->NewInstance());
+  level->ShallowCopy(output);
+  this->LODLevels.push_front(std::make_pair(factor, level));
+
+  vtkPVRenderView* view = vtkPVRenderView::SafeDownCast(this->GetView());
+  const size_t maxLevels = view ? static_cast<size_t>(view->GetNumberOfLODLevels()) : 1;
+  if (this->LODLevels.size() > maxLevels)
+  {
+    this->LODLevels.resize(maxLevels);
+  }
+  return level;
+}
+
 //----------------------------------------------------------------------------
 int vtkGeometryRepresentation::RequestData(
   vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -469,6 +684,7 @@ int vtkGeometryRepresentation::RequestData(
     this->GeometryFilter->SetInputDataObject(0, placeholder.GetPointer());
   }
   this->CacheKeeper->Update();
+  this->InitializeStreaming();
 
   // HACK: To overcome issue with PolyDataMapper (OpenGL2). It doesn't recreate
   // VBO/IBOs when using data from cache. I suspect it's because the blocks in
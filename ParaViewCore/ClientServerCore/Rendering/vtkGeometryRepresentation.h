@@ -28,11 +28,13 @@
 #ifndef vtkGeometryRepresentation_h
 #define vtkGeometryRepresentation_h
 #include <array>         // needed for array
+#include <list>          // needed for list
 #include <unordered_map> // needed for unordered_map
 
 #include "vtkPVClientServerCoreRenderingModule.h" // needed for exports
 #include "vtkPVDataRepresentation.h"
-#include "vtkProperty.h" // needed for VTK_POINTS etc.
+#include "vtkProperty.h"     // needed for VTK_POINTS etc.
+#include "vtkSmartPointer.h" // needed for vtkSmartPointer
 
 class vtkCallbackCommand;
 class vtkCompositeDataDisplayAttributes;
@@ -376,6 +378,37 @@ protected:
   vtkGeometryRepresentation_detail::DecimationFilterType* Decimator;
   vtkPVGeometryFilter* LODOutlineFilter;
 
+  /**
+   * Returns the decimated geometry for the given LOD factor. Each level of the
+   * LOD hierarchy requested by the view is decimated once and kept in
+   * LODLevels till the geometry changes. LODLevels holds the most recently
+   * used levels first and no more levels than the view's NumberOfLODLevels,
+   * so factors the view no longer requests, e.g. after the LODResolution
+   * changed, are evicted.
+   */
+  vtkDataObject* GetLODLevel(double factor);
+
+  std::list<std::pair<double, vtkSmartPointer<vtkDataObject> > > LODLevels;
+  vtkTimeStamp LODLevelsTime;
+
+  /**
+   * When streaming is enabled (see vtkPVView::GetEnableStreaming()), only the
+   * structure of the geometry is delivered in REQUEST_UPDATE() and the blocks
+   * are delivered one at a time in REQUEST_STREAMING_UPDATE() passes, in order
+   * of their coverage of the view. This is called in RequestData() to prepare
+   * the blocks to stream.
+   */
+  void InitializeStreaming();
+
+  /**
+   * Returns the next block to stream, prioritized using the view planes, or
+   * nullptr when all blocks have been streamed.
+   */
+  vtkDataObject* GetNextStreamedPiece(const double view_planes[24]);
+
+  class vtkStreamingInternals;
+  vtkStreamingInternals* StreamingInternals;
+
   vtkMapper* Mapper;
   vtkMapper* LODMapper;
   vtkPVLODActor* Actor;
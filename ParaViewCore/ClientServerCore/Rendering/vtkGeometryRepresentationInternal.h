@@ -35,6 +35,7 @@ public:
     void SetLODFactor(double factor)
   {
     factor = vtkMath::ClampValue(factor, 0., 1.);
+    this->LODFactor = factor;
 
     // This produces the following number of divisions for 'factor':
     // 0.0 --> 64
@@ -43,6 +44,11 @@ public:
     int divs = static_cast<int>(std::pow(2, 4. * factor + 6.));
     this->SetNumberOfDivisions(divs, divs, divs);
   }
+
+  double GetLODFactor() const { return this->LODFactor; }
+
+private:
+  double LODFactor = 0.5;
 };
 vtkStandardNewMacro(DecimationFilterType)
 }
@@ -63,6 +69,7 @@ public:
     void SetLODFactor(double factor)
   {
     factor = vtkMath::ClampValue(factor, 0., 1.);
+    this->LODFactor = factor;
 
     // This is the same equation used in the old implementation:
     // 0.0 --> 10
@@ -78,6 +85,11 @@ public:
     this->SetCopyCellData(1);
     this->SetUseInternalTriangles(0);
   }
+
+  double GetLODFactor() const { return this->LODFactor; }
+
+private:
+  double LODFactor = 0.5;
 };
 vtkStandardNewMacro(DecimationFilterType)
 }
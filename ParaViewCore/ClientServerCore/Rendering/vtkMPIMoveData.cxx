@@ -36,7 +36,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkOutlineFilter.h"
 #include "vtkOverlappingAMR.h"
+#include "vtkPVBufferCompressor.h"
 #include "vtkPVConfig.h"
+#include "vtkPVDataObjectMarshaler.h"
 #include "vtkPVSession.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -62,7 +64,9 @@
 
 #include <vector>
 
-bool vtkMPIMoveData::UseZLibCompression = false;
+int vtkMPIMoveData::CompressionMethod = vtkPVBufferCompressor::NONE;
+int vtkMPIMoveData::CompressionLevel = 6;
+bool vtkMPIMoveData::UseBinaryMarshaling = true;
 
 namespace
 {
@@ -185,13 +189,49 @@ void vtkMPIMoveData::InitializeForCommunicationForParaView()
 //----------------------------------------------------------------------------
 void vtkMPIMoveData::SetUseZLibCompression(bool b)
 {
-  vtkMPIMoveData::UseZLibCompression = b;
+  vtkMPIMoveData::CompressionMethod = b ? vtkPVBufferCompressor::ZLIB : vtkPVBufferCompressor::NONE;
 }
 
 //----------------------------------------------------------------------------
 bool vtkMPIMoveData::GetUseZLibCompression()
 {
-  return vtkMPIMoveData::UseZLibCompression;
+  return vtkMPIMoveData::CompressionMethod == vtkPVBufferCompressor::ZLIB;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCompressionMethod(int method)
+{
+  vtkMPIMoveData::CompressionMethod = method;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetCompressionMethod()
+{
+  return vtkMPIMoveData::CompressionMethod;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetCompressionLevel(int level)
+{
+  vtkMPIMoveData::CompressionLevel = level;
+}
+
+//----------------------------------------------------------------------------
+int vtkMPIMoveData::GetCompressionLevel()
+{
+  return vtkMPIMoveData::CompressionLevel;
+}
+
+//----------------------------------------------------------------------------
+void vtkMPIMoveData::SetUseBinaryMarshaling(bool b)
+{
+  vtkMPIMoveData::UseBinaryMarshaling = b;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMPIMoveData::GetUseBinaryMarshaling()
+{
+  return vtkMPIMoveData::UseBinaryMarshaling;
 }
 
 //----------------------------------------------------------------------------
@@ -1039,52 +1079,59 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
     this->NumberOfBuffers = 0;
   }
 
-  // Copy input to isolate reader from the pipeline.
-  vtkDataWriter* writer = vtkGenericDataObjectWriter::New();
-  writer->SetInputData(data);
-  if (imageData)
+  // Marshal the arrays directly when possible, otherwise fall back to the
+  // legacy writer.
+  char* marshaled = NULL;
+  vtkIdType marshaled_length = 0;
+  if (vtkMPIMoveData::UseBinaryMarshaling && vtkPVDataObjectMarshaler::CanMarshal(data))
   {
-    // We add the image extents to the header, since the writer doesn't preserve
-    // the extents.
-    int* extent = imageData->GetExtent();
-    double* origin = imageData->GetOrigin();
-    std::ostringstream stream;
-    stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
-           << " " << extent[4] << " " << extent[5];
-    stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
-    writer->SetHeader(stream.str().c_str());
+    marshaled = vtkPVDataObjectMarshaler::Marshal(data, marshaled_length);
   }
 
-  writer->SetFileTypeToBinary();
-  writer->WriteToOutputStringOn();
-  writer->Write();
+  vtkSmartPointer<vtkDataWriter> writer;
+  if (marshaled == NULL)
+  {
+    // Copy input to isolate reader from the pipeline.
+    writer.TakeReference(vtkGenericDataObjectWriter::New());
+    writer->SetInputData(data);
+    if (imageData)
+    {
+      // We add the image extents to the header, since the writer doesn't preserve
+      // the extents.
+      int* extent = imageData->GetExtent();
+      double* origin = imageData->GetOrigin();
+      std::ostringstream stream;
+      stream << "EXTENT " << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
+             << " " << extent[4] << " " << extent[5];
+      stream << " ORIGIN " << origin[0] << " " << origin[1] << " " << origin[2];
+      writer->SetHeader(stream.str().c_str());
+    }
+
+    writer->SetFileTypeToBinary();
+    writer->WriteToOutputStringOn();
+    writer->Write();
+  }
+
+  const char* raw_buffer = marshaled ? marshaled : writer->GetOutputString();
+  vtkIdType raw_length = marshaled ? marshaled_length : writer->GetOutputStringLength();
 
   char* buffer = NULL;
   vtkIdType buffer_length = 0;
 
-  if (vtkMPIMoveData::UseZLibCompression)
+  if (vtkMPIMoveData::CompressionMethod != vtkPVBufferCompressor::NONE)
   {
-    vtkTimerLog::MarkStartEvent("Zlib compress");
-    // Use z-lib compression.
-    uLongf out_size = compressBound(writer->GetOutputStringLength());
-    buffer = new char[out_size + 8];
-    memcpy(buffer, "zlib0000", 8);
+    buffer = vtkPVBufferCompressor::Compress(raw_buffer, raw_length,
+      vtkMPIMoveData::CompressionMethod, vtkMPIMoveData::CompressionLevel, buffer_length);
+  }
 
-    compress2(reinterpret_cast<Bytef*>(buffer + 8), &out_size,
-      reinterpret_cast<const Bytef*>(writer->GetOutputString()), writer->GetOutputStringLength(),
-      /* compression_level */ Z_DEFAULT_COMPRESSION);
-    vtkTimerLog::MarkEndEvent("Zlib compress");
-    int in_size = static_cast<int>(writer->GetOutputStringLength());
-    for (int cc = 0; cc < 4; cc++)
-    {
-      // the first 4 bytes in the header are "zlib" which helps the receiver
-      // identify that zlib compression has been used.
-      // the next 4 bytes are the original length since zlib doesn't provide
-      // that to the receiver.
-      buffer[4 + cc] = (in_size & 0x0ff);
-      in_size = in_size >> 8;
-    }
-    buffer_length = out_size + 8;
+  if (buffer)
+  {
+    delete[] marshaled;
+  }
+  else if (marshaled)
+  {
+    buffer_length = marshaled_length;
+    buffer = marshaled;
   }
   else
   {
@@ -1100,9 +1147,6 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   this->BufferOffsets[0] = 0;
   this->Buffers = buffer;
   this->BufferTotalLength = this->BufferLengths[0];
-
-  writer->Delete();
-  writer = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -1123,7 +1167,20 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
     vtkIdType bufferLength = this->BufferLengths[idx];
 
     char* realBuffer = 0;
-    if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
+    if (vtkPVBufferCompressor::IsCompressedBuffer(bufferArray, bufferLength))
+    {
+      vtkIdType uncompressed_length = 0;
+      realBuffer =
+        vtkPVBufferCompressor::Decompress(bufferArray, bufferLength, uncompressed_length);
+      if (!realBuffer)
+      {
+        vtkErrorMacro("Failed to decompress received data.");
+        continue;
+      }
+      bufferArray = realBuffer;
+      bufferLength = uncompressed_length;
+    }
+    else if (bufferLength > 4 && strncmp(bufferArray, "zlib", 4) == 0)
     {
       // sender used zlib compression. Decompress it.
       vtkIdType compressed_length = bufferLength - 8; // remove the zlib header.
@@ -1145,6 +1202,24 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       bufferLength = uncompressed_length;
     }
 
+    if (vtkPVDataObjectMarshaler::IsMarshaledBuffer(bufferArray, bufferLength))
+    {
+      vtkDataObject* piece = vtkPVDataObjectMarshaler::Unmarshal(bufferArray, bufferLength);
+      if (piece)
+      {
+        // reconstructing data distributted on MPI node, so global ids are valid
+        unsetGlobalIdsAttribute(piece);
+        pieces.push_back(piece);
+        piece->Delete();
+      }
+      else
+      {
+        vtkErrorMacro("Failed to reconstruct data from marshaled buffer.");
+      }
+      delete[] realBuffer;
+      continue;
+    }
+
     // Setup a reader.
     vtkDataReader* reader = vtkGenericDataObjectReader::New();
     reader->ReadFromInputStringOn();
@@ -1207,6 +1282,9 @@ void vtkMPIMoveData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Server: " << this->Server << endl;
   os << indent << "MoveMode: " << this->MoveMode << endl;
   os << indent << "SkipDataServerGatherToZero: " << this->SkipDataServerGatherToZero << endl;
+  os << indent << "CompressionMethod: "
+     << vtkPVBufferCompressor::GetMethodAsString(vtkMPIMoveData::CompressionMethod) << endl;
+  os << indent << "CompressionLevel: " << vtkMPIMoveData::CompressionLevel << endl;
   os << indent << "OutputDataType: ";
   if (this->OutputDataType == VTK_POLY_DATA)
   {
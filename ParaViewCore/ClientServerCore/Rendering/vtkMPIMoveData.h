@@ -108,11 +108,44 @@ public:
    * When set to true, zlib compression is used. False by default.
    * This value has any effect only on the data-sender processes. The receiver
    * always checks the received data to see if zlib decompression is required.
+   * This is a shortcut for SetCompressionMethod(vtkPVBufferCompressor::ZLIB).
    */
   static void SetUseZLibCompression(bool b);
   static bool GetUseZLibCompression();
   //@}
 
+  //@{
+  /**
+   * Set the method used to compress the data buffers. Accepted values are
+   * vtkPVBufferCompressor::NONE (default), vtkPVBufferCompressor::ZLIB and
+   * vtkPVBufferCompressor::LZ4. Buffers are compressed in chunks, in
+   * parallel. This value has any effect only on the data-sender processes.
+   */
+  static void SetCompressionMethod(int method);
+  static int GetCompressionMethod();
+  //@}
+
+  //@{
+  /**
+   * Set the compression level (1-9) used when CompressionMethod is ZLIB.
+   * Default is 6.
+   */
+  static void SetCompressionLevel(int level);
+  static int GetCompressionLevel();
+  //@}
+
+  //@{
+  /**
+   * When set to true (default), datasets supported by vtkPVDataObjectMarshaler
+   * are marshaled as raw binary arrays instead of going through
+   * vtkGenericDataObjectWriter. Unsupported datasets always use the legacy
+   * writer. This value has any effect only on the data-sender processes. The
+   * receiver detects the format used from the received buffer.
+   */
+  static void SetUseBinaryMarshaling(bool b);
+  static bool GetUseBinaryMarshaling();
+  //@}
+
   /**
    * vtkMPIMoveData doesn't necessarily generate a valid output data on all the
    * involved processes (depending on the MoveMode and Server ivars). This
@@ -195,7 +228,9 @@ private:
   vtkMPIMoveData(const vtkMPIMoveData&) = delete;
   void operator=(const vtkMPIMoveData&) = delete;
 
-  static bool UseZLibCompression;
+  static int CompressionMethod;
+  static int CompressionLevel;
+  static bool UseBinaryMarshaling;
 };
 
 #endif
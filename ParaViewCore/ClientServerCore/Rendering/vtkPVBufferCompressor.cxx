@@ -0,0 +1,295 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBufferCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVBufferCompressor.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+
+#include "vtk_lz4.h"
+#include "vtk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// Header layout: 4 bytes magic, 1 byte method, 3 bytes reserved, followed by
+// the uncompressed length, the chunk size and the number of chunks (64-bit
+// each), followed by the compressed size of each chunk (64-bit each).
+const char MAGIC[4] = { 'p', 'v', 'c', 'z' };
+const size_t FIXED_HEADER_SIZE = 8 + 3 * sizeof(vtkTypeInt64);
+
+class CompressChunks
+{
+public:
+  const char* Input;
+  vtkIdType Length;
+  vtkIdType ChunkSize;
+  int Method;
+  int Level;
+  std::vector<std::vector<char> >* Chunks;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      const char* src = this->Input + cc * this->ChunkSize;
+      const vtkIdType srcLength = std::min(this->ChunkSize, this->Length - cc * this->ChunkSize);
+      std::vector<char>& dest = (*this->Chunks)[cc];
+      if (this->Method == vtkPVBufferCompressor::ZLIB)
+      {
+        uLongf destLength = compressBound(static_cast<uLong>(srcLength));
+        dest.resize(destLength);
+        if (compress2(reinterpret_cast<Bytef*>(&dest[0]), &destLength,
+              reinterpret_cast<const Bytef*>(src), static_cast<uLong>(srcLength),
+              this->Level) != Z_OK)
+        {
+          dest.clear();
+          continue;
+        }
+        dest.resize(destLength);
+      }
+      else
+      {
+        int destLength = LZ4_compressBound(static_cast<int>(srcLength));
+        dest.resize(destLength);
+        destLength =
+          LZ4_compress_default(src, &dest[0], static_cast<int>(srcLength), destLength);
+        dest.resize(destLength > 0 ? destLength : 0);
+      }
+    }
+  }
+};
+
+class DecompressChunks
+{
+public:
+  const char* Input;
+  char* Output;
+  vtkIdType Length;
+  vtkIdType ChunkSize;
+  int Method;
+  const std::vector<vtkTypeInt64>* Offsets;
+  const std::vector<vtkTypeInt64>* Sizes;
+  std::vector<char>* Status;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      const char* src = this->Input + (*this->Offsets)[cc];
+      const vtkIdType srcLength = static_cast<vtkIdType>((*this->Sizes)[cc]);
+      char* dest = this->Output + cc * this->ChunkSize;
+      const vtkIdType destLength =
+        std::min(this->ChunkSize, this->Length - cc * this->ChunkSize);
+      bool ok;
+      if (this->Method == vtkPVBufferCompressor::ZLIB)
+      {
+        uLongf actualLength = static_cast<uLongf>(destLength);
+        ok = uncompress(reinterpret_cast<Bytef*>(dest), &actualLength,
+               reinterpret_cast<const Bytef*>(src), static_cast<uLong>(srcLength)) == Z_OK &&
+          static_cast<vtkIdType>(actualLength) == destLength;
+      }
+      else
+      {
+        ok = LZ4_decompress_safe(src, dest, static_cast<int>(srcLength),
+               static_cast<int>(destLength)) == destLength;
+      }
+      (*this->Status)[cc] = ok ? 1 : 0;
+    }
+  }
+};
+
+vtkTypeInt64 ReadInt64(const char* buffer)
+{
+  vtkTypeInt64 value;
+  memcpy(&value, buffer, sizeof(value));
+  return value;
+}
+
+void WriteInt64(char* buffer, vtkTypeInt64 value)
+{
+  memcpy(buffer, &value, sizeof(value));
+}
+}
+
+vtkStandardNewMacro(vtkPVBufferCompressor);
+//----------------------------------------------------------------------------
+vtkPVBufferCompressor::vtkPVBufferCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVBufferCompressor::~vtkPVBufferCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVBufferCompressor::GetMethodAsString(int method)
+{
+  switch (method)
+  {
+    case NONE:
+      return "None";
+    case ZLIB:
+      return "ZLib";
+    case LZ4:
+      return "LZ4";
+    default:
+      return "Unknown";
+  }
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVBufferCompressor::Compress(const char* data, vtkIdType length, int method, int level,
+  vtkIdType& compressedLength, vtkIdType chunkSize)
+{
+  compressedLength = 0;
+  if ((method != ZLIB && method != LZ4) || data == NULL || length <= 0 || chunkSize <= 0)
+  {
+    return NULL;
+  }
+  if (method == LZ4)
+  {
+    // LZ4 works with int sizes.
+    chunkSize = std::min(chunkSize, static_cast<vtkIdType>(LZ4_MAX_INPUT_SIZE));
+  }
+  level = std::max(1, std::min(level, 9));
+
+  vtkTimerLog::MarkStartEvent("Compress delivery buffer");
+  const vtkIdType numChunks = (length + chunkSize - 1) / chunkSize;
+  std::vector<std::vector<char> > chunks(numChunks);
+
+  CompressChunks functor;
+  functor.Input = data;
+  functor.Length = length;
+  functor.ChunkSize = chunkSize;
+  functor.Method = method;
+  functor.Level = level;
+  functor.Chunks = &chunks;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+
+  size_t total = FIXED_HEADER_SIZE + numChunks * sizeof(vtkTypeInt64);
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+  {
+    if (chunks[cc].empty())
+    {
+      vtkTimerLog::MarkEndEvent("Compress delivery buffer");
+      vtkGenericWarningMacro("Failed to compress chunk " << cc << ".");
+      return NULL;
+    }
+    total += chunks[cc].size();
+  }
+
+  char* buffer = new char[total];
+  memcpy(buffer, MAGIC, 4);
+  buffer[4] = static_cast<char>(method);
+  buffer[5] = buffer[6] = buffer[7] = 0;
+  WriteInt64(buffer + 8, length);
+  WriteInt64(buffer + 8 + sizeof(vtkTypeInt64), chunkSize);
+  WriteInt64(buffer + 8 + 2 * sizeof(vtkTypeInt64), numChunks);
+
+  char* sizes = buffer + FIXED_HEADER_SIZE;
+  char* payload = sizes + numChunks * sizeof(vtkTypeInt64);
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+  {
+    WriteInt64(sizes + cc * sizeof(vtkTypeInt64), static_cast<vtkTypeInt64>(chunks[cc].size()));
+    memcpy(payload, &chunks[cc][0], chunks[cc].size());
+    payload += chunks[cc].size();
+  }
+  vtkTimerLog::MarkEndEvent("Compress delivery buffer");
+
+  compressedLength = static_cast<vtkIdType>(total);
+  return buffer;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVBufferCompressor::IsCompressedBuffer(const char* buffer, vtkIdType length)
+{
+  return buffer != NULL && length >= static_cast<vtkIdType>(FIXED_HEADER_SIZE) &&
+    memcmp(buffer, MAGIC, 4) == 0;
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVBufferCompressor::Decompress(
+  const char* buffer, vtkIdType length, vtkIdType& decompressedLength)
+{
+  decompressedLength = 0;
+  if (!vtkPVBufferCompressor::IsCompressedBuffer(buffer, length))
+  {
+    return NULL;
+  }
+
+  const int method = buffer[4];
+  const vtkTypeInt64 total = ReadInt64(buffer + 8);
+  const vtkTypeInt64 chunkSize = ReadInt64(buffer + 8 + sizeof(vtkTypeInt64));
+  const vtkTypeInt64 numChunks = ReadInt64(buffer + 8 + 2 * sizeof(vtkTypeInt64));
+  if ((method != ZLIB && method != LZ4) || total < 0 || chunkSize <= 0 || numChunks < 0 ||
+    numChunks != (total + chunkSize - 1) / chunkSize ||
+    FIXED_HEADER_SIZE + numChunks * sizeof(vtkTypeInt64) > static_cast<size_t>(length))
+  {
+    vtkGenericWarningMacro("Invalid compressed buffer header.");
+    return NULL;
+  }
+
+  std::vector<vtkTypeInt64> offsets(numChunks);
+  std::vector<vtkTypeInt64> sizes(numChunks);
+  vtkTypeInt64 offset = FIXED_HEADER_SIZE + numChunks * sizeof(vtkTypeInt64);
+  for (vtkTypeInt64 cc = 0; cc < numChunks; ++cc)
+  {
+    sizes[cc] = ReadInt64(buffer + FIXED_HEADER_SIZE + cc * sizeof(vtkTypeInt64));
+    offsets[cc] = offset;
+    offset += sizes[cc];
+  }
+  if (offset > length)
+  {
+    vtkGenericWarningMacro("Truncated compressed buffer.");
+    return NULL;
+  }
+
+  vtkTimerLog::MarkStartEvent("Decompress delivery buffer");
+  char* output = new char[total > 0 ? total : 1];
+  std::vector<char> status(numChunks, 0);
+
+  DecompressChunks functor;
+  functor.Input = buffer;
+  functor.Output = output;
+  functor.Length = total;
+  functor.ChunkSize = chunkSize;
+  functor.Method = method;
+  functor.Offsets = &offsets;
+  functor.Sizes = &sizes;
+  functor.Status = &status;
+  vtkSMPTools::For(0, numChunks, 1, functor);
+  vtkTimerLog::MarkEndEvent("Decompress delivery buffer");
+
+  if (std::find(status.begin(), status.end(), 0) != status.end())
+  {
+    vtkGenericWarningMacro("Failed to decompress buffer.");
+    delete[] output;
+    return NULL;
+  }
+
+  decompressedLength = static_cast<vtkIdType>(total);
+  return output;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVBufferCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVBufferCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVBufferCompressor
+ * @brief   chunked, multithreaded compression of data delivery buffers.
+ *
+ * vtkPVBufferCompressor compresses the buffers generated when marshaling
+ * data objects for delivery (see vtkMPIMoveData). The input is split into
+ * fixed size chunks that are compressed (and decompressed) independently
+ * using vtkSMPTools, so that the cost of compression scales with the number
+ * of cores available on the sending and receiving processes.
+ *
+ * The compressed buffer is self-describing: it stores the method used, the
+ * chunk size and the size of each compressed chunk. Receivers can use
+ * IsCompressedBuffer() to determine if a buffer needs to be decompressed.
+*/
+
+#ifndef vtkPVBufferCompressor_h
+#define vtkPVBufferCompressor_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVBufferCompressor : public vtkObject
+{
+public:
+  static vtkPVBufferCompressor* New();
+  vtkTypeMacro(vtkPVBufferCompressor, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  enum Methods
+  {
+    NONE = 0,
+    ZLIB = 1,
+    LZ4 = 2
+  };
+
+  /**
+   * Returns a human readable name for the compression method.
+   */
+  static const char* GetMethodAsString(int method);
+
+#ifndef __WRAP__
+  /**
+   * Default size (in bytes) of the chunks compressed independently.
+   */
+  static const vtkIdType DEFAULT_CHUNK_SIZE = 1048576;
+
+  /**
+   * Compresses `length` bytes from `data` using the given method. `level` is
+   * the compression level used by ZLIB (1-9) and is ignored by LZ4. Returns a
+   * newly allocated buffer that the caller must release using `delete[]`, or
+   * NULL if method is NONE or compression failed.
+   */
+  static char* Compress(const char* data, vtkIdType length, int method, int level,
+    vtkIdType& compressedLength, vtkIdType chunkSize = DEFAULT_CHUNK_SIZE);
+
+  /**
+   * Returns true if the buffer was generated by Compress().
+   */
+  static bool IsCompressedBuffer(const char* buffer, vtkIdType length);
+
+  /**
+   * Decompresses a buffer generated by Compress(). Returns a newly allocated
+   * buffer that the caller must release using `delete[]`, or NULL on failure.
+   */
+  static char* Decompress(const char* buffer, vtkIdType length, vtkIdType& decompressedLength);
+#endif
+
+protected:
+  vtkPVBufferCompressor();
+  ~vtkPVBufferCompressor() override;
+
+private:
+  vtkPVBufferCompressor(const vtkPVBufferCompressor&) = delete;
+  void operator=(const vtkPVBufferCompressor&) = delete;
+};
+
+#endif
@@ -23,23 +23,63 @@
 #include "vtkProcessModule.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
 #include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
 //----------------------------------------------------------------------------
-class vtkPVCacheKeeper::vtkCacheMap : public std::map<double, vtkSmartPointer<vtkDataObject> >
+class vtkPVCacheKeeper::vtkCacheMap
 {
 public:
+  struct vtkEntry
+  {
+    vtkSmartPointer<vtkDataObject> Data;
+    // Size (in kbytes) reported to the vtkCacheSizeKeeper.
+    unsigned long Size;
+    vtkTypeUInt64 LastAccess;
+  };
+  typedef std::map<double, vtkEntry> MapType;
+  MapType Map;
+
   unsigned long GetActualMemorySize()
   {
     unsigned long actual_size = 0;
-    vtkCacheMap::iterator iter;
-    for (iter = this->begin(); iter != this->end(); ++iter)
+    for (MapType::iterator iter = this->Map.begin(); iter != this->Map.end(); ++iter)
     {
-      actual_size += iter->second.GetPointer()->GetActualMemorySize();
+      actual_size += iter->second.Size;
     }
     return actual_size;
   }
+
+  MapType::iterator GetLeastRecentlyUsed()
+  {
+    MapType::iterator lru = this->Map.end();
+    for (MapType::iterator iter = this->Map.begin(); iter != this->Map.end(); ++iter)
+    {
+      if (lru == this->Map.end() || iter->second.LastAccess < lru->second.LastAccess)
+      {
+        lru = iter;
+      }
+    }
+    return lru;
+  }
 };
 
+namespace
+{
+// All the cache keepers, for the eviction across filters.
+std::set<vtkPVCacheKeeper*>& GetCacheKeepers()
+{
+  static std::set<vtkPVCacheKeeper*> keepers;
+  return keepers;
+}
+
+// Incremented on every save or use of a cached entry.
+vtkTypeUInt64 AccessCounter = 0;
+}
+
 vtkStandardNewMacro(vtkPVCacheKeeper);
 vtkCxxSetObjectMacro(vtkPVCacheKeeper, CacheSizeKeeper, vtkCacheSizeKeeper);
 //----------------------------------------------------------------------------
@@ -47,6 +87,7 @@ int vtkPVCacheKeeper::CacheHit = 0;
 int vtkPVCacheKeeper::CacheMiss = 0;
 int vtkPVCacheKeeper::CacheSkips = 0;
 int vtkPVCacheKeeper::CacheClears = 0;
+int vtkPVCacheKeeper::CacheEvictions = 0;
 //----------------------------------------------------------------------------
 vtkPVCacheKeeper::vtkPVCacheKeeper()
 {
@@ -54,12 +95,15 @@ vtkPVCacheKeeper::vtkPVCacheKeeper()
   this->CacheTime = 0.0;
   this->CachingEnabled = true;
   this->CacheSizeKeeper = 0;
+  this->MaximumNumberOfCachedEntries = 0;
   this->SetCacheSizeKeeper(vtkCacheSizeKeeper::GetInstance());
+  GetCacheKeepers().insert(this);
 }
 
 //----------------------------------------------------------------------------
 vtkPVCacheKeeper::~vtkPVCacheKeeper()
 {
+  GetCacheKeepers().erase(this);
   this->RemoveAllCaches();
 
   // Unset cache keeper only after having cleared the cache.
@@ -74,7 +118,7 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 {
   // cout << this << " RemoveAllCaches" << endl;
   unsigned long freed_size = this->Cache->GetActualMemorySize();
-  this->Cache->clear();
+  this->Cache->Map.clear();
   if (freed_size > 0 && this->CacheSizeKeeper)
   {
     // Tell the cache size keeper about the newly freed memory size.
@@ -89,8 +133,96 @@ void vtkPVCacheKeeper::RemoveAllCaches()
 //----------------------------------------------------------------------------
 bool vtkPVCacheKeeper::IsCached(double cacheTime)
 {
-  vtkPVCacheKeeper::vtkCacheMap::iterator iter = this->Cache->find(cacheTime);
-  return (iter != this->Cache->end());
+  return this->Cache->Map.find(cacheTime) != this->Cache->Map.end();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVCacheKeeper::GetNumberOfCachedEntries()
+{
+  return static_cast<int>(this->Cache->Map.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::EvictLeastRecentlyUsedEntry()
+{
+  vtkCacheMap::MapType::iterator iter = this->Cache->GetLeastRecentlyUsed();
+  if (iter == this->Cache->Map.end())
+  {
+    return;
+  }
+  if (this->CacheSizeKeeper)
+  {
+    this->CacheSizeKeeper->RecordEviction(iter->second.Size);
+  }
+  this->Cache->Map.erase(iter);
+  ++vtkPVCacheKeeper::CacheEvictions;
+
+  // this method should never mark the filter modified !!!
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVCacheKeeper::GetNumberOfEntriesToEvict(vtkCacheSizeKeeper* keeper)
+{
+  if (!keeper || keeper->GetEvictionPolicy() != vtkCacheSizeKeeper::LRU ||
+    keeper->GetCacheSize() <= keeper->GetCacheLimit())
+  {
+    return 0;
+  }
+
+  std::vector<std::pair<vtkTypeUInt64, unsigned long> > entries;
+  const std::set<vtkPVCacheKeeper*>& keepers = GetCacheKeepers();
+  for (std::set<vtkPVCacheKeeper*>::const_iterator kiter = keepers.begin(); kiter != keepers.end();
+       ++kiter)
+  {
+    if ((*kiter)->CacheSizeKeeper != keeper)
+    {
+      continue;
+    }
+    const vtkCacheMap::MapType& map = (*kiter)->Cache->Map;
+    for (vtkCacheMap::MapType::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+    {
+      entries.push_back(std::make_pair(iter->second.LastAccess, iter->second.Size));
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  unsigned long size = keeper->GetCacheSize();
+  vtkIdType count = 0;
+  for (size_t cc = 0; cc < entries.size() && size > keeper->GetCacheLimit(); ++cc, ++count)
+  {
+    size -= std::min(size, entries[cc].second);
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCacheKeeper::EvictLeastRecentlyUsed(vtkCacheSizeKeeper* keeper, vtkIdType count)
+{
+  const std::set<vtkPVCacheKeeper*>& keepers = GetCacheKeepers();
+  for (vtkIdType cc = 0; cc < count; ++cc)
+  {
+    vtkPVCacheKeeper* lruKeeper = NULL;
+    vtkTypeUInt64 lruAccess = 0;
+    for (std::set<vtkPVCacheKeeper*>::const_iterator kiter = keepers.begin();
+         kiter != keepers.end(); ++kiter)
+    {
+      if ((*kiter)->CacheSizeKeeper != keeper)
+      {
+        continue;
+      }
+      vtkCacheMap::MapType::iterator iter = (*kiter)->Cache->GetLeastRecentlyUsed();
+      if (iter != (*kiter)->Cache->Map.end() && (!lruKeeper || iter->second.LastAccess < lruAccess))
+      {
+        lruKeeper = *kiter;
+        lruAccess = iter->second.LastAccess;
+      }
+    }
+    if (!lruKeeper)
+    {
+      return;
+    }
+    lruKeeper->EvictLeastRecentlyUsedEntry();
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -98,15 +230,29 @@ bool vtkPVCacheKeeper::SaveData(vtkDataObject* output)
 {
   if (!this->CacheSizeKeeper || !this->CacheSizeKeeper->GetCacheFull())
   {
-    vtkSmartPointer<vtkDataObject> cache;
-    cache.TakeReference(output->NewInstance());
-    cache->ShallowCopy(output);
-    (*this->Cache)[this->CacheTime] = cache;
+    int maxEntries = this->MaximumNumberOfCachedEntries;
+    if (maxEntries == 0 && this->CacheSizeKeeper)
+    {
+      maxEntries = this->CacheSizeKeeper->GetMaximumNumberOfCachedEntries();
+    }
+    if (maxEntries > 0)
+    {
+      while (this->GetNumberOfCachedEntries() >= maxEntries)
+      {
+        this->EvictLeastRecentlyUsedEntry();
+      }
+    }
+
+    vtkCacheMap::vtkEntry& entry = this->Cache->Map[this->CacheTime];
+    entry.Data.TakeReference(output->NewInstance());
+    entry.Data->ShallowCopy(output);
+    entry.Size = entry.Data->GetActualMemorySize();
+    entry.LastAccess = ++AccessCounter;
 
     if (this->CacheSizeKeeper)
     {
       // Register used cache size.
-      this->CacheSizeKeeper->AddCacheSize(cache->GetActualMemorySize());
+      this->CacheSizeKeeper->AddCacheSize(entry.Size);
     }
     return true;
   }
@@ -165,7 +311,9 @@ int vtkPVCacheKeeper::RequestData(vtkInformation* vtkNotUsed(reqInfo),
   {
     if (this->IsCached(this->CacheTime))
     {
-      output->ShallowCopy((*this->Cache)[this->CacheTime]);
+      vtkCacheMap::vtkEntry& entry = this->Cache->Map[this->CacheTime];
+      entry.LastAccess = ++AccessCounter;
+      output->ShallowCopy(entry.Data);
       // cout << this << " using Cache: " << this->CacheTime << endl;
       vtkPVCacheKeeper::CacheHit++;
     }
@@ -193,6 +341,7 @@ void vtkPVCacheKeeper::ClearCacheStateFlags()
   vtkPVCacheKeeper::CacheMiss = 0;
   vtkPVCacheKeeper::CacheSkips = 0;
   vtkPVCacheKeeper::CacheClears = 0;
+  vtkPVCacheKeeper::CacheEvictions = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -219,8 +368,18 @@ int vtkPVCacheKeeper::GetCacheClears()
   return vtkPVCacheKeeper::CacheClears;
 }
 
+//----------------------------------------------------------------------------
+int vtkPVCacheKeeper::GetCacheEvictions()
+{
+  return vtkPVCacheKeeper::CacheEvictions;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVCacheKeeper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+  os << indent << "MaximumNumberOfCachedEntries: " << this->MaximumNumberOfCachedEntries << endl;
+  os << indent << "NumberOfCachedEntries: " << this->GetNumberOfCachedEntries() << endl;
 }
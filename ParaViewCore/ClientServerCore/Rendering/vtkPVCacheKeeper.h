@@ -22,6 +22,10 @@
  * then this filter shuts the update request, otherwise propagates the update
  * and then cache the result for later use.  The current time step is set using
  * SetCacheTime().
+ *
+ * Cached entries can be evicted, least recently used first, either when this
+ * filter holds more than MaximumNumberOfCachedEntries entries or when the
+ * vtkCacheSizeKeeper limit is exceeded and its EvictionPolicy is LRU.
  * @sa
  * vtkPVCacheKeeperPipeline
 */
@@ -71,6 +75,36 @@ public:
   vtkBooleanMacro(CachingEnabled, bool);
   //@}
 
+  //@{
+  /**
+   * Get/Set the maximum number of entries (time steps) cached by this filter.
+   * When it is reached, the least recently used entry is evicted before a new
+   * one is saved. 0 means that the vtkCacheSizeKeeper's
+   * MaximumNumberOfCachedEntries applies. Default is 0.
+   */
+  vtkSetClampMacro(MaximumNumberOfCachedEntries, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedEntries, int);
+  //@}
+
+  /**
+   * Returns the number of entries currently cached.
+   */
+  int GetNumberOfCachedEntries();
+
+  //@{
+  /**
+   * Least recently used eviction across all the vtkPVCacheKeeper instances
+   * reporting to the given vtkCacheSizeKeeper. GetNumberOfEntriesToEvict()
+   * returns how many of the least recently used entries must be evicted for
+   * the cache size to fit the keeper's limit, EvictLeastRecentlyUsed() evicts
+   * that many. Accesses are ordered by a counter that advances identically on
+   * all processes, so evicting the same number of entries everywhere keeps
+   * the processes in agreement about what is cached.
+   */
+  static vtkIdType GetNumberOfEntriesToEvict(vtkCacheSizeKeeper* keeper);
+  static void EvictLeastRecentlyUsed(vtkCacheSizeKeeper* keeper, vtkIdType count);
+  //@}
+
   //@{
   /**
    * These methods are used for testing. Using this global state we can add
@@ -82,6 +116,7 @@ public:
   static int GetCacheMisses();
   static int GetCacheSkips();
   static int GetCacheClears();
+  static int GetCacheEvictions();
   //@}
 
 protected:
@@ -112,6 +147,7 @@ protected:
   bool CachingEnabled;
   double CacheTime;
   vtkCacheSizeKeeper* CacheSizeKeeper;
+  int MaximumNumberOfCachedEntries;
 
 private:
   vtkPVCacheKeeper(const vtkPVCacheKeeper&) = delete;
@@ -120,10 +156,16 @@ private:
   class vtkCacheMap;
   vtkCacheMap* Cache;
 
+  /**
+   * Evicts the least recently used entry of this filter, if any.
+   */
+  void EvictLeastRecentlyUsedEntry();
+
   static int CacheHit;
   static int CacheMiss;
   static int CacheSkips;
   static int CacheClears;
+  static int CacheEvictions;
 };
 
 #endif
@@ -24,6 +24,8 @@ vtkStandardNewMacro(vtkPVCacheSizeInformation);
 vtkPVCacheSizeInformation::vtkPVCacheSizeInformation()
 {
   this->CacheSize = 0;
+  this->NumberOfEvictions = 0;
+  this->EvictedSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -48,13 +50,16 @@ void vtkPVCacheSizeInformation::CopyFromObject(vtkObject* obj)
     return;
   }
   this->CacheSize = csk->GetCacheSize();
+  this->NumberOfEvictions = csk->GetNumberOfEvictions();
+  this->EvictedSize = csk->GetEvictedSize();
 }
 
 //-----------------------------------------------------------------------------
 void vtkPVCacheSizeInformation::CopyToStream(vtkClientServerStream* stream)
 {
   stream->Reset();
-  *stream << vtkClientServerStream::Reply << this->CacheSize << vtkClientServerStream::End;
+  *stream << vtkClientServerStream::Reply << this->CacheSize << this->NumberOfEvictions
+          << this->EvictedSize << vtkClientServerStream::End;
 }
 
 //-----------------------------------------------------------------------------
@@ -65,6 +70,16 @@ void vtkPVCacheSizeInformation::CopyFromStream(const vtkClientServerStream* stre
   {
     vtkErrorMacro("Error parsing CacheSize.");
   }
+  this->NumberOfEvictions = 0;
+  if (!stream->GetArgument(0, 1, &this->NumberOfEvictions))
+  {
+    vtkErrorMacro("Error parsing NumberOfEvictions.");
+  }
+  this->EvictedSize = 0;
+  if (!stream->GetArgument(0, 2, &this->EvictedSize))
+  {
+    vtkErrorMacro("Error parsing EvictedSize.");
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -77,6 +92,11 @@ void vtkPVCacheSizeInformation::AddInformation(vtkPVInformation* info)
     return;
   }
   this->CacheSize = (cinfo->CacheSize > this->CacheSize) ? cinfo->CacheSize : this->CacheSize;
+  this->NumberOfEvictions = (cinfo->NumberOfEvictions > this->NumberOfEvictions)
+    ? cinfo->NumberOfEvictions
+    : this->NumberOfEvictions;
+  this->EvictedSize =
+    (cinfo->EvictedSize > this->EvictedSize) ? cinfo->EvictedSize : this->EvictedSize;
 }
 
 //-----------------------------------------------------------------------------
@@ -84,4 +104,6 @@ void vtkPVCacheSizeInformation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
+  os << indent << "EvictedSize: " << this->EvictedSize << endl;
 }
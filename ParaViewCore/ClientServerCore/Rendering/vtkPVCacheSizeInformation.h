@@ -17,7 +17,8 @@
  * @brief   information obeject to
  * collect cache size information from a vtkCacheSizeKeeper.
  *
- * Gather information about cache size from vtkCacheSizeKeeper.
+ * Gather information about cache size and evictions from vtkCacheSizeKeeper.
+ * When merged, the largest values reported by any process are kept.
 */
 
 #ifndef vtkPVCacheSizeInformation_h
@@ -54,11 +55,23 @@ public:
   vtkGetMacro(CacheSize, unsigned long);
   vtkSetMacro(CacheSize, unsigned long);
 
+  //@{
+  /**
+   * Number of cache entries evicted and their total size (in kbytes).
+   */
+  vtkGetMacro(NumberOfEvictions, vtkTypeUInt64);
+  vtkSetMacro(NumberOfEvictions, vtkTypeUInt64);
+  vtkGetMacro(EvictedSize, vtkTypeUInt64);
+  vtkSetMacro(EvictedSize, vtkTypeUInt64);
+  //@}
+
 protected:
   vtkPVCacheSizeInformation();
   ~vtkPVCacheSizeInformation() override;
 
   unsigned long CacheSize;
+  vtkTypeUInt64 NumberOfEvictions;
+  vtkTypeUInt64 EvictedSize;
 
 private:
   vtkPVCacheSizeInformation(const vtkPVCacheSizeInformation&) = delete;
@@ -15,6 +15,7 @@
 #include "vtkPVDataDeliveryManager.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkDataObject.h"
 #include "vtkExtentTranslator.h"
 #include "vtkKdTreeManager.h"
@@ -879,7 +880,17 @@ void vtkPVDataDeliveryManager::DeliverStreamedPieces(unsigned int size, unsigned
     // really necessary). We can API to allow representations to be able to
     // specify the data type.
     vtkDataObject* data = item->GetDataObject();
-    vtkDataObject* piece = item->GetStreamedPiece();
+    vtkSmartPointer<vtkDataObject> piece = item->GetStreamedPiece();
+    if (piece == nullptr && data != nullptr)
+    {
+      // this process has nothing left to stream for this representation,
+      // while others do. Send an empty piece with a matching structure.
+      piece.TakeReference(data->NewInstance());
+      if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data))
+      {
+        vtkCompositeDataSet::SafeDownCast(piece)->CopyStructure(cd);
+      }
+    }
 
     vtkNew<vtkMPIMoveData> dataMover;
     dataMover->InitializeForCommunicationForParaView();
@@ -0,0 +1,1097 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataObjectMarshaler.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVDataObjectMarshaler.h"
+
+#include "vtkAMRBox.h"
+#include "vtkAMRInformation.h"
+#include "vtkByteSwap.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataObjectTypes.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkOverlappingAMR.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTimerLog.h"
+#include "vtkUniformGrid.h"
+#include "vtkUniformGridAMR.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Header layout: 4 bytes magic, 1 byte version, 1 byte endianness,
+// 1 byte sizeof(vtkIdType), 1 byte reserved.
+const char MAGIC[4] = { 'p', 'v', 'b', 'm' };
+const unsigned char VERSION = 1;
+const size_t HEADER_SIZE = 8;
+const vtkTypeInt32 NULL_OBJECT = -1;
+
+unsigned char GetNativeEndianness()
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// BufferWriter is used twice: once with a NULL buffer to compute the total
+// size and once to fill the allocated buffer.
+class BufferWriter
+{
+public:
+  BufferWriter(char* buffer)
+    : Buffer(buffer)
+    , Offset(0)
+  {
+  }
+
+  void WriteBytes(const void* data, size_t size)
+  {
+    if (this->Buffer && size > 0)
+    {
+      memcpy(this->Buffer + this->Offset, data, size);
+    }
+    this->Offset += size;
+  }
+
+  template <typename T>
+  void WriteValue(const T& value)
+  {
+    this->WriteBytes(&value, sizeof(T));
+  }
+
+  void WriteString(const char* str)
+  {
+    vtkTypeInt32 len = str ? static_cast<vtkTypeInt32>(strlen(str)) : -1;
+    this->WriteValue(len);
+    if (len > 0)
+    {
+      this->WriteBytes(str, static_cast<size_t>(len));
+    }
+  }
+
+  char* Buffer;
+  size_t Offset;
+};
+
+//-----------------------------------------------------------------------------
+class BufferReader
+{
+public:
+  BufferReader(const char* buffer, size_t length)
+    : Buffer(buffer)
+    , Length(length)
+    , Offset(0)
+    , Swap(false)
+  {
+  }
+
+  bool ReadBytes(void* data, size_t size)
+  {
+    if (this->Offset + size > this->Length)
+    {
+      return false;
+    }
+    if (size > 0)
+    {
+      memcpy(data, this->Buffer + this->Offset, size);
+    }
+    this->Offset += size;
+    return true;
+  }
+
+  template <typename T>
+  bool ReadValue(T& value)
+  {
+    if (!this->ReadBytes(&value, sizeof(T)))
+    {
+      return false;
+    }
+    if (this->Swap && sizeof(T) > 1)
+    {
+      vtkByteSwap::SwapVoidRange(&value, 1, static_cast<int>(sizeof(T)));
+    }
+    return true;
+  }
+
+  bool ReadString(std::string& str, bool& valid)
+  {
+    vtkTypeInt32 len;
+    if (!this->ReadValue(len))
+    {
+      return false;
+    }
+    valid = (len >= 0);
+    str.clear();
+    if (len > 0)
+    {
+      if (this->Offset + static_cast<size_t>(len) > this->Length)
+      {
+        return false;
+      }
+      str.assign(this->Buffer + this->Offset, static_cast<size_t>(len));
+      this->Offset += static_cast<size_t>(len);
+    }
+    return true;
+  }
+
+  const char* Buffer;
+  size_t Length;
+  size_t Offset;
+  bool Swap;
+};
+
+//-----------------------------------------------------------------------------
+bool CanMarshalArray(vtkAbstractArray* array)
+{
+  vtkDataArray* da = vtkDataArray::SafeDownCast(array);
+  if (!da || da->GetDataType() == VTK_BIT || !da->HasStandardMemoryLayout())
+  {
+    return false;
+  }
+  switch (da->GetDataType())
+  {
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_UNSIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_UNSIGNED_SHORT:
+    case VTK_INT:
+    case VTK_UNSIGNED_INT:
+    case VTK_LONG:
+    case VTK_UNSIGNED_LONG:
+    case VTK_LONG_LONG:
+    case VTK_UNSIGNED_LONG_LONG:
+    case VTK_FLOAT:
+    case VTK_DOUBLE:
+    case VTK_ID_TYPE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool CanMarshalFieldData(vtkFieldData* fd)
+{
+  if (!fd)
+  {
+    return true;
+  }
+  for (int cc = 0; cc < fd->GetNumberOfArrays(); ++cc)
+  {
+    if (!CanMarshalArray(fd->GetAbstractArray(cc)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool CanMarshalDataSetAttributes(vtkDataSet* ds)
+{
+  return CanMarshalFieldData(ds->GetPointData()) && CanMarshalFieldData(ds->GetCellData());
+}
+
+//-----------------------------------------------------------------------------
+bool CanMarshalDataObject(vtkDataObject* data)
+{
+  if (!data)
+  {
+    return true;
+  }
+  if (!CanMarshalFieldData(data->GetFieldData()))
+  {
+    return false;
+  }
+  switch (data->GetDataObjectType())
+  {
+    case VTK_POLY_DATA:
+    case VTK_UNSTRUCTURED_GRID:
+    case VTK_STRUCTURED_GRID:
+    {
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(data);
+      if (ps->GetPoints() && !CanMarshalArray(ps->GetPoints()->GetData()))
+      {
+        return false;
+      }
+      return CanMarshalDataSetAttributes(ps);
+    }
+
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_UNIFORM_GRID:
+      return CanMarshalDataSetAttributes(vtkDataSet::SafeDownCast(data));
+
+    case VTK_RECTILINEAR_GRID:
+    {
+      vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(data);
+      vtkDataArray* coords[3] = { rg->GetXCoordinates(), rg->GetYCoordinates(),
+        rg->GetZCoordinates() };
+      for (int cc = 0; cc < 3; ++cc)
+      {
+        if (coords[cc] && !CanMarshalArray(coords[cc]))
+        {
+          return false;
+        }
+      }
+      return CanMarshalDataSetAttributes(rg);
+    }
+
+    case VTK_MULTIBLOCK_DATA_SET:
+    {
+      vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data);
+      for (unsigned int cc = 0; cc < mb->GetNumberOfBlocks(); ++cc)
+      {
+        if (!CanMarshalDataObject(mb->GetBlock(cc)))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    case VTK_MULTIPIECE_DATA_SET:
+    {
+      vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data);
+      for (unsigned int cc = 0; cc < mp->GetNumberOfPieces(); ++cc)
+      {
+        if (!CanMarshalDataObject(mp->GetPieceAsDataObject(cc)))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    case VTK_OVERLAPPING_AMR:
+    case VTK_NON_OVERLAPPING_AMR:
+    {
+      vtkUniformGridAMR* amr = vtkUniformGridAMR::SafeDownCast(data);
+      for (unsigned int level = 0; level < amr->GetNumberOfLevels(); ++level)
+      {
+        for (unsigned int idx = 0; idx < amr->GetNumberOfDataSets(level); ++idx)
+        {
+          if (!CanMarshalDataObject(amr->GetDataSet(level, idx)))
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void WriteArray(BufferWriter& writer, vtkDataArray* array)
+{
+  vtkTypeInt32 present = array ? 1 : 0;
+  writer.WriteValue(present);
+  if (!array)
+  {
+    return;
+  }
+
+  const vtkTypeInt32 numComps = array->GetNumberOfComponents();
+  const vtkTypeInt64 numTuples = array->GetNumberOfTuples();
+  writer.WriteString(array->GetName());
+  writer.WriteValue(static_cast<vtkTypeInt32>(array->GetDataType()));
+  writer.WriteValue(static_cast<vtkTypeInt32>(array->GetDataTypeSize()));
+  writer.WriteValue(numComps);
+  writer.WriteValue(numTuples);
+
+  vtkTypeInt32 hasComponentNames = array->HasAComponentName() ? 1 : 0;
+  writer.WriteValue(hasComponentNames);
+  if (hasComponentNames)
+  {
+    for (int cc = 0; cc < numComps; ++cc)
+    {
+      writer.WriteString(array->GetComponentName(cc));
+    }
+  }
+
+  const size_t numBytes =
+    static_cast<size_t>(numTuples) * numComps * static_cast<size_t>(array->GetDataTypeSize());
+  writer.WriteBytes(numBytes > 0 ? array->GetVoidPointer(0) : NULL, numBytes);
+}
+
+//-----------------------------------------------------------------------------
+bool ReadArray(BufferReader& reader, vtkSmartPointer<vtkDataArray>& array)
+{
+  array = NULL;
+
+  vtkTypeInt32 present;
+  if (!reader.ReadValue(present))
+  {
+    return false;
+  }
+  if (!present)
+  {
+    return true;
+  }
+
+  std::string name;
+  bool hasName;
+  vtkTypeInt32 dataType, dataTypeSize, numComps;
+  vtkTypeInt64 numTuples;
+  if (!reader.ReadString(name, hasName) || !reader.ReadValue(dataType) ||
+    !reader.ReadValue(dataTypeSize) || !reader.ReadValue(numComps) ||
+    !reader.ReadValue(numTuples) || numComps < 1 || numTuples < 0)
+  {
+    return false;
+  }
+
+  array.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  if (!array || array->GetDataTypeSize() != dataTypeSize)
+  {
+    vtkGenericWarningMacro("Cannot unmarshal array of type "
+      << dataType << " with value size " << dataTypeSize << ".");
+    array = NULL;
+    return false;
+  }
+  if (hasName)
+  {
+    array->SetName(name.c_str());
+  }
+  array->SetNumberOfComponents(numComps);
+
+  vtkTypeInt32 hasComponentNames;
+  if (!reader.ReadValue(hasComponentNames))
+  {
+    return false;
+  }
+  if (hasComponentNames)
+  {
+    for (int cc = 0; cc < numComps; ++cc)
+    {
+      std::string compName;
+      bool hasCompName;
+      if (!reader.ReadString(compName, hasCompName))
+      {
+        return false;
+      }
+      if (hasCompName)
+      {
+        array->SetComponentName(cc, compName.c_str());
+      }
+    }
+  }
+
+  const size_t numBytes =
+    static_cast<size_t>(numTuples) * numComps * static_cast<size_t>(dataTypeSize);
+  if (reader.Offset + numBytes > reader.Length)
+  {
+    return false;
+  }
+  array->SetNumberOfTuples(static_cast<vtkIdType>(numTuples));
+  if (numBytes > 0)
+  {
+    void* ptr = array->GetVoidPointer(0);
+    reader.ReadBytes(ptr, numBytes);
+    if (reader.Swap && dataTypeSize > 1)
+    {
+      vtkByteSwap::SwapVoidRange(ptr, static_cast<size_t>(numTuples) * numComps, dataTypeSize);
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void WriteFieldData(BufferWriter& writer, vtkFieldData* fd)
+{
+  vtkTypeInt32 numArrays = fd ? fd->GetNumberOfArrays() : 0;
+  writer.WriteValue(numArrays);
+  for (int cc = 0; cc < numArrays; ++cc)
+  {
+    WriteArray(writer, vtkDataArray::SafeDownCast(fd->GetAbstractArray(cc)));
+  }
+
+  vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+  if (dsa)
+  {
+    int indices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    dsa->GetAttributeIndices(indices);
+    for (int cc = 0; cc < vtkDataSetAttributes::NUM_ATTRIBUTES; ++cc)
+    {
+      writer.WriteValue(static_cast<vtkTypeInt32>(indices[cc]));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool ReadFieldData(BufferReader& reader, vtkFieldData* fd)
+{
+  vtkTypeInt32 numArrays;
+  if (!reader.ReadValue(numArrays) || numArrays < 0)
+  {
+    return false;
+  }
+  fd->Initialize();
+  for (int cc = 0; cc < numArrays; ++cc)
+  {
+    vtkSmartPointer<vtkDataArray> array;
+    if (!ReadArray(reader, array))
+    {
+      return false;
+    }
+    if (array)
+    {
+      fd->AddArray(array);
+    }
+  }
+
+  vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+  if (dsa)
+  {
+    for (int cc = 0; cc < vtkDataSetAttributes::NUM_ATTRIBUTES; ++cc)
+    {
+      vtkTypeInt32 index;
+      if (!reader.ReadValue(index))
+      {
+        return false;
+      }
+      if (index >= 0 && index < numArrays)
+      {
+        dsa->SetActiveAttribute(index, cc);
+      }
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void WritePoints(BufferWriter& writer, vtkPoints* points)
+{
+  WriteArray(writer, points ? points->GetData() : NULL);
+}
+
+//-----------------------------------------------------------------------------
+bool ReadPoints(BufferReader& reader, vtkPointSet* ps)
+{
+  vtkSmartPointer<vtkDataArray> array;
+  if (!ReadArray(reader, array))
+  {
+    return false;
+  }
+  if (array)
+  {
+    vtkNew<vtkPoints> points;
+    points->SetData(array);
+    ps->SetPoints(points.GetPointer());
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void WriteCellArray(BufferWriter& writer, vtkCellArray* cells)
+{
+  vtkTypeInt64 numCells = cells ? cells->GetNumberOfCells() : 0;
+  writer.WriteValue(numCells);
+  WriteArray(writer, cells ? cells->GetData() : NULL);
+}
+
+//-----------------------------------------------------------------------------
+bool ReadCellArray(BufferReader& reader, vtkSmartPointer<vtkCellArray>& cells)
+{
+  cells = NULL;
+  vtkTypeInt64 numCells;
+  vtkSmartPointer<vtkDataArray> array;
+  if (!reader.ReadValue(numCells) || !ReadArray(reader, array))
+  {
+    return false;
+  }
+  if (array)
+  {
+    vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(array);
+    if (!ids)
+    {
+      return false;
+    }
+    cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->SetCells(static_cast<vtkIdType>(numCells), ids);
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void WriteExtent(BufferWriter& writer, const int extent[6])
+{
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    writer.WriteValue(static_cast<vtkTypeInt32>(extent[cc]));
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool ReadExtent(BufferReader& reader, int extent[6])
+{
+  for (int cc = 0; cc < 6; ++cc)
+  {
+    vtkTypeInt32 value;
+    if (!reader.ReadValue(value))
+    {
+      return false;
+    }
+    extent[cc] = value;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void WriteDataObject(BufferWriter& writer, vtkDataObject* data)
+{
+  if (!data)
+  {
+    writer.WriteValue(NULL_OBJECT);
+    return;
+  }
+
+  const vtkTypeInt32 type = data->GetDataObjectType();
+  writer.WriteValue(type);
+  WriteFieldData(writer, data->GetFieldData());
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+  if (ds)
+  {
+    WriteFieldData(writer, ds->GetPointData());
+    WriteFieldData(writer, ds->GetCellData());
+  }
+
+  switch (type)
+  {
+    case VTK_POLY_DATA:
+    {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+      WritePoints(writer, pd->GetPoints());
+      WriteCellArray(writer, pd->GetVerts());
+      WriteCellArray(writer, pd->GetLines());
+      WriteCellArray(writer, pd->GetPolys());
+      WriteCellArray(writer, pd->GetStrips());
+    }
+    break;
+
+    case VTK_UNSTRUCTURED_GRID:
+    {
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+      WritePoints(writer, ug->GetPoints());
+      WriteCellArray(writer, ug->GetCells());
+      WriteArray(writer, ug->GetCellTypesArray());
+      WriteArray(writer, ug->GetCellLocationsArray());
+      WriteArray(writer, ug->GetFaceLocations());
+      WriteArray(writer, ug->GetFaces());
+    }
+    break;
+
+    case VTK_STRUCTURED_GRID:
+    {
+      vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(data);
+      WriteExtent(writer, sg->GetExtent());
+      WritePoints(writer, sg->GetPoints());
+    }
+    break;
+
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_UNIFORM_GRID:
+    {
+      vtkImageData* id = vtkImageData::SafeDownCast(data);
+      WriteExtent(writer, id->GetExtent());
+      writer.WriteBytes(id->GetOrigin(), 3 * sizeof(double));
+      writer.WriteBytes(id->GetSpacing(), 3 * sizeof(double));
+    }
+    break;
+
+    case VTK_RECTILINEAR_GRID:
+    {
+      vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(data);
+      WriteExtent(writer, rg->GetExtent());
+      WriteArray(writer, rg->GetXCoordinates());
+      WriteArray(writer, rg->GetYCoordinates());
+      WriteArray(writer, rg->GetZCoordinates());
+    }
+    break;
+
+    case VTK_MULTIBLOCK_DATA_SET:
+    case VTK_MULTIPIECE_DATA_SET:
+    {
+      vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data);
+      vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data);
+      const vtkTypeInt32 numBlocks = mb ? mb->GetNumberOfBlocks() : mp->GetNumberOfPieces();
+      writer.WriteValue(numBlocks);
+      for (vtkTypeInt32 cc = 0; cc < numBlocks; ++cc)
+      {
+        const char* name = NULL;
+        if (mb && mb->HasMetaData(cc) &&
+          mb->GetMetaData(cc)->Has(vtkCompositeDataSet::NAME()))
+        {
+          name = mb->GetMetaData(cc)->Get(vtkCompositeDataSet::NAME());
+        }
+        else if (mp && mp->HasMetaData(cc) &&
+          mp->GetMetaData(cc)->Has(vtkCompositeDataSet::NAME()))
+        {
+          name = mp->GetMetaData(cc)->Get(vtkCompositeDataSet::NAME());
+        }
+        writer.WriteString(name);
+        WriteDataObject(writer, mb ? mb->GetBlock(cc) : mp->GetPieceAsDataObject(cc));
+      }
+    }
+    break;
+
+    case VTK_OVERLAPPING_AMR:
+    case VTK_NON_OVERLAPPING_AMR:
+    {
+      vtkUniformGridAMR* amr = vtkUniformGridAMR::SafeDownCast(data);
+      vtkOverlappingAMR* oamr = vtkOverlappingAMR::SafeDownCast(data);
+      const vtkTypeInt32 numLevels = amr->GetNumberOfLevels();
+      writer.WriteValue(numLevels);
+      for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+      {
+        writer.WriteValue(static_cast<vtkTypeInt32>(amr->GetNumberOfDataSets(level)));
+      }
+      writer.WriteValue(static_cast<vtkTypeInt32>(amr->GetGridDescription()));
+      if (oamr)
+      {
+        writer.WriteBytes(oamr->GetOrigin(), 3 * sizeof(double));
+        const bool hasRefinement = oamr->GetAMRInfo()->HasRefinementRatio();
+        for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+        {
+          double spacing[3];
+          oamr->GetSpacing(level, spacing);
+          writer.WriteBytes(spacing, 3 * sizeof(double));
+          writer.WriteValue(
+            static_cast<vtkTypeInt32>(hasRefinement ? oamr->GetRefinementRatio(level) : -1));
+        }
+      }
+      for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+      {
+        for (unsigned int idx = 0; idx < amr->GetNumberOfDataSets(level); ++idx)
+        {
+          if (oamr)
+          {
+            const vtkAMRBox& box = oamr->GetAMRBox(level, idx);
+            int corners[6];
+            std::copy(box.GetLoCorner(), box.GetLoCorner() + 3, corners);
+            std::copy(box.GetHiCorner(), box.GetHiCorner() + 3, corners + 3);
+            WriteExtent(writer, corners);
+          }
+          WriteDataObject(writer, amr->GetDataSet(level, idx));
+        }
+      }
+    }
+    break;
+
+    default:
+      // CanMarshal() prevents us from getting here.
+      assert(false);
+      break;
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool ReadDoubles(BufferReader& reader, double values[3])
+{
+  for (int cc = 0; cc < 3; ++cc)
+  {
+    if (!reader.ReadValue(values[cc]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> ReadDataObject(BufferReader& reader, bool& status)
+{
+  status = false;
+  vtkTypeInt32 type;
+  if (!reader.ReadValue(type))
+  {
+    return NULL;
+  }
+  if (type == NULL_OBJECT)
+  {
+    status = true;
+    return NULL;
+  }
+
+  vtkSmartPointer<vtkDataObject> data;
+  data.TakeReference(vtkDataObjectTypes::NewDataObject(type));
+  if (!data || !ReadFieldData(reader, data->GetFieldData()))
+  {
+    return NULL;
+  }
+
+  vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+  if (ds && (!ReadFieldData(reader, ds->GetPointData()) ||
+              !ReadFieldData(reader, ds->GetCellData())))
+  {
+    return NULL;
+  }
+
+  switch (type)
+  {
+    case VTK_POLY_DATA:
+    {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(data);
+      vtkSmartPointer<vtkCellArray> verts, lines, polys, strips;
+      if (!ReadPoints(reader, pd) || !ReadCellArray(reader, verts) ||
+        !ReadCellArray(reader, lines) || !ReadCellArray(reader, polys) ||
+        !ReadCellArray(reader, strips))
+      {
+        return NULL;
+      }
+      pd->SetVerts(verts);
+      pd->SetLines(lines);
+      pd->SetPolys(polys);
+      pd->SetStrips(strips);
+    }
+    break;
+
+    case VTK_UNSTRUCTURED_GRID:
+    {
+      vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(data);
+      vtkSmartPointer<vtkCellArray> cells;
+      vtkSmartPointer<vtkDataArray> types, locations, faceLocations, faces;
+      if (!ReadPoints(reader, ug) || !ReadCellArray(reader, cells) ||
+        !ReadArray(reader, types) || !ReadArray(reader, locations) ||
+        !ReadArray(reader, faceLocations) || !ReadArray(reader, faces))
+      {
+        return NULL;
+      }
+      if (cells)
+      {
+        vtkUnsignedCharArray* typesArray = vtkUnsignedCharArray::SafeDownCast(types);
+        vtkIdTypeArray* locationsArray = vtkIdTypeArray::SafeDownCast(locations);
+        if (!typesArray || !locationsArray)
+        {
+          return NULL;
+        }
+        ug->SetCells(typesArray, locationsArray, cells,
+          vtkIdTypeArray::SafeDownCast(faceLocations), vtkIdTypeArray::SafeDownCast(faces));
+      }
+    }
+    break;
+
+    case VTK_STRUCTURED_GRID:
+    {
+      vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(data);
+      int extent[6];
+      if (!ReadExtent(reader, extent) || !ReadPoints(reader, sg))
+      {
+        return NULL;
+      }
+      sg->SetExtent(extent);
+    }
+    break;
+
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_UNIFORM_GRID:
+    {
+      vtkImageData* id = vtkImageData::SafeDownCast(data);
+      int extent[6];
+      double origin[3], spacing[3];
+      if (!ReadExtent(reader, extent) || !ReadDoubles(reader, origin) ||
+        !ReadDoubles(reader, spacing))
+      {
+        return NULL;
+      }
+      id->SetExtent(extent);
+      id->SetOrigin(origin);
+      id->SetSpacing(spacing);
+    }
+    break;
+
+    case VTK_RECTILINEAR_GRID:
+    {
+      vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(data);
+      int extent[6];
+      vtkSmartPointer<vtkDataArray> x, y, z;
+      if (!ReadExtent(reader, extent) || !ReadArray(reader, x) || !ReadArray(reader, y) ||
+        !ReadArray(reader, z))
+      {
+        return NULL;
+      }
+      rg->SetExtent(extent);
+      rg->SetXCoordinates(x);
+      rg->SetYCoordinates(y);
+      rg->SetZCoordinates(z);
+    }
+    break;
+
+    case VTK_MULTIBLOCK_DATA_SET:
+    case VTK_MULTIPIECE_DATA_SET:
+    {
+      vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(data);
+      vtkMultiPieceDataSet* mp = vtkMultiPieceDataSet::SafeDownCast(data);
+      vtkTypeInt32 numBlocks;
+      if (!reader.ReadValue(numBlocks) || numBlocks < 0)
+      {
+        return NULL;
+      }
+      if (mb)
+      {
+        mb->SetNumberOfBlocks(numBlocks);
+      }
+      else
+      {
+        mp->SetNumberOfPieces(numBlocks);
+      }
+      for (vtkTypeInt32 cc = 0; cc < numBlocks; ++cc)
+      {
+        std::string name;
+        bool hasName, blockStatus;
+        if (!reader.ReadString(name, hasName))
+        {
+          return NULL;
+        }
+        vtkSmartPointer<vtkDataObject> block = ReadDataObject(reader, blockStatus);
+        if (!blockStatus)
+        {
+          return NULL;
+        }
+        if (mb)
+        {
+          mb->SetBlock(cc, block);
+          if (hasName)
+          {
+            mb->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(), name.c_str());
+          }
+        }
+        else
+        {
+          mp->SetPiece(cc, block);
+          if (hasName)
+          {
+            mp->GetMetaData(cc)->Set(vtkCompositeDataSet::NAME(), name.c_str());
+          }
+        }
+      }
+    }
+    break;
+
+    case VTK_OVERLAPPING_AMR:
+    case VTK_NON_OVERLAPPING_AMR:
+    {
+      vtkUniformGridAMR* amr = vtkUniformGridAMR::SafeDownCast(data);
+      vtkOverlappingAMR* oamr = vtkOverlappingAMR::SafeDownCast(data);
+      vtkTypeInt32 numLevels, gridDescription;
+      if (!reader.ReadValue(numLevels) || numLevels < 0)
+      {
+        return NULL;
+      }
+      std::vector<int> blocksPerLevel(numLevels);
+      for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+      {
+        vtkTypeInt32 count;
+        if (!reader.ReadValue(count) || count < 0)
+        {
+          return NULL;
+        }
+        blocksPerLevel[level] = count;
+      }
+      if (!reader.ReadValue(gridDescription))
+      {
+        return NULL;
+      }
+      amr->Initialize(numLevels, numLevels > 0 ? &blocksPerLevel[0] : NULL);
+      amr->SetGridDescription(gridDescription);
+      if (oamr)
+      {
+        double origin[3];
+        if (!ReadDoubles(reader, origin))
+        {
+          return NULL;
+        }
+        oamr->SetOrigin(origin);
+        for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+        {
+          double spacing[3];
+          vtkTypeInt32 ratio;
+          if (!ReadDoubles(reader, spacing) || !reader.ReadValue(ratio))
+          {
+            return NULL;
+          }
+          oamr->SetSpacing(level, spacing);
+          if (ratio > 0)
+          {
+            oamr->SetRefinementRatio(level, ratio);
+          }
+        }
+      }
+      for (vtkTypeInt32 level = 0; level < numLevels; ++level)
+      {
+        for (int idx = 0; idx < blocksPerLevel[level]; ++idx)
+        {
+          if (oamr)
+          {
+            int corners[6];
+            if (!ReadExtent(reader, corners))
+            {
+              return NULL;
+            }
+            oamr->SetAMRBox(level, idx, vtkAMRBox(corners, corners + 3));
+          }
+          bool blockStatus;
+          vtkSmartPointer<vtkDataObject> block = ReadDataObject(reader, blockStatus);
+          if (!blockStatus)
+          {
+            return NULL;
+          }
+          vtkUniformGrid* grid = vtkUniformGrid::SafeDownCast(block);
+          if (grid)
+          {
+            amr->SetDataSet(level, idx, grid);
+          }
+        }
+      }
+    }
+    break;
+
+    default:
+      vtkGenericWarningMacro("Cannot unmarshal data object of type " << type << ".");
+      return NULL;
+  }
+
+  status = true;
+  return data;
+}
+}
+
+vtkStandardNewMacro(vtkPVDataObjectMarshaler);
+//----------------------------------------------------------------------------
+vtkPVDataObjectMarshaler::vtkPVDataObjectMarshaler()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVDataObjectMarshaler::~vtkPVDataObjectMarshaler()
+{
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataObjectMarshaler::CanMarshal(vtkDataObject* data)
+{
+  return data != NULL && CanMarshalDataObject(data);
+}
+
+//----------------------------------------------------------------------------
+char* vtkPVDataObjectMarshaler::Marshal(vtkDataObject* data, vtkIdType& length)
+{
+  length = 0;
+  if (!vtkPVDataObjectMarshaler::CanMarshal(data))
+  {
+    return NULL;
+  }
+
+  vtkTimerLog::MarkStartEvent("Marshal data object");
+
+  // First pass: compute the size of the buffer.
+  BufferWriter sizer(NULL);
+  WriteDataObject(sizer, data);
+
+  const size_t total = HEADER_SIZE + sizer.Offset;
+  char* buffer = new char[total];
+  memcpy(buffer, MAGIC, 4);
+  buffer[4] = static_cast<char>(VERSION);
+  buffer[5] = static_cast<char>(GetNativeEndianness());
+  buffer[6] = static_cast<char>(sizeof(vtkIdType));
+  buffer[7] = 0;
+
+  // Second pass: copy every array into the buffer.
+  BufferWriter writer(buffer + HEADER_SIZE);
+  WriteDataObject(writer, data);
+  assert(writer.Offset == sizer.Offset);
+
+  vtkTimerLog::MarkEndEvent("Marshal data object");
+
+  length = static_cast<vtkIdType>(total);
+  return buffer;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVDataObjectMarshaler::IsMarshaledBuffer(const char* buffer, vtkIdType length)
+{
+  return buffer != NULL && length >= static_cast<vtkIdType>(HEADER_SIZE) &&
+    memcmp(buffer, MAGIC, 4) == 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkPVDataObjectMarshaler::Unmarshal(const char* buffer, vtkIdType length)
+{
+  if (!vtkPVDataObjectMarshaler::IsMarshaledBuffer(buffer, length))
+  {
+    vtkGenericWarningMacro("Buffer was not generated by vtkPVDataObjectMarshaler.");
+    return NULL;
+  }
+  if (static_cast<unsigned char>(buffer[4]) != VERSION)
+  {
+    vtkGenericWarningMacro(
+      "Unsupported marshaling version " << static_cast<int>(buffer[4]) << ".");
+    return NULL;
+  }
+  if (static_cast<size_t>(buffer[6]) != sizeof(vtkIdType))
+  {
+    vtkGenericWarningMacro("Sender and receiver use different vtkIdType sizes.");
+    return NULL;
+  }
+
+  vtkTimerLog::MarkStartEvent("Unmarshal data object");
+  BufferReader reader(buffer + HEADER_SIZE, static_cast<size_t>(length) - HEADER_SIZE);
+  reader.Swap = (static_cast<unsigned char>(buffer[5]) != GetNativeEndianness());
+
+  bool status;
+  vtkSmartPointer<vtkDataObject> data = ReadDataObject(reader, status);
+  vtkTimerLog::MarkEndEvent("Unmarshal data object");
+  if (!status || !data)
+  {
+    vtkGenericWarningMacro("Failed to unmarshal data object.");
+    return NULL;
+  }
+  data->Register(NULL);
+  return data.GetPointer();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVDataObjectMarshaler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVDataObjectMarshaler.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPVDataObjectMarshaler
+ * @brief   binary, array-level marshaling of data objects.
+ *
+ * vtkPVDataObjectMarshaler serializes a data object into a single buffer
+ * made of a small header followed by the raw memory of each of its arrays
+ * (points, connectivity, attributes). Unlike vtkGenericDataObjectWriter, no
+ * formatting or per-value encoding takes place: the total size is computed
+ * first and each array is copied exactly once into the outgoing buffer.
+ * Likewise, Unmarshal() copies each array exactly once out of the received
+ * buffer.
+ *
+ * Supported types are vtkPolyData, vtkUnstructuredGrid, vtkImageData (and
+ * subclasses), vtkRectilinearGrid, vtkStructuredGrid, vtkMultiBlockDataSet,
+ * vtkMultiPieceDataSet, vtkOverlappingAMR and vtkNonOverlappingAMR whose
+ * arrays are all vtkDataArray subclasses with the standard
+ * array-of-structures memory layout. Use CanMarshal() to check whether a data
+ * object is supported; callers are expected to fall back to the legacy
+ * writer/reader otherwise.
+ *
+ * The receiver byte-swaps the arrays if the sender had a different
+ * endianness. Arrays whose value size differs between sender and receiver
+ * (e.g. vtkIdType or long) are not converted and result in an error.
+ *
+ * @sa vtkMPIMoveData vtkClientServerMoveData
+*/
+
+#ifndef vtkPVDataObjectMarshaler_h
+#define vtkPVDataObjectMarshaler_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+
+class vtkDataObject;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVDataObjectMarshaler : public vtkObject
+{
+public:
+  static vtkPVDataObjectMarshaler* New();
+  vtkTypeMacro(vtkPVDataObjectMarshaler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  /**
+   * Returns true if the data object (and all its blocks, for composite
+   * datasets) can be marshaled by this class.
+   */
+  static bool CanMarshal(vtkDataObject* data);
+
+#ifndef __WRAP__
+  /**
+   * Marshals the data object into a newly allocated buffer. The caller takes
+   * ownership of the returned buffer and must release it using `delete[]`.
+   * Returns NULL if the data object cannot be marshaled.
+   */
+  static char* Marshal(vtkDataObject* data, vtkIdType& length);
+
+  /**
+   * Returns true if the buffer starts with the header written by Marshal().
+   */
+  static bool IsMarshaledBuffer(const char* buffer, vtkIdType length);
+
+  /**
+   * Reconstructs a data object from a buffer generated by Marshal(). Returns
+   * a new instance that the caller must release, or NULL on failure.
+   */
+  static vtkDataObject* Unmarshal(const char* buffer, vtkIdType length);
+#endif
+
+protected:
+  vtkPVDataObjectMarshaler();
+  ~vtkPVDataObjectMarshaler() override;
+
+private:
+  vtkPVDataObjectMarshaler(const vtkPVDataObjectMarshaler&) = delete;
+  void operator=(const vtkPVDataObjectMarshaler&) = delete;
+};
+
+#endif
@@ -108,7 +108,9 @@
 #include "vtkOSPRayRendererNode.h"
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <map>
 #include <set>
 #include <sstream>
@@ -359,6 +361,12 @@ vtkPVRenderView::vtkPVRenderView()
   this->RemoteRenderingThreshold = 0;
   this->LODRenderingThreshold = 0;
   this->LODResolution = 0.5;
+  this->NumberOfLODLevels = 1;
+  this->LODLevel = 0;
+  this->MinimumLODLevel = 0;
+  this->LODRenderTimeBudget = 0.0;
+  this->LODSizeBudget = 0.0;
+  this->LastInteractiveRenderTime = 0.0;
   this->UseOutlineForLODRendering = false;
   this->UseLightKit = false;
   this->Interactor = 0;
@@ -1210,6 +1218,10 @@ void vtkPVRenderView::Update()
   // information during update.
   this->GeometryBounds.Reset();
 
+  // the data may have changed, so the levels of the LOD hierarchy that
+  // exceeded the size budget may fit now.
+  this->MinimumLODLevel = 0;
+
   // reset flags that representations set in REQUEST_UPDATE() pass.
   this->DistributedRenderingRequired = false;
   this->NonDistributedRenderingRequired = false;
@@ -1305,22 +1317,41 @@ void vtkPVRenderView::UpdateLOD()
 
   // Update LOD geometry.
 
-  this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
-  if (this->UseOutlineForLODRendering)
-  {
-    this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
-  }
+  // Use coarser levels of the LOD hierarchy till the LOD geometry fits the
+  // size budget. Since the size is synchronized, all processes pick the same
+  // level. Representations keep the levels they generated, so going through
+  // several levels only decimates each of them once.
+  const int lastLevel = this->NumberOfLODLevels - 1;
+  int level = std::min(std::max(this->LODLevel, this->MinimumLODLevel), lastLevel);
+  double local_size = 0.0;
+  for (;; ++level)
+  {
+    this->RequestInformation->Set(
+      LOD_RESOLUTION(), this->LODResolution * std::pow(0.5, static_cast<double>(level)));
+    if (this->UseOutlineForLODRendering)
+    {
+      this->RequestInformation->Set(USE_OUTLINE_FOR_LOD(), 1);
+    }
 
-  // reset flags that representations set in REQUEST_UPDATE_LOD() pass.
-  this->DistributedRenderingRequiredLOD = false;
-  this->NonDistributedRenderingRequiredLOD = false;
+    // reset flags that representations set in REQUEST_UPDATE_LOD() pass.
+    this->DistributedRenderingRequiredLOD = false;
+    this->NonDistributedRenderingRequiredLOD = false;
 
-  this->CallProcessViewRequest(
-    vtkPVView::REQUEST_UPDATE_LOD(), this->RequestInformation, this->ReplyInformationVector);
+    this->CallProcessViewRequest(
+      vtkPVView::REQUEST_UPDATE_LOD(), this->RequestInformation, this->ReplyInformationVector);
 
-  double local_size = this->GetDeliveryManager()->GetVisibleDataSize(true) / 1024.0;
-  this->SynchronizedWindows->SynchronizeSize(local_size);
-  // cout << "LOD Geometry size: " << local_size << endl;
+    local_size = this->GetDeliveryManager()->GetVisibleDataSize(true) / 1024.0;
+    this->SynchronizedWindows->SynchronizeSize(local_size);
+    // cout << "LOD Geometry size: " << local_size << endl;
+
+    if (this->UseOutlineForLODRendering || this->LODSizeBudget <= 0.0 ||
+      local_size <= this->LODSizeBudget || level >= lastLevel)
+    {
+      break;
+    }
+    this->MinimumLODLevel = level + 1;
+  }
+  this->LODLevel = level;
 
   this->UseDistributedRenderingForInteractiveRender =
     this->ShouldUseDistributedRendering(local_size, /*using_lod=*/true);
@@ -1336,6 +1367,29 @@ void vtkPVRenderView::UpdateLOD()
   vtkTimerLog::MarkEndEvent("RenderView::UpdateLOD");
 }
 
+//----------------------------------------------------------------------------
+int vtkPVRenderView::GetSuggestedLODLevel()
+{
+  const int level = std::min(this->LODLevel, this->NumberOfLODLevels - 1);
+  if (this->LODRenderTimeBudget <= 0.0 || this->LastInteractiveRenderTime <= 0.0)
+  {
+    return level;
+  }
+  if (this->LastInteractiveRenderTime > this->LODRenderTimeBudget &&
+    level + 1 < this->NumberOfLODLevels)
+  {
+    return level + 1;
+  }
+  // A level has about a quarter of the triangles of the previous one, only go
+  // back to the finer level when it is expected to fit the budget too.
+  if (this->LastInteractiveRenderTime * 4.0 < this->LODRenderTimeBudget &&
+    level > this->MinimumLODLevel)
+  {
+    return level - 1;
+  }
+  return level;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::StillRender()
 {
@@ -1550,6 +1604,10 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     if (!this->MakingSelection)
     {
       this->Timer->StopTimer();
+      if (interactive)
+      {
+        this->LastInteractiveRenderTime = this->Timer->GetElapsedTime();
+      }
     }
   }
 
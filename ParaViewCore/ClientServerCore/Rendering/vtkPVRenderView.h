@@ -268,6 +268,65 @@ public:
   vtkGetMacro(UseOutlineForLODRendering, bool);
   //@}
 
+  //@{
+  /**
+   * Get/Set the number of levels in the LOD hierarchy. Level 0 uses the
+   * LODResolution and every following level halves the resolution of the
+   * previous one. Representations keep the geometry of each level until their
+   * data changes, hence switching between levels is cheap. Default is 1 i.e.
+   * a single LOD geometry.
+   * \note CallOnAllProcesses
+   */
+  vtkSetClampMacro(NumberOfLODLevels, int, 1, 8);
+  vtkGetMacro(NumberOfLODLevels, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the level of the LOD hierarchy to use in the next UpdateLOD().
+   * The level is clamped to the NumberOfLODLevels and may be raised in
+   * UpdateLOD() to respect the LODSizeBudget.
+   * \note CallOnAllProcesses
+   */
+  vtkSetMacro(LODLevel, int);
+  vtkGetMacro(LODLevel, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the time in seconds that interactive renders should take when
+   * using LOD. GetSuggestedLODLevel() uses it to pick a coarser level when
+   * the last interactive render was slower and a finer one when it was much
+   * faster. 0 (default) disables the adaptation.
+   * \note CallOnAllProcesses
+   */
+  vtkSetClampMacro(LODRenderTimeBudget, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LODRenderTimeBudget, double);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the size in megabytes of the LOD geometry to deliver. In
+   * UpdateLOD(), coarser levels are used till the LOD geometry fits this
+   * budget. 0 (default) implies no limit.
+   * \note CallOnAllProcesses
+   */
+  vtkSetClampMacro(LODSizeBudget, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LODSizeBudget, double);
+  //@}
+
+  /**
+   * Returns the time taken by the last interactive render on this process.
+   */
+  vtkGetMacro(LastInteractiveRenderTime, double);
+
+  /**
+   * Returns the level of the LOD hierarchy that the next interactive render
+   * should use given the time taken by the last interactive render and the
+   * LODRenderTimeBudget.
+   */
+  int GetSuggestedLODLevel();
+
   /**
    * Passes the compressor configuration to the client-server synchronizer, if
    * any. This affects the image compression used to relay images back to the
@@ -1105,6 +1164,13 @@ protected:
   vtkNew<vtkFXAAOptions> FXAAOptions;
 
   double LODResolution;
+  int NumberOfLODLevels;
+  int LODLevel;
+  // Levels finer than this one did not fit the LODSizeBudget.
+  int MinimumLODLevel;
+  double LODRenderTimeBudget;
+  double LODSizeBudget;
+  double LastInteractiveRenderTime;
   bool UseLightKit;
 
   bool UsedLODForLastRender;
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPVRenderViewSettings.h"
 
+#include "vtkMPIMoveData.h"
 #include "vtkMapper.h"
 #include "vtkObjectFactory.h"
 
@@ -96,6 +97,20 @@ void vtkPVRenderViewSettings::SetZShift(double val)
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderViewSettings::SetGeometryCompressionMethod(int method)
+{
+  vtkMPIMoveData::SetCompressionMethod(method);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderViewSettings::SetGeometryCompressionLevel(int level)
+{
+  vtkMPIMoveData::SetCompressionLevel(level);
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderViewSettings::PrintSelf(ostream& os, vtkIndent indent)
 {
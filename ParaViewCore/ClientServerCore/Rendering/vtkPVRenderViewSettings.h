@@ -78,6 +78,16 @@ public:
   vtkGetMacro(PointPickingRadius, int);
   //@}
 
+  //@{
+  /**
+   * Compression used when delivering geometry between processes.
+   * These simply forward to vtkMPIMoveData::SetCompressionMethod() and
+   * vtkMPIMoveData::SetCompressionLevel().
+   */
+  void SetGeometryCompressionMethod(int method);
+  void SetGeometryCompressionLevel(int level);
+  //@}
+
   //@{
   /**
    * EXPERIMENTAL: Add ability to disable IceT.
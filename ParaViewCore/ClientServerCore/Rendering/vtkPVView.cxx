@@ -20,6 +20,7 @@
 #include "vtkInformationRequestKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVCacheKeeper.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSession.h"
@@ -297,13 +298,26 @@ void vtkPVView::Update()
   if (this->GetUseCache())
   {
     vtkCacheSizeKeeper* cacheSizeKeeper = vtkCacheSizeKeeper::GetInstance();
-    unsigned int cache_full = 0;
-    if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
+    if (cacheSizeKeeper->GetEvictionPolicy() == vtkCacheSizeKeeper::LRU)
     {
-      cache_full = 1;
+      // Evict the least recently used entries to fit the cache limit. All
+      // processes evict the same number of entries, the largest needed by any
+      // of them, so that they agree on which time steps are cached.
+      vtkIdType count = vtkPVCacheKeeper::GetNumberOfEntriesToEvict(cacheSizeKeeper);
+      this->SynchronizedWindows->Reduce(count, vtkPVSynchronizedRenderWindows::MAX_OP);
+      vtkPVCacheKeeper::EvictLeastRecentlyUsed(cacheSizeKeeper, count);
+      cacheSizeKeeper->SetCacheFull(false);
+    }
+    else
+    {
+      unsigned int cache_full = 0;
+      if (cacheSizeKeeper->GetCacheSize() > cacheSizeKeeper->GetCacheLimit())
+      {
+        cache_full = 1;
+      }
+      this->SynchronizedWindows->SynchronizeSize(cache_full);
+      cacheSizeKeeper->SetCacheFull(cache_full > 0);
     }
-    this->SynchronizedWindows->SynchronizeSize(cache_full);
-    cacheSizeKeeper->SetCacheFull(cache_full > 0);
   }
 
   this->CallProcessViewRequest(
@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestClientServerStreamArraySpan.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks array views and move-in construction of vtkClientServerStream, and
+// compares copying large array arguments out of a stream with viewing them.
+
+#include "vtkClientServerStream.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace
+{
+double Seconds(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool CheckStream(const vtkClientServerStream& css, const std::vector<double>& values)
+{
+  vtkClientServerStream::ArraySpan<double> span;
+  if (!css.GetArgument(0, 1, &span) || span.GetLength() != values.size())
+  {
+    cerr << "ERROR: failed to view the double array." << endl;
+    return false;
+  }
+  for (vtkTypeUInt32 cc = 0; cc < span.GetLength(); ++cc)
+  {
+    if (span[cc] != values[cc])
+    {
+      cerr << "ERROR: wrong value at " << cc << ": " << span[cc] << endl;
+      return false;
+    }
+  }
+  const double* ptr = span.GetPointer();
+  if (ptr && ptr[values.size() - 1] != values.back())
+  {
+    cerr << "ERROR: wrong aligned pointer." << endl;
+    return false;
+  }
+
+  // Views are only available for arrays of the exact type.
+  vtkClientServerStream::ArraySpan<float> fspan;
+  vtkClientServerStream::ArraySpan<int> ispan;
+  if (css.GetArgument(0, 1, &fspan) || css.GetArgument(0, 0, &ispan) ||
+    !css.GetArgument(0, 2, &ispan) || ispan.GetLength() != 3 || ispan[2] != 3)
+  {
+    cerr << "ERROR: unexpected view of mismatched argument." << endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestClientServerStreamArraySpan(int, char* [])
+{
+  const vtkTypeUInt32 numValues = 1 << 20;
+  std::vector<double> values(numValues);
+  for (vtkTypeUInt32 cc = 0; cc < numValues; ++cc)
+  {
+    values[cc] = 0.5 * cc;
+  }
+  const int ivalues[] = { 1, 2, 3 };
+
+  vtkClientServerStream css;
+  css << vtkClientServerStream::Invoke << 1
+      << vtkClientServerStream::InsertArray(&values[0], static_cast<int>(numValues))
+      << vtkClientServerStream::InsertArray(ivalues, 3) << vtkClientServerStream::End;
+  if (!CheckStream(css, values))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Move the stream data into another stream.
+  const unsigned char* data;
+  size_t length;
+  css.GetData(&data, &length);
+  std::vector<unsigned char> buffer(data, data + length);
+  vtkClientServerStream moved(std::move(buffer));
+  if (!buffer.empty() || moved.GetNumberOfMessages() != 1 || !CheckStream(moved, values))
+  {
+    cerr << "ERROR: failed to construct stream from moved data." << endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<unsigned char> invalid(3, 255);
+  if (moved.SetData(std::move(invalid)) || moved.GetNumberOfMessages() != 0)
+  {
+    cerr << "ERROR: invalid data accepted." << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Compare reading the array argument by copy and by view.
+  const int iterations = 50;
+  std::vector<double> copy(numValues);
+  double copySum = 0.0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    vtkTypeUInt32 len = 0;
+    css.GetArgumentLength(0, 1, &len);
+    css.GetArgument(0, 1, &copy[0], len);
+    copySum += copy[len - 1];
+  }
+  const double copyTime = Seconds(start);
+
+  double spanSum = 0.0;
+  start = std::chrono::steady_clock::now();
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    vtkClientServerStream::ArraySpan<double> span;
+    css.GetArgument(0, 1, &span);
+    spanSum += span[span.GetLength() - 1];
+  }
+  const double spanTime = Seconds(start);
+
+  std::vector<unsigned char> streamData(data, data + length);
+  start = std::chrono::steady_clock::now();
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    vtkClientServerStream received;
+    received.SetData(&streamData[0], streamData.size());
+  }
+  const double setDataTime = Seconds(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int iter = 0; iter < iterations; ++iter)
+  {
+    vtkClientServerStream received(std::move(streamData));
+    received.GetData(&data, &length);
+    streamData.assign(data, data + length);
+  }
+  const double moveTime = Seconds(start);
+
+  if (copySum != spanSum)
+  {
+    cerr << "ERROR: copy and view disagree." << endl;
+    return EXIT_FAILURE;
+  }
+  cout << "array of " << numValues << " doubles, " << iterations << " iterations:" << endl
+       << "  GetArgument copy: " << copyTime << "s, view: " << spanTime << "s" << endl
+       << "  SetData copy: " << setDataTime << "s, move (with refill): " << moveTime << "s"
+       << endl;
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
 
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 //----------------------------------------------------------------------------
@@ -273,6 +274,14 @@ vtkClientServerStream::vtkClientServerStream(const vtkClientServerStream& r, vtk
   this->Internal = new vtkClientServerStreamInternals(*r.Internal, owner);
 }
 
+//----------------------------------------------------------------------------
+vtkClientServerStream::vtkClientServerStream(
+  std::vector<unsigned char>&& data, vtkObjectBase* owner)
+{
+  this->Internal = new vtkClientServerStreamInternals(owner);
+  this->SetData(std::move(data));
+}
+
 //----------------------------------------------------------------------------
 vtkClientServerStream& vtkClientServerStream::operator=(const vtkClientServerStream& that)
 {
@@ -1084,6 +1093,63 @@ VTK_CSS_GET_ARGUMENT_ARRAY(unsigned __int64)
 #endif
 #undef VTK_CSS_GET_ARGUMENT_ARRAY
 
+//----------------------------------------------------------------------------
+// Template and macro to implement array view GetArgument methods in the same
+// way.
+template <class T>
+int vtkClientServerStreamGetArgumentSpan(const vtkClientServerStream* self, int midx,
+  int argument, vtkClientServerStream::ArraySpan<T>* value)
+{
+  typedef VTK_CSS_TYPENAME vtkTypeTraits<T>::SizedType Type;
+  if (const unsigned char* data =
+        vtkClientServerStreamInternals::GetValue(*self, midx, 1 + argument))
+  {
+    // Get the type of the value in the stream.
+    vtkTypeUInt32 tp;
+    memcpy(&tp, data, sizeof(tp));
+    data += sizeof(tp);
+
+    // Only arrays of the exact type can be viewed.
+    if (static_cast<vtkClientServerStream::Types>(tp) == vtkClientServerTypeTraits<Type>::Array())
+    {
+      // Get the length of the value in the stream.
+      vtkTypeUInt32 len;
+      memcpy(&len, data, sizeof(len));
+      data += sizeof(len);
+
+      *value = vtkClientServerStream::ArraySpan<T>(data, len);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+#define VTK_CSS_GET_ARGUMENT_SPAN(type)                                                            \
+  int vtkClientServerStream::GetArgument(int message, int argument, ArraySpan<type>* value) const  \
+  {                                                                                                \
+    return vtkClientServerStreamGetArgumentSpan(this, message, argument, value);                   \
+  }
+VTK_CSS_GET_ARGUMENT_SPAN(signed char)
+VTK_CSS_GET_ARGUMENT_SPAN(char)
+VTK_CSS_GET_ARGUMENT_SPAN(int)
+VTK_CSS_GET_ARGUMENT_SPAN(short)
+VTK_CSS_GET_ARGUMENT_SPAN(long)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned char)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned int)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned short)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned long)
+VTK_CSS_GET_ARGUMENT_SPAN(float)
+VTK_CSS_GET_ARGUMENT_SPAN(double)
+#if defined(VTK_TYPE_USE_LONG_LONG)
+VTK_CSS_GET_ARGUMENT_SPAN(long long)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned long long)
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+VTK_CSS_GET_ARGUMENT_SPAN(__int64)
+VTK_CSS_GET_ARGUMENT_SPAN(unsigned __int64)
+#endif
+#undef VTK_CSS_GET_ARGUMENT_SPAN
+
 //----------------------------------------------------------------------------
 int vtkClientServerStream::GetArgument(int message, int argument, const char** value) const
 {
@@ -1461,7 +1527,22 @@ int vtkClientServerStream::SetData(const unsigned char* data, size_t length)
   {
     this->Internal->Data.insert(this->Internal->Data.begin(), data, data + length);
   }
+  return this->FinishSetData();
+}
 
+//----------------------------------------------------------------------------
+int vtkClientServerStream::SetData(std::vector<unsigned char>&& data)
+{
+  // Reset and take over the given data.
+  this->Reset();
+  this->Internal->Data.swap(data);
+  vtkClientServerStreamInternals::DataType().swap(data);
+  return this->FinishSetData();
+}
+
+//----------------------------------------------------------------------------
+int vtkClientServerStream::FinishSetData()
+{
   // Parse the stream to fill in ValueOffsets and MessageIndexes and
   // to perform byte-swapping if necessary.
   if (this->ParseData())
@@ -30,6 +30,10 @@
 #include "vtkClientServerID.h"
 #include "vtkVariant.h"
 
+#include <cstdint> // for uintptr_t
+#include <cstring> // for memcpy
+#include <vector>  // for std::vector
+
 class vtkClientServerStreamInternals;
 
 class VTKCLIENTSERVER_EXPORT vtkClientServerStream
@@ -52,6 +56,12 @@ public:
   vtkClientServerStream& operator=(const vtkClientServerStream&);
   //@}
 
+  /**
+   * Construct the stream by taking over the given data, as in
+   * SetData(std::vector<unsigned char>&&).
+   */
+  vtkClientServerStream(std::vector<unsigned char>&& data, vtkObjectBase* owner = 0);
+
   /**
    * Enumeration of message types that may be stored in a stream.
    * This must be kept in sync with the string table in this class's
@@ -225,6 +235,87 @@ public:
    */
   int GetArgumentObject(int message, int argument, vtkObjectBase** value, const char* type) const;
 
+  /**
+   * Read-only view of an array argument pointing into the stream data, used
+   * to access large arrays without copying them. The view is invalidated when
+   * the stream is modified or destroyed. Arrays are not necessarily aligned in
+   * the stream, hence values are read with GetValue() or CopyTo(), while
+   * GetPointer() returns 0 unless the data is suitably aligned for T.
+   */
+  template <class T>
+  class ArraySpan
+  {
+  public:
+    ArraySpan()
+      : Data(0)
+      , Length(0)
+    {
+    }
+    ArraySpan(const unsigned char* data, vtkTypeUInt32 length)
+      : Data(data)
+      , Length(length)
+    {
+    }
+
+    vtkTypeUInt32 GetLength() const { return this->Length; }
+    size_t GetNumberOfBytes() const { return this->Length * sizeof(T); }
+    const unsigned char* GetBytes() const { return this->Data; }
+
+    T GetValue(vtkTypeUInt32 index) const
+    {
+      T value;
+      memcpy(&value, this->Data + index * sizeof(T), sizeof(T));
+      return value;
+    }
+    T operator[](vtkTypeUInt32 index) const { return this->GetValue(index); }
+
+    void CopyTo(T* dest) const
+    {
+      if (this->Length > 0)
+      {
+        memcpy(dest, this->Data, this->GetNumberOfBytes());
+      }
+    }
+
+    const T* GetPointer() const
+    {
+      return (reinterpret_cast<uintptr_t>(this->Data) % alignof(T)) == 0
+        ? reinterpret_cast<const T*>(this->Data)
+        : 0;
+    }
+
+  private:
+    const unsigned char* Data;
+    vtkTypeUInt32 Length;
+  };
+
+  //@{
+  /**
+   * Get a view of the given array argument in the given message without
+   * copying or converting it. Returns whether the argument is an array of
+   * exactly the requested type.
+   */
+  int GetArgument(int message, int argument, ArraySpan<signed char>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<char>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<short>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<int>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<long>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned char>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned short>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned int>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned long>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<float>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<double>* value) const;
+#if defined(VTK_TYPE_USE_LONG_LONG)
+  int GetArgument(int message, int argument, ArraySpan<long long>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned long long>* value) const;
+#endif
+#if defined(VTK_TYPE_USE___INT64)
+  int GetArgument(int message, int argument, ArraySpan<__int64>* value) const;
+  int GetArgument(int message, int argument, ArraySpan<unsigned __int64>* value) const;
+#endif
+  //@}
+
   //@{
   /**
    * Proxy-object returned by the two-argument form of GetArgument.
@@ -343,6 +434,13 @@ public:
    */
   int SetData(const unsigned char* data, size_t length);
 
+  /**
+   * Construct the entire stream by taking over the given data instead of
+   * copying it. The vector is left empty. Returns whether the stream is
+   * deemed valid, as SetData(const unsigned char*, size_t) does.
+   */
+  int SetData(std::vector<unsigned char>&& data);
+
   //--------------------------------------------------------------------------
   // Utility methods:
 
@@ -410,6 +508,7 @@ protected:
   vtkClientServerStream& Write(const void* data, size_t length);
 
   // Data parsing utilities for SetData.
+  int FinishSetData();
   int ParseData();
   unsigned char* ParseCommand(
     int order, unsigned char* data, unsigned char* begin, unsigned char* end);
@@ -211,7 +211,9 @@ protected:
   bool GatherInformationInternal(vtkPVInformation* information, vtkTypeUInt32 globalid);
 
   /**
-   * Gather information across MPI satellites.
+   * Gather information across MPI satellites. The information is merged
+   * along a binomial tree, so that no process merges more than log2(N)
+   * information objects.
    */
   bool CollectInformation(vtkPVInformation*);
 
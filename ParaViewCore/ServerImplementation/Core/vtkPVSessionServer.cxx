@@ -614,6 +614,38 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     }
     break;
 
+    case vtkPVSessionServer::PUSH_BATCH:
+    {
+      // One-way messages queued by the client within a batch. Each one is
+      // processed in order as if it had been sent on its own, so a failure
+      // only affects its own message.
+      int count;
+      stream >> count;
+      for (int cc = 0; cc < count; ++cc)
+      {
+        std::string item;
+        stream >> item;
+
+        int itemType = -1;
+        if (!item.empty())
+        {
+          vtkMultiProcessStream itemStream;
+          itemStream.SetRawData(reinterpret_cast<const unsigned char*>(item.c_str()),
+            static_cast<unsigned int>(item.size()));
+          itemStream >> itemType;
+        }
+        if (itemType != vtkPVSessionServer::PUSH && itemType != vtkPVSessionServer::REGISTER_SI &&
+          itemType != vtkPVSessionServer::UNREGISTER_SI)
+        {
+          vtkErrorMacro("Skipping batched message " << cc << " of " << count
+                                                    << " with unsupported type " << itemType);
+          continue;
+        }
+        this->OnClientServerMessageRMI(&item[0], static_cast<int>(item.size()));
+      }
+    }
+    break;
+
     case vtkPVSessionServer::GATHER_INFORMATION:
     {
       std::string classname;
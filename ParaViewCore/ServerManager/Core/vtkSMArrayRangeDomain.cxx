@@ -19,6 +19,7 @@
 #include "vtkPVArrayInformation.h"
 #include "vtkPVDataInformation.h"
 #include "vtkSMArrayListDomain.h"
+#include "vtkSMOutputPort.h"
 #include "vtkSMSourceProxy.h"
 #include "vtkSMUncheckedPropertyHelper.h"
 
@@ -111,6 +112,7 @@ void vtkSMArrayRangeDomain::Update(const char* arrayName, int fieldAssociation,
 
       arrayInfo = info->GetArrayInformation(arrayName, otherField);
       arrayInfo = arrayInfo ? arrayInfo : info->GetArrayInformation(name.c_str(), otherField);
+      fieldAssociation = arrayInfo ? otherField : fieldAssociation;
     }
 
     // Now, extract static component information if no dynamic component have been specified.
@@ -130,6 +132,16 @@ void vtkSMArrayRangeDomain::Update(const char* arrayName, int fieldAssociation,
     }
   }
 
+  if (arrayInfo && !arrayInfo->GetHasRanges())
+  {
+    // The ranges were not gathered with the data information, get the one of
+    // this array.
+    std::string name = arrayInfo->GetName();
+    vtkPVDataInformation* rangedInfo =
+      producer->GetOutputPort(producerPort)->GetRangedDataInformation(name.c_str());
+    arrayInfo = rangedInfo->GetArrayInformation(name.c_str(), fieldAssociation);
+  }
+
   if (!arrayInfo)
   {
     std::vector<vtkEntry> values;
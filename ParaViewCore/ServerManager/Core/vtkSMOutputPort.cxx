@@ -30,7 +30,18 @@
 #include "vtkSMSession.h"
 #include "vtkTimerLog.h"
 
+#include "vtkSmartPointer.h"
+
+#include <map>
 #include <sstream>
+#include <string>
+
+class vtkSMOutputPort::vtkRangedDataInformation
+  : public std::map<std::string, vtkSmartPointer<vtkPVDataInformation> >
+{
+};
+
+bool vtkSMOutputPort::GatherArrayRanges = true;
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSMOutputPort);
@@ -44,6 +55,7 @@ vtkSMOutputPort::vtkSMOutputPort()
   this->ClassNameInformationValid = 0;
   this->DataInformationValid = false;
   this->TemporalDataInformationValid = false;
+  this->RangedDataInformation = new vtkRangedDataInformation();
   this->PortIndex = 0;
   this->SourceProxy = 0;
   this->CompoundSourceProxy = 0;
@@ -57,6 +69,7 @@ vtkSMOutputPort::~vtkSMOutputPort()
   this->ClassNameInformation->Delete();
   this->DataInformation->Delete();
   this->TemporalDataInformation->Delete();
+  delete this->RangedDataInformation;
 }
 
 //----------------------------------------------------------------------------
@@ -73,6 +86,41 @@ vtkPVDataInformation* vtkSMOutputPort::GetDataInformation()
   return this->DataInformation;
 }
 
+//----------------------------------------------------------------------------
+vtkPVDataInformation* vtkSMOutputPort::GetRangedDataInformation(const char* arrayName)
+{
+  vtkPVDataInformation* dataInfo = this->GetDataInformation();
+  if (vtkSMOutputPort::GatherArrayRanges || !arrayName || !this->SourceProxy)
+  {
+    return dataInfo;
+  }
+
+  vtkSmartPointer<vtkPVDataInformation>& rangedInfo = (*this->RangedDataInformation)[arrayName];
+  if (!rangedInfo)
+  {
+    rangedInfo = vtkSmartPointer<vtkPVDataInformation>::New();
+    rangedInfo->SetPortNumber(this->PortIndex);
+    rangedInfo->SetComputeArrayRanges(false);
+    rangedInfo->SetRangeArrayName(arrayName);
+    this->SourceProxy->GetSession()->PrepareProgress();
+    this->SourceProxy->GatherInformation(rangedInfo);
+    this->SourceProxy->GetSession()->CleanupPendingProgress();
+  }
+  return rangedInfo;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMOutputPort::SetGatherArrayRanges(bool val)
+{
+  vtkSMOutputPort::GatherArrayRanges = val;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMOutputPort::GetGatherArrayRanges()
+{
+  return vtkSMOutputPort::GatherArrayRanges;
+}
+
 //----------------------------------------------------------------------------
 vtkPVTemporalDataInformation* vtkSMOutputPort::GetTemporalDataInformation()
 {
@@ -105,6 +153,7 @@ void vtkSMOutputPort::InvalidateDataInformation()
   this->DataInformationValid = false;
   this->ClassNameInformationValid = false;
   this->TemporalDataInformationValid = false;
+  this->RangedDataInformation->clear();
 }
 
 //----------------------------------------------------------------------------
@@ -119,6 +168,7 @@ void vtkSMOutputPort::GatherDataInformation()
   this->SourceProxy->GetSession()->PrepareProgress();
   this->DataInformation->Initialize();
   this->DataInformation->SetPortNumber(this->PortIndex);
+  this->DataInformation->SetComputeArrayRanges(vtkSMOutputPort::GatherArrayRanges);
   this->SourceProxy->GatherInformation(this->DataInformation);
   this->DataInformationValid = true;
   this->SourceProxy->GetSession()->CleanupPendingProgress();
@@ -56,6 +56,26 @@ public:
    */
   virtual vtkPVDataInformation* GetDataInformation();
 
+  /**
+   * Returns data information in which the array named arrayName has its
+   * range. When array ranges are gathered (see SetGatherArrayRanges), this is
+   * GetDataInformation(). Otherwise, the range of that array alone is gathered
+   * the first time it is requested and kept until the data information is
+   * invalidated.
+   */
+  virtual vtkPVDataInformation* GetRangedDataInformation(const char* arrayName);
+
+  //@{
+  /**
+   * When off, GetDataInformation() does not compute the ranges of the arrays,
+   * which takes a pass over the values of every array on every rank. Callers
+   * needing the range of an array then use GetRangedDataInformation(). On by
+   * default.
+   */
+  static void SetGatherArrayRanges(bool val);
+  static bool GetGatherArrayRanges();
+  //@}
+
   /**
    * Returns data information collected over all timesteps provided by the
    * pipeline. If the data information is not valid, this results iterating over
@@ -138,6 +158,8 @@ protected:
   vtkPVTemporalDataInformation* TemporalDataInformation;
   bool TemporalDataInformationValid;
 
+  static bool GatherArrayRanges;
+
 private:
   vtkSMOutputPort(const vtkSMOutputPort&) = delete;
   void operator=(const vtkSMOutputPort&) = delete;
@@ -148,6 +170,10 @@ private:
 
   // Update Pipeline with the given timestep request.
   void UpdatePipeline(double time);
+
+  // Data information gathered for the range of one array, by array name.
+  class vtkRangedDataInformation;
+  vtkRangedDataInformation* RangedDataInformation;
 };
 
 #endif
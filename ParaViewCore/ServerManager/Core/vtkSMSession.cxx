@@ -72,6 +72,7 @@ vtkSMSession::vtkSMSession(
   this->SessionProxyManager = NULL;
   this->StateLocator = vtkSMStateLocator::New();
   this->IsAutoMPI = false;
+  this->BatchCount = 0;
 
   // Create and setup deserializer for the local ProxyLocator
   vtkNew<vtkSMDeserializerProtobuf> deserializer;
@@ -131,6 +132,45 @@ void vtkSMSession::PushState(vtkSMMessage* msg)
   this->Superclass::PushState(msg);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSession::BeginBatch()
+{
+  this->BatchCount++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::EndBatch()
+{
+  if (this->BatchCount <= 0)
+  {
+    vtkErrorMacro("BeginBatch and EndBatch mismatch!");
+    return;
+  }
+  if (--this->BatchCount == 0)
+  {
+    this->FlushBatch();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSMSession::vtkScopedBatch::vtkScopedBatch(vtkSMSession* session)
+  : Session(session)
+{
+  if (this->Session)
+  {
+    this->Session->BeginBatch();
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkSMSession::vtkScopedBatch::~vtkScopedBatch()
+{
+  if (this->Session)
+  {
+    this->Session->EndBatch();
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSession::UpdateStateHistory(vtkSMMessage* msg)
 {
@@ -145,6 +145,51 @@ public:
    */
   void PushState(vtkSMMessage* msg) VTK_OVERRIDE;
 
+  //@{
+  /**
+   * Begin/end a batch of state pushes. Within a batch, sessions connected to
+   * remote servers queue the one-way messages sent to the servers (proxy
+   * creation and deletion, property pushes) and send them as a single message
+   * when the outermost batch ends. Any call that needs a reply from the
+   * servers, such as PullState() or GatherInformation(), or that executes a
+   * stream, first sends the queued messages so the order in which the servers
+   * process messages is unchanged. Batches can be nested.
+   */
+  void BeginBatch();
+  void EndBatch();
+  //@}
+
+  /**
+   * Returns true if the session is within a BeginBatch()/EndBatch() block.
+   */
+  bool GetInBatch() { return this->BatchCount > 0; }
+
+  /**
+   * Sends the messages queued in the current batch, if any, right away. The
+   * implementation provided by this class does nothing since builtin sessions
+   * never queue messages.
+   */
+  virtual void FlushBatch() {}
+
+  /**
+   * Helper class designed to call session->BeginBatch() in constructor and
+   * session->EndBatch() in destructor.
+   * @code
+   * {
+   *    vtkSMSession::vtkScopedBatch batch(session);
+   *    ...
+   * }
+   * @endcode
+   */
+  class VTKPVSERVERMANAGERCORE_EXPORT vtkScopedBatch
+  {
+    vtkSMSession* Session;
+
+  public:
+    vtkScopedBatch(vtkSMSession* session);
+    ~vtkScopedBatch();
+  };
+
   /**
    * Sends the message to all clients.
    */
@@ -288,6 +333,8 @@ protected:
   bool IsAutoMPI;
 
 private:
+  int BatchCount;
+
   vtkSMSession(const vtkSMSession&) = delete;
   void operator=(const vtkSMSession&) = delete;
 
@@ -47,6 +47,7 @@
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
+#include <map>
 #include <set>
 
 //****************************************************************************/
@@ -61,6 +62,15 @@ void RMICallback(
   self->OnServerNotificationMessageRMI(remoteArg, remoteArgLength);
 }
 };
+
+//****************************************************************************/
+// Messages queued per server connection while the session is within a batch,
+// in the order they were sent.
+class vtkSMSessionClient::vtkBatchedMessages
+  : public std::map<vtkMultiProcessController*, std::vector<std::string> >
+{
+};
+
 //****************************************************************************/
 vtkStandardNewMacro(vtkSMSessionClient);
 vtkCxxSetObjectMacro(vtkSMSessionClient, RenderServerController, vtkMultiProcessController);
@@ -92,6 +102,7 @@ vtkSMSessionClient::vtkSMSessionClient()
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->BatchedMessages = new vtkBatchedMessages();
 }
 
 //----------------------------------------------------------------------------
@@ -120,11 +131,18 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+
+  delete this->BatchedMessages;
+  this->BatchedMessages = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkMultiProcessController* vtkSMSessionClient::GetController(ServerFlags processType)
 {
+  // The caller may talk to the servers directly, so queued messages must be
+  // sent first.
+  this->FlushBatch();
+
   switch (processType)
   {
     case CLIENT:
@@ -447,6 +465,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushBatch();
   if (this->DataServerController)
   {
     this->DataServerController->TriggerRMIOnAllChildren(vtkPVSessionServer::CLOSE_SESSION);
@@ -488,6 +507,47 @@ vtkTypeUInt32 vtkSMSessionClient::GetRealLocation(vtkTypeUInt32 location)
   return location;
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendToServer(
+  vtkMultiProcessController* controller, const unsigned char* data, int size)
+{
+  if (this->GetInBatch())
+  {
+    (*this->BatchedMessages)[controller].push_back(
+      std::string(reinterpret_cast<const char*>(data), size));
+    return;
+  }
+  controller->TriggerRMIOnAllChildren(
+    const_cast<unsigned char*>(data), size, vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushBatch()
+{
+  if (this->BatchedMessages->empty())
+  {
+    return;
+  }
+
+  // Swap the queue out first: triggering the RMI may end up pushing more state.
+  vtkBatchedMessages batches;
+  batches.swap(*this->BatchedMessages);
+  for (vtkBatchedMessages::iterator iter = batches.begin(); iter != batches.end(); ++iter)
+  {
+    vtkMultiProcessStream stream;
+    stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH)
+           << static_cast<int>(iter->second.size());
+    for (size_t cc = 0; cc < iter->second.size(); ++cc)
+    {
+      stream << iter->second[cc];
+    }
+    std::vector<unsigned char> raw_message;
+    stream.GetRawData(raw_message);
+    iter->first->TriggerRMIOnAllChildren(&raw_message[0], static_cast<int>(raw_message.size()),
+      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PushState(vtkSMMessage* message)
 {
@@ -519,8 +579,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     stream.GetRawData(raw_message);
     for (int cc = 0; cc < num_controllers; cc++)
     {
-      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
-        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], &raw_message[0], static_cast<int>(raw_message.size()));
     }
   }
 
@@ -557,8 +616,8 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         stream << msg.SerializeAsString();
         std::vector<unsigned char> raw_message;
         stream.GetRawData(raw_message);
-        this->DataServerController->TriggerRMIOnAllChildren(&raw_message[0],
-          static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(
+          this->DataServerController, &raw_message[0], static_cast<int>(raw_message.size()));
       }
       else if (!remoteObject)
       {
@@ -583,6 +642,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushBatch();
   this->StartBusyWork();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
@@ -654,6 +714,9 @@ void vtkSMSessionClient::ExecuteStream(
 
   if (num_controllers > 0)
   {
+    // Streams may use objects created or modified by queued messages.
+    this->FlushBatch();
+
     const unsigned char* data;
     size_t size;
     cssstream.GetData(&data, &size);
@@ -682,6 +745,7 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushBatch();
   this->StartBusyWork();
   location = this->GetRealLocation(location);
 
@@ -730,6 +794,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushBatch();
   this->StartBusyWork();
   if (this->RenderServerController == NULL)
   {
@@ -852,8 +917,7 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     stream.GetRawData(raw_message);
     for (int cc = 0; cc < num_controllers; cc++)
     {
-      controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
-        static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], &raw_message[0], static_cast<int>(raw_message.size()));
     }
   }
 
@@ -895,8 +959,7 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
     {
       if (controllers[cc] != NULL)
       {
-        controllers[cc]->TriggerRMIOnAllChildren(&raw_message[0],
-          static_cast<int>(raw_message.size()), vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(controllers[cc], &raw_message[0], static_cast<int>(raw_message.size()));
       }
     }
   }
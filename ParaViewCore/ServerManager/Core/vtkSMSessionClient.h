@@ -108,6 +108,13 @@ public:
   const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location) override;
   //@}
 
+  /**
+   * Sends the messages queued in the current batch as one PUSH_BATCH message
+   * per server. The servers process the queued messages in order, exactly as
+   * if they had been sent one by one.
+   */
+  void FlushBatch() override;
+
   //@{
   /**
    * When Connect() is waiting for a server to connect back to the client (in
@@ -239,6 +246,12 @@ protected:
    */
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  /**
+   * Sends a one-way message to the servers of the given controller, or queues
+   * it if the session is within a batch.
+   */
+  void SendToServer(vtkMultiProcessController* controller, const unsigned char* data, int size);
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -280,6 +293,9 @@ private:
   int NotBusy;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
+
+  class vtkBatchedMessages;
+  vtkBatchedMessages* BatchedMessages;
 };
 
 #endif
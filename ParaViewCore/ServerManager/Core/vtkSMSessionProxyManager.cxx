@@ -1215,6 +1215,11 @@ void vtkSMSessionProxyManager::LoadXMLState(
 
   bool prev = this->InLoadXMLState;
   this->InLoadXMLState = true;
+
+  // Send the proxy creations and property pushes of the state to the server
+  // together rather than one message at a time.
+  vtkSMSession::vtkScopedBatch batch(this->GetSession());
+
   vtkSmartPointer<vtkSMStateLoader> spLoader;
   if (!loader)
   {
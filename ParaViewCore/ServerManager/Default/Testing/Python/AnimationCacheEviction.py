@@ -0,0 +1,88 @@
+from paraview.simple import *
+
+from paraview import smtesting
+from paraview.vtk.vtkPVClientServerCoreRendering import vtkCacheSizeKeeper
+from paraview.vtk.vtkPVClientServerCoreRendering import vtkPVCacheKeeper
+
+smtesting.ProcessCommandLineArguments()
+
+# Plays through more time steps than the animation cache holds and checks which
+# ones stay cached. The cache holds 3 time steps on the first rank and more on
+# the others, so in symmetric mode the other ranks must evict as many time steps
+# as the first one to agree on what is cached.
+pm = servermanager.vtkProcessModule.GetProcessModule()
+rank = pm.GetGlobalController().GetLocalProcessId()
+
+can_ex2 = OpenDataFile(smtesting.DataDir + '/can.ex2')
+can_ex2.PointVariables = ['DISPL']
+can_ex2.ElementVariables = ['EQPS']
+Show()
+Render()
+scene = GetAnimationScene()
+scene.PlayMode = 'Snap To TimeSteps'
+times = GetTimeKeeper().TimestepValues
+# Start from a time step the test does not use, so that going to the first one
+# updates the pipeline.
+scene.AnimationTime = times[-1]
+
+settings = servermanager.ProxyManager().GetProxy("settings", "GeneralSettings")
+settings.CacheGeometryForAnimation = 1
+settings.AnimationGeometryCacheLimit = 1024 * 1024
+settings.AnimationGeometryCacheEvictionPolicy = 'Evict Least Recently Used'
+settings.AnimationGeometryCacheMaximumNumberOfEntries = 0
+keeper = vtkCacheSizeKeeper.GetInstance()
+
+def go(index, cached):
+    vtkPVCacheKeeper.ClearCacheStateFlags()
+    scene.AnimationTime = times[index]
+    if cached:
+        assert vtkPVCacheKeeper.GetCacheHits() > 0 and \
+                vtkPVCacheKeeper.GetCacheMisses() == 0, \
+                "time step %d is not cached" % index
+    else:
+        assert vtkPVCacheKeeper.GetCacheMisses() > 0, \
+                "time step %d is still cached" % index
+
+#---------------------------------------------------------
+# The time steps all have the same size, the limit on the first rank is 3 and
+# a half of them.
+go(0, False)
+stepSize = keeper.GetCacheSize()
+assert stepSize > 0
+keeper.SetCacheLimit(int((3 + 2 * rank + 0.5) * stepSize))
+
+for index in range(1, 5):
+    go(index, False)
+assert vtkPVCacheKeeper.GetCacheEvictions() > 0
+
+#---------------------------------------------------------
+# Least recently used first: revisiting 2 keeps it when 3 is evicted, although
+# 2 was cached before 3.
+go(2, True)
+go(5, False)
+go(6, False)
+go(2, True)
+go(4, False)
+go(6, True)
+go(3, False)
+
+#---------------------------------------------------------
+# Without eviction, nothing more is cached once the cache is full.
+settings.AnimationGeometryCacheEvictionPolicy = 'Stop Caching'
+go(7, False)
+go(8, False)
+go(7, False)
+
+#---------------------------------------------------------
+# Limit the number of cached time steps instead of the size.
+settings.AnimationGeometryCacheEvictionPolicy = 'Evict Least Recently Used'
+settings.AnimationGeometryCacheMaximumNumberOfEntries = 2
+keeper.SetCacheLimit(1024 * 1024)
+go(10, False)
+go(11, False)
+go(10, True)
+go(12, False)
+go(10, True)
+go(11, False)
+
+print("The animation cache evicted the expected time steps.")
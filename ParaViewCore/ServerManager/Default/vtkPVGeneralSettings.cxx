@@ -15,12 +15,14 @@
 #include "vtkPVGeneralSettings.h"
 
 #include "vtkCacheSizeKeeper.h"
+#include "vtkFileSeriesReader.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModuleAutoMPI.h"
 #include "vtkSISourceProxy.h"
 #include "vtkSMArraySelectionDomain.h"
 #include "vtkSMChartSeriesSelectionDomain.h"
 #include "vtkSMInputArrayDomain.h"
+#include "vtkSMOutputPort.h"
 #include "vtkSMParaViewPipelineControllerWithRendering.h"
 #include "vtkSMTrace.h"
 #include "vtkSMTransferFunctionManager.h"
@@ -150,6 +152,86 @@ void vtkPVGeneralSettings::SetAnimationGeometryCacheLimit(unsigned long val)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetAnimationGeometryCacheEvictionPolicy(int val)
+{
+  if (this->GetAnimationGeometryCacheEvictionPolicy() != val)
+  {
+    vtkCacheSizeKeeper::GetInstance()->SetEvictionPolicy(val);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetAnimationGeometryCacheEvictionPolicy()
+{
+  return vtkCacheSizeKeeper::GetInstance()->GetEvictionPolicy();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetAnimationGeometryCacheMaximumNumberOfEntries(int val)
+{
+  if (this->GetAnimationGeometryCacheMaximumNumberOfEntries() != val)
+  {
+    vtkCacheSizeKeeper::GetInstance()->SetMaximumNumberOfCachedEntries(val);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetAnimationGeometryCacheMaximumNumberOfEntries()
+{
+  return vtkCacheSizeKeeper::GetInstance()->GetMaximumNumberOfCachedEntries();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetFileSeriesPrefetchNumberOfFiles(int val)
+{
+  if (this->GetFileSeriesPrefetchNumberOfFiles() != val)
+  {
+    vtkFileSeriesReader::SetDefaultPrefetchNumberOfFiles(val);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetFileSeriesPrefetchNumberOfFiles()
+{
+  return vtkFileSeriesReader::GetDefaultPrefetchNumberOfFiles();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetFileSeriesPrefetchMemoryLimit(int val)
+{
+  if (this->GetFileSeriesPrefetchMemoryLimit() != val)
+  {
+    vtkFileSeriesReader::SetDefaultPrefetchMemoryLimit(val);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVGeneralSettings::GetFileSeriesPrefetchMemoryLimit()
+{
+  return vtkFileSeriesReader::GetDefaultPrefetchMemoryLimit();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeneralSettings::SetGatherArrayRanges(bool val)
+{
+  if (this->GetGatherArrayRanges() != val)
+  {
+    vtkSMOutputPort::SetGatherArrayRanges(val);
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeneralSettings::GetGatherArrayRanges()
+{
+  return vtkSMOutputPort::GetGatherArrayRanges();
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeneralSettings::SetScalarBarMode(int val)
 {
@@ -152,6 +152,42 @@ public:
   vtkGetMacro(AnimationGeometryCacheLimit, unsigned long);
   //@}
 
+  //@{
+  /**
+   * Set what happens to the animation cache once it reaches its limit, one of
+   * vtkCacheSizeKeeper::EvictionPolicies, and the maximum number of time steps
+   * cached for each representation (0 for no limit). Forwarded to
+   * vtkCacheSizeKeeper.
+   */
+  void SetAnimationGeometryCacheEvictionPolicy(int val);
+  int GetAnimationGeometryCacheEvictionPolicy();
+  void SetAnimationGeometryCacheMaximumNumberOfEntries(int val);
+  int GetAnimationGeometryCacheMaximumNumberOfEntries();
+  //@}
+
+  //@{
+  /**
+   * Set the number of files and the number of megabytes that file series
+   * readers read ahead in a background thread. Forwarded to
+   * vtkFileSeriesReader, affects the readers created afterwards.
+   */
+  void SetFileSeriesPrefetchNumberOfFiles(int val);
+  int GetFileSeriesPrefetchNumberOfFiles();
+  void SetFileSeriesPrefetchMemoryLimit(int val);
+  int GetFileSeriesPrefetchMemoryLimit();
+  //@}
+
+  //@{
+  /**
+   * Set whether the data information gathered for the outputs of pipeline
+   * sources includes the ranges of all the arrays. When off, only the ranges
+   * that are used, such as the one of the colored array, are gathered.
+   * Forwarded to vtkSMOutputPort.
+   */
+  void SetGatherArrayRanges(bool val);
+  bool GetGatherArrayRanges();
+  //@}
+
   //@{
   /**
    * Set the precision of the animation time toolbar.
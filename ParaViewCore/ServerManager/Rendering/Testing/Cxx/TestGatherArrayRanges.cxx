@@ -0,0 +1,132 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestGatherArrayRanges.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that, when output ports gather data information without the array
+// ranges, the array range domains and the rescaling of transfer functions
+// still get the range of the array they use.
+
+#include "vtkDataObject.h"
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkPVArrayInformation.h"
+#include "vtkPVDataInformation.h"
+#include "vtkProcessModule.h"
+#include "vtkSMArrayRangeDomain.h"
+#include "vtkSMOutputPort.h"
+#include "vtkSMPVRepresentationProxy.h"
+#include "vtkSMParaViewPipelineControllerWithRendering.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSMTransferFunctionProxy.h"
+#include "vtkSmartPointer.h"
+
+#include <vector>
+
+namespace
+{
+vtkSMSourceProxy* CreatePipelineProxy(
+  vtkSMSession* session, const char* xmlgroup, const char* xmlname, vtkSMProxy* input = NULL)
+{
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  vtkSmartPointer<vtkSMSourceProxy> proxy;
+  proxy.TakeReference(vtkSMSourceProxy::SafeDownCast(pxm->NewProxy(xmlgroup, xmlname)));
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  controller->PreInitializeProxy(proxy.Get());
+  if (input != NULL)
+  {
+    vtkSMPropertyHelper(proxy, "Input").Set(input);
+  }
+  controller->PostInitializeProxy(proxy.Get());
+  proxy->UpdateVTKObjects();
+  controller->RegisterPipelineProxy(proxy);
+  return proxy.Get();
+}
+
+bool Check(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    cerr << "ERROR: " << message << endl;
+  }
+  return condition;
+}
+}
+
+int TestGatherArrayRanges(int, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  vtkNew<vtkSMParaViewPipelineControllerWithRendering> controller;
+  vtkNew<vtkSMSession> session;
+  vtkProcessModule::GetProcessModule()->RegisterSession(session.Get());
+  controller->InitializeSession(session.Get());
+
+  vtkSMSourceProxy* wavelet = CreatePipelineProxy(session.Get(), "sources", "RTAnalyticSource");
+  wavelet->UpdatePipeline();
+  double expected[2];
+  wavelet->GetDataInformation(0)
+    ->GetArrayInformation("RTData", vtkDataObject::POINT)
+    ->GetComponentRange(0, expected);
+
+  vtkSMOutputPort::SetGatherArrayRanges(false);
+  wavelet->GetOutputPort(0u)->InvalidateDataInformation();
+  vtkPVArrayInformation* info =
+    wavelet->GetDataInformation(0)->GetArrayInformation("RTData", vtkDataObject::POINT);
+  bool ok = Check(info && !info->GetHasRanges(), "the ranges were gathered");
+  info = wavelet->GetOutputPort(0u)->GetRangedDataInformation("RTData")->GetArrayInformation(
+    "RTData", vtkDataObject::POINT);
+  ok &= Check(info && info->GetHasRanges() && info->GetComponentRange(0)[0] == expected[0] &&
+      info->GetComponentRange(0)[1] == expected[1],
+    "wrong range of the requested array");
+
+  // The array range domain of the threshold range.
+  vtkSMSourceProxy* threshold = CreatePipelineProxy(session.Get(), "filters", "Threshold", wavelet);
+  vtkSMArrayRangeDomain* domain = vtkSMArrayRangeDomain::SafeDownCast(
+    threshold->GetProperty("ThresholdBetween")->GetDomain("range"));
+  ok &= Check(domain && domain->GetMinimum(0) == expected[0] &&
+      domain->GetMaximum(0) == expected[1],
+    "wrong array range domain");
+
+  // Rescaling the color map of the wavelet colored by RTData.
+  vtkSMProxy* view = session->GetSessionProxyManager()->NewProxy("views", "RenderView");
+  controller->InitializeProxy(view);
+  view->UpdateVTKObjects();
+  controller->RegisterViewProxy(view);
+  view->Delete();
+  vtkSMProxy* repr = controller->Show(wavelet, 0, view);
+  vtkSMPVRepresentationProxy::SetScalarColoring(repr, "RTData", vtkDataObject::POINT);
+  ok &= Check(
+    vtkSMPVRepresentationProxy::RescaleTransferFunctionToDataRange(repr, false, true),
+    "cannot rescale the color map");
+  vtkSMProxy* lut = vtkSMPropertyHelper(repr, "LookupTable").GetAsProxy();
+  std::vector<double> points = vtkSMPropertyHelper(lut, "RGBPoints").GetDoubleArray();
+  ok &= Check(points.size() >= 8 && points[0] == expected[0] &&
+      points[points.size() - 4] == expected[1],
+    "wrong color map range");
+  double range[2];
+  ok &= Check(vtkSMTransferFunctionProxy::ComputeDataRange(lut, range) &&
+      range[0] == expected[0] && range[1] == expected[1],
+    "wrong transfer function data range");
+
+  vtkSMOutputPort::SetGatherArrayRanges(true);
+  controller->UnRegisterProxy(threshold);
+  controller->UnRegisterProxy(wavelet);
+  controller->UnRegisterProxy(view);
+  vtkProcessModule::GetProcessModule()->UnRegisterSession(session.Get());
+  vtkInitializationHelper::Finalize();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
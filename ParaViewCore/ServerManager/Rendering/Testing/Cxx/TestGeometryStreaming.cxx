@@ -0,0 +1,169 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestGeometryStreaming.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that, when streaming is enabled, the geometry representation of a
+// multiblock first renders its structure only and then receives every block,
+// each one in its own slot, as the view streams them.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeRepresentation.h"
+#include "vtkDataSet.h"
+#include "vtkGeometryRepresentation.h"
+#include "vtkInitializationHelper.h"
+#include "vtkMapper.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVDataInformation.h"
+#include "vtkPVLODActor.h"
+#include "vtkPVView.h"
+#include "vtkProcessModule.h"
+#include "vtkSMParaViewPipelineControllerWithRendering.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMRenderViewProxy.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSMSourceProxy.h"
+#include "vtkSmartPointer.h"
+
+#include <vector>
+
+namespace
+{
+const int NumberOfBlocks = 4;
+
+vtkSMSourceProxy* CreatePipelineProxy(vtkSMSession* session, const char* xmlgroup,
+  const char* xmlname, const std::vector<vtkSMProxy*>& inputs = std::vector<vtkSMProxy*>())
+{
+  vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+  vtkSmartPointer<vtkSMSourceProxy> proxy;
+  proxy.TakeReference(vtkSMSourceProxy::SafeDownCast(pxm->NewProxy(xmlgroup, xmlname)));
+
+  vtkNew<vtkSMParaViewPipelineController> controller;
+  controller->PreInitializeProxy(proxy.Get());
+  for (size_t cc = 0; cc < inputs.size(); ++cc)
+  {
+    vtkSMPropertyHelper(proxy, "Input").Add(inputs[cc], 0);
+  }
+  controller->PostInitializeProxy(proxy.Get());
+  proxy->UpdateVTKObjects();
+  controller->RegisterPipelineProxy(proxy);
+  return proxy.Get();
+}
+
+bool Check(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    cerr << "ERROR: " << message << endl;
+  }
+  return condition;
+}
+
+// Returns the number of cells of each leaf of the multiblock the representation
+// renders.
+std::vector<vtkIdType> GetRenderedCells(vtkSMProxy* repr)
+{
+  std::vector<vtkIdType> cells;
+  vtkCompositeRepresentation* composite =
+    vtkCompositeRepresentation::SafeDownCast(repr->GetClientSideObject());
+  vtkGeometryRepresentation* geometry = composite
+    ? vtkGeometryRepresentation::SafeDownCast(composite->GetActiveRepresentation())
+    : NULL;
+  vtkMapper* mapper = geometry ? geometry->GetActor()->GetMapper() : NULL;
+  vtkMultiBlockDataSet* rendered =
+    mapper ? vtkMultiBlockDataSet::SafeDownCast(mapper->GetInputDataObject(0, 0)) : NULL;
+  if (rendered == NULL)
+  {
+    return cells;
+  }
+
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(rendered->NewIterator());
+  iter->SkipEmptyNodesOff();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet* block = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    cells.push_back(block ? block->GetNumberOfCells() : 0);
+  }
+  return cells;
+}
+}
+
+int TestGeometryStreaming(int, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+  vtkPVView::SetEnableStreaming(true);
+
+  vtkNew<vtkSMParaViewPipelineControllerWithRendering> controller;
+  vtkNew<vtkSMSession> session;
+  vtkProcessModule::GetProcessModule()->RegisterSession(session.Get());
+  controller->InitializeSession(session.Get());
+
+  // Spheres of different resolutions side by side, grouped in a multiblock.
+  std::vector<vtkSMProxy*> spheres;
+  std::vector<vtkIdType> expected;
+  for (int cc = 0; cc < NumberOfBlocks; ++cc)
+  {
+    vtkSMSourceProxy* sphere = CreatePipelineProxy(session.Get(), "sources", "SphereSource");
+    double center[3] = { 2.0 * cc, 0.0, 0.0 };
+    vtkSMPropertyHelper(sphere, "Center").Set(center, 3);
+    vtkSMPropertyHelper(sphere, "ThetaResolution").Set(8 + 4 * cc);
+    sphere->UpdateVTKObjects();
+    sphere->UpdatePipeline();
+    expected.push_back(sphere->GetDataInformation(0)->GetNumberOfCells());
+    spheres.push_back(sphere);
+  }
+  vtkSMSourceProxy* group =
+    CreatePipelineProxy(session.Get(), "filters", "GroupDataSets", spheres);
+
+  vtkSMRenderViewProxy* view = vtkSMRenderViewProxy::SafeDownCast(
+    session->GetSessionProxyManager()->NewProxy("views", "RenderView"));
+  controller->InitializeProxy(view);
+  view->UpdateVTKObjects();
+  controller->RegisterViewProxy(view);
+  view->Delete();
+  vtkSMProxy* repr = controller->Show(group, 0, view);
+  view->ResetCamera();
+  view->StillRender();
+
+  // Only the structure is rendered before streaming.
+  std::vector<vtkIdType> cells = GetRenderedCells(repr);
+  bool ok = Check(cells.size() == expected.size(), "wrong number of rendered blocks");
+  for (size_t cc = 0; ok && cc < cells.size(); ++cc)
+  {
+    ok &= Check(cells[cc] == 0, "a block was rendered before streaming");
+  }
+
+  // A block is streamed per update.
+  int updates = 0;
+  while (updates <= NumberOfBlocks && view->StreamingUpdate(true))
+  {
+    ++updates;
+  }
+  ok &= Check(updates == NumberOfBlocks, "wrong number of streaming updates");
+
+  cells = GetRenderedCells(repr);
+  ok &= Check(cells == expected, "the streamed blocks do not match the input blocks");
+
+  vtkPVView::SetEnableStreaming(false);
+  controller->UnRegisterProxy(group);
+  for (size_t cc = 0; cc < spheres.size(); ++cc)
+  {
+    controller->UnRegisterProxy(spheres[cc]);
+  }
+  controller->UnRegisterProxy(view);
+  vtkProcessModule::GetProcessModule()->UnRegisterSession(session.Get());
+  vtkInitializationHelper::Finalize();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,7 @@
 #include "vtkPVSession.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSMInputProperty.h"
+#include "vtkSMOutputPort.h"
 #include "vtkSMPropertyHelper.h"
 #include "vtkSMProxyManager.h"
 #include "vtkSMRepresentationProxy.h"
@@ -122,8 +123,16 @@ bool vtkSMMultiSliceViewProxy::GetDataBounds(vtkSMSourceProxy* source, int oppor
   vtkPVDataInformation* info = source ? source->GetDataInformation(opport) : NULL;
   if (info)
   {
-    if (vtkPVArrayInformation* ainfo =
-          info->GetFieldDataInformation()->GetArrayInformation("BoundingBoxInModelCoordinates"))
+    vtkPVArrayInformation* ainfo =
+      info->GetFieldDataInformation()->GetArrayInformation("BoundingBoxInModelCoordinates");
+    if (ainfo && !ainfo->GetHasRanges())
+    {
+      ainfo = source->GetOutputPort(opport)
+                ->GetRangedDataInformation("BoundingBoxInModelCoordinates")
+                ->GetFieldDataInformation()
+                ->GetArrayInformation("BoundingBoxInModelCoordinates");
+    }
+    if (ainfo)
     {
       // use "original basis" bounds,  if present.
       if (ainfo->GetNumberOfTuples() == 1 && ainfo->GetNumberOfComponents() == 6)
@@ -48,6 +48,25 @@ class vtkSMPVRepresentationProxy::vtkStringSet : public std::set<std::string>
 {
 };
 
+namespace
+{
+// Returns the information of an array of the data produced on the given port,
+// gathering its range when the data information was gathered without ranges.
+vtkPVArrayInformation* vtkGetRangedArrayInformation(
+  vtkSMSourceProxy* input, unsigned int port, const char* arrayname, int association)
+{
+  vtkPVArrayInformation* info =
+    input->GetDataInformation(port)->GetArrayInformation(arrayname, association);
+  if (info && !info->GetHasRanges())
+  {
+    vtkPVDataInformation* rangedInfo =
+      input->GetOutputPort(port)->GetRangedDataInformation(arrayname);
+    info = rangedInfo->GetArrayInformation(arrayname, association);
+  }
+  return info;
+}
+}
+
 vtkStandardNewMacro(vtkSMPVRepresentationProxy);
 //----------------------------------------------------------------------------
 vtkSMPVRepresentationProxy::vtkSMPVRepresentationProxy()
@@ -222,8 +241,8 @@ bool vtkSMPVRepresentationProxy::RescaleTransferFunctionToDataRange(
     return false;
   }
 
-  vtkPVDataInformation* dataInfo = inputProxy->GetDataInformation(port);
-  vtkPVArrayInformation* info = dataInfo->GetArrayInformation(arrayname, attribute_type);
+  vtkPVArrayInformation* info =
+    vtkGetRangedArrayInformation(inputProxy, port, arrayname, attribute_type);
   if (!info)
   {
     vtkPVDataInformation* representedDataInfo = this->GetRepresentedDataInformation();
@@ -760,8 +779,9 @@ vtkPVArrayInformation* vtkSMPVRepresentationProxy::GetArrayInformationForColorAr
   unsigned int port = inputHelper.GetOutputPort();
   if (input)
   {
-    vtkPVArrayInformation* arrayInfoFromData = input->GetDataInformation(port)->GetArrayInformation(
-      colorArrayHelper.GetInputArrayNameToProcess(), colorArrayHelper.GetInputArrayAssociation());
+    vtkPVArrayInformation* arrayInfoFromData =
+      vtkGetRangedArrayInformation(input, port, colorArrayHelper.GetInputArrayNameToProcess(),
+        colorArrayHelper.GetInputArrayAssociation());
     if (arrayInfoFromData)
     {
       return arrayInfoFromData;
@@ -247,6 +247,17 @@ vtkTypeUInt32 vtkSMRenderViewProxy::PreRender(bool interactive)
   {
     // for interactive renders, we need to determine if we are going to use LOD.
     // If so, we may need to update the LOD geometries.
+    // The level of the LOD hierarchy to use is picked based on the time taken
+    // by the last interactive render, which is known on the client.
+    const int level = rv->GetSuggestedLODLevel();
+    if (level != rv->GetLODLevel())
+    {
+      vtkClientServerStream stream;
+      stream << vtkClientServerStream::Invoke << VTKOBJECT(this) << "SetLODLevel" << level
+             << vtkClientServerStream::End;
+      this->ExecuteStream(stream);
+      this->NeedsUpdateLOD = true;
+    }
     this->UpdateLOD();
   }
   this->DeliveryManager->Deliver(interactive);
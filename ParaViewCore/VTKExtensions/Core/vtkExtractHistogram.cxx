@@ -14,9 +14,11 @@
 =========================================================================*/
 #include "vtkExtractHistogram.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkGraph.h"
@@ -27,6 +29,8 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
@@ -260,11 +264,148 @@ void vtkExtractHistogram::FillBinExtents(vtkDoubleArray* bin_extents, double min
   }
 }
 
-inline int vtkExtractHistogramClamp(int value, int min, int max)
+namespace
 {
-  value = value < min ? min : value;
-  value = value > max ? max : value;
-  return value;
+// Returns true if vtkDataArray::GetComponent can be called on the array from
+// several threads at the same time.
+bool vtkExtractHistogramCanReadConcurrently(vtkDataArray* array)
+{
+  const int arrayType = array->GetArrayType();
+  return arrayType == vtkAbstractArray::AoSDataArrayTemplate ||
+    arrayType == vtkAbstractArray::SoADataArrayTemplate;
+}
+
+// Parameters and results of the binning of an array.
+struct vtkExtractHistogramBins
+{
+  int Component;
+  int BinCount;
+  double Min;
+  double BinDelta;
+  double Offset;
+  bool Parallel;
+
+  // Arrays for which the values are accumulated per bin to compute averages,
+  // and the offset of each of them in the totals of a bin.
+  std::vector<vtkDataArray*> Others;
+  std::vector<int> OtherOffsets;
+  int TotalsSize;
+
+  std::vector<vtkIdType> Counts;
+  std::vector<double> Totals;
+
+  int GetBin(double value) const
+  {
+    // Values equal to max are included in the last bin. This is written so
+    // that NaN ends up in the first bin without overflowing an int.
+    const double bin = (value - this->Min + this->Offset) / this->BinDelta;
+    if (bin >= this->BinCount - 1)
+    {
+      return this->BinCount - 1;
+    }
+    return bin > 0 ? static_cast<int>(bin) : 0;
+  }
+};
+
+// Each thread counts the values in its own bins, the bins are summed in
+// Reduce().
+template <typename ArrayT>
+class vtkExtractHistogramFunctor
+{
+public:
+  vtkExtractHistogramFunctor(ArrayT* array, vtkExtractHistogramBins& bins)
+    : Array(array)
+    , Bins(bins)
+  {
+  }
+
+  void Initialize()
+  {
+    this->LocalCounts.Local().assign(this->Bins.BinCount, 0);
+    this->LocalTotals.Local().assign(
+      static_cast<size_t>(this->Bins.BinCount) * this->Bins.TotalsSize, 0.0);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkDataArrayAccessor<ArrayT> accessor(this->Array);
+    vtkIdType* counts = &this->LocalCounts.Local()[0];
+    std::vector<double>& totals = this->LocalTotals.Local();
+    const vtkExtractHistogramBins& bins = this->Bins;
+    const int component = bins.Component;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const int index = bins.GetBin(static_cast<double>(accessor.Get(i, component)));
+      ++counts[index];
+      if (bins.TotalsSize > 0)
+      {
+        double* binTotals = &totals[static_cast<size_t>(index) * bins.TotalsSize];
+        for (size_t cc = 0; cc < bins.Others.size(); ++cc)
+        {
+          vtkDataArray* array = bins.Others[cc];
+          for (int comp = 0, numComps = array->GetNumberOfComponents(); comp < numComps; ++comp)
+          {
+            binTotals[bins.OtherOffsets[cc] + comp] += array->GetComponent(i, comp);
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    for (typename vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator iter =
+           this->LocalCounts.begin();
+         iter != this->LocalCounts.end(); ++iter)
+    {
+      for (size_t cc = 0; cc < iter->size(); ++cc)
+      {
+        this->Bins.Counts[cc] += (*iter)[cc];
+      }
+    }
+    for (typename vtkSMPThreadLocal<std::vector<double> >::iterator iter =
+           this->LocalTotals.begin();
+         iter != this->LocalTotals.end(); ++iter)
+    {
+      for (size_t cc = 0; cc < iter->size(); ++cc)
+      {
+        this->Bins.Totals[cc] += (*iter)[cc];
+      }
+    }
+  }
+
+private:
+  ArrayT* Array;
+  vtkExtractHistogramBins& Bins;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > LocalCounts;
+  vtkSMPThreadLocal<std::vector<double> > LocalTotals;
+};
+
+struct vtkExtractHistogramWorker
+{
+  vtkExtractHistogramWorker(vtkExtractHistogramBins& bins)
+    : Bins(bins)
+  {
+  }
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    vtkExtractHistogramFunctor<ArrayT> functor(array, this->Bins);
+    if (this->Bins.Parallel)
+    {
+      vtkSMPTools::For(0, array->GetNumberOfTuples(), functor);
+    }
+    else
+    {
+      functor.Initialize();
+      functor(0, array->GetNumberOfTuples());
+      functor.Reduce();
+    }
+  }
+
+  vtkExtractHistogramBins& Bins;
+};
 }
 
 //-----------------------------------------------------------------------------
@@ -279,50 +420,78 @@ void vtkExtractHistogram::BinAnArray(
     return;
   }
 
-  int num_of_tuples = data_array->GetNumberOfTuples();
-  double bin_delta =
+  this->UpdateProgress(0.10);
+
+  vtkExtractHistogramBins bins;
+  bins.Component = this->Component;
+  bins.BinCount = this->BinCount;
+  bins.Min = min;
+  bins.BinDelta =
     (max - min) / (this->CenterBinsAroundMinAndMax ? (this->BinCount - 1) : this->BinCount);
-  double half_delta = bin_delta / 2.0;
+  bins.Offset = this->CenterBinsAroundMinAndMax ? bins.BinDelta / 2.0 : 0.0;
+  bins.Parallel = true;
+  bins.TotalsSize = 0;
 
-  for (int i = 0; i != num_of_tuples; ++i)
+  if (this->CalculateAverages && data_array->GetNumberOfTuples() > 0)
   {
-    if (i % 1000 == 0)
+    // Get all other arrays, their values are added to the bins and divided
+    // by the number of elements at the end.
+    int num_arrays = field->GetNumberOfArrays();
+    for (int idx = 0; idx < num_arrays; idx++)
     {
-      this->UpdateProgress(0.10 + 0.90 * i / num_of_tuples);
+      vtkDataArray* array = field->GetArray(idx);
+      if (array && array != data_array && array->GetName())
+      {
+        bins.Others.push_back(array);
+        bins.OtherOffsets.push_back(bins.TotalsSize);
+        bins.TotalsSize += array->GetNumberOfComponents();
+        bins.Parallel = bins.Parallel && vtkExtractHistogramCanReadConcurrently(array);
+      }
     }
-    const double value = data_array->GetComponent(i, this->Component);
-    int index = static_cast<int>(
-      (value - min + (this->CenterBinsAroundMinAndMax ? half_delta : 0.)) / bin_delta);
+  }
 
-    // If the value is equal to max, include it in the last bin.
-    index = ::vtkExtractHistogramClamp(index, 0, this->BinCount - 1);
-    bin_values->SetValue(index, bin_values->GetValue(index) + 1);
+  bins.Counts.assign(this->BinCount, 0);
+  bins.Totals.assign(static_cast<size_t>(this->BinCount) * bins.TotalsSize, 0.0);
+  vtkExtractHistogramWorker worker(bins);
+  if (!vtkArrayDispatch::Dispatch::Execute(data_array, worker))
+  {
+    // Arrays that are not dispatched may not support concurrent reads.
+    bins.Parallel = false;
+    worker(data_array);
+  }
+
+  for (int i = 0; i < this->BinCount; ++i)
+  {
+    vtkIdType count = bin_values->GetValue(i) + bins.Counts[i];
+    if (count > VTK_INT_MAX)
+    {
+      vtkWarningMacro("Bin " << i << " has more than " << VTK_INT_MAX << " values.");
+      count = VTK_INT_MAX;
+    }
+    bin_values->SetValue(i, static_cast<int>(count));
+  }
 
-    if (this->CalculateAverages)
+  for (size_t cc = 0; cc < bins.Others.size(); ++cc)
+  {
+    vtkEHInternals::ArrayValuesType& arrayValues =
+      this->Internal->ArrayValues[bins.Others[cc]->GetName()];
+    arrayValues.TotalValues.resize(this->BinCount);
+    const int numComps = bins.Others[cc]->GetNumberOfComponents();
+    for (int i = 0; i < this->BinCount; ++i)
     {
-      // Get all other arrays, add their value to the bin
-      // For each bin, we will need 2 values per array ->
-      // total, num. elements
-      // at the end, divide each total by num. elements
-      int num_arrays = field->GetNumberOfArrays();
-      for (int idx = 0; idx < num_arrays; idx++)
+      // All bins are allocated, so that the number of components is known
+      // even if the first bin is empty.
+      std::vector<double>& totals = arrayValues.TotalValues[i];
+      totals.resize(numComps, 0.0);
+      const double* binTotals = &bins.Totals[static_cast<size_t>(i) * bins.TotalsSize];
+      for (int comp = 0; comp < numComps; comp++)
       {
-        vtkDataArray* array = field->GetArray(idx);
-        if (array && array != data_array && array->GetName())
-        {
-          vtkEHInternals::ArrayValuesType& arrayValues =
-            this->Internal->ArrayValues[array->GetName()];
-          arrayValues.TotalValues.resize(this->BinCount);
-          int numComps = array->GetNumberOfComponents();
-          arrayValues.TotalValues[index].resize(numComps);
-          for (int comp = 0; comp < numComps; comp++)
-          {
-            arrayValues.TotalValues[index][comp] += array->GetComponent(i, comp);
-          }
-        }
+        totals[comp] += binTotals[bins.OtherOffsets[cc] + comp];
       }
     }
   }
+
+  this->UpdateProgress(1.0);
 }
 
 //-----------------------------------------------------------------------------
@@ -31,7 +31,11 @@
 #include "vtkInformation.h"
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
+#include "vtkConditionVariable.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -45,6 +49,7 @@
 
 #include <algorithm>
 #include <ctype.h> // for isprint().
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -55,6 +60,9 @@
 //=============================================================================
 vtkStandardNewMacro(vtkFileSeriesReader);
 
+int vtkFileSeriesReader::DefaultPrefetchNumberOfFiles = 0;
+int vtkFileSeriesReader::DefaultPrefetchMemoryLimit = 512;
+
 //=============================================================================
 // Internal class for holding time ranges.
 class vtkFileSeriesReaderTimeRanges
@@ -359,6 +367,135 @@ private:
 };
 }
 
+//=============================================================================
+// Reads files in a background thread so that they are in the file system
+// cache when the internal reader opens them. The data read is discarded.
+class vtkFileSeriesReaderPrefetcher
+{
+public:
+  vtkFileSeriesReaderPrefetcher()
+    : ThreadId(-1)
+    , Terminate(false)
+    , Generation(0)
+  {
+  }
+  ~vtkFileSeriesReaderPrefetcher() { this->Stop(); }
+
+  // Replaces the files waiting to be prefetched. The file being prefetched,
+  // if any, is abandoned.
+  void Schedule(const std::vector<std::string>& files)
+  {
+    this->Lock.Lock();
+    // Forget the files that left the window, they may be evicted from the
+    // cache by the time they are requested again.
+    std::set<std::string> prefetched;
+    this->Queue.clear();
+    for (size_t cc = 0; cc < files.size(); ++cc)
+    {
+      if (this->Prefetched.find(files[cc]) != this->Prefetched.end())
+      {
+        prefetched.insert(files[cc]);
+      }
+      else
+      {
+        this->Queue.push_back(files[cc]);
+      }
+    }
+    this->Prefetched.swap(prefetched);
+    this->Generation++;
+    this->Lock.Unlock();
+    this->Condition.Signal();
+
+    if (this->ThreadId < 0 && !files.empty())
+    {
+      this->ThreadId =
+        this->Threader->SpawnThread(&vtkFileSeriesReaderPrefetcher::Run, this);
+    }
+  }
+
+  void Stop()
+  {
+    if (this->ThreadId < 0)
+    {
+      return;
+    }
+    this->Lock.Lock();
+    this->Terminate = true;
+    this->Lock.Unlock();
+    this->Condition.Signal();
+    this->Threader->TerminateThread(this->ThreadId);
+    this->ThreadId = -1;
+    this->Terminate = false;
+  }
+
+private:
+  static VTK_THREAD_RETURN_TYPE Run(void* arg)
+  {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkFileSeriesReaderPrefetcher* self =
+      static_cast<vtkFileSeriesReaderPrefetcher*>(info->UserData);
+
+    self->Lock.Lock();
+    while (!self->Terminate)
+    {
+      if (self->Queue.empty())
+      {
+        self->Condition.Wait(self->Lock);
+        continue;
+      }
+      std::string fname = self->Queue.front();
+      self->Queue.pop_front();
+      const unsigned long generation = self->Generation;
+      self->Lock.Unlock();
+
+      const bool complete = self->ReadFile(fname, generation);
+
+      self->Lock.Lock();
+      if (complete && generation == self->Generation)
+      {
+        self->Prefetched.insert(fname);
+      }
+    }
+    self->Lock.Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+  }
+
+  // Returns false if the read was abandoned.
+  bool ReadFile(const std::string& fname, unsigned long generation)
+  {
+    if (vtksys::SystemTools::FileIsDirectory(fname))
+    {
+      return true;
+    }
+    ifstream file(fname.c_str(), ios::in | ios::binary);
+    std::vector<char> buffer(1048576);
+    while (file.read(&buffer[0], buffer.size()) || file.gcount() > 0)
+    {
+      this->Lock.Lock();
+      const bool cancelled = this->Terminate || generation != this->Generation;
+      this->Lock.Unlock();
+      if (cancelled)
+      {
+        return false;
+      }
+      if (!file)
+      {
+        break;
+      }
+    }
+    return true;
+  }
+
+  vtkNew<vtkMultiThreader> Threader;
+  int ThreadId;
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable Condition;
+  std::deque<std::string> Queue;
+  std::set<std::string> Prefetched;
+  bool Terminate;
+  unsigned long Generation;
+};
+
 //=============================================================================
 struct vtkFileSeriesReaderInternals
 {
@@ -367,6 +504,14 @@ struct vtkFileSeriesReaderInternals
   std::vector<double> TimeValues;
   bool FileNameIsSet;
   vtkFileSeriesReaderTimeRanges* TimeRanges;
+
+  // Last file requested and direction of the last change, used to choose the
+  // files to prefetch.
+  int LastRequestedIndex;
+  int Direction;
+  // Files scheduled by the last request, nearest first.
+  std::vector<std::string> PrefetchWindow;
+  vtkFileSeriesReaderPrefetcher Prefetcher;
 };
 
 //=============================================================================
@@ -378,11 +523,15 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->Internal = new vtkFileSeriesReaderInternals;
   this->Internal->FileNameIsSet = false;
   this->Internal->TimeRanges = new vtkFileSeriesReaderTimeRanges;
+  this->Internal->LastRequestedIndex = -1;
+  this->Internal->Direction = 1;
 
   this->UseMetaFile = 0;
   this->UseJsonMetaFile = false;
 
   this->IgnoreReaderTime = false;
+  this->PrefetchNumberOfFiles = vtkFileSeriesReader::DefaultPrefetchNumberOfFiles;
+  this->PrefetchMemoryLimit = vtkFileSeriesReader::DefaultPrefetchMemoryLimit;
 }
 
 //-----------------------------------------------------------------------------
@@ -642,6 +791,8 @@ int vtkFileSeriesReader::RequestUpdateExtent(vtkInformation* request,
   // RequestInformation has been called.
   this->RequestInformationForInput(index);
 
+  this->PrefetchFiles(index);
+
 // I commented out the following block because it is probably not important
 // and it is causing a crash in some circumstances (bug #7253).
 #if 0
@@ -932,6 +1083,86 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "PrefetchNumberOfFiles: " << this->PrefetchNumberOfFiles << endl;
+  os << indent << "PrefetchMemoryLimit: " << this->PrefetchMemoryLimit << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::PrefetchFiles(int index)
+{
+  vtkFileSeriesReaderInternals* internal = this->Internal;
+  if (internal->LastRequestedIndex >= 0 && index != internal->LastRequestedIndex)
+  {
+    internal->Direction = index > internal->LastRequestedIndex ? 1 : -1;
+  }
+  if (index == internal->LastRequestedIndex && this->PrefetchNumberOfFiles > 0)
+  {
+    // Same file as the previous request, the window did not move.
+    return;
+  }
+  internal->LastRequestedIndex = index;
+
+  std::vector<std::string> files;
+  const int numFiles = static_cast<int>(this->GetNumberOfFileNames());
+  const vtkTypeInt64 limit = static_cast<vtkTypeInt64>(this->PrefetchMemoryLimit) * 1048576;
+  vtkTypeInt64 total = 0;
+  for (int cc = 1; cc <= this->PrefetchNumberOfFiles; ++cc)
+  {
+    const int next = index + cc * internal->Direction;
+    if (next < 0 || next >= numFiles)
+    {
+      break;
+    }
+    const char* fname = this->GetFileName(static_cast<unsigned int>(next));
+    total += static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fname));
+    if (total > limit && !files.empty())
+    {
+      break;
+    }
+    files.push_back(fname);
+  }
+  internal->Prefetcher.Schedule(files);
+  internal->PrefetchWindow.swap(files);
+}
+
+//-----------------------------------------------------------------------------
+unsigned int vtkFileSeriesReader::GetNumberOfPrefetchFileNames()
+{
+  return static_cast<unsigned int>(this->Internal->PrefetchWindow.size());
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkFileSeriesReader::GetPrefetchFileName(unsigned int idx)
+{
+  if (idx >= this->Internal->PrefetchWindow.size())
+  {
+    return NULL;
+  }
+  return this->Internal->PrefetchWindow[idx].c_str();
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::SetDefaultPrefetchNumberOfFiles(int val)
+{
+  vtkFileSeriesReader::DefaultPrefetchNumberOfFiles = std::max(val, 0);
+}
+
+//-----------------------------------------------------------------------------
+int vtkFileSeriesReader::GetDefaultPrefetchNumberOfFiles()
+{
+  return vtkFileSeriesReader::DefaultPrefetchNumberOfFiles;
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::SetDefaultPrefetchMemoryLimit(int val)
+{
+  vtkFileSeriesReader::DefaultPrefetchMemoryLimit = std::max(val, 1);
+}
+
+//-----------------------------------------------------------------------------
+int vtkFileSeriesReader::GetDefaultPrefetchMemoryLimit()
+{
+  return vtkFileSeriesReader::DefaultPrefetchMemoryLimit;
 }
 
 //-----------------------------------------------------------------------------
@@ -75,6 +75,12 @@
  * with SetMetaFileName in this case. Do not use the AddFileName() method when
  * using SetMetaFileName() as names set with AddFileName() will be ignored.
  *
+ * When PrefetchNumberOfFiles is set, the files following the one being read,
+ * in the direction the time steps were last changed in, are read ahead in a
+ * background thread so that they are in the file system cache when the
+ * internal reader opens them. This hides most of the I/O latency during
+ * animation playback.
+ *
 */
 
 #ifndef vtkFileSeriesReader_h
@@ -151,6 +157,46 @@ public:
   vtkBooleanMacro(IgnoreReaderTime, bool);
   //@}
 
+  //@{
+  /**
+   * Set the number of files that are read ahead in a background thread. 0
+   * disables prefetching. Default is GetDefaultPrefetchNumberOfFiles().
+   */
+  vtkSetClampMacro(PrefetchNumberOfFiles, int, 0, VTK_INT_MAX);
+  vtkGetMacro(PrefetchNumberOfFiles, int);
+  //@}
+
+  //@{
+  /**
+   * Set the maximum number of megabytes that are read ahead. Files are
+   * prefetched in order until this limit is reached. Default is
+   * GetDefaultPrefetchMemoryLimit().
+   */
+  vtkSetClampMacro(PrefetchMemoryLimit, int, 1, VTK_INT_MAX);
+  vtkGetMacro(PrefetchMemoryLimit, int);
+  //@}
+
+  //@{
+  /**
+   * Set the PrefetchNumberOfFiles and PrefetchMemoryLimit of the readers
+   * created afterwards. These are 0 and 512 unless changed, e.g. by
+   * vtkPVGeneralSettings.
+   */
+  static void SetDefaultPrefetchNumberOfFiles(int);
+  static int GetDefaultPrefetchNumberOfFiles();
+  static void SetDefaultPrefetchMemoryLimit(int);
+  static int GetDefaultPrefetchMemoryLimit();
+  //@}
+
+  //@{
+  /**
+   * Get the files scheduled for prefetching by the last time request,
+   * nearest first.
+   */
+  unsigned int GetNumberOfPrefetchFileNames();
+  const char* GetPrefetchFileName(unsigned int idx);
+  //@}
+
 protected:
   vtkFileSeriesReader();
   ~vtkFileSeriesReader() override;
@@ -216,6 +262,18 @@ protected:
 
   int ChooseInput(vtkInformation*);
 
+  /**
+   * Schedules the prefetching of the files following index, in the direction
+   * of the last change of file.
+   */
+  void PrefetchFiles(int index);
+
+  int PrefetchNumberOfFiles;
+  int PrefetchMemoryLimit;
+
+  static int DefaultPrefetchNumberOfFiles;
+  static int DefaultPrefetchMemoryLimit;
+
 private:
   vtkFileSeriesReader(const vtkFileSeriesReader&) = delete;
   void operator=(const vtkFileSeriesReader&) = delete;
@@ -29,6 +29,7 @@
 #include "vtkTable.h"
 
 #include <string>
+#include <vector>
 #include <vtksys/RegularExpression.hxx>
 
 vtkStandardNewMacro(vtkPExtractHistogram);
@@ -93,6 +94,14 @@ int vtkPExtractHistogram::RequestData(
     // Nothing to do if there is no data
     return 1;
   }
+
+  if (!this->CalculateAverages)
+  {
+    // Only the bin counts need to be summed, which the controller does
+    // along a tree instead of gathering all the tables on the root.
+    return this->ReduceBinValues(output);
+  }
+
   // Now we need to collect and reduce data from all nodes on the root.
   vtkSmartPointer<vtkReductionFilter> reduceFilter = vtkSmartPointer<vtkReductionFilter>::New();
   reduceFilter->SetController(this->Controller);
@@ -156,6 +165,51 @@ int vtkPExtractHistogram::RequestData(
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+int vtkPExtractHistogram::ReduceBinValues(vtkTable* output)
+{
+  vtkIntArray* bin_values =
+    vtkIntArray::SafeDownCast(output->GetRowData()->GetAbstractArray("bin_values"));
+  std::vector<vtkIdType> local_values(this->BinCount, 0);
+  for (vtkIdType cc = 0; bin_values && cc < bin_values->GetNumberOfTuples() && cc < this->BinCount;
+       ++cc)
+  {
+    local_values[cc] = bin_values->GetValue(cc);
+  }
+
+  std::vector<vtkIdType> values(this->BinCount, 0);
+  if (!this->Controller->Reduce(
+        &local_values[0], &values[0], this->BinCount, vtkCommunicator::SUM_OP, 0))
+  {
+    vtkErrorMacro("Parallel communication error. Could not reduce bin values.");
+    return 0;
+  }
+
+  if (this->Controller->GetLocalProcessId() != 0)
+  {
+    output->Initialize();
+    return 1;
+  }
+
+  if (!bin_values)
+  {
+    vtkErrorMacro(<< "Missing bin_values array.");
+    return 0;
+  }
+  bin_values->SetNumberOfTuples(this->BinCount);
+  for (int cc = 0; cc < this->BinCount; ++cc)
+  {
+    if (values[cc] > VTK_INT_MAX)
+    {
+      vtkWarningMacro("Bin " << cc << " has more than " << VTK_INT_MAX << " values.");
+      values[cc] = VTK_INT_MAX;
+    }
+    bin_values->SetValue(cc, static_cast<int>(values[cc]));
+  }
+  bin_values->Modified();
+  return 1;
+}
+
 //-----------------------------------------------------------------------------
 void vtkPExtractHistogram::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -17,7 +17,9 @@
  * @brief   Extract histogram for parallel dataset.
  *
  * vtkPExtractHistogram is vtkExtractHistogram subclass for parallel datasets.
- * It gathers the histogram data on the root node.
+ * It gathers the histogram data on the root node. When averages are not
+ * computed, only the bin counts are summed on the root using
+ * vtkMultiProcessController::Reduce().
 */
 
 #ifndef vtkPExtractHistogram_h
@@ -27,6 +29,7 @@
 #include "vtkPVVTKExtensionsCoreModule.h" //needed for exports
 
 class vtkMultiProcessController;
+class vtkTable;
 
 class VTKPVVTKEXTENSIONSCORE_EXPORT vtkPExtractHistogram : public vtkExtractHistogram
 {
@@ -57,6 +60,12 @@ protected:
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
     vtkInformationVector* outputVector) VTK_OVERRIDE;
 
+  /**
+   * Sums the bin_values of all processes on the root node. The output is
+   * emptied on satellites.
+   */
+  int ReduceBinValues(vtkTable* output);
+
   vtkMultiProcessController* Controller;
 
 private:
@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHaloFinderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the halo finder and the subhalo finder produce the same halos,
+// subhalos and centers with several threads as with one.
+
+#include <mpi.h>
+
+#include "HaloFinderTestHelpers.h"
+
+#include "vtkDataArray.h"
+#include "vtkMPIController.h"
+#include "vtkPANLSubhaloFinder.h"
+
+namespace
+{
+const int NUMBER_OF_THREADS = 4;
+
+bool sameOutputs(vtkUnstructuredGrid* serial, vtkUnstructuredGrid* threaded, const char* output)
+{
+  if (serial->GetNumberOfPoints() != threaded->GetNumberOfPoints())
+  {
+    std::cerr << output << ": " << threaded->GetNumberOfPoints() << " points instead of "
+              << serial->GetNumberOfPoints() << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < serial->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    serial->GetPoint(i, p);
+    threaded->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      std::cerr << output << ": point " << i << " differs" << std::endl;
+      return false;
+    }
+  }
+  vtkPointData* serialData = serial->GetPointData();
+  vtkPointData* threadedData = threaded->GetPointData();
+  if (serialData->GetNumberOfArrays() != threadedData->GetNumberOfArrays())
+  {
+    std::cerr << output << ": wrong number of arrays" << std::endl;
+    return false;
+  }
+  for (int a = 0; a < serialData->GetNumberOfArrays(); ++a)
+  {
+    vtkDataArray* expected = serialData->GetArray(a);
+    vtkDataArray* array = threadedData->GetArray(expected->GetName());
+    if (!array || array->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+      array->GetNumberOfComponents() != expected->GetNumberOfComponents())
+    {
+      std::cerr << output << ": array " << expected->GetName()
+                << " is missing or has the wrong size" << std::endl;
+      return false;
+    }
+    for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+      for (int c = 0; c < expected->GetNumberOfComponents(); ++c)
+      {
+        if (array->GetComponent(i, c) != expected->GetComponent(i, c))
+        {
+          std::cerr << output << ": array " << expected->GetName() << " differs at tuple " << i
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+int runHaloFinderTest(int argc, char* argv[])
+{
+  HaloFinderTestHelpers::HaloFinderTestVTKObjects to = HaloFinderTestHelpers::SetupHaloFinderTest(
+    argc, argv, vtkPANLHaloFinder::MOST_BOUND_PARTICLE, true);
+
+  vtkNew<vtkUnstructuredGrid> serial[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    serial[i]->DeepCopy(to.haloFinder->GetOutput(i));
+  }
+  if (serial[2]->GetNumberOfPoints() == 0)
+  {
+    std::cerr << "No subhalos found" << std::endl;
+    return 0;
+  }
+
+  to.haloFinder->SetNumberOfThreads(NUMBER_OF_THREADS);
+  to.haloFinder->Update();
+  const char* outputs[] = { "halo finder particles", "halo finder halos",
+    "halo finder subhalos" };
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!sameOutputs(serial[i].GetPointer(), to.haloFinder->GetOutput(i), outputs[i]))
+    {
+      return 0;
+    }
+  }
+
+  // Find the subhalos of the halos the halo finder looks for subhalos in.
+  vtkPointData* halos = serial[1]->GetPointData();
+  vtkDataArray* haloCount = halos->GetArray("fof_halo_count");
+  vtkDataArray* haloTag = halos->GetArray("fof_halo_tag");
+  vtkNew<vtkPANLSubhaloFinder> subhaloFinder;
+  subhaloFinder->SetInputData(serial[0].GetPointer());
+  subhaloFinder->SetRL(128);
+  subhaloFinder->SetParticleMass(13070871810);
+  subhaloFinder->SetBB(0.2);
+  subhaloFinder->SetMinCandidateSize(20);
+  subhaloFinder->SetMode(vtkPANLSubhaloFinder::ONLY_SELECTED_HALOS);
+  for (vtkIdType i = 0; i < haloCount->GetNumberOfTuples(); ++i)
+  {
+    if (haloCount->GetTuple1(i) > 7000)
+    {
+      subhaloFinder->AddHaloToProcess(static_cast<vtkIdType>(haloTag->GetTuple1(i)));
+    }
+  }
+  subhaloFinder->Update();
+
+  vtkNew<vtkUnstructuredGrid> serialSubhalos[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    serialSubhalos[i]->DeepCopy(subhaloFinder->GetOutput(i));
+  }
+
+  subhaloFinder->SetNumberOfThreads(NUMBER_OF_THREADS);
+  subhaloFinder->Update();
+  vtkUnstructuredGrid* particles = vtkUnstructuredGrid::SafeDownCast(subhaloFinder->GetOutput(0));
+  vtkUnstructuredGrid* subhalos = vtkUnstructuredGrid::SafeDownCast(subhaloFinder->GetOutput(1));
+  if (!sameOutputs(serialSubhalos[0].GetPointer(), particles, "subhalo finder particles") ||
+    !sameOutputs(serialSubhalos[1].GetPointer(), subhalos, "subhalo finder subhalos"))
+  {
+    return 0;
+  }
+  return 1;
+}
+}
+
+int TestHaloFinderThreads(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize();
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int retVal = runHaloFinderTest(argc, argv);
+
+  controller->Finalize();
+  return !retVal;
+}
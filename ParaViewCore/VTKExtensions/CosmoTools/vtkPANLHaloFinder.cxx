@@ -36,7 +36,10 @@
 #include "Partition.h"
 #include "SubHaloFinder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <thread>
 #include <vector>
 
 namespace
@@ -119,6 +122,68 @@ private:
   std::vector<POSVEL_T> mass;
   std::vector<ID_T> id;
 };
+
+// Properties of the subhalos of one halo
+struct HaloSubhalos
+{
+  std::vector<int> Count;
+  std::vector<POSVEL_T> Mass, XPos, YPos, ZPos, XCofMass, YCofMass, ZCofMass, XVel, YVel, ZVel,
+    VelDisp;
+};
+
+// Compares halos by decreasing number of particles
+class LargerHalo
+{
+public:
+  LargerHalo(int* haloCounts)
+    : counts(haloCounts)
+  {
+  }
+  bool operator()(int a, int b) const { return this->counts[a] > this->counts[b]; }
+
+private:
+  int* counts;
+};
+
+// Returns the halos with more than minSize particles, largest first so that the
+// threads do not end up waiting on a large halo taken last.
+std::vector<int> HalosBySize(int numHalos, int* haloCounts, long minSize)
+{
+  std::vector<int> halos;
+  for (int i = 0; i < numHalos; ++i)
+  {
+    if (haloCounts[i] > minSize)
+    {
+      halos.push_back(i);
+    }
+  }
+  std::stable_sort(halos.begin(), halos.end(), LargerHalo(haloCounts));
+  return halos;
+}
+
+// Calls work(halo, thread) for each of the halos on numThreads threads, each
+// thread taking the next halo when it is done with the previous one.
+template <typename Work>
+void ForEachHalo(const std::vector<int>& halos, int numThreads, Work& work)
+{
+  std::atomic<size_t> next(0);
+  auto worker = [&](int thread) {
+    for (size_t i = next++; i < halos.size(); i = next++)
+    {
+      work(halos[i], thread);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < numThreads; ++thread)
+  {
+    threads.push_back(std::thread(worker, thread));
+  }
+  worker(0);
+  for (size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+}
 }
 
 class vtkPANLHaloFinder::vtkInternals
@@ -173,7 +238,7 @@ public:
 
   void reserveForInputData(vtkIdType numPts)
   {
-    if (numPts > 0 && this->xx.capacity() < static_cast<size_t>(numPts))
+    if (numPts > 0 && this->xx.size() < static_cast<size_t>(numPts))
     {
       this->xx.resize(numPts);
       this->yy.resize(numPts);
@@ -192,7 +257,11 @@ public:
     this->vx.clear();
     this->vy.clear();
     this->vz.clear();
+    this->mass.clear();
     this->tag.clear();
+    this->mask.clear();
+    this->potential.clear();
+    this->status.clear();
   }
 };
 
@@ -219,6 +288,7 @@ vtkStandardNewMacro(vtkPANLHaloFinder)
   this->MinCandidateSize = 200;
   this->NumSPHNeighbors = 64;
   this->NumNeighbors = 20;
+  this->NumberOfThreads = 1;
 
   this->CenterFindingMode = NONE;
   this->SmoothingLength = 0.0;
@@ -271,6 +341,8 @@ int vtkPANLHaloFinder::RequestData(
 
   cosmotk::Partition::initialize();
 
+  // drop the particles and ghost particles of the previous execution
+  this->Internal->clear();
   if (grid != NULL)
   {
     this->ExtractDataArrays(grid, 0);
@@ -370,15 +442,18 @@ void vtkPANLHaloFinder::CreateGhostParticles()
 void vtkPANLHaloFinder::ExecuteHaloFinder(
   vtkUnstructuredGrid* allParticles, vtkUnstructuredGrid* fofProperties)
 {
+  delete this->Internal->haloFinder;
   this->Internal->haloFinder = new cosmotk::CosmoHaloFinderP();
   this->Internal->haloFinder->setParameters(
     "", this->RL, this->DeadSize, this->NP, this->PMin, this->BB, this->NMin);
+  this->Internal->haloFinder->setNumberOfThreads(this->NumberOfThreads);
   this->Internal->haloFinder->setParticles(this->Internal->xx.size(), &this->Internal->xx[0],
     &this->Internal->yy[0], &this->Internal->zz[0], &this->Internal->vx[0], &this->Internal->vy[0],
     &this->Internal->vz[0], &this->Internal->potential[0], &this->Internal->tag[0],
     &this->Internal->mask[0], &this->Internal->status[0]);
   this->Internal->haloFinder->executeHaloFinder();
   this->Internal->haloFinder->collectHalos(false);
+  delete this->Internal->fof;
   this->Internal->fof = new cosmotk::FOFHaloProperties();
   int numberOfFOFHalos = this->Internal->haloFinder->getNumberOfHalos();
   int* fofHalos = this->Internal->haloFinder->getHalos();
@@ -494,97 +569,88 @@ void vtkPANLHaloFinder::ExecuteSubHaloFinder(
 {
   std::vector<ID_T> parentHaloTag, subHaloTag;
   std::vector<long> parentFOFCount, subCount;
-  std::vector<POSVEL_T> subRadius, subMass, subCenterOfMassX, subCenterOfMassY, subCenterOfMassZ,
-    subAvgX, subAvgY, subAvgZ, subAvgVX, subAvgVY, subAvgVZ, subVelDisp;
-
-  std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
-  std::vector<ID_T> shTag, shHID, shID;
+  std::vector<POSVEL_T> subMass, subCenterOfMassX, subCenterOfMassY, subCenterOfMassZ, subAvgX,
+    subAvgY, subAvgZ, subAvgVX, subAvgVY, subAvgVZ, subVelDisp;
 
   vtkNew<vtkTypeInt64Array> subhaloId;
   subhaloId->SetName("subhalo_tag");
   subhaloId->SetNumberOfTuples(this->Internal->xx.size());
-  for (size_t i = 0; i < this->Internal->xx.size(); ++i)
-  {
-    subhaloId->SetValue(i, -1);
-  }
+  subhaloId->FillComponent(0, -1);
 
   int numberOfFOFHalos = this->Internal->haloFinder->getNumberOfHalos();
   int* fofHaloCount = this->Internal->haloFinder->getHaloCount();
-  ExtractHalo haloData(numberOfFOFHalos, fofHaloCount, this->Internal->fof);
+  std::vector<int> halos = HalosBySize(numberOfFOFHalos, fofHaloCount, this->MinFOFSubhaloSize);
+  int numberOfThreads = std::min(this->NumberOfThreads, static_cast<int>(halos.size()));
+
+  // Each thread extracts the halos it processes into its own buffers, and the
+  // halos have distinct particles so they set distinct subhalo tags.
+  std::vector<ExtractHalo> haloData(
+    numberOfThreads, ExtractHalo(numberOfFOFHalos, fofHaloCount, this->Internal->fof));
+  std::vector<HaloSubhalos> subhalos(numberOfFOFHalos);
+  vtkTypeInt64* subhaloIds = subhaloId->GetPointer(0);
+  auto findSubhalos = [&](int halo, int thread) {
+    ExtractHalo& data = haloData[thread];
+    data.SetCurrentHalo(halo);
+
+    cosmotk::SubHaloFinder subFinder;
+    subFinder.setParameters(this->ParticleMass, GRAVITY_C, this->AlphaFactor, this->BetaFactor,
+      this->MinCandidateSize, this->NumSPHNeighbors, this->NumNeighbors);
+
+    data.SetParticles(subFinder);
+    subFinder.findSubHalos();
+
+    int numberOfSubHalos = subFinder.getNumberOfSubhalos();
+    int* fofSubHalos = subFinder.getSubhalos();
+    int* fofSubHaloCount = subFinder.getSubhaloCount();
+    int* fofSubHaloList = subFinder.getSubhaloList();
+
+    cosmotk::FOFHaloProperties subhaloProperties;
+    subhaloProperties.setHalos(numberOfSubHalos, fofSubHalos, fofSubHaloCount, fofSubHaloList);
+    subhaloProperties.setParameters("", this->RL, this->DeadSize, this->BB);
+    data.SetParticles(subhaloProperties);
+
+    HaloSubhalos& result = subhalos[halo];
+    result.Count.assign(fofSubHaloCount, fofSubHaloCount + numberOfSubHalos);
+    subhaloProperties.FOFHaloMass(&result.Mass);
+    subhaloProperties.FOFPosition(&result.XPos, &result.YPos, &result.ZPos);
+    subhaloProperties.FOFCenterOfMass(&result.XCofMass, &result.YCofMass, &result.ZCofMass);
+    subhaloProperties.FOFVelocity(&result.XVel, &result.YVel, &result.ZVel);
+    subhaloProperties.FOFVelocityDispersion(
+      &result.XVel, &result.YVel, &result.ZVel, &result.VelDisp);
+
+    std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
+    std::vector<ID_T> shTag, shHID, shID;
+    subFinder.getSubhaloCosmoData(this->Internal->haloFinder->getHaloID(halo), shX, shY, shZ,
+      shVX, shVY, shVZ, shTag, shHID, shID);
+
+    for (size_t i = 0; i < shX.size(); ++i)
+    {
+      subhaloIds[data.GetActualIndex(i)] = shID[i];
+    }
+  };
+  ForEachHalo(halos, numberOfThreads, findSubhalos);
 
+  // Gather the subhalos in the order of their halos
   for (int halo = 0; halo < numberOfFOFHalos; ++halo)
   {
-    long particleCount = fofHaloCount[halo];
-    if (particleCount > this->MinFOFSubhaloSize)
+    const HaloSubhalos& result = subhalos[halo];
+    for (size_t sidx = 0; sidx < result.Count.size(); ++sidx)
     {
-      haloData.SetCurrentHalo(halo);
-
-      cosmotk::SubHaloFinder subFinder;
-      subFinder.setParameters(this->ParticleMass, GRAVITY_C, this->AlphaFactor, this->BetaFactor,
-        this->MinCandidateSize, this->NumSPHNeighbors, this->NumNeighbors);
-
-      haloData.SetParticles(subFinder);
-      subFinder.findSubHalos();
-
-      int numberOfSubHalos = subFinder.getNumberOfSubhalos();
-      int* fofSubHalos = subFinder.getSubhalos();
-      int* fofSubHaloCount = subFinder.getSubhaloCount();
-      int* fofSubHaloList = subFinder.getSubhaloList();
-
-      cosmotk::FOFHaloProperties subhaloProperties;
-      subhaloProperties.setHalos(numberOfSubHalos, fofSubHalos, fofSubHaloCount, fofSubHaloList);
-      subhaloProperties.setParameters("", this->RL, this->DeadSize, this->BB);
-      haloData.SetParticles(subhaloProperties);
-
-      std::vector<POSVEL_T> subhaloMass;
-      subhaloProperties.FOFHaloMass(&subhaloMass);
-
-      std::vector<POSVEL_T> subhaloXPos;
-      std::vector<POSVEL_T> subhaloYPos;
-      std::vector<POSVEL_T> subhaloZPos;
-      subhaloProperties.FOFPosition(&subhaloXPos, &subhaloYPos, &subhaloZPos);
-
-      std::vector<POSVEL_T> subhaloXCofMass;
-      std::vector<POSVEL_T> subhaloYCofMass;
-      std::vector<POSVEL_T> subhaloZCofMass;
-      subhaloProperties.FOFCenterOfMass(&subhaloXCofMass, &subhaloYCofMass, &subhaloZCofMass);
-
-      std::vector<POSVEL_T> subhaloXVel;
-      std::vector<POSVEL_T> subhaloYVel;
-      std::vector<POSVEL_T> subhaloZVel;
-      subhaloProperties.FOFVelocity(&subhaloXVel, &subhaloYVel, &subhaloZVel);
-
-      std::vector<POSVEL_T> subhaloVelDisp;
-      subhaloProperties.FOFVelocityDispersion(
-        &subhaloXVel, &subhaloYVel, &subhaloZVel, &subhaloVelDisp);
-
-      for (int sidx = 0; sidx < numberOfSubHalos; ++sidx)
-      {
-        parentHaloTag.push_back(this->Internal->haloFinder->getHaloID(halo));
-        parentFOFCount.push_back(particleCount);
-        subHaloTag.push_back(sidx);
-        subCount.push_back(fofSubHaloCount[sidx]);
-        subMass.push_back(subhaloMass[sidx]);
-        subCenterOfMassX.push_back(subhaloXCofMass[sidx]);
-        subCenterOfMassY.push_back(subhaloYCofMass[sidx]);
-        subCenterOfMassZ.push_back(subhaloZCofMass[sidx]);
-        subAvgX.push_back(subhaloXPos[sidx]);
-        subAvgY.push_back(subhaloYPos[sidx]);
-        subAvgZ.push_back(subhaloZPos[sidx]);
-        subAvgVX.push_back(subhaloXVel[sidx]);
-        subAvgVY.push_back(subhaloYVel[sidx]);
-        subAvgVZ.push_back(subhaloZVel[sidx]);
-        subVelDisp.push_back(subhaloVelDisp[sidx]);
-      }
-
-      size_t pointsBefore = shX.size();
-      subFinder.getSubhaloCosmoData(this->Internal->haloFinder->getHaloID(halo), shX, shY, shZ,
-        shVX, shVY, shVZ, shTag, shHID, shID);
-
-      for (size_t i = 0; pointsBefore + i < shX.size(); ++i)
-      {
-        subhaloId->SetValue(haloData.GetActualIndex(i), shID[pointsBefore + i]);
-      }
+      parentHaloTag.push_back(this->Internal->haloFinder->getHaloID(halo));
+      parentFOFCount.push_back(fofHaloCount[halo]);
+      subHaloTag.push_back(sidx);
+      subCount.push_back(result.Count[sidx]);
+      subMass.push_back(result.Mass[sidx]);
+      subCenterOfMassX.push_back(result.XCofMass[sidx]);
+      subCenterOfMassY.push_back(result.YCofMass[sidx]);
+      subCenterOfMassZ.push_back(result.ZCofMass[sidx]);
+      subAvgX.push_back(result.XPos[sidx]);
+      subAvgY.push_back(result.YPos[sidx]);
+      subAvgZ.push_back(result.ZPos[sidx]);
+      subAvgVX.push_back(result.XVel[sidx]);
+      subAvgVY.push_back(result.YVel[sidx]);
+      subAvgVZ.push_back(result.ZVel[sidx]);
+      subVelDisp.push_back(result.VelDisp[sidx]);
     }
   }
 
@@ -657,7 +723,9 @@ void vtkPANLHaloFinder::ExecuteSubHaloFinder(
 void vtkPANLHaloFinder::FindCenters(
   vtkUnstructuredGrid* allParticles, vtkUnstructuredGrid* fofProperties)
 {
-  if (this->CenterFindingMode == vtkPANLHaloFinder::NONE)
+  if (this->CenterFindingMode != MOST_BOUND_PARTICLE &&
+    this->CenterFindingMode != MOST_CONNECTED_PARTICLE &&
+    this->CenterFindingMode != HIST_CENTER_FINDING)
   {
     return;
   }
@@ -672,19 +740,23 @@ void vtkPANLHaloFinder::FindCenters(
   centers->SetNumberOfComponents(3);
   centers->SetNumberOfTuples(numberOfFOFHalos);
 
-  ExtractHalo haloData(numberOfFOFHalos, fofHaloCount, this->Internal->fof);
-  for (int halo = 0; halo < numberOfFOFHalos; ++halo)
-  {
-    haloData.SetCurrentHalo(halo);
+  std::vector<int> halos = HalosBySize(numberOfFOFHalos, fofHaloCount, 0);
+  int numberOfThreads = std::min(this->NumberOfThreads, static_cast<int>(halos.size()));
+  std::vector<ExtractHalo> haloData(
+    numberOfThreads, ExtractHalo(numberOfFOFHalos, fofHaloCount, this->Internal->fof));
+  float* centerValues = centers->GetPointer(0);
+  auto findCenter = [&](int halo, int thread) {
+    ExtractHalo& data = haloData[thread];
+    data.SetCurrentHalo(halo);
     cosmotk::HaloCenterFinder centerFinder;
-    haloData.SetParticles(centerFinder);
+    data.SetParticles(centerFinder);
     centerFinder.setParameters(this->BB, this->SmoothingLength, this->DistanceConvertFactor,
       this->RL, this->NP, OmegaMatter, OmegaCB, this->Hubble, this->RedShift);
     int centerIndex = -1;
     if (this->CenterFindingMode == MOST_BOUND_PARTICLE)
     {
       float minPotential;
-      if (haloData.GetNumberOfParticlesInCurrentHalo() < MBP_THRESHOLD)
+      if (data.GetNumberOfParticlesInCurrentHalo() < MBP_THRESHOLD)
       {
         centerIndex = centerFinder.mostBoundParticleN2(&minPotential);
       }
@@ -695,7 +767,7 @@ void vtkPANLHaloFinder::FindCenters(
     }
     else if (this->CenterFindingMode == MOST_CONNECTED_PARTICLE)
     {
-      if (haloData.GetNumberOfParticlesInCurrentHalo() < MCP_THRESHOLD)
+      if (data.GetNumberOfParticlesInCurrentHalo() < MCP_THRESHOLD)
       {
         centerIndex = centerFinder.mostConnectedParticleN2();
       }
@@ -704,23 +776,21 @@ void vtkPANLHaloFinder::FindCenters(
         centerIndex = centerFinder.mostConnectedParticleChainMesh();
       }
     }
-    else if (this->CenterFindingMode == HIST_CENTER_FINDING)
-    {
-      centerIndex = centerFinder.mostConnectedParticleHist();
-    }
     else
     {
-      return;
+      centerIndex = centerFinder.mostConnectedParticleHist();
     }
-    float center[] = { 0.0, 0.0, 0.0 };
+    float* center = centerValues + 3 * halo;
+    center[0] = center[1] = center[2] = 0.0;
     if (centerIndex >= 0)
     {
-      double* point = allParticles->GetPoint(haloData.GetActualIndex(centerIndex));
+      double point[3];
+      allParticles->GetPoint(data.GetActualIndex(centerIndex), point);
       center[0] = point[0];
       center[1] = point[1];
       center[2] = point[2];
     }
-    centers->SetTypedTuple(halo, center);
-  }
+  };
+  ForEachHalo(halos, numberOfThreads, findCenter);
   fofProperties->GetPointData()->AddArray(centers.GetPointer());
 }
@@ -187,6 +187,16 @@ class VTKPVVTKEXTENSIONSCOSMOTOOLS_EXPORT vtkPANLHaloFinder : public vtkUnstruct
     vtkSetMacro(NumNeighbors, int) vtkGetMacro(NumNeighbors, int)
     //@}
 
+    //@{
+    /**
+     * Gets/Sets the number of threads used in each process to find the halos,
+     * their subhalos and their centers.  The results are the same as with one
+     * thread.
+     * Default: 1
+     */
+    vtkSetClampMacro(NumberOfThreads, int, 1, VTK_INT_MAX) vtkGetMacro(NumberOfThreads, int)
+    //@}
+
     enum CenterFindingType {
       NONE = 0,
       MOST_BOUND_PARTICLE = 1,
@@ -277,6 +287,7 @@ class VTKPVVTKEXTENSIONSCOSMOTOOLS_EXPORT vtkPANLHaloFinder : public vtkUnstruct
   int MinCandidateSize;
   int NumSPHNeighbors;
   int NumNeighbors;
+  int NumberOfThreads;
 
   bool RunSubHaloFinder;
 
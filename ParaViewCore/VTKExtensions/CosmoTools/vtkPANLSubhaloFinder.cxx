@@ -31,22 +31,21 @@
 #include "FOFHaloProperties.h"
 #include "SubHaloFinder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <set>
+#include <thread>
 #include <vector>
 
 namespace
 {
 // magic number taken from BasicDefinition.h in the halo finder code
 static const double GRAVITY_C = 43.015e-10;
-}
 
-class vtkPANLSubhaloFinder::vtkInternals
+// The particles of a halo, loaded by one of the threads
+struct HaloParticles
 {
-public:
-  vtkInternals() {}
-  std::map<vtkIdType, std::vector<vtkIdType> > haloIndices;
-
   std::vector<POSVEL_T> xx;
   std::vector<POSVEL_T> yy;
   std::vector<POSVEL_T> zz;
@@ -56,6 +55,47 @@ public:
   std::vector<POSVEL_T> mass;
   std::vector<ID_T> id;
   std::vector<ID_T> actualIndex;
+};
+
+// Properties of the subhalos of one halo
+struct HaloSubhalos
+{
+  long ParticleCount = 0;
+  std::vector<int> Count;
+  std::vector<POSVEL_T> Mass, XPos, YPos, ZPos, XCofMass, YCofMass, ZCofMass, XVel, YVel, ZVel,
+    VelDisp;
+};
+
+// Calls work(i, thread) for i in [0, n) on numThreads threads, each thread
+// taking the next i when it is done with the previous one.
+template <typename Work>
+void ForEachHalo(vtkIdType n, int numThreads, Work& work)
+{
+  std::atomic<vtkIdType> next(0);
+  auto worker = [&](int thread) {
+    for (vtkIdType i = next++; i < n; i = next++)
+    {
+      work(i, thread);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < numThreads; ++thread)
+  {
+    threads.push_back(std::thread(worker, thread));
+  }
+  worker(0);
+  for (size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+}
+}
+
+class vtkPANLSubhaloFinder::vtkInternals
+{
+public:
+  vtkInternals() {}
+  std::map<vtkIdType, std::vector<vtkIdType> > haloIndices;
 
   void ReadHalos(vtkDataArray* haloTag, vtkIdList* halos)
   {
@@ -64,19 +104,21 @@ public:
     {
       haloIndices[halos->GetId(i)] = std::vector<vtkIdType>();
     }
-    for (int j = 0; j < haloTag->GetNumberOfTuples(); ++j)
+    for (vtkIdType j = 0; j < haloTag->GetNumberOfTuples(); ++j)
     {
-      for (int i = 0; i < halos->GetNumberOfIds(); ++i)
+      std::map<vtkIdType, std::vector<vtkIdType> >::iterator itr =
+        haloIndices.find(static_cast<vtkIdType>(haloTag->GetTuple1(j)));
+      if (itr != haloIndices.end())
       {
-        if (halos->GetId(i) == static_cast<vtkIdType>(haloTag->GetTuple1(j)))
-        {
-          haloIndices[halos->GetId(i)].push_back(j);
-        }
+        itr->second.push_back(j);
       }
     }
   }
 
-  void LoadHalo(vtkIdType haloId, double particleMass, vtkUnstructuredGrid* input)
+  // Loads the particles of a halo read by ReadHalos().  This is called by
+  // several threads at once, each with its own particles.
+  void LoadHalo(
+    vtkIdType haloId, double particleMass, vtkUnstructuredGrid* input, HaloParticles& particles)
   {
     vtkPointData* pd = input->GetPointData();
     assert(pd);
@@ -89,29 +131,30 @@ public:
     vtkDataArray* id_array = pd->GetArray("id");
     assert(id_array);
     double point[3];
-    std::vector<vtkIdType>& haloIdxs = haloIndices[haloId];
-    this->xx.resize(haloIdxs.size());
-    this->yy.resize(haloIdxs.size());
-    this->zz.resize(haloIdxs.size());
-    this->vx.resize(haloIdxs.size());
-    this->vy.resize(haloIdxs.size());
-    this->vz.resize(haloIdxs.size());
-    this->mass.resize(haloIdxs.size());
-    this->id.resize(haloIdxs.size());
-    this->actualIndex.resize(haloIdxs.size());
+    const std::vector<vtkIdType>& haloIdxs = haloIndices.find(haloId)->second;
+    particles.xx.resize(haloIdxs.size());
+    particles.yy.resize(haloIdxs.size());
+    particles.zz.resize(haloIdxs.size());
+    particles.vx.resize(haloIdxs.size());
+    particles.vy.resize(haloIdxs.size());
+    particles.vz.resize(haloIdxs.size());
+    particles.mass.resize(haloIdxs.size());
+    particles.id.resize(haloIdxs.size());
+    particles.actualIndex.resize(haloIdxs.size());
+    // GetComponent() rather than GetTuple1() which is not thread safe
     for (size_t i = 0; i < haloIdxs.size(); ++i)
     {
       vtkIdType idx = haloIdxs[i];
       input->GetPoint(idx, point);
-      this->xx[i] = point[0];
-      this->yy[i] = point[1];
-      this->zz[i] = point[2];
-      this->vx[i] = vx_array->GetTuple1(idx);
-      this->vy[i] = vy_array->GetTuple1(idx);
-      this->vz[i] = vz_array->GetTuple1(idx);
-      this->mass[i] = particleMass;
-      this->id[i] = id_array->GetTuple1(idx);
-      this->actualIndex[i] = idx;
+      particles.xx[i] = point[0];
+      particles.yy[i] = point[1];
+      particles.zz[i] = point[2];
+      particles.vx[i] = vx_array->GetComponent(idx, 0);
+      particles.vy[i] = vy_array->GetComponent(idx, 0);
+      particles.vz[i] = vz_array->GetComponent(idx, 0);
+      particles.mass[i] = particleMass;
+      particles.id[i] = id_array->GetComponent(idx, 0);
+      particles.actualIndex[i] = idx;
     }
   }
 };
@@ -134,6 +177,7 @@ vtkPANLSubhaloFinder::vtkPANLSubhaloFinder()
   this->MinCandidateSize = 200;
   this->NumSPHNeighbors = 64;
   this->NumNeighbors = 20;
+  this->NumberOfThreads = 1;
 }
 
 vtkPANLSubhaloFinder::~vtkPANLSubhaloFinder()
@@ -261,9 +305,6 @@ void vtkPANLSubhaloFinder::ExecuteSubHaloFinder(vtkUnstructuredGrid* input,
   std::vector<POSVEL_T> subMass, subCenterOfMassX, subCenterOfMassY, subCenterOfMassZ, subAvgX,
     subAvgY, subAvgZ, subAvgVX, subAvgVY, subAvgVZ, subVelDisp;
 
-  std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
-  std::vector<ID_T> shTag, shHID, shID;
-
   vtkNew<vtkTypeInt64Array> subhaloId;
   subhaloId->SetName("subhalo_tag");
   subhaloId->SetNumberOfTuples(input->GetNumberOfPoints());
@@ -305,24 +346,29 @@ void vtkPANLSubhaloFinder::ExecuteSubHaloFinder(vtkUnstructuredGrid* input,
     }
   }
 
-  for (int i = 0; i < finalHalosToProcess->GetNumberOfIds(); ++i)
-  {
+  vtkIdType numberOfHalos = finalHalosToProcess->GetNumberOfIds();
+  int numberOfThreads =
+    static_cast<int>(std::min(static_cast<vtkIdType>(this->NumberOfThreads), numberOfHalos));
+
+  // The halos have distinct particles so the threads set distinct subhalo tags.
+  std::vector<HaloParticles> particles(numberOfThreads);
+  std::vector<HaloSubhalos> subhalos(numberOfHalos);
+  vtkTypeInt64* subhaloIds = subhaloId->GetPointer(0);
+  auto findSubhalos = [&](vtkIdType i, int thread) {
     vtkIdType haloId = finalHalosToProcess->GetId(i);
-    vtkDebugMacro(<< "Processing halo: " << haloId);
-    this->Internal->LoadHalo(haloId, this->ParticleMass, input);
-    long particleCount = this->Internal->xx.size();
+    HaloParticles& halo = particles[thread];
+    this->Internal->LoadHalo(haloId, this->ParticleMass, input, halo);
+    long particleCount = halo.xx.size();
     if (particleCount == 0)
     {
-      continue;
+      return;
     }
 
     cosmotk::SubHaloFinder subFinder;
     subFinder.setParameters(this->ParticleMass, GRAVITY_C, this->AlphaFactor, this->BetaFactor,
       this->MinCandidateSize, this->NumSPHNeighbors, this->NumNeighbors);
-    subFinder.setParticles(this->Internal->xx.size(), &this->Internal->xx[0],
-      &this->Internal->yy[0], &this->Internal->zz[0], &this->Internal->vx[0],
-      &this->Internal->vy[0], &this->Internal->vz[0], &this->Internal->mass[0],
-      &this->Internal->id[0]);
+    subFinder.setParticles(halo.xx.size(), &halo.xx[0], &halo.yy[0], &halo.zz[0], &halo.vx[0],
+      &halo.vy[0], &halo.vz[0], &halo.mass[0], &halo.id[0]);
     subFinder.findSubHalos();
 
     int numberOfSubHalos = subFinder.getNumberOfSubhalos();
@@ -333,58 +379,51 @@ void vtkPANLSubhaloFinder::ExecuteSubHaloFinder(vtkUnstructuredGrid* input,
     cosmotk::FOFHaloProperties subhaloProperties;
     subhaloProperties.setHalos(numberOfSubHalos, fofSubHalos, fofSubHaloCount, fofSubHaloList);
     subhaloProperties.setParameters("", this->RL, this->DeadSize, this->BB);
-    subhaloProperties.setParticles(this->Internal->xx.size(), &this->Internal->xx[0],
-      &this->Internal->yy[0], &this->Internal->zz[0], &this->Internal->vx[0],
-      &this->Internal->vy[0], &this->Internal->vz[0], &this->Internal->mass[0],
-      &this->Internal->id[0]);
-
-    std::vector<POSVEL_T> subhaloMass;
-    subhaloProperties.FOFHaloMass(&subhaloMass);
-
-    std::vector<POSVEL_T> subhaloXPos;
-    std::vector<POSVEL_T> subhaloYPos;
-    std::vector<POSVEL_T> subhaloZPos;
-    subhaloProperties.FOFPosition(&subhaloXPos, &subhaloYPos, &subhaloZPos);
-
-    std::vector<POSVEL_T> subhaloXCofMass;
-    std::vector<POSVEL_T> subhaloYCofMass;
-    std::vector<POSVEL_T> subhaloZCofMass;
-    subhaloProperties.FOFCenterOfMass(&subhaloXCofMass, &subhaloYCofMass, &subhaloZCofMass);
-
-    std::vector<POSVEL_T> subhaloXVel;
-    std::vector<POSVEL_T> subhaloYVel;
-    std::vector<POSVEL_T> subhaloZVel;
-    subhaloProperties.FOFVelocity(&subhaloXVel, &subhaloYVel, &subhaloZVel);
-
-    std::vector<POSVEL_T> subhaloVelDisp;
+    subhaloProperties.setParticles(halo.xx.size(), &halo.xx[0], &halo.yy[0], &halo.zz[0],
+      &halo.vx[0], &halo.vy[0], &halo.vz[0], &halo.mass[0], &halo.id[0]);
+
+    HaloSubhalos& result = subhalos[i];
+    result.ParticleCount = particleCount;
+    result.Count.assign(fofSubHaloCount, fofSubHaloCount + numberOfSubHalos);
+    subhaloProperties.FOFHaloMass(&result.Mass);
+    subhaloProperties.FOFPosition(&result.XPos, &result.YPos, &result.ZPos);
+    subhaloProperties.FOFCenterOfMass(&result.XCofMass, &result.YCofMass, &result.ZCofMass);
+    subhaloProperties.FOFVelocity(&result.XVel, &result.YVel, &result.ZVel);
     subhaloProperties.FOFVelocityDispersion(
-      &subhaloXVel, &subhaloYVel, &subhaloZVel, &subhaloVelDisp);
+      &result.XVel, &result.YVel, &result.ZVel, &result.VelDisp);
 
-    for (int sidx = 0; sidx < numberOfSubHalos; ++sidx)
+    std::vector<POSVEL_T> shX, shY, shZ, shVX, shVY, shVZ;
+    std::vector<ID_T> shTag, shHID, shID;
+    subFinder.getSubhaloCosmoData(haloId, shX, shY, shZ, shVX, shVY, shVZ, shTag, shHID, shID);
+
+    for (size_t j = 0; j < shX.size(); ++j)
     {
-      parentHaloTag.push_back(haloId);
-      parentFOFCount.push_back(particleCount);
-      subHaloTag.push_back(sidx);
-      subCount.push_back(fofSubHaloCount[sidx]);
-      subMass.push_back(subhaloMass[sidx]);
-      subCenterOfMassX.push_back(subhaloXCofMass[sidx]);
-      subCenterOfMassY.push_back(subhaloYCofMass[sidx]);
-      subCenterOfMassZ.push_back(subhaloZCofMass[sidx]);
-      subAvgX.push_back(subhaloXPos[sidx]);
-      subAvgY.push_back(subhaloYPos[sidx]);
-      subAvgZ.push_back(subhaloZPos[sidx]);
-      subAvgVX.push_back(subhaloXVel[sidx]);
-      subAvgVY.push_back(subhaloYVel[sidx]);
-      subAvgVZ.push_back(subhaloZVel[sidx]);
-      subVelDisp.push_back(subhaloVelDisp[sidx]);
+      subhaloIds[halo.actualIndex[j]] = shID[j];
     }
+  };
+  ForEachHalo(numberOfHalos, numberOfThreads, findSubhalos);
 
-    size_t pointsBefore = shX.size();
-    subFinder.getSubhaloCosmoData(haloId, shX, shY, shZ, shVX, shVY, shVZ, shTag, shHID, shID);
-
-    for (size_t j = 0; pointsBefore + j < shX.size(); ++j)
+  // Gather the subhalos in the order of their halos
+  for (vtkIdType i = 0; i < numberOfHalos; ++i)
+  {
+    const HaloSubhalos& result = subhalos[i];
+    for (size_t sidx = 0; sidx < result.Count.size(); ++sidx)
     {
-      subhaloId->SetValue(this->Internal->actualIndex[j], shID[pointsBefore + j]);
+      parentHaloTag.push_back(finalHalosToProcess->GetId(i));
+      parentFOFCount.push_back(result.ParticleCount);
+      subHaloTag.push_back(sidx);
+      subCount.push_back(result.Count[sidx]);
+      subMass.push_back(result.Mass[sidx]);
+      subCenterOfMassX.push_back(result.XCofMass[sidx]);
+      subCenterOfMassY.push_back(result.YCofMass[sidx]);
+      subCenterOfMassZ.push_back(result.ZCofMass[sidx]);
+      subAvgX.push_back(result.XPos[sidx]);
+      subAvgY.push_back(result.YPos[sidx]);
+      subAvgZ.push_back(result.ZPos[sidx]);
+      subAvgVX.push_back(result.XVel[sidx]);
+      subAvgVY.push_back(result.YVel[sidx]);
+      subAvgVZ.push_back(result.ZVel[sidx]);
+      subVelDisp.push_back(result.VelDisp[sidx]);
     }
   }
 
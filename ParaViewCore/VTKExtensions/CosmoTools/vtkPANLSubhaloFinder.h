@@ -186,6 +186,16 @@ class VTKPVVTKEXTENSIONSCOSMOTOOLS_EXPORT vtkPANLSubhaloFinder : public vtkPassI
     vtkSetMacro(NumNeighbors, int) vtkGetMacro(NumNeighbors, int)
     //@}
 
+    //@{
+    /**
+     * Gets/Sets the number of threads used in each process to find the subhalos.
+     * Halos are processed concurrently and the results are the same as with one
+     * thread.
+     * Default: 1
+     */
+    vtkSetClampMacro(NumberOfThreads, int, 1, VTK_INT_MAX) vtkGetMacro(NumberOfThreads, int)
+    //@}
+
     protected : vtkPANLSubhaloFinder();
   virtual ~vtkPANLSubhaloFinder();
 
@@ -202,6 +212,7 @@ class VTKPVVTKEXTENSIONSCOSMOTOOLS_EXPORT vtkPANLSubhaloFinder : public vtkPassI
   int MinCandidateSize;
   int NumSPHNeighbors;
   int NumNeighbors;
+  int NumberOfThreads;
 
   int Mode;
   vtkIdType SizeThreshold;
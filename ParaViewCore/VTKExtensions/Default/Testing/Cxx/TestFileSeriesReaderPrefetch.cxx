@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSeriesReaderPrefetch.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the files vtkFileSeriesReader schedules for prefetching as time steps
+// are requested forward and backward, and that the memory limit is honored.
+
+#include "vtkCellArray.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataReader.h"
+#include "vtkPolyDataWriter.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const int NUMBER_OF_FILES = 8;
+
+// Each file is about 480 KB, so that two of them fit in 1 MB.
+std::string WriteFile(const std::string& dir, int index)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(40000);
+  for (vtkIdType cc = 0; cc < points->GetNumberOfPoints(); ++cc)
+  {
+    points->SetPoint(cc, cc, index, 0);
+  }
+  vtkNew<vtkPolyData> pd;
+  pd->SetPoints(points.Get());
+
+  std::ostringstream fname;
+  fname << dir << "/TestFileSeriesReaderPrefetch_" << index << ".vtk";
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputData(pd.Get());
+  writer->SetFileTypeToBinary();
+  writer->SetFileName(fname.str().c_str());
+  writer->Write();
+  return fname.str();
+}
+
+// Checks that the prefetch window holds the files of expected, in order.
+bool CheckWindow(vtkFileSeriesReader* reader, const std::vector<std::string>& files,
+  const std::vector<int>& expected, const char* step)
+{
+  bool same = reader->GetNumberOfPrefetchFileNames() == expected.size();
+  for (unsigned int cc = 0; same && cc < expected.size(); ++cc)
+  {
+    same = files[expected[cc]] == reader->GetPrefetchFileName(cc);
+  }
+  if (!same)
+  {
+    cerr << "ERROR: wrong prefetch window " << step << ": got";
+    for (unsigned int cc = 0; cc < reader->GetNumberOfPrefetchFileNames(); ++cc)
+    {
+      cerr << " " << reader->GetPrefetchFileName(cc);
+    }
+    cerr << endl;
+  }
+  return same;
+}
+
+std::vector<int> Window(int first, int last)
+{
+  std::vector<int> window;
+  const int step = first <= last ? 1 : -1;
+  for (int index = first; index != last + step; index += step)
+  {
+    window.push_back(index);
+  }
+  return window;
+}
+}
+
+int TestFileSeriesReaderPrefetch(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string dir = tempDir;
+  delete[] tempDir;
+
+  std::vector<std::string> files;
+  for (int cc = 0; cc < NUMBER_OF_FILES; ++cc)
+  {
+    files.push_back(WriteFile(dir, cc));
+  }
+  const unsigned long fileLength = vtksys::SystemTools::FileLength(files[0]);
+  if (fileLength < 350 * 1024 || fileLength > 512 * 1024)
+  {
+    cerr << "ERROR: unexpected file length " << fileLength << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The default comes from the general settings.
+  vtkFileSeriesReader::SetDefaultPrefetchNumberOfFiles(3);
+  vtkNew<vtkFileSeriesReader> reader;
+  vtkFileSeriesReader::SetDefaultPrefetchNumberOfFiles(0);
+  if (reader->GetPrefetchNumberOfFiles() != 3 ||
+    reader->GetPrefetchMemoryLimit() != vtkFileSeriesReader::GetDefaultPrefetchMemoryLimit())
+  {
+    cerr << "ERROR: the prefetch defaults were not used." << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkPolyDataReader> polyReader;
+  reader->SetReader(polyReader.Get());
+  reader->SetFileNameMethod("SetFileName");
+  for (int cc = 0; cc < NUMBER_OF_FILES; ++cc)
+  {
+    reader->AddFileName(files[cc].c_str());
+  }
+  reader->UpdateInformation();
+
+  // Without time, the time steps are the file indices. Forward first.
+  bool success = true;
+  reader->UpdateTimeStep(0);
+  success &= CheckWindow(reader.Get(), files, Window(1, 3), "at 0");
+  reader->UpdateTimeStep(1);
+  success &= CheckWindow(reader.Get(), files, Window(2, 4), "at 1, forward");
+  reader->UpdateTimeStep(4);
+  success &= CheckWindow(reader.Get(), files, Window(5, 7), "at 4, forward");
+  reader->UpdateTimeStep(6);
+  success &= CheckWindow(reader.Get(), files, Window(7, 7), "at 6, forward");
+
+  // Backward.
+  reader->UpdateTimeStep(5);
+  success &= CheckWindow(reader.Get(), files, Window(4, 2), "at 5, backward");
+  reader->UpdateTimeStep(2);
+  success &= CheckWindow(reader.Get(), files, Window(1, 0), "at 2, backward");
+
+  // Forward again, with a memory limit that only holds two files.
+  reader->SetPrefetchNumberOfFiles(5);
+  reader->SetPrefetchMemoryLimit(1);
+  reader->UpdateTimeStep(3);
+  success &= CheckWindow(reader.Get(), files, Window(4, 5), "at 3, 1 MB");
+
+  // Disabling prefetching empties the window.
+  reader->SetPrefetchNumberOfFiles(0);
+  reader->UpdateTimeStep(4);
+  success &= CheckWindow(reader.Get(), files, std::vector<int>(), "at 4, disabled");
+
+  for (int cc = 0; cc < NUMBER_OF_FILES; ++cc)
+  {
+    vtksys::SystemTools::RemoveFile(files[cc]);
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,12 +1,14 @@
 #include "vtkPEnSightGoldBinaryReader.h"
 
 #include "vtkByteSwap.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -16,6 +18,7 @@
 
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <ctype.h>
 #include <string>
 
@@ -24,21 +27,28 @@ vtkStandardNewMacro(vtkPEnSightGoldBinaryReader);
 // This is half the precision of an int.
 #define MAXIMUM_PART_ID 65536
 
+// Size of the buffer used by the file stream.
+#define VTK_PENSIGHT_GOLD_BINARY_READ_BUFFER_SIZE 1048576
+
 //----------------------------------------------------------------------------
 vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 {
   this->IFile = NULL;
+  this->IFileBuffer = new char[VTK_PENSIGHT_GOLD_BINARY_READ_BUFFER_SIZE];
   this->FileSize = 0;
   this->Fortran = 0;
   this->NodeIdsListed = 0;
   this->ElementIdsListed = 0;
 
-  this->FloatBufferSize = 1000;
+  this->FloatBufferSize = 131072;
 
+  // Room for the three components and the Fortran record markers, so that
+  // small records can be read with a single request.
+  this->FloatBufferStorage = new float[3 * this->FloatBufferSize + 6];
   this->FloatBuffer = (float**)malloc(3 * sizeof(float*));
-  this->FloatBuffer[0] = new float[this->FloatBufferSize];
-  this->FloatBuffer[1] = new float[this->FloatBufferSize];
-  this->FloatBuffer[2] = new float[this->FloatBufferSize];
+  this->FloatBuffer[0] = this->FloatBufferStorage;
+  this->FloatBuffer[1] = this->FloatBufferStorage + this->FloatBufferSize;
+  this->FloatBuffer[2] = this->FloatBufferStorage + 2 * this->FloatBufferSize;
   this->FloatBufferIndexBegin = -1;
   this->FloatBufferFilePosition = 0;
   this->FloatBufferNumberOfVectors = 0;
@@ -53,10 +63,9 @@ vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
     delete this->IFile;
     this->IFile = NULL;
   }
-  delete[] this->FloatBuffer[2];
-  delete[] this->FloatBuffer[1];
-  delete[] this->FloatBuffer[0];
+  delete[] this->FloatBufferStorage;
   free(this->FloatBuffer);
+  delete[] this->IFileBuffer;
 }
 
 //----------------------------------------------------------------------------
@@ -84,10 +93,14 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
 
+    // Use a large stream buffer, the headers of the records are read with
+    // many small reads that should not each be a request to the file system.
+    this->IFile = new ifstream;
+    this->IFile->rdbuf()->pubsetbuf(this->IFileBuffer, VTK_PENSIGHT_GOLD_BINARY_READ_BUFFER_SIZE);
 #ifdef _WIN32
-    this->IFile = new ifstream(filename, ios::in | ios::binary);
+    this->IFile->open(filename, ios::in | ios::binary);
 #else
-    this->IFile = new ifstream(filename, ios::in);
+    this->IFile->open(filename, ios::in);
 #endif
   }
   else
@@ -249,6 +262,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     int j = 0;
     // Try to find the nearest time step for which we know the offset
     for (i = realTimeStep; i >= 0; i--)
@@ -266,7 +280,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(
     // Find it (and cache any timestep we find on the way...)
     while (j++ < realTimeStep)
     {
-      if (!this->SkipTimeStep())
+      if (!this->SkipTimeStep(fileName, j - 1))
       {
         return 0;
       }
@@ -330,8 +344,11 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(
     lineRead = this->ReadLine(line); // "part"
   }
 
+  // The offsets of the parts are kept once the whole time step is read.
+  std::map<int, long> partOffsets;
   while (lineRead > 0 && strncmp(line, "part", 4) == 0)
   {
+    long partOffset = this->IFile->tellg();
     this->ReadPartId(&partId);
     partId--; // EnSight starts #ing at 1.
     if (partId < 0 || partId >= MAXIMUM_PART_ID)
@@ -340,6 +357,7 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(
       return 0;
     }
     realId = this->InsertNewPartId(partId);
+    partOffsets[partId] = partOffset;
 
     // Increment the number of geometry parts such that the measured geometry,
     // if any, can be properly combined into a vtkMultiBlockDataSet object.
@@ -412,6 +430,10 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(
   {
     return 0;
   }
+  if (this->UseFileSets)
+  {
+    this->PartOffsets[fileName][timeStep - 1] = partOffsets;
+  }
 
   return 1;
 }
@@ -498,42 +520,56 @@ int vtkPEnSightGoldBinaryReader::SkipTimeStep()
       vtkErrorMacro("Invalid part id; check that ByteOrder is set correctly.");
       return 0;
     }
-    this->ReadLine(line); // part description line
-    this->ReadLine(line);
+    lineRead = this->SkipPart(line);
+  }
 
-    if (strncmp(line, "block", 5) == 0)
+  if (lineRead < 0)
+  {
+    if (this->IFile)
     {
-      if (sscanf(line, " %*s %s", subLine) == 1)
-      {
-        if (strncmp(subLine, "rectilinear", 11) == 0)
-        {
-          // block rectilinear
-          lineRead = this->SkipRectilinearGrid(line);
-        }
-        else if (strncmp(subLine, "uniform,", 7) == 0)
-        {
-          // block uniform
-          lineRead = this->SkipImageData(line);
-        }
-        else
-        {
-          // block iblanked
-          lineRead = this->SkipStructuredGrid(line);
-        }
-      }
-      else
-      {
-        // block
-        lineRead = this->SkipStructuredGrid(line);
-      }
+      this->IFile->close();
+      delete this->IFile;
+      this->IFile = NULL;
     }
-    else
+    return 0;
+  }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::SkipTimeStep(const char* fileName, int timeStep)
+{
+  // The parts that follow the last one are the end of the time step.
+  long lastPartOffset = -1;
+  std::map<std::string, std::map<int, std::map<int, long> > >::const_iterator file =
+    this->PartOffsets.find(fileName);
+  if (file != this->PartOffsets.end())
+  {
+    std::map<int, std::map<int, long> >::const_iterator step = file->second.find(timeStep);
+    if (step != file->second.end())
     {
-      lineRead = this->SkipUnstructuredGrid(line);
+      std::map<int, long>::const_iterator part;
+      for (part = step->second.begin(); part != step->second.end(); ++part)
+      {
+        lastPartOffset = std::max(lastPartOffset, part->second);
+      }
     }
   }
+  if (lastPartOffset < 0)
+  {
+    return this->SkipTimeStep();
+  }
 
-  if (lineRead < 0)
+  char line[80];
+  int partId;
+  this->IFile->seekg(lastPartOffset, ios::beg);
+  if (!this->ReadPartId(&partId) || partId < 0 || partId > MAXIMUM_PART_ID)
+  {
+    vtkErrorMacro("Invalid part id; check that ByteOrder is set correctly.");
+    return 0;
+  }
+  if (this->SkipPart(line) < 0)
   {
     if (this->IFile)
     {
@@ -543,10 +579,51 @@ int vtkPEnSightGoldBinaryReader::SkipTimeStep()
     }
     return 0;
   }
-
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::SkipPart(char line[80])
+{
+  char subLine[80];
+  int lineRead;
+
+  this->ReadLine(line); // part description line
+  this->ReadLine(line);
+
+  if (strncmp(line, "block", 5) == 0)
+  {
+    if (sscanf(line, " %*s %s", subLine) == 1)
+    {
+      if (strncmp(subLine, "rectilinear", 11) == 0)
+      {
+        // block rectilinear
+        lineRead = this->SkipRectilinearGrid(line);
+      }
+      else if (strncmp(subLine, "uniform,", 7) == 0)
+      {
+        // block uniform
+        lineRead = this->SkipImageData(line);
+      }
+      else
+      {
+        // block iblanked
+        lineRead = this->SkipStructuredGrid(line);
+      }
+    }
+    else
+    {
+      // block
+      lineRead = this->SkipStructuredGrid(line);
+    }
+  }
+  else
+  {
+    lineRead = this->SkipUnstructuredGrid(line);
+  }
+  return lineRead;
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::SkipStructuredGrid(char line[256])
 {
@@ -1092,7 +1169,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(
   char line[80], subLine[80];
   vtkIdType i;
   int* pointIds;
-  float *xCoords, *yCoords, *zCoords;
+  float* coords;
   vtkPoints* points = vtkPoints::New();
   vtkPolyData* pd = vtkPolyData::New();
 
@@ -1139,6 +1216,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     int k, j = 0;
     // Try to find the nearest time step for which we know the offset
     for (k = realTimeStep; k >= 0; k--)
@@ -1218,12 +1296,11 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(
     partId, dimensions, newDimensions, &splitDimension, &splitDimensionBeginIndex, 0, NULL, NULL);
 
   pointIds = new int[this->NumberOfMeasuredPoints];
-  xCoords = new float[this->NumberOfMeasuredPoints];
-  yCoords = new float[this->NumberOfMeasuredPoints];
-  zCoords = new float[this->NumberOfMeasuredPoints];
+  coords = new float[3 * this->NumberOfMeasuredPoints];
 
   points->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
-  pd->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
+  vtkNew<vtkIdTypeArray> verts;
+  verts->Allocate(2 * this->GetPointIds(partId)->GetLocalNumberOfIds());
 
   // Extract the array of point indices. Note EnSight Manual v8.2 (pp. 559,
   // http://www-vis.lbl.gov/NERSC/Software/ensight/docs82/UserManual.pdf)
@@ -1235,48 +1312,37 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(
   this->ReadIntArray(pointIds, this->NumberOfMeasuredPoints);
 
   // Read point coordinates tuple by tuple while each tuple contains three
-  // components: (x-cord, y-cord, z-cord)
-  int floatSize = sizeof(float);
-  for (i = 0; i < this->NumberOfMeasuredPoints; i++)
-  {
-    this->IFile->read((char*)(xCoords + i), floatSize);
-    this->IFile->read((char*)(yCoords + i), floatSize);
-    this->IFile->read((char*)(zCoords + i), floatSize);
-  }
-
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-  {
-    vtkByteSwap::Swap4LERange(xCoords, this->NumberOfMeasuredPoints);
-    vtkByteSwap::Swap4LERange(yCoords, this->NumberOfMeasuredPoints);
-    vtkByteSwap::Swap4LERange(zCoords, this->NumberOfMeasuredPoints);
-  }
-  else
+  // components: (x-cord, y-cord, z-cord). The tuples are contiguous, so they
+  // are read with a single request.
+  if (this->NumberOfMeasuredPoints > 0 &&
+    !this->IFile->read((char*)coords, 3 * sizeof(float) * this->NumberOfMeasuredPoints).good())
   {
-    vtkByteSwap::Swap4BERange(xCoords, this->NumberOfMeasuredPoints);
-    vtkByteSwap::Swap4BERange(yCoords, this->NumberOfMeasuredPoints);
-    vtkByteSwap::Swap4BERange(zCoords, this->NumberOfMeasuredPoints);
+    vtkErrorMacro("Read failed");
   }
+  this->ByteSwapRange(coords, 3 * this->NumberOfMeasuredPoints);
 
+  // One vertex for each point, their connectivity is written directly.
   for (i = 0; i < this->NumberOfMeasuredPoints; i++)
   {
     int realId = this->GetPointIds(partId)->GetId(i);
     if (realId != -1)
     {
-      vtkIdType tempId = realId;
-      points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
-      pd->InsertNextCell(VTK_VERTEX, 1, &tempId);
+      points->InsertNextPoint(coords + 3 * i);
+      verts->InsertNextValue(1);
+      verts->InsertNextValue(realId);
     }
   }
+  vtkNew<vtkCellArray> vertices;
+  vertices->SetCells(verts->GetNumberOfTuples() / 2, verts.GetPointer());
 
   pd->SetPoints(points);
+  pd->SetVerts(vertices.GetPointer());
   this->AddToBlock(output, partId, pd);
 
   points->Delete();
   pd->Delete();
   delete[] pointIds;
-  delete[] xCoords;
-  delete[] yCoords;
-  delete[] zCoords;
+  delete[] coords;
 
   if (this->IFile)
   {
@@ -1330,6 +1396,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(const char* fileName, const
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1552,6 +1619,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(const char* fileName, const
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1763,6 +1831,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(const char* fileName, const
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     int j = 0;
     // Try to find the nearest time step for which we know the offset
     for (i = realTimeStep; i >= 0; i--)
@@ -1927,6 +1996,7 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(const char* fileName,
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2183,6 +2253,7 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(const char* fileName,
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2432,6 +2503,7 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(const char* fileName,
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -2664,7 +2736,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 {
   int lineRead = 1;
   int i, j;
-  vtkIdType* nodeIds;
   int* nodeIdList;
   int numElements;
   int idx, cellType;
@@ -2734,8 +2805,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         return -1;
       }
 
-      nodeIds = new vtkIdType[1];
-
       if (this->ElementIdsListed)
       {
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
@@ -2743,15 +2812,9 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements];
       this->ReadIntArray(nodeIdList, numElements);
+      this->InsertCellsAndIds(output, VTK_VERTEX, 1, NULL, nodeIdList, NULL, idx,
+        vtkPEnSightReader::POINT, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        nodeIds[0] = nodeIdList[i] - 1;
-        this->InsertNextCellAndId(
-          output, VTK_VERTEX, 1, nodeIds, idx, vtkPEnSightReader::POINT, i, numElements);
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_point", 7) == 0)
@@ -2785,7 +2848,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         vtkErrorMacro("Invalid number of bar2 cells; check that ByteOrder is set correctly.");
         return -1;
       }
-      nodeIds = new vtkIdType[2];
       if (this->ElementIdsListed)
       {
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
@@ -2793,18 +2855,9 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements * 2];
       this->ReadIntArray(nodeIdList, numElements * 2);
+      this->InsertCellsAndIds(
+        output, VTK_LINE, 2, NULL, nodeIdList, NULL, idx, vtkPEnSightReader::BAR2, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        for (j = 0; j < 2; j++)
-        {
-          nodeIds[j] = nodeIdList[2 * i + j] - 1;
-        }
-        this->InsertNextCellAndId(
-          output, VTK_LINE, 2, nodeIds, idx, vtkPEnSightReader::BAR2, i, numElements);
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_bar2", 6) == 0)
@@ -2838,8 +2891,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         vtkErrorMacro("Invalid number of bar3 cells; check that ByteOrder is set correctly.");
         return -1;
       }
-      nodeIds = new vtkIdType[3];
-
       if (this->ElementIdsListed)
       {
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
@@ -2847,17 +2898,10 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
 
       nodeIdList = new int[numElements * 3];
       this->ReadIntArray(nodeIdList, numElements * 3);
+      static const int bar3Order[3] = { 0, 2, 1 };
+      this->InsertCellsAndIds(output, VTK_QUADRATIC_EDGE, 3, NULL, nodeIdList, bar3Order, idx,
+        vtkPEnSightReader::BAR3, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        nodeIds[0] = nodeIdList[3 * i] - 1;
-        nodeIds[1] = nodeIdList[3 * i + 2] - 1;
-        nodeIds[2] = nodeIdList[3 * i + 1] - 1;
-        this->InsertNextCellAndId(
-          output, VTK_QUADRATIC_EDGE, 3, nodeIds, idx, vtkPEnSightReader::BAR3, i, numElements);
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_bar3", 6) == 0)
@@ -2886,7 +2930,6 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       vtkDebugMacro("nsided");
       int* numNodesPerElement;
       int numNodes = 0;
-      int nodeCount = 0;
 
       cellType = vtkPEnSightReader::NSIDED;
       this->ReadInt(&numElements);
@@ -2910,20 +2953,8 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       }
       nodeIdList = new int[numNodes];
       this->ReadIntArray(nodeIdList, numNodes);
-
-      for (i = 0; i < numElements; i++)
-      {
-        nodeIds = new vtkIdType[numNodesPerElement[i]];
-        for (j = 0; j < numNodesPerElement[i]; j++)
-        {
-          nodeIds[j] = nodeIdList[nodeCount] - 1;
-          nodeCount++;
-        }
-        this->InsertNextCellAndId(
-          output, VTK_POLYGON, numNodesPerElement[i], nodeIds, idx, cellType, i, numElements);
-
-        delete[] nodeIds;
-      }
+      this->InsertCellsAndIds(
+        output, VTK_POLYGON, 0, numNodesPerElement, nodeIdList, NULL, idx, cellType, numElements);
 
       delete[] nodeIdList;
       delete[] numNodesPerElement;
@@ -2985,42 +3016,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 3;
+      int vtkType = VTK_TRIANGLE;
       if (cellType == vtkPEnSightReader::TRIA6)
       {
-        nodeIds = new vtkIdType[6];
-        nodeIdList = new int[numElements * 6];
-        this->ReadIntArray(nodeIdList, numElements * 6);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[3];
-        nodeIdList = new int[numElements * 3];
-        this->ReadIntArray(nodeIdList, numElements * 3);
+        numNodesPerElement = 6;
+        vtkType = VTK_QUADRATIC_TRIANGLE;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::TRIA6)
-        {
-          for (j = 0; j < 6; j++)
-          {
-            nodeIds[j] = nodeIdList[6 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_TRIANGLE, 6, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 3; j++)
-          {
-            nodeIds[j] = nodeIdList[3 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_TRIANGLE, 3, nodeIds, idx, cellType, i, numElements);
-        }
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_tria3", 7) == 0 || strncmp(line, "g_tria6", 7) == 0)
@@ -3086,41 +3093,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 4;
+      int vtkType = VTK_QUAD;
       if (cellType == vtkPEnSightReader::QUAD8)
       {
-        nodeIds = new vtkIdType[8];
-        nodeIdList = new int[numElements * 8];
-        this->ReadIntArray(nodeIdList, numElements * 8);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[4];
-        nodeIdList = new int[numElements * 4];
-        this->ReadIntArray(nodeIdList, numElements * 4);
-      }
-
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::QUAD8)
-        {
-          for (j = 0; j < 8; j++)
-          {
-            nodeIds[j] = nodeIdList[8 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_QUAD, 8, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 4; j++)
-          {
-            nodeIds[j] = nodeIdList[4 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(output, VTK_QUAD, 4, nodeIds, idx, cellType, i, numElements);
-        }
+        numNodesPerElement = 8;
+        vtkType = VTK_QUADRATIC_QUAD;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_quad4", 7) == 0 || strncmp(line, "g_quad8", 7) == 0)
@@ -3229,27 +3213,28 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
       nodeIdList = new int[numNodes];
       this->ReadIntArray(nodeIdList, numNodes);
 
+      // Keep each node once per element, the nodes kept are moved to the
+      // front of the list.
+      int uniqueNodeCount = 0;
       for (i = 0; i < numElements; i++)
       {
         // For each nfaced...
         elementNodeCount = 0;
-        nodeIds = new vtkIdType[numNodesPerElement[i]];
         for (j = 0; j < numNodesPerElement[i]; j++)
         {
           // For each Node (Point) in Element (Nfaced) ...
           if (nodeMarker[nodeIdList[nodeCount] - 1] < i)
           {
-            nodeIds[elementNodeCount] = nodeIdList[nodeCount] - 1;
             nodeMarker[nodeIdList[nodeCount] - 1] = i;
+            nodeIdList[uniqueNodeCount++] = nodeIdList[nodeCount];
             elementNodeCount += 1;
           }
           nodeCount++;
         }
-        this->InsertNextCellAndId(
-          output, VTK_CONVEX_POINT_SET, elementNodeCount, nodeIds, idx, cellType, i, numElements);
-
-        delete[] nodeIds;
+        numNodesPerElement[i] = elementNodeCount;
       }
+      this->InsertCellsAndIds(output, VTK_CONVEX_POINT_SET, 0, numNodesPerElement, nodeIdList,
+        NULL, idx, cellType, numElements);
 
       delete[] nodeMarker;
       delete[] nodeIdList;
@@ -3282,41 +3267,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 4;
+      int vtkType = VTK_TETRA;
       if (cellType == vtkPEnSightReader::TETRA10)
       {
-        nodeIds = new vtkIdType[10];
-        nodeIdList = new int[numElements * 10];
-        this->ReadIntArray(nodeIdList, numElements * 10);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[4];
-        nodeIdList = new int[numElements * 4];
-        this->ReadIntArray(nodeIdList, numElements * 4);
+        numNodesPerElement = 10;
+        vtkType = VTK_QUADRATIC_TETRA;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::TETRA10)
-        {
-          for (j = 0; j < 10; j++)
-          {
-            nodeIds[j] = nodeIdList[10 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_TETRA, 10, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 4; j++)
-          {
-            nodeIds[j] = nodeIdList[4 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(output, VTK_TETRA, 4, nodeIds, idx, cellType, i, numElements);
-        }
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_tetra4", 8) == 0 || strncmp(line, "g_tetra10", 9) == 0)
@@ -3383,41 +3345,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 5;
+      int vtkType = VTK_PYRAMID;
       if (cellType == vtkPEnSightReader::PYRAMID13)
       {
-        nodeIds = new vtkIdType[13];
-        nodeIdList = new int[numElements * 13];
-        this->ReadIntArray(nodeIdList, numElements * 13);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[5];
-        nodeIdList = new int[numElements * 5];
-        this->ReadIntArray(nodeIdList, numElements * 5);
+        numNodesPerElement = 13;
+        vtkType = VTK_QUADRATIC_PYRAMID;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::PYRAMID13)
-        {
-          for (j = 0; j < 13; j++)
-          {
-            nodeIds[j] = nodeIdList[13 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_PYRAMID, 13, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 5; j++)
-          {
-            nodeIds[j] = nodeIdList[5 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(output, VTK_PYRAMID, 5, nodeIds, idx, cellType, i, numElements);
-        }
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_pyramid5", 10) == 0 || strncmp(line, "g_pyramid13", 11) == 0)
@@ -3483,41 +3422,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 8;
+      int vtkType = VTK_HEXAHEDRON;
       if (cellType == vtkPEnSightReader::HEXA20)
       {
-        nodeIds = new vtkIdType[20];
-        nodeIdList = new int[numElements * 20];
-        this->ReadIntArray(nodeIdList, numElements * 20);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[8];
-        nodeIdList = new int[numElements * 8];
-        this->ReadIntArray(nodeIdList, numElements * 8);
+        numNodesPerElement = 20;
+        vtkType = VTK_QUADRATIC_HEXAHEDRON;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::HEXA20)
-        {
-          for (j = 0; j < 20; j++)
-          {
-            nodeIds[j] = nodeIdList[20 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_HEXAHEDRON, 20, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 8; j++)
-          {
-            nodeIds[j] = nodeIdList[8 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_HEXAHEDRON, 8, nodeIds, idx, cellType, i, numElements);
-        }
-      }
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_hexa8", 7) == 0 || strncmp(line, "g_hexa20", 8) == 0)
@@ -3583,41 +3499,18 @@ int vtkPEnSightGoldBinaryReader::CreateUnstructuredGridOutput(
         this->IFile->seekg(sizeof(int) * numElements, ios::cur);
       }
 
+      int numNodesPerElement = 6;
+      int vtkType = VTK_WEDGE;
       if (cellType == vtkPEnSightReader::PENTA15)
       {
-        nodeIds = new vtkIdType[15];
-        nodeIdList = new int[numElements * 15];
-        this->ReadIntArray(nodeIdList, numElements * 15);
-      }
-      else
-      {
-        nodeIds = new vtkIdType[6];
-        nodeIdList = new int[numElements * 6];
-        this->ReadIntArray(nodeIdList, numElements * 6);
+        numNodesPerElement = 15;
+        vtkType = VTK_QUADRATIC_WEDGE;
       }
+      nodeIdList = new int[numElements * numNodesPerElement];
+      this->ReadIntArray(nodeIdList, numElements * numNodesPerElement);
+      this->InsertCellsAndIds(output, vtkType, numNodesPerElement, NULL, nodeIdList, NULL, idx,
+        cellType, numElements);
 
-      for (i = 0; i < numElements; i++)
-      {
-        if (cellType == vtkPEnSightReader::PENTA15)
-        {
-          for (j = 0; j < 15; j++)
-          {
-            nodeIds[j] = nodeIdList[15 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(
-            output, VTK_QUADRATIC_WEDGE, 15, nodeIds, idx, cellType, i, numElements);
-        }
-        else
-        {
-          for (j = 0; j < 6; j++)
-          {
-            nodeIds[j] = nodeIdList[6 * i + j] - 1;
-          }
-          this->InsertNextCellAndId(output, VTK_WEDGE, 6, nodeIds, idx, cellType, i, numElements);
-        }
-      }
-
-      delete[] nodeIds;
       delete[] nodeIdList;
     }
     else if (strncmp(line, "g_penta6", 8) == 0 || strncmp(line, "g_penta15", 9) == 0)
@@ -4255,14 +4148,7 @@ int vtkPEnSightGoldBinaryReader::ReadIntArray(int* result, int numInts)
     return 0;
   }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-  {
-    vtkByteSwap::Swap4LERange(result, numInts);
-  }
-  else
-  {
-    vtkByteSwap::Swap4BERange(result, numInts);
-  }
+  this->ByteSwapRange(result, numInts);
 
   if (this->Fortran)
   {
@@ -4301,14 +4187,7 @@ int vtkPEnSightGoldBinaryReader::ReadFloatArray(float* result, int numFloats)
     return 0;
   }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-  {
-    vtkByteSwap::Swap4LERange(result, numFloats);
-  }
-  else
-  {
-    vtkByteSwap::Swap4BERange(result, numFloats);
-  }
+  this->ByteSwapRange(result, numFloats);
 
   if (this->Fortran)
   {
@@ -4502,8 +4381,36 @@ void vtkPEnSightGoldBinaryReader::UpdateFloatBuffer()
     sizeToRead = this->FloatBufferSize;
   }
 
+  if (sizeToRead > 0 && this->FloatBufferIndexBegin == 0 &&
+    sizeToRead == this->FloatBufferNumberOfVectors)
+  {
+    // The buffer holds the whole record: read the three components, and the
+    // Fortran record markers between them, with a single request.
+    int numWords = 3 * sizeToRead;
+    int stride = sizeToRead;
+    if (this->Fortran)
+    {
+      numWords += 6;
+      stride += 2;
+    }
+    this->IFile->seekg(this->FloatBufferFilePosition);
+    if (!this->IFile->read((char*)this->FloatBufferStorage, sizeof(float) * numWords).good())
+    {
+      vtkErrorMacro("Read failed");
+    }
+    this->ByteSwapRange(this->FloatBufferStorage, numWords);
+    for (int i = 0; i < 3; i++)
+    {
+      this->FloatBuffer[i] = this->FloatBufferStorage + i * stride + (this->Fortran ? 1 : 0);
+    }
+    this->IFile->seekg(currentPosition);
+    return;
+  }
+
   for (int i = 0; i < 3; i++)
   {
+    this->FloatBuffer[i] = this->FloatBufferStorage + i * this->FloatBufferSize;
+
     // We cannot use ReadFloatArray method, because Fortran format has dummy things
     if (this->Fortran)
       this->IFile->seekg(this->FloatBufferFilePosition + 4 +
@@ -4519,19 +4426,33 @@ void vtkPEnSightGoldBinaryReader::UpdateFloatBuffer()
       vtkErrorMacro("Read failed");
     }
 
-    if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-    {
-      vtkByteSwap::Swap4LERange(this->FloatBuffer[i], sizeToRead);
-    }
-    else
-    {
-      vtkByteSwap::Swap4BERange(this->FloatBuffer[i], sizeToRead);
-    }
+    this->ByteSwapRange(this->FloatBuffer[i], sizeToRead);
   }
 
   this->IFile->seekg(currentPosition);
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::ByteSwapRange(void* data, vtkIdType numWords)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  if (this->ByteOrder != FILE_LITTLE_ENDIAN)
+#else
+  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
+#endif
+  {
+    return;
+  }
+  // Shifts and masks rather than byte copies, so that the compiler can
+  // vectorize the loop.
+  vtkTypeUInt32* words = static_cast<vtkTypeUInt32*>(data);
+  for (vtkIdType i = 0; i < numWords; ++i)
+  {
+    const vtkTypeUInt32 w = words[i];
+    words[i] = (w >> 24) | ((w >> 8) & 0x0000ff00) | ((w << 8) & 0x00ff0000) | (w << 24);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
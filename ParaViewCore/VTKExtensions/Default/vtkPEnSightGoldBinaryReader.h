@@ -171,6 +171,12 @@ protected:
    */
   int ReadFloatArray(float* result, int numFloats);
 
+  /**
+   * Swaps the bytes of 4 byte words read from the file, if the byte order of
+   * the file differs from the one of this machine.
+   */
+  void ByteSwapRange(void* data, vtkIdType numWords);
+
   /**
    * Read Coordinates, or just skip the part in the file.
    */
@@ -192,9 +198,14 @@ protected:
 
   //@{
   /**
-   * Read to the next time step in the geometry file.
+   * Read to the next time step in the geometry file. When the parts of
+   * timeStep of fileName are in PartOffsets, only its last part is read.
+   * SkipPart reads past a part whose id was just read and returns the result
+   * of reading the line that follows it.
    */
   int SkipTimeStep();
+  int SkipTimeStep(const char* fileName, int timeStep);
+  int SkipPart(char line[80]);
   int SkipStructuredGrid(char line[256]);
   int SkipUnstructuredGrid(char line[256]);
   int SkipRectilinearGrid(char line[256]);
@@ -206,15 +217,18 @@ protected:
   int Fortran;
 
   ifstream* IFile;
+  // The buffer used by IFile.
+  char* IFileBuffer;
   // The size of the file could be used to choose byte order.
   long FileSize;
 
   // Float Vector Buffer utils
   void GetVectorFromFloatBuffer(int i, float* vector);
   void UpdateFloatBuffer();
-  // The buffer
+  // The buffer, FloatBuffer[i] points in FloatBufferStorage
   float** FloatBuffer;
-  // The buffer size. Default is 1000
+  float* FloatBufferStorage;
+  // The buffer size. Default is 131072
   int FloatBufferSize;
   // The FloatBuffer store the vectors
   // from FloatBufferIndexBegin to FloatBufferIndexBegin + FloatBufferSize
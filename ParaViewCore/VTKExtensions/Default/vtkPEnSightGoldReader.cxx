@@ -111,6 +111,7 @@ int vtkPEnSightGoldReader::ReadGeometryFile(
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -316,6 +317,7 @@ int vtkPEnSightGoldReader::ReadMeasuredGeometryFile(
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -466,6 +468,7 @@ int vtkPEnSightGoldReader::ReadScalarsPerNode(const char* fileName, const char*
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -686,6 +689,7 @@ int vtkPEnSightGoldReader::ReadVectorsPerNode(const char* fileName, const char*
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -865,6 +869,7 @@ int vtkPEnSightGoldReader::ReadTensorsPerNode(const char* fileName, const char*
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -991,6 +996,7 @@ int vtkPEnSightGoldReader::ReadScalarsPerElement(const char* fileName, const cha
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     int j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1198,6 +1204,7 @@ int vtkPEnSightGoldReader::ReadVectorsPerElement(const char* fileName, const cha
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     j = 0;
     for (i = realTimeStep; i >= 0; i--)
@@ -1367,6 +1374,7 @@ int vtkPEnSightGoldReader::ReadTensorsPerElement(const char* fileName, const cha
   if (this->UseFileSets)
   {
     int realTimeStep = timeStep - 1;
+    this->LoadFileOffsets(fileName);
     // Try to find the nearest time step for which we know the offset
     j = 0;
     for (i = realTimeStep; i >= 0; i--)
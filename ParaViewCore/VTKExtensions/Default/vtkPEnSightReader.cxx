@@ -15,6 +15,7 @@
 
 #include "vtkPEnSightReader.h"
 
+#include "vtkCellArray.h"
 #include "vtkDataArrayCollection.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
@@ -22,12 +23,14 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkStructuredPoints.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include "vtkBSPCuts.h"
@@ -40,6 +43,11 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObject.h"
 
+#include <vtksys/SystemTools.hxx>
+
+#include <cstdlib>
+#include <set>
+
 typedef std::vector<vtkPEnSightReader::vtkPEnSightReaderCellIds*> vtkPEnSightReaderCellIdsTypeBase;
 class vtkPEnSightReaderCellIdsType : public vtkPEnSightReaderCellIdsTypeBase
 {
@@ -47,6 +55,10 @@ class vtkPEnSightReaderCellIdsType : public vtkPEnSightReaderCellIdsTypeBase
 
 namespace
 {
+// Identifies the index files written by SaveFileOffsets.
+const char* const TimeStepIndexHeader = "ParaViewEnSightTimeStepIndex";
+const int TimeStepIndexVersion = 2;
+
 void cleanup(vtkPEnSightReaderCellIdsType* foo)
 {
   if (!foo)
@@ -437,6 +449,7 @@ int vtkPEnSightReader::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  this->SaveFileOffsets();
   return 1;
 }
 
@@ -2313,15 +2326,18 @@ void vtkPEnSightReader::InsertNextCellAndId(vtkUnstructuredGrid* output, int vtk
   vtkIdType begin = mpiLocalProcessId * numElnts;
   if ((globalId >= begin) && (globalId < (begin + numElnts)))
   {
-    // First note the points : they will be injected later
-    vtkIdType* newPoints = new vtkIdType[numPoints];
+    // First note the points : they will be injected later. Most cells have
+    // few points, avoid allocating the ids for each of them.
+    vtkIdType newPointsBuffer[64];
+    vtkIdType* newPoints = numPoints <= 64 ? newPointsBuffer : new vtkIdType[numPoints];
 
+    vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
     for (int i = 0; i < numPoints; i++)
     {
-      int realId = this->GetPointIds(partId)->GetId(points[i]);
+      int realId = pointIds->GetId(points[i]);
       if (realId == -1)
       {
-        this->GetPointIds(partId)->SetId(points[i], this->LastPointId);
+        pointIds->SetId(points[i], this->LastPointId);
         newPoints[i] = this->LastPointId;
         this->LastPointId++;
       }
@@ -2333,7 +2349,10 @@ void vtkPEnSightReader::InsertNextCellAndId(vtkUnstructuredGrid* output, int vtk
     // go. Insert It with real points Ids
     vtkIdType cellId = output->InsertNextCell(vtkCellType, numPoints, newPoints);
     this->GetCellIds(partId, ensightCellType)->InsertNextId(cellId);
-    delete[] newPoints;
+    if (newPoints != newPointsBuffer)
+    {
+      delete[] newPoints;
+    }
 
     this->CoordinatesAtEnd = true;
     this->InjectGlobalElementIds = true;
@@ -2345,6 +2364,95 @@ void vtkPEnSightReader::InsertNextCellAndId(vtkUnstructuredGrid* output, int vtk
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::InsertCellsAndIds(vtkUnstructuredGrid* output, int vtkCellType,
+  int numPoints, const int* numPointsPerElement, const int* nodeIdList, const int* nodeOrder,
+  int partId, int ensightCellType, vtkIdType numElements)
+{
+  // Same distribution as InsertNextCellAndId: each process inserts a range of
+  // consecutive elements.
+  int mpiLocalProcessId = this->GetMultiProcessLocalProcessId();
+  int mpiNumberOfProcesses = this->GetMultiProcessNumberOfProcesses();
+  vtkIdType numElnts = (numElements / mpiNumberOfProcesses) + 1;
+  vtkIdType begin = std::min(mpiLocalProcessId * numElnts, numElements);
+  vtkIdType end = std::min(begin + numElnts, numElements);
+
+  // Where the nodes of the local elements start, and the size of their cells.
+  vtkIdType firstNode = begin * numPoints;
+  vtkIdType connectivitySize = (end - begin) * (numPoints + 1);
+  if (numPointsPerElement)
+  {
+    firstNode = 0;
+    connectivitySize = end - begin;
+    for (vtkIdType i = 0; i < begin; i++)
+    {
+      firstNode += numPointsPerElement[i];
+    }
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      connectivitySize += numPointsPerElement[i];
+    }
+  }
+
+  vtkPEnSightReaderCellIds* cellIds = this->GetCellIds(partId, ensightCellType);
+  for (vtkIdType i = 0; i < begin; i++)
+  {
+    cellIds->InsertNextId(-1);
+  }
+
+  if (begin < end)
+  {
+    // Keep references, output releases its arrays when they are set again.
+    vtkSmartPointer<vtkIdTypeArray> connectivity = output->GetCells()->GetData();
+    vtkSmartPointer<vtkUnsignedCharArray> types = output->GetCellTypesArray();
+    vtkSmartPointer<vtkIdTypeArray> locations = output->GetCellLocationsArray();
+    vtkIdType firstCell = output->GetNumberOfCells();
+    vtkIdType location = connectivity->GetMaxId() + 1;
+
+    vtkIdType* cell = connectivity->WritePointer(location, connectivitySize);
+    unsigned char* cellType = types->WritePointer(firstCell, end - begin);
+    vtkIdType* cellLocation = locations->WritePointer(firstCell, end - begin);
+    vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
+    const int* nodes = nodeIdList + firstNode;
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      int npts = numPointsPerElement ? numPointsPerElement[i] : numPoints;
+      *cellType++ = static_cast<unsigned char>(vtkCellType);
+      *cellLocation++ = location;
+      *cell++ = npts;
+      for (int j = 0; j < npts; j++)
+      {
+        // First note the points : they will be injected later.
+        int pointId = nodes[nodeOrder ? nodeOrder[j] : j] - 1;
+        int realId = pointIds->GetId(pointId);
+        if (realId == -1)
+        {
+          realId = this->LastPointId++;
+          pointIds->SetId(pointId, realId);
+        }
+        *cell++ = realId;
+      }
+      nodes += npts;
+      location += npts + 1;
+      cellIds->InsertNextId(static_cast<int>(firstCell + i - begin));
+    }
+
+    // A new cell array over the extended connectivity, so that it knows the
+    // new number of cells and where the next ones go.
+    vtkNew<vtkCellArray> cells;
+    cells->SetCells(firstCell + end - begin, connectivity);
+    output->SetCells(types, locations, cells.GetPointer());
+
+    this->CoordinatesAtEnd = true;
+    this->InjectGlobalElementIds = true;
+  }
+
+  for (vtkIdType i = end; i < numElements; i++)
+  {
+    cellIds->InsertNextId(-1);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightReader::PrepareStructuredDimensionsForDistribution(int partId, int* oldDimensions,
   int* newDimensions, int* splitDimension, int* splitDimensionBeginIndex, int ghostLevel,
@@ -2539,6 +2647,181 @@ void vtkPEnSightReader::SetBlockName(
   output->GetMetaData(blockNo)->Set(vtkCompositeDataSet::NAME(), name);
 }
 
+//----------------------------------------------------------------------------
+// Returns the path of the file as opened by the subclasses.
+static std::string vtkPEnSightReaderGetFullFileName(const char* filePath, const std::string& name)
+{
+  std::string fullName;
+  if (filePath)
+  {
+    fullName = filePath;
+    if (!fullName.empty() && fullName[fullName.length() - 1] != '/')
+    {
+      fullName += "/";
+    }
+  }
+  return fullName + name;
+}
+
+//----------------------------------------------------------------------------
+// Returns the number of offsets known for the file.
+static size_t vtkPEnSightReaderGetNumberOfOffsets(
+  const std::map<int, long>& offsets, const std::map<int, std::map<int, long> >& partOffsets)
+{
+  size_t count = offsets.size();
+  std::map<int, std::map<int, long> >::const_iterator step;
+  for (step = partOffsets.begin(); step != partOffsets.end(); ++step)
+  {
+    count += step->second.size();
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::LoadFileOffsets(const char* fileName)
+{
+  if (!this->UseTimeStepIndex || !fileName ||
+    this->FileOffsetsIndexSizes.find(fileName) != this->FileOffsetsIndexSizes.end())
+  {
+    return;
+  }
+  this->FileOffsetsIndexSizes[fileName] = 0;
+
+  std::string dataFileName = vtkPEnSightReaderGetFullFileName(this->FilePath, fileName);
+  vtksys::SystemTools::Stat_t fs;
+  if (vtksys::SystemTools::Stat(dataFileName.c_str(), &fs) != 0)
+  {
+    return;
+  }
+  std::string indexFileName = dataFileName + ".pvtsi";
+  ifstream index(indexFileName.c_str());
+  if (!index)
+  {
+    return;
+  }
+
+  // The index is only valid for the data file it was written for.
+  std::string header;
+  int version = 0;
+  vtkTypeInt64 size = -1, modified = -1;
+  index >> header >> version >> size >> modified;
+  if (!index || header != TimeStepIndexHeader || version != TimeStepIndexVersion ||
+    size != static_cast<vtkTypeInt64>(fs.st_size) ||
+    modified != static_cast<vtkTypeInt64>(fs.st_mtime))
+  {
+    vtkDebugMacro("Ignoring out of date time step index " << indexFileName.c_str());
+    return;
+  }
+
+  // Time steps are listed as "<time step> <offset>", parts as
+  // "part <time step> <part id> <offset>".
+  std::map<int, long>& offsets = this->FileOffsets[fileName];
+  std::map<int, std::map<int, long> >& partOffsets = this->PartOffsets[fileName];
+  std::string entry;
+  while (index >> entry)
+  {
+    int timeStep, partId;
+    long offset;
+    if (entry == "part")
+    {
+      if (!(index >> timeStep >> partId >> offset))
+      {
+        break;
+      }
+      partOffsets[timeStep][partId] = offset;
+    }
+    else
+    {
+      if (!(index >> offset))
+      {
+        break;
+      }
+      offsets[atoi(entry.c_str())] = offset;
+    }
+  }
+  this->FileOffsetsIndexSizes[fileName] =
+    vtkPEnSightReaderGetNumberOfOffsets(offsets, partOffsets);
+  vtkDebugMacro("Loaded " << this->FileOffsetsIndexSizes[fileName] << " offsets from "
+                          << indexFileName.c_str());
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightReader::SaveFileOffsets()
+{
+  // All the processes find the same offsets, only one of them writes them.
+  if (!this->UseTimeStepIndex || this->GetMultiProcessLocalProcessId() > 0)
+  {
+    return;
+  }
+
+  std::set<std::string> fileNames;
+  std::map<std::string, std::map<int, long> >::const_iterator iter;
+  for (iter = this->FileOffsets.begin(); iter != this->FileOffsets.end(); ++iter)
+  {
+    fileNames.insert(iter->first);
+  }
+  std::map<std::string, std::map<int, std::map<int, long> > >::const_iterator partIter;
+  for (partIter = this->PartOffsets.begin(); partIter != this->PartOffsets.end(); ++partIter)
+  {
+    fileNames.insert(partIter->first);
+  }
+
+  std::set<std::string>::const_iterator fileName;
+  for (fileName = fileNames.begin(); fileName != fileNames.end(); ++fileName)
+  {
+    const std::map<int, long>& offsets = this->FileOffsets[*fileName];
+    const std::map<int, std::map<int, long> >& partOffsets = this->PartOffsets[*fileName];
+    size_t& indexSize = this->FileOffsetsIndexSizes[*fileName];
+    size_t numberOfOffsets = vtkPEnSightReaderGetNumberOfOffsets(offsets, partOffsets);
+    if (numberOfOffsets <= indexSize)
+    {
+      continue;
+    }
+    indexSize = numberOfOffsets;
+
+    std::string dataFileName = vtkPEnSightReaderGetFullFileName(this->FilePath, *fileName);
+    vtksys::SystemTools::Stat_t fs;
+    if (vtksys::SystemTools::Stat(dataFileName.c_str(), &fs) != 0)
+    {
+      continue;
+    }
+
+    // Write to a temporary file first so that a process reading the index
+    // never sees a partial one.
+    std::string indexFileName = dataFileName + ".pvtsi";
+    std::string tmpFileName = indexFileName + ".tmp";
+    {
+      ofstream index(tmpFileName.c_str());
+      if (!index)
+      {
+        vtkDebugMacro("Cannot write time step index " << indexFileName.c_str());
+        continue;
+      }
+      index << TimeStepIndexHeader << " " << TimeStepIndexVersion << " "
+            << static_cast<vtkTypeInt64>(fs.st_size) << " "
+            << static_cast<vtkTypeInt64>(fs.st_mtime) << "\n";
+      std::map<int, long>::const_iterator offset;
+      for (offset = offsets.begin(); offset != offsets.end(); ++offset)
+      {
+        index << offset->first << " " << offset->second << "\n";
+      }
+      std::map<int, std::map<int, long> >::const_iterator step;
+      for (step = partOffsets.begin(); step != partOffsets.end(); ++step)
+      {
+        for (offset = step->second.begin(); offset != step->second.end(); ++offset)
+        {
+          index << "part " << step->first << " " << offset->first << " " << offset->second
+                << "\n";
+        }
+      }
+    }
+    if (!vtksys::SystemTools::RenameFile(tmpFileName.c_str(), indexFileName.c_str()))
+    {
+      vtksys::SystemTools::RemoveFile(tmpFileName);
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkPEnSightReader::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -787,6 +787,19 @@ protected:
     int partId, int ensightCellType, int insertionType);
   //@}
 
+  /**
+   * Insert the elements of a whole section, as InsertNextCellAndId does for
+   * each of them. The connectivity, cell types and cell locations of output
+   * are extended once for the elements of this process and written in place.
+   * nodeIdList lists the (1-based) nodes of the numElements elements, which
+   * have numPoints nodes each or numPointsPerElement[i] nodes when it is not
+   * NULL. When nodeOrder is not NULL, the j-th point of a cell is the
+   * nodeOrder[j]-th node of its element.
+   */
+  void InsertCellsAndIds(vtkUnstructuredGrid* output, int vtkCellType, int numPoints,
+    const int* numPointsPerElement, const int* nodeIdList, const int* nodeOrder, int partId,
+    int ensightCellType, vtkIdType numElements);
+
   /**
    * 1. Find future split dimension for distribution (biggest)
    * 2. Compute New dimensions
@@ -879,6 +892,24 @@ protected:
 
   std::map<std::string, std::map<int, long> > FileOffsets;
 
+  // Offsets of the parts of the time steps of each file, by time step and
+  // part id. Only known for the time steps that were read.
+  std::map<std::string, std::map<int, std::map<int, long> > > PartOffsets;
+
+  //@{
+  /**
+   * Load the time step and part offsets of fileName from its index file, and
+   * write the index files of the files for which new offsets were found. Only
+   * used when UseTimeStepIndex is on.
+   */
+  void LoadFileOffsets(const char* fileName);
+  void SaveFileOffsets();
+  //@}
+
+  // Number of offsets in the index file of each data file, files are listed
+  // once their index file was looked for.
+  std::map<std::string, size_t> FileOffsetsIndexSizes;
+
 private:
   vtkPEnSightReader(const vtkPEnSightReader&) = delete;
   void operator=(const vtkPEnSightReader&) = delete;
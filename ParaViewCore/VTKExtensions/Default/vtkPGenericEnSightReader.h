@@ -38,6 +38,19 @@ public:
   vtkTypeMacro(vtkPGenericEnSightReader, vtkGenericEnSightReader);
   void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
 
+  //@{
+  /**
+   * When on, the parallel readers keep the offsets of the time steps found in
+   * transient files in an index file stored next to each data file (with a
+   * ".pvtsi" extension). The index is reused by all processes and by later
+   * sessions, so that moving to any time step does not require scanning the
+   * file. The index is ignored if the data file was modified. Default is off.
+   */
+  vtkSetMacro(UseTimeStepIndex, int);
+  vtkGetMacro(UseTimeStepIndex, int);
+  vtkBooleanMacro(UseTimeStepIndex, int);
+  //@}
+
 protected:
   vtkPGenericEnSightReader();
   ~vtkPGenericEnSightReader() override;
@@ -57,6 +70,8 @@ protected:
   int MultiProcessLocalProcessId;
   int MultiProcessNumberOfProcesses;
 
+  int UseTimeStepIndex;
+
 private:
   vtkPGenericEnSightReader(const vtkPGenericEnSightReader&) = delete;
   void operator=(const vtkPGenericEnSightReader&) = delete;
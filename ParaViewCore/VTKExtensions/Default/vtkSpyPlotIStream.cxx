@@ -1,8 +1,29 @@
 #include "vtkSpyPlotIStream.h"
 #include "vtkByteSwap.h"
 
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 int vtkSpyPlotIStream::ReadString(char* str, size_t len)
 {
+  if (this->MappedData)
+  {
+    const unsigned char* data = this->ReadMapped(len);
+    if (!data)
+    {
+      return 0;
+    }
+    memcpy(str, data, len);
+    return 1;
+  }
   this->IStream->read(str, len);
   if (len != static_cast<size_t>(this->IStream->gcount()))
   {
@@ -13,20 +34,14 @@ int vtkSpyPlotIStream::ReadString(char* str, size_t len)
 //-----------------------------------------------------------------------------
 int vtkSpyPlotIStream::ReadString(unsigned char* str, size_t len)
 {
-  this->IStream->read(reinterpret_cast<char*>(str), len);
-  if (len != static_cast<size_t>(this->IStream->gcount()))
-  {
-    return 0;
-  }
-  return 1;
+  return this->ReadString(reinterpret_cast<char*>(str), len);
 }
 
 //-----------------------------------------------------------------------------
 int vtkSpyPlotIStream::ReadInt32s(int* val, int num)
 {
   size_t len = 4 * num;
-  this->IStream->read(reinterpret_cast<char*>(val), len);
-  if (len != static_cast<size_t>(this->IStream->gcount()))
+  if (!this->ReadString(reinterpret_cast<char*>(val), len))
   {
     return 0;
   }
@@ -55,8 +70,7 @@ int vtkSpyPlotIStream::ReadInt64s(vtkTypeInt64* val, int num)
 int vtkSpyPlotIStream::ReadDoubles(double* val, int num)
 {
   size_t len = 8 * num;
-  this->IStream->read(reinterpret_cast<char*>(val), len);
-  if (len != static_cast<size_t>(this->IStream->gcount()))
+  if (!this->ReadString(reinterpret_cast<char*>(val), len))
   {
     return 0;
   }
@@ -66,6 +80,11 @@ int vtkSpyPlotIStream::ReadDoubles(double* val, int num)
 
 void vtkSpyPlotIStream::Seek(vtkTypeInt64 offset, bool rel)
 {
+  if (this->MappedData)
+  {
+    this->MappedPosition = rel ? this->MappedPosition + offset : offset;
+    return;
+  }
   if (rel)
   {
     this->IStream->seekg(offset, ios::cur);
@@ -78,6 +97,10 @@ void vtkSpyPlotIStream::Seek(vtkTypeInt64 offset, bool rel)
 
 vtkTypeInt64 vtkSpyPlotIStream::Tell()
 {
+  if (this->MappedData)
+  {
+    return this->MappedPosition;
+  }
   return this->IStream->tellg();
 }
 
@@ -93,15 +116,113 @@ void vtkSpyPlotIStream::SetStream(istream* ist)
   this->IStream = ist;
 }
 
+const unsigned char* vtkSpyPlotIStream::ReadMapped(size_t len)
+{
+  if (!this->MappedData || this->MappedPosition < 0 ||
+    static_cast<vtkTypeInt64>(len) > this->MappedLength - this->MappedPosition)
+  {
+    return NULL;
+  }
+  const unsigned char* data = this->MappedData + this->MappedPosition;
+  this->MappedPosition += len;
+  return data;
+}
+
+bool vtkSpyPlotIStream::MapFile(const char* filename)
+{
+  this->UnmapFile();
+  if (!filename)
+  {
+    return false;
+  }
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  LARGE_INTEGER size;
+  HANDLE mapping = NULL;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+    static_cast<unsigned long long>(size.QuadPart) <= static_cast<size_t>(-1))
+  {
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  }
+  // The mapping keeps the file open.
+  CloseHandle(file);
+  if (!mapping)
+  {
+    return false;
+  }
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!data)
+  {
+    CloseHandle(mapping);
+    return false;
+  }
+  this->MappingHandle = mapping;
+  this->MappedLength = size.QuadPart;
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0 &&
+    static_cast<unsigned long long>(info.st_size) <= static_cast<size_t>(-1))
+  {
+    data = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping keeps the file open.
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+  this->MappedLength = info.st_size;
+#endif
+  this->MappedData = static_cast<const unsigned char*>(data);
+  this->MappedPosition = 0;
+  return true;
+}
+
+void vtkSpyPlotIStream::UnmapFile()
+{
+  if (!this->MappedData)
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(this->MappedData);
+  CloseHandle(this->MappingHandle);
+  this->MappingHandle = NULL;
+#else
+  munmap(const_cast<unsigned char*>(this->MappedData), static_cast<size_t>(this->MappedLength));
+#endif
+  this->MappedData = NULL;
+  this->MappedLength = 0;
+  this->MappedPosition = 0;
+}
+
 vtkSpyPlotIStream::vtkSpyPlotIStream()
   : FileBufferSize(2097152)
   , Buffer(0)
   , IStream(0)
+  , MappedData(NULL)
+  , MappedLength(0)
+  , MappedPosition(0)
+#ifdef _WIN32
+  , MappingHandle(NULL)
+#endif
 {
 }
 
 vtkSpyPlotIStream::~vtkSpyPlotIStream()
 {
+  this->UnmapFile();
   if (this->Buffer)
   {
     delete[] this->Buffer;
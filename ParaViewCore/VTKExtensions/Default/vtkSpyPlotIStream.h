@@ -20,6 +20,10 @@ PURPOSE.  See the above copyright notice for more information.
  * was factored out of vtkSpyPlotReader.cxx.  The class wraps an already
  * opened istream
  *
+ * Alternatively, MapFile() memory-maps a file. All reads are then served
+ * from the mapping and ReadMapped() gives direct access to the file contents
+ * without copying them.
+ *
 */
 
 #ifndef vtkSpyPlotIStream_h
@@ -43,12 +47,36 @@ public:
   void Seek(vtkTypeInt64 offset, bool rel = false);
   vtkTypeInt64 Tell();
 
+  /**
+   * Memory-maps the file for reading. Returns false if the file could not be
+   * mapped, in which case the caller should use SetStream() instead.
+   */
+  bool MapFile(const char* filename);
+  void UnmapFile();
+  bool IsMapped() const { return this->MappedData != NULL; }
+
+  /**
+   * When the file is mapped, returns a pointer to the next `len` bytes of the
+   * file and advances the read position. Returns NULL if the file is not
+   * mapped or is too short.
+   */
+  const unsigned char* ReadMapped(size_t len);
+
 protected:
   const int FileBufferSize;
   char* Buffer;
   istream* IStream;
 
+  // Memory-mapped file, when MapFile() succeeded.
+  const unsigned char* MappedData;
+  vtkTypeInt64 MappedLength;
+  vtkTypeInt64 MappedPosition;
+#ifdef _WIN32
+  void* MappingHandle;
+#endif
+
 private:
+  vtkSpyPlotIStream(const vtkSpyPlotIStream&);
   void operator=(const vtkSpyPlotIStream&);
 };
 
@@ -97,6 +97,7 @@ vtkSpyPlotReader::vtkSpyPlotReader()
   this->TimeStepRange[1] = 0;
   this->ComputeDerivedVariables = 1;
   this->DownConvertVolumeFraction = 1;
+  this->UseMemoryMapping = 1;
   this->MergeXYZComponents = 1;
 
   // this has all of the processes.
@@ -917,6 +918,20 @@ int vtkSpyPlotReader::RequestData(vtkInformation* request,
     this->AddBlockIdArray(cds);
   }
 
+  if (this->GetDebug())
+  {
+    vtkSpyPlotReaderMap::MapOfStringToSPCTH::iterator fileIt;
+    for (fileIt = this->Map->Files.begin(); fileIt != this->Map->Files.end(); ++fileIt)
+    {
+      if (fileIt->second)
+      {
+        vtkDebugMacro("File: " << fileIt->first << " read: " << fileIt->second->GetReadTime()
+                               << "s decode: " << fileIt->second->GetDecodeTime()
+                               << "s bytes: " << fileIt->second->GetBytesRead());
+      }
+    }
+  }
+
   return 1;
 }
 
@@ -1346,6 +1361,22 @@ void vtkSpyPlotReader::SetDownConvertVolumeFraction(int vf)
   this->Modified();
 }
 
+//-----------------------------------------------------------------------------
+void vtkSpyPlotReader::SetUseMemoryMapping(int mmap)
+{
+  if (mmap == this->UseMemoryMapping)
+  {
+    return;
+  }
+  vtkSpyPlotReaderMap::MapOfStringToSPCTH::iterator mapIt;
+  for (mapIt = this->Map->Files.begin(); mapIt != this->Map->Files.end(); ++mapIt)
+  {
+    this->Map->GetReader(mapIt, this)->SetUseMemoryMapping(mmap);
+  }
+  this->UseMemoryMapping = mmap;
+  this->Modified();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSpyPlotReader::SetMergeXYZComponents(int merge)
 {
@@ -1420,6 +1451,16 @@ void vtkSpyPlotReader::PrintSelf(ostream& os, vtkIndent indent)
     os << "false" << endl;
   }
 
+  os << "UseMemoryMapping: ";
+  if (this->UseMemoryMapping)
+  {
+    os << "true" << endl;
+  }
+  else
+  {
+    os << "false" << endl;
+  }
+
   os << "MergeXYZComponents: ";
   if (this->MergeXYZComponents)
   {
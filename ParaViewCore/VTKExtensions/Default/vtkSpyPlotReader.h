@@ -175,6 +175,17 @@ public:
   vtkBooleanMacro(DownConvertVolumeFraction, int);
   //@}
 
+  //@{
+  /**
+   * If true, the files are memory-mapped and fields are decoded directly
+   * from the mapping. See vtkSpyPlotUniReader::SetUseMemoryMapping().
+   * True by default.
+   */
+  void SetUseMemoryMapping(int mmap);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+  //@}
+
   //@{
   /**
    * If true, the reader will calculate all derived variables it can given
@@ -387,6 +398,8 @@ protected:
 
   int DownConvertVolumeFraction;
 
+  int UseMemoryMapping;
+
   bool TimeRequestedFromPipeline;
 
   int MergeXYZComponents;
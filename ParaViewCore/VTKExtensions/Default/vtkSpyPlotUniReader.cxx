@@ -5,9 +5,12 @@
 #include "vtkFloatArray.h"
 #include "vtkIntArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkSpyPlotBlock.h"
 #include "vtkSpyPlotIStream.h"
+#include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
+#include <algorithm>
 #include <sstream>
 #include <vector>
 #include <vtksys/RegularExpression.hxx>
@@ -88,6 +91,9 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
 
   this->MarkersOn = 0;
   this->GenerateMarkers = 1;
+
+  this->UseMemoryMapping = 1;
+  this->ResetTimingCounters();
 }
 
 //-----------------------------------------------------------------------------
@@ -192,6 +198,143 @@ void vtkSpyPlotUniReader::SetDownConvertVolumeFraction(int vf)
   this->DataTypeChanged = 1;
 }
 
+//-----------------------------------------------------------------------------
+template <class t>
+int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, const unsigned char* in,
+  int inSize, t* out, int outSize, t scale = 1);
+
+// An encoded plane of a cell field. The planes of a field are read first and
+// then decoded in parallel; each plane is decoded into its own range of its
+// array so the result does not depend on the scheduling.
+struct vtkSpyPlotUniReaderEncodedPlane
+{
+  vtkFloatArray* FloatArray;
+  vtkUnsignedCharArray* UnsignedCharArray;
+  vtkIdType OutputOffset;
+  int OutputSize;
+  // Offset in the buffer the plane was read into, when not memory-mapped.
+  size_t BufferOffset;
+  const unsigned char* Data;
+  int Size;
+};
+
+// Decodes a range of planes. It runs on the vtkSMPTools threads, so it only
+// records whether each plane could be decoded and leaves the reporting to the
+// calling thread.
+class vtkSpyPlotUniReaderDecodePlanes
+{
+public:
+  const std::vector<vtkSpyPlotUniReaderEncodedPlane>* Planes;
+  std::vector<char>* Status;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      const vtkSpyPlotUniReaderEncodedPlane& plane = (*this->Planes)[cc];
+      int ok;
+      if (plane.FloatArray)
+      {
+        ok = ::vtkSpyPlotUniReaderRunLengthDataDecode(NULL, plane.Data, plane.Size,
+          plane.FloatArray->GetPointer(plane.OutputOffset), plane.OutputSize);
+      }
+      else
+      {
+        ok = ::vtkSpyPlotUniReaderRunLengthDataDecode(NULL, plane.Data, plane.Size,
+          plane.UnsignedCharArray->GetPointer(plane.OutputOffset), plane.OutputSize,
+          static_cast<unsigned char>(255));
+      }
+      (*this->Status)[cc] = static_cast<char>(ok);
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// Decodes the planes of a field in parallel, then empties planes and buffer so
+// that they can be reused, without releasing their memory, for the next field.
+// When the file is not memory-mapped, the planes were read into buffer.
+static bool vtkSpyPlotUniReaderDecodeField(std::vector<vtkSpyPlotUniReaderEncodedPlane>& planes,
+  std::vector<unsigned char>& buffer, bool mapped, double& decodeTime)
+{
+  if (planes.empty())
+  {
+    return true;
+  }
+  if (!mapped)
+  {
+    // The buffer may have been reallocated while reading, the pointers are
+    // only set now.
+    for (size_t cc = 0; cc < planes.size(); ++cc)
+    {
+      planes[cc].Data = buffer.empty() ? NULL : &buffer[0] + planes[cc].BufferOffset;
+    }
+  }
+
+  const double start = vtkTimerLog::GetUniversalTime();
+  std::vector<char> status(planes.size(), 0);
+  vtkSpyPlotUniReaderDecodePlanes decoder;
+  decoder.Planes = &planes;
+  decoder.Status = &status;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(planes.size()), decoder);
+  decodeTime += vtkTimerLog::GetUniversalTime() - start;
+
+  planes.clear();
+  buffer.clear();
+  return std::find(status.begin(), status.end(), 0) == status.end();
+}
+
+//-----------------------------------------------------------------------------
+// Releases the arrays read for a field that could not be read or decoded, and
+// the field's block list, so that the field is read again by the next update
+// instead of keeping uninitialized values.
+static void vtkSpyPlotUniReaderDiscardField(
+  vtkSpyPlotUniReader::Variable* var, std::vector<vtkDataArray*>& arrays)
+{
+  for (size_t cc = 0; cc < arrays.size(); ++cc)
+  {
+    arrays[cc]->Delete();
+  }
+  arrays.clear();
+  delete[] var->DataBlocks;
+  var->DataBlocks = 0;
+  delete[] var->GhostCellsFixed;
+  var->GhostCellsFixed = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Reads a record of numBytes bytes, returning a pointer to it. When the file
+// is memory-mapped, the pointer refers to the mapping, otherwise the record is
+// read into buffer.
+static const unsigned char* vtkSpyPlotUniReaderReadRecord(vtkSpyPlotIStream* spis,
+  std::vector<unsigned char>& buffer, int numBytes, double& readTime, vtkTypeInt64& bytesRead)
+{
+  const double start = vtkTimerLog::GetUniversalTime();
+  const unsigned char* data = NULL;
+  if (numBytes < 0)
+  {
+    return NULL;
+  }
+  if (spis->IsMapped())
+  {
+    // Decode straight from the mapped file.
+    data = spis->ReadMapped(numBytes);
+  }
+  else
+  {
+    if (buffer.size() < static_cast<size_t>(numBytes) + 1)
+    {
+      buffer.resize(static_cast<size_t>(numBytes) + 1);
+    }
+    if (spis->ReadString(&buffer[0], numBytes))
+    {
+      data = &buffer[0];
+    }
+  }
+  readTime += vtkTimerLog::GetUniversalTime() - start;
+  bytesRead += data ? numBytes : 0;
+  return data;
+}
+
 //-----------------------------------------------------------------------------
 int vtkSpyPlotUniReader::MakeCurrent()
 {
@@ -212,9 +355,13 @@ int vtkSpyPlotUniReader::MakeCurrent()
   }
 
   std::vector<unsigned char> arrayBuffer;
-  ifstream ifs(this->FileName, ios::binary | ios::in);
+  ifstream ifs;
   vtkSpyPlotIStream spis;
-  spis.SetStream(&ifs);
+  if (!this->UseMemoryMapping || !spis.MapFile(this->FileName))
+  {
+    ifs.open(this->FileName, ios::binary | ios::in);
+    spis.SetStream(&ifs);
+  }
   int dump;
   vtkSpyPlotUniReader::DataDump* dp;
   int blocksUpdated = 0;
@@ -264,17 +411,17 @@ int vtkSpyPlotUniReader::MakeCurrent()
           }
           // vtkDebugMacro( "  Number of bytes for " << component << ": "
           // << numBytes );
-          if (static_cast<int>(arrayBuffer.size()) < numBytes)
-          {
-            arrayBuffer.resize(numBytes);
-          }
-
-          if (!spis.ReadString(&*arrayBuffer.begin(), numBytes))
+          const unsigned char* encoded = vtkSpyPlotUniReaderReadRecord(
+            &spis, arrayBuffer, numBytes, this->ReadTime, this->BytesRead);
+          if (!encoded)
           {
             vtkErrorMacro("Problem reading the bytes");
             return 0;
           }
-          if (!b->SetGeometry(component, &*arrayBuffer.begin(), numBytes))
+          const double start = vtkTimerLog::GetUniversalTime();
+          const int status = b->SetGeometry(component, encoded, numBytes);
+          this->DecodeTime += vtkTimerLog::GetUniversalTime() - start;
+          if (!status)
           {
             vtkErrorMacro("Problem RLD decoding rectilinear grid array: " << component);
             return 0;
@@ -325,6 +472,12 @@ int vtkSpyPlotUniReader::MakeCurrent()
   dump = this->CurrentTimeStep;
   dp = this->DataDumps + dump;
 
+  // The fields are read and decoded one at a time, so at most one field of
+  // encoded data is buffered when the file is not memory-mapped. The arrays
+  // of a field are only stored in its DataBlocks once it is decoded.
+  std::vector<vtkSpyPlotUniReaderEncodedPlane> planes;
+  std::vector<vtkDataArray*> fieldArrays;
+  arrayBuffer.clear();
   for (int fieldCnt = 0; fieldCnt < dp->NumVars; ++fieldCnt)
   {
     vtkSpyPlotUniReader::Variable* var = dp->Variables + fieldCnt;
@@ -389,7 +542,6 @@ int vtkSpyPlotUniReader::MakeCurrent()
     spis.Seek(dp->SavedVariableOffsets[fieldCnt]);
     int numBytes;
     int block;
-    int actualBlockId = 0;
     for (block = 0; block < dp->NumberOfBlocks; ++block)
     {
       vtkSpyPlotBlock* bk = this->Blocks + block;
@@ -398,7 +550,7 @@ int vtkSpyPlotUniReader::MakeCurrent()
         vtkFloatArray* floatArray = 0;
         vtkUnsignedCharArray* unsignedCharArray = 0;
         vtkDataArray* dataArray = 0;
-        if (this->CellArraySelection->ArrayIsEnabled(var->Name) && !var->DataBlocks[actualBlockId])
+        if (this->CellArraySelection->ArrayIsEnabled(var->Name))
         {
           if (this->DownConvertVolumeFraction && this->IsVolumeFraction(var))
           {
@@ -414,6 +566,7 @@ int vtkSpyPlotUniReader::MakeCurrent()
           dataArray->SetNumberOfTuples(
             bk->GetDimension(0) * bk->GetDimension(1) * bk->GetDimension(2));
           dataArray->SetName(var->Name);
+          fieldArrays.push_back(dataArray);
           // vtkDebugMacro( "*** Create data array: "
           // << dataArray->GetNumberOfTuples() );
         }
@@ -426,45 +579,69 @@ int vtkSpyPlotUniReader::MakeCurrent()
           if (!spis.ReadInt32s(&numBytes, 1))
           {
             vtkErrorMacro("Problem reading the number of bytes");
+            vtkSpyPlotUniReaderDiscardField(var, fieldArrays);
+            this->NeedToCheck = 1;
             return 0;
           }
-          if (static_cast<int>(arrayBuffer.size()) < numBytes)
+          if (!dataArray)
           {
-            arrayBuffer.resize(numBytes);
+            // The array is not needed, skip the plane.
+            spis.Seek(numBytes, true);
+            continue;
           }
-          if (!spis.ReadString(&*arrayBuffer.begin(), numBytes))
+          vtkSpyPlotUniReaderEncodedPlane plane;
+          plane.FloatArray = floatArray;
+          plane.UnsignedCharArray = unsignedCharArray;
+          plane.OutputOffset = static_cast<vtkIdType>(zax) * planeSize;
+          plane.OutputSize = planeSize;
+          plane.BufferOffset = arrayBuffer.size();
+          plane.Data = NULL;
+          plane.Size = numBytes;
+          const double start = vtkTimerLog::GetUniversalTime();
+          bool status = false;
+          if (numBytes >= 0 && spis.IsMapped())
           {
-            vtkErrorMacro("Problem reading the bytes");
-            return 0;
+            plane.Data = spis.ReadMapped(numBytes);
+            status = plane.Data != NULL;
           }
-          if (floatArray)
+          else if (numBytes >= 0)
           {
-            float* ptr = floatArray->GetPointer(zax * planeSize);
-            if (!this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes, ptr, planeSize))
-            {
-              vtkErrorMacro("Problem RLD decoding float data array");
-              return 0;
-            }
+            // The buffer may be reallocated, the pointers are set once all
+            // planes have been read.
+            arrayBuffer.resize(plane.BufferOffset + numBytes);
+            status =
+              numBytes == 0 || spis.ReadString(&arrayBuffer[plane.BufferOffset], numBytes) != 0;
           }
-          if (unsignedCharArray)
+          this->ReadTime += vtkTimerLog::GetUniversalTime() - start;
+          if (!status)
           {
-            unsigned char* ptr = unsignedCharArray->GetPointer(zax * planeSize);
-            if (!this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes, ptr, planeSize))
-            {
-              vtkErrorMacro("Problem RLD decoding unsigned char data array");
-              return 0;
-            }
+            vtkErrorMacro("Problem reading the bytes");
+            vtkSpyPlotUniReaderDiscardField(var, fieldArrays);
+            this->NeedToCheck = 1;
+            return 0;
           }
-        }
-        if (dataArray)
-        {
-          var->DataBlocks[actualBlockId] = dataArray;
-          var->GhostCellsFixed[actualBlockId] = 0;
-          vtkDebugMacro(" " << dataArray << " initialized: " << dataArray->GetName());
-          actualBlockId++;
+          this->BytesRead += numBytes;
+          planes.push_back(plane);
         }
       }
     }
+
+    if (!vtkSpyPlotUniReaderDecodeField(planes, arrayBuffer, spis.IsMapped(), this->DecodeTime))
+    {
+      vtkErrorMacro("Problem RLD decoding data array: " << var->Name);
+      vtkSpyPlotUniReaderDiscardField(var, fieldArrays);
+      this->NeedToCheck = 1;
+      return 0;
+    }
+    for (int actualBlockId = 0; actualBlockId < static_cast<int>(fieldArrays.size());
+         ++actualBlockId)
+    {
+      var->DataBlocks[actualBlockId] = fieldArrays[actualBlockId];
+      var->GhostCellsFixed[actualBlockId] = 0;
+      vtkDebugMacro(" " << fieldArrays[actualBlockId]
+                        << " initialized: " << fieldArrays[actualBlockId]->GetName());
+    }
+    fieldArrays.clear();
   }
 
   if (blocksUpdated && needMarkers)
@@ -664,59 +841,62 @@ void vtkSpyPlotUniReader::PrintInformation()
 //-----------------------------------------------------------------------------
 template <class t>
 int vtkSpyPlotUniReaderRunLengthDataDecode(
-  vtkSpyPlotUniReader* self, const unsigned char* in, int inSize, t* out, int outSize, t scale = 1)
+  vtkSpyPlotUniReader* self, const unsigned char* in, int inSize, t* out, int outSize, t scale)
 {
-  int outIndex = 0, inIndex = 0;
-
+  int outIndex = 0;
   const unsigned char* ptmp = in;
+  const unsigned char* end = in + inSize;
 
   /* Run-length decode */
-  while ((outIndex < outSize) && (inIndex < inSize))
+  while ((outIndex < outSize) && (ptmp < end))
   {
     // Okay get the run length
-    unsigned char runLength = *ptmp;
+    const int runLength = *ptmp;
     ptmp++;
-    if (runLength < 128)
+    // Runs shorter than 128 repeat a single value, longer ones are followed
+    // by (runLength - 128) literal values.
+    const bool repeat = runLength < 128;
+    const int count = repeat ? runLength : runLength - 128;
+    const int numValues = repeat ? 1 : count;
+    if (count > outSize - outIndex)
     {
+      if (self)
+      {
+        vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+            << "Too much data generated. Expected: " << outSize);
+      }
+      return 0;
+    }
+    if (4 * numValues > end - ptmp)
+    {
+      if (self)
+      {
+        vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+            << "Not enough encoded data.");
+      }
+      return 0;
+    }
+
+    if (repeat)
+    {
+      // Constant runs dominate volume fractions, decode the value once.
       float val;
       memcpy(&val, ptmp, sizeof(float));
       vtkByteSwap::SwapBE(&val);
       ptmp += 4;
-      // Now populate the out data
-      int k;
-      for (k = 0; k < runLength; ++k)
-      {
-        if (outIndex >= outSize)
-        {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-              << "Too much data generated. Expected: " << outSize);
-          return 0;
-        }
-        out[outIndex] = static_cast<t>(val * scale);
-        outIndex++;
-      }
-      inIndex += 5;
+      std::fill(out + outIndex, out + outIndex + count, static_cast<t>(val * scale));
     }
-    else // runLength >= 128
+    else
     {
-      int k;
-      for (k = 0; k < runLength - 128; ++k)
+      for (int k = 0; k < count; ++k, ptmp += 4)
       {
-        if (outIndex >= outSize)
-        {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-              << "Too much data generated. Expected: " << outSize);
-          return 0;
-        }
         float val;
         memcpy(&val, ptmp, sizeof(float));
         vtkByteSwap::SwapBE(&val);
-        out[outIndex] = static_cast<t>(val * scale);
-        outIndex++;
-        ptmp += 4;
+        out[outIndex + k] = static_cast<t>(val * scale);
       }
-      inIndex += 4 * (runLength - 128) + 1;
     }
+    outIndex += count;
   } // while
 
   return 1;
@@ -919,6 +1099,12 @@ vtkDataArray* vtkSpyPlotUniReader::GetCellFieldData(int block, int field, int* f
     return 0;
   }
 
+  if (!var->DataBlocks)
+  {
+    // The field was not read or could not be decoded.
+    return 0;
+  }
+
   *fixed = var->GhostCellsFixed[block];
 
   vtkDebugMacro(
@@ -967,7 +1153,7 @@ int vtkSpyPlotUniReader::MarkCellFieldDataFixed(int block, int field)
     return 0;
   }
   vtkSpyPlotUniReader::Variable* var = this->GetCellField(field);
-  if (!var)
+  if (!var || !var->DataBlocks)
   {
     return 0;
   }
@@ -1337,6 +1523,18 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << endl;
+  os << indent << "ReadTime: " << this->ReadTime << endl;
+  os << indent << "DecodeTime: " << this->DecodeTime << endl;
+  os << indent << "BytesRead: " << this->BytesRead << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSpyPlotUniReader::ResetTimingCounters()
+{
+  this->ReadTime = 0.0;
+  this->DecodeTime = 0.0;
+  this->BytesRead = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -231,6 +231,31 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  //@{
+  /**
+   * When set, MakeCurrent() memory-maps the file and decodes the fields
+   * directly from the mapping instead of reading them through a stream. The
+   * reader falls back to the stream if the file cannot be mapped. Default is
+   * on.
+   */
+  vtkSetMacro(UseMemoryMapping, int);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+  //@}
+
+  //@{
+  /**
+   * Timing counters accumulated by MakeCurrent(): time spent reading the
+   * encoded fields, time spent decoding them (in seconds) and the number of
+   * encoded bytes read. When the file is memory-mapped, the file is actually
+   * read while decoding.
+   */
+  vtkGetMacro(ReadTime, double);
+  vtkGetMacro(DecodeTime, double);
+  vtkGetMacro(BytesRead, vtkTypeInt64);
+  void ResetTimingCounters();
+  //@}
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader() override;
@@ -307,6 +332,11 @@ private:
   int DataTypeChanged;
   int DownConvertVolumeFraction;
 
+  int UseMemoryMapping;
+  double ReadTime;
+  double DecodeTime;
+  vtkTypeInt64 BytesRead;
+
   int NumberOfCellFields;
 
   vtkDataArraySelection* CellArraySelection;
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestDeltaImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends a sequence of frames through vtkDeltaImageCompressor and checks that
+// the receiver reconstructs them and that only the modified tiles are sent.
+
+#include "vtkDeltaImageCompressor.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstring>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+vtkSmartPointer<vtkUnsignedCharArray> MakeFrame(int width, int height, int numComps)
+{
+  vtkSmartPointer<vtkUnsignedCharArray> frame = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  frame->SetNumberOfComponents(numComps);
+  frame->SetNumberOfTuples(static_cast<vtkIdType>(width) * height);
+  unsigned char* ptr = frame->GetPointer(0);
+  for (int j = 0; j < height; ++j)
+  {
+    for (int i = 0; i < width; ++i)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        *ptr++ = static_cast<unsigned char>((i * (c + 1) + j * 3) % 256);
+      }
+    }
+  }
+  return frame;
+}
+
+void FillRect(vtkUnsignedCharArray* frame, int width, int x0, int y0, int x1, int y1)
+{
+  const int numComps = frame->GetNumberOfComponents();
+  for (int j = y0; j < y1; ++j)
+  {
+    for (int i = x0; i < x1; ++i)
+    {
+      memset(frame->GetPointer((static_cast<vtkIdType>(j) * width + i) * numComps), 255, numComps);
+    }
+  }
+}
+
+bool Send(vtkDeltaImageCompressor* sender, vtkDeltaImageCompressor* receiver,
+  vtkUnsignedCharArray* frame, int width, int height, bool expectKeyFrame, int expectedTiles)
+{
+  vtkNew<vtkUnsignedCharArray> compressed;
+  sender->SetImageResolution(width, height);
+  sender->SetInput(frame);
+  sender->SetOutput(compressed.Get());
+  if (sender->Compress() != VTK_OK)
+  {
+    cerr << "ERROR: compression failed." << endl;
+    return false;
+  }
+  if (sender->GetLastFrameWasKeyFrame() != expectKeyFrame ||
+    (expectedTiles >= 0 && sender->GetLastNumberOfTiles() != expectedTiles))
+  {
+    cerr << "ERROR: unexpected frame (keyframe: " << sender->GetLastFrameWasKeyFrame()
+         << ", tiles: " << sender->GetLastNumberOfTiles() << ")." << endl;
+    return false;
+  }
+
+  vtkNew<vtkUnsignedCharArray> decompressed;
+  decompressed->SetNumberOfComponents(frame->GetNumberOfComponents());
+  decompressed->SetNumberOfTuples(frame->GetNumberOfTuples());
+  receiver->SetImageResolution(width, height);
+  receiver->SetInput(compressed.Get());
+  receiver->SetOutput(decompressed.Get());
+  if (receiver->Decompress() != VTK_OK ||
+    memcmp(decompressed->GetPointer(0), frame->GetPointer(0),
+      frame->GetNumberOfTuples() * frame->GetNumberOfComponents()) != 0)
+  {
+    cerr << "ERROR: decompressed frame does not match." << endl;
+    return false;
+  }
+  cout << (expectKeyFrame ? "keyframe" : "delta") << " " << width << "x" << height << ": "
+       << compressed->GetNumberOfTuples() << " bytes" << endl;
+  return true;
+}
+}
+
+int TestDeltaImageCompressor(int, char* [])
+{
+  vtkNew<vtkDeltaImageCompressor> sender;
+  vtkNew<vtkDeltaImageCompressor> receiver;
+  sender->RestoreConfiguration("vtkDeltaImageCompressor 1 0 16 10");
+  receiver->RestoreConfiguration(sender->SaveConfiguration());
+  if (sender->GetTileSize() != 16 || receiver->GetTileSize() != 16 ||
+    receiver->GetKeyFrameInterval() != 10)
+  {
+    cerr << "ERROR: failed to restore configuration." << endl;
+    return TEST_FAILED;
+  }
+
+  vtkSmartPointer<vtkUnsignedCharArray> frame = MakeFrame(100, 70, 4);
+  if (!Send(sender.Get(), receiver.Get(), frame, 100, 70, true, -1) ||
+    !Send(sender.Get(), receiver.Get(), frame, 100, 70, false, 0))
+  {
+    return TEST_FAILED;
+  }
+
+  // A rectangle covering 2x2 tiles, and one touching the partial tiles on the
+  // image border.
+  FillRect(frame, 100, 20, 20, 40, 40);
+  if (!Send(sender.Get(), receiver.Get(), frame, 100, 70, false, 4))
+  {
+    return TEST_FAILED;
+  }
+  FillRect(frame, 100, 97, 66, 100, 70);
+  if (!Send(sender.Get(), receiver.Get(), frame, 100, 70, false, 1))
+  {
+    return TEST_FAILED;
+  }
+
+  // Changing the resolution or the number of components sends a keyframe.
+  frame = MakeFrame(64, 48, 3);
+  if (!Send(sender.Get(), receiver.Get(), frame, 64, 48, true, -1))
+  {
+    return TEST_FAILED;
+  }
+  FillRect(frame, 64, 0, 0, 1, 1);
+  if (!Send(sender.Get(), receiver.Get(), frame, 64, 48, false, 1))
+  {
+    return TEST_FAILED;
+  }
+
+  // Frames after the KeyFrameInterval are keyframes.
+  for (int cc = 0; cc < 9; ++cc)
+  {
+    if (!Send(sender.Get(), receiver.Get(), frame, 64, 48, false, 0))
+    {
+      return TEST_FAILED;
+    }
+  }
+  if (!Send(sender.Get(), receiver.Get(), frame, 64, 48, true, -1))
+  {
+    return TEST_FAILED;
+  }
+
+  // A receiver without the reference frame rejects deltas.
+  vtkNew<vtkUnsignedCharArray> compressed;
+  sender->SetInput(frame);
+  sender->SetOutput(compressed.Get());
+  sender->Compress();
+  vtkNew<vtkDeltaImageCompressor> lateReceiver;
+  vtkNew<vtkUnsignedCharArray> decompressed;
+  decompressed->SetNumberOfComponents(3);
+  decompressed->SetNumberOfTuples(64 * 48);
+  lateReceiver->SetInput(compressed.Get());
+  lateReceiver->SetOutput(decompressed.Get());
+  vtkObject::GlobalWarningDisplayOff();
+  const int status = lateReceiver->Decompress();
+  vtkObject::GlobalWarningDisplayOn();
+  if (status == VTK_OK)
+  {
+    cerr << "ERROR: delta frame accepted without reference frame." << endl;
+    return TEST_FAILED;
+  }
+
+  return TEST_SUCCESS;
+}
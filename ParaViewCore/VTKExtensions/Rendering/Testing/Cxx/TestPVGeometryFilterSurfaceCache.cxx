@@ -0,0 +1,246 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterSurfaceCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPVGeometryFilter reuses the surface of an unstructured grid
+// when only its points and attributes change, and that the result matches a
+// full extraction.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+// Returns a grid of dim^3 hexahedra, inserted in reverse order when
+// \c reversed is true.
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int dim, bool reversed = false)
+{
+  const int npts = dim + 1;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < npts; ++k)
+  {
+    for (int j = 0; j < npts; ++j)
+    {
+      for (int i = 0; i < npts; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.Get());
+  grid->Allocate(dim * dim * dim);
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        const int c[3] = { reversed ? dim - 1 - i : i, reversed ? dim - 1 - j : j,
+          reversed ? dim - 1 - k : k };
+        const vtkIdType p0 = c[0] + npts * (c[1] + npts * c[2]);
+        const vtkIdType ids[8] = { p0, p0 + 1, p0 + 1 + npts, p0 + npts, p0 + npts * npts,
+          p0 + 1 + npts * npts, p0 + 1 + npts + npts * npts, p0 + npts + npts * npts };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+      }
+    }
+  }
+  return grid;
+}
+
+// Returns a grid sharing the cells of \c grid, with moved points and new
+// point and cell arrays, as a reader would produce for a new time step.
+vtkSmartPointer<vtkUnstructuredGrid> NextTimeStep(vtkUnstructuredGrid* grid, double time)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(grid->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType cc = 0; cc < grid->GetNumberOfPoints(); ++cc)
+  {
+    double pt[3];
+    grid->GetPoint(cc, pt);
+    pt[2] += time * pt[0];
+    points->SetPoint(cc, pt);
+    pressure->SetValue(cc, time + cc);
+  }
+  vtkNew<vtkDoubleArray> cellValues;
+  cellValues->SetName("cellValues");
+  cellValues->SetNumberOfTuples(grid->GetNumberOfCells());
+  for (vtkIdType cc = 0; cc < grid->GetNumberOfCells(); ++cc)
+  {
+    cellValues->SetValue(cc, 2 * time + cc);
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> next = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  next->SetPoints(points.Get());
+  next->SetCells(grid->GetCellTypesArray(), grid->GetCellLocationsArray(), grid->GetCells());
+  next->GetPointData()->AddArray(pressure.Get());
+  next->GetCellData()->AddArray(cellValues.Get());
+  return next;
+}
+
+bool Compare(vtkPolyData* actual, vtkPolyData* expected)
+{
+  if (actual->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+    actual->GetNumberOfPolys() != expected->GetNumberOfPolys())
+  {
+    cerr << "ERROR: wrong number of points or polygons." << endl;
+    return false;
+  }
+
+  // Surfaces are compared through the ids of the input points and cells.
+  vtkIdTypeArray* actualPointIds =
+    vtkIdTypeArray::SafeDownCast(actual->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkIdTypeArray* expectedPointIds =
+    vtkIdTypeArray::SafeDownCast(expected->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkDataArray* actualPressure = actual->GetPointData()->GetArray("pressure");
+  vtkDataArray* expectedPressure = expected->GetPointData()->GetArray("pressure");
+  vtkIdTypeArray* actualCellIds =
+    vtkIdTypeArray::SafeDownCast(actual->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkIdTypeArray* expectedCellIds =
+    vtkIdTypeArray::SafeDownCast(expected->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkDataArray* actualValues = actual->GetCellData()->GetArray("cellValues");
+  vtkDataArray* expectedValues = expected->GetCellData()->GetArray("cellValues");
+  if (!actualPointIds || !expectedPointIds || !actualPressure || !expectedPressure ||
+    !actualCellIds || !expectedCellIds || !actualValues || !expectedValues)
+  {
+    cerr << "ERROR: missing arrays." << endl;
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < actual->GetNumberOfPoints(); ++cc)
+  {
+    double pt[3], expectedPt[3];
+    actual->GetPoint(cc, pt);
+    expected->GetPoint(cc, expectedPt);
+    if (actualPointIds->GetValue(cc) != expectedPointIds->GetValue(cc) ||
+      pt[0] != expectedPt[0] || pt[1] != expectedPt[1] || pt[2] != expectedPt[2] ||
+      actualPressure->GetTuple1(cc) != expectedPressure->GetTuple1(cc))
+    {
+      cerr << "ERROR: point " << cc << " differs." << endl;
+      return false;
+    }
+  }
+  for (vtkIdType cc = 0; cc < actual->GetNumberOfCells(); ++cc)
+  {
+    if (actualCellIds->GetValue(cc) != expectedCellIds->GetValue(cc) ||
+      actualValues->GetTuple1(cc) != expectedValues->GetTuple1(cc))
+    {
+      cerr << "ERROR: cell " << cc << " differs." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestPVGeometryFilterSurfaceCache(int, char* [])
+{
+  // Built first, so that its cell array is older than the arrays of mesh.
+  vtkSmartPointer<vtkUnstructuredGrid> reversedMesh = MakeGrid(40, true);
+  vtkSmartPointer<vtkUnstructuredGrid> mesh = MakeGrid(40);
+
+  vtkNew<vtkPVGeometryFilter> cached;
+  cached->SetUseOutline(0);
+  vtkNew<vtkPVGeometryFilter> reference;
+  reference->SetUseOutline(0);
+  reference->SetUseSurfaceCache(false);
+
+  cached->SetInputData(NextTimeStep(mesh, 0.0));
+  double start = vtkTimerLog::GetUniversalTime();
+  cached->Update();
+  const double firstTime = vtkTimerLog::GetUniversalTime() - start;
+  vtkSmartPointer<vtkCellArray> polys =
+    vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0))->GetPolys();
+
+  for (int step = 1; step < 4; ++step)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> grid = NextTimeStep(mesh, step);
+    cached->SetInputData(grid);
+    start = vtkTimerLog::GetUniversalTime();
+    cached->Update();
+    const double cachedTime = vtkTimerLog::GetUniversalTime() - start;
+    reference->SetInputData(grid);
+    reference->Update();
+
+    vtkPolyData* output = vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0));
+    if (output->GetPolys() != polys.GetPointer())
+    {
+      cerr << "ERROR: the cached surface was not used for step " << step << "." << endl;
+      return TEST_FAILED;
+    }
+    if (!Compare(output, vtkPolyData::SafeDownCast(reference->GetOutputDataObject(0))))
+    {
+      return TEST_FAILED;
+    }
+    cout << "step " << step << ": " << firstTime << "s -> " << cachedTime << "s" << endl;
+  }
+
+  // Another cell array, even an older one, extracts the surface again. The
+  // cells have the same sizes, so the other arrays are shared.
+  vtkSmartPointer<vtkUnstructuredGrid> shuffled = NextTimeStep(mesh, 4.0);
+  shuffled->SetCells(
+    mesh->GetCellTypesArray(), mesh->GetCellLocationsArray(), reversedMesh->GetCells());
+  cached->SetInputData(shuffled);
+  cached->Update();
+  reference->SetInputData(shuffled);
+  reference->Update();
+  vtkPolyData* output = vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0));
+  if (output->GetPolys() == polys.GetPointer() ||
+    !Compare(output, vtkPolyData::SafeDownCast(reference->GetOutputDataObject(0))))
+  {
+    cerr << "ERROR: wrong surface after replacing the cell array." << endl;
+    return TEST_FAILED;
+  }
+
+  // Changing the cells or the settings extracts the surface again.
+  vtkSmartPointer<vtkUnstructuredGrid> other = NextTimeStep(MakeGrid(20), 0.0);
+  cached->SetInputData(other);
+  cached->Update();
+  reference->SetInputData(other);
+  reference->Update();
+  output = vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0));
+  if (output->GetPolys() == polys.GetPointer() || output->GetNumberOfPolys() != 6 * 20 * 20 ||
+    !Compare(output, vtkPolyData::SafeDownCast(reference->GetOutputDataObject(0))))
+  {
+    cerr << "ERROR: wrong surface after changing the cells." << endl;
+    return TEST_FAILED;
+  }
+
+  polys = output->GetPolys();
+  cached->SetNonlinearSubdivisionLevel(0);
+  cached->Update();
+  output = vtkPolyData::SafeDownCast(cached->GetOutputDataObject(0));
+  if (output->GetPolys() == polys.GetPointer())
+  {
+    cerr << "ERROR: cached surface used after changing the settings." << endl;
+    return TEST_FAILED;
+  }
+
+  return TEST_SUCCESS;
+}
@@ -0,0 +1,278 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVGeometryFilterThreads.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkPVGeometryFilter produces the same surfaces, with the same
+// face winding, with and without threads, for a large unstructured grid and
+// for a multiblock with many blocks, and reports the time taken in both cases.
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolygon.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedIntArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#define TEST_SUCCESS 0
+#define TEST_FAILED 1
+
+namespace
+{
+vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int dim, double offset)
+{
+  const int npts = dim + 1;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  for (int k = 0; k < npts; ++k)
+  {
+    for (int j = 0; j < npts; ++j)
+    {
+      for (int i = 0; i < npts; ++i)
+      {
+        points->InsertNextPoint(offset + i, j, k);
+        pressure->InsertNextValue(offset + i + 2 * j + 3 * k);
+      }
+    }
+  }
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points.Get());
+  grid->GetPointData()->AddArray(pressure.Get());
+  grid->Allocate(dim * dim * dim);
+  vtkNew<vtkDoubleArray> cellValues;
+  cellValues->SetName("cellValues");
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        const vtkIdType p0 = i + npts * (j + npts * k);
+        const vtkIdType ids[8] = { p0, p0 + 1, p0 + 1 + npts, p0 + npts, p0 + npts * npts,
+          p0 + 1 + npts * npts, p0 + 1 + npts + npts * npts, p0 + npts + npts * npts };
+        cellValues->InsertNextValue(grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids));
+      }
+    }
+  }
+  grid->GetCellData()->AddArray(cellValues.Get());
+  return grid;
+}
+
+// Returns the faces of the surface as input point ids, in polygon order
+// starting from the smallest one so that winding is compared, followed by the
+// id of the input cell.
+std::set<std::vector<vtkIdType> > GetFaces(vtkPolyData* surface)
+{
+  std::set<std::vector<vtkIdType> > faces;
+  vtkIdTypeArray* pointIds =
+    vtkIdTypeArray::SafeDownCast(surface->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(surface->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!pointIds || !cellIds)
+  {
+    return faces;
+  }
+  vtkIdType npts;
+  vtkIdType* pts;
+  vtkCellArray* polys = surface->GetPolys();
+  vtkIdType cellId = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+  {
+    std::vector<vtkIdType> face;
+    for (vtkIdType cc = 0; cc < npts; ++cc)
+    {
+      face.push_back(pointIds->GetValue(pts[cc]));
+    }
+    std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+    face.push_back(cellIds->GetValue(cellId));
+    faces.insert(face);
+  }
+  return faces;
+}
+
+bool CheckAttributes(vtkPolyData* surface, vtkUnstructuredGrid* grid)
+{
+  vtkIdTypeArray* pointIds =
+    vtkIdTypeArray::SafeDownCast(surface->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkDataArray* pressure = surface->GetPointData()->GetArray("pressure");
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(surface->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkDataArray* cellValues = surface->GetCellData()->GetArray("cellValues");
+  if (!pointIds || !pressure || !cellIds || !cellValues)
+  {
+    cerr << "ERROR: missing arrays in the surface." << endl;
+    return false;
+  }
+  for (vtkIdType cc = 0; cc < surface->GetNumberOfPoints(); ++cc)
+  {
+    const vtkIdType ptId = pointIds->GetValue(cc);
+    double pt[3], expected[3];
+    surface->GetPoint(cc, pt);
+    grid->GetPoint(ptId, expected);
+    if (pt[0] != expected[0] || pt[1] != expected[1] || pt[2] != expected[2] ||
+      pressure->GetTuple1(cc) != grid->GetPointData()->GetArray("pressure")->GetTuple1(ptId))
+    {
+      cerr << "ERROR: wrong point or point data for point " << cc << "." << endl;
+      return false;
+    }
+  }
+  for (vtkIdType cc = 0; cc < surface->GetNumberOfCells(); ++cc)
+  {
+    if (cellValues->GetTuple1(cc) != cellIds->GetValue(cc))
+    {
+      cerr << "ERROR: wrong cell data for face " << cc << "." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks that the normals of the faces point away from the center.
+bool CheckOrientation(vtkPolyData* surface, const double center[3])
+{
+  vtkIdType npts;
+  vtkIdType* pts;
+  vtkCellArray* polys = surface->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    double normal[3], centroid[3] = { 0.0, 0.0, 0.0 };
+    vtkPolygon::ComputeNormal(surface->GetPoints(), static_cast<int>(npts), pts, normal);
+    for (vtkIdType cc = 0; cc < npts; ++cc)
+    {
+      double pt[3];
+      surface->GetPoint(pts[cc], pt);
+      for (int i = 0; i < 3; ++i)
+      {
+        centroid[i] += pt[i] / npts;
+      }
+    }
+    const double outwards = (centroid[0] - center[0]) * normal[0] +
+      (centroid[1] - center[1]) * normal[1] + (centroid[2] - center[2]) * normal[2];
+    if (outwards <= 0.0)
+    {
+      cerr << "ERROR: face with points " << pts[0] << ", " << pts[1] << ", " << pts[2]
+           << " points inwards." << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkDataObject> Execute(vtkDataObject* input, bool useThreads, double& time)
+{
+  vtkNew<vtkPVGeometryFilter> filter;
+  filter->SetUseOutline(0);
+  filter->SetUseThreads(useThreads);
+  filter->SetInputData(input);
+  const double start = vtkTimerLog::GetUniversalTime();
+  filter->Update();
+  time = vtkTimerLog::GetUniversalTime() - start;
+  return filter->GetOutputDataObject(0);
+}
+}
+
+int TestPVGeometryFilterThreads(int, char* [])
+{
+  // A single grid large enough for the threaded external faces extraction.
+  const int dim = 50;
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeGrid(dim, 0.0);
+  double serialTime, threadedTime;
+  vtkPolyData* serial = vtkPolyData::SafeDownCast(Execute(grid, false, serialTime));
+  vtkPolyData* threaded = vtkPolyData::SafeDownCast(Execute(grid, true, threadedTime));
+  const vtkIdType expectedPoints =
+    (dim + 1) * (dim + 1) * (dim + 1) - (dim - 1) * (dim - 1) * (dim - 1);
+  const vtkIdType expectedPolys = 6 * dim * dim;
+  if (!serial || !threaded || serial->GetNumberOfPolys() != expectedPolys ||
+    threaded->GetNumberOfPolys() != expectedPolys ||
+    serial->GetNumberOfPoints() != expectedPoints ||
+    threaded->GetNumberOfPoints() != expectedPoints)
+  {
+    cerr << "ERROR: unexpected surface for the unstructured grid." << endl;
+    return TEST_FAILED;
+  }
+  if (GetFaces(serial) != GetFaces(threaded) || GetFaces(threaded).empty())
+  {
+    cerr << "ERROR: threaded surface differs from vtkDataSetSurfaceFilter." << endl;
+    return TEST_FAILED;
+  }
+  const double center[3] = { 0.5 * dim, 0.5 * dim, 0.5 * dim };
+  if (!CheckAttributes(threaded, grid) || !CheckOrientation(threaded, center))
+  {
+    return TEST_FAILED;
+  }
+  cout << "unstructured grid (" << grid->GetNumberOfCells() << " cells): " << serialTime
+       << "s -> " << threadedTime << "s" << endl;
+
+  // Many small blocks, some of them empty.
+  const unsigned int numBlocks = 512;
+  vtkNew<vtkMultiBlockDataSet> mb;
+  mb->SetNumberOfBlocks(numBlocks);
+  for (unsigned int cc = 0; cc < numBlocks; ++cc)
+  {
+    if (cc % 7 != 3)
+    {
+      mb->SetBlock(cc, MakeGrid(1 + cc % 6, 10.0 * cc));
+    }
+  }
+  vtkMultiBlockDataSet* serialMB =
+    vtkMultiBlockDataSet::SafeDownCast(Execute(mb.Get(), false, serialTime));
+  vtkMultiBlockDataSet* threadedMB =
+    vtkMultiBlockDataSet::SafeDownCast(Execute(mb.Get(), true, threadedTime));
+  if (!serialMB || !threadedMB || threadedMB->GetNumberOfBlocks() != numBlocks)
+  {
+    cerr << "ERROR: unexpected output for the multiblock." << endl;
+    return TEST_FAILED;
+  }
+  for (unsigned int cc = 0; cc < numBlocks; ++cc)
+  {
+    vtkPolyData* expected = vtkPolyData::SafeDownCast(serialMB->GetBlock(cc));
+    vtkPolyData* actual = vtkPolyData::SafeDownCast(threadedMB->GetBlock(cc));
+    if ((expected == NULL) != (actual == NULL) || (cc % 7 == 3) != (actual == NULL))
+    {
+      cerr << "ERROR: block " << cc << " is missing." << endl;
+      return TEST_FAILED;
+    }
+    if (!actual)
+    {
+      continue;
+    }
+    vtkUnsignedIntArray* index =
+      vtkUnsignedIntArray::SafeDownCast(actual->GetCellData()->GetArray("vtkCompositeIndex"));
+    if (actual->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+      actual->GetNumberOfPolys() != expected->GetNumberOfPolys() ||
+      actual->GetBounds()[0] != 10.0 * cc || !index || index->GetValue(0) != cc + 1 ||
+      GetFaces(actual) != GetFaces(expected))
+    {
+      cerr << "ERROR: block " << cc << " differs." << endl;
+      return TEST_FAILED;
+    }
+  }
+  cout << "multiblock (" << numBlocks << " blocks): " << serialTime << "s -> " << threadedTime
+       << "s" << endl;
+
+  return TEST_SUCCESS;
+}
@@ -0,0 +1,529 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkDeltaImageCompressor.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDeltaImageCompressor.h"
+
+#include "vtkLZ4Compressor.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+enum FrameTypes
+{
+  KEYFRAME = 0,
+  DELTA = 1
+};
+
+// Header layout (32-bit each): frame type, frame index, width, height, number
+// of components, tile size, number of tiles and uncompressed payload size. It
+// is followed by the payload compressed with vtkLZ4Compressor. The payload of
+// a keyframe is the image, the payload of a delta frame is the index of each
+// tile followed by the pixels of each tile, row by row.
+const int HEADER_LENGTH = 8;
+const vtkIdType HEADER_SIZE = HEADER_LENGTH * sizeof(vtkTypeInt32);
+
+class TileGeometry
+{
+public:
+  int Width;
+  int Height;
+  int NumberOfComponents;
+  int TileSize;
+  int TilesX;
+  int TilesY;
+
+  TileGeometry(int width, int height, int numComps, int tileSize)
+    : Width(width)
+    , Height(height)
+    , NumberOfComponents(numComps)
+    , TileSize(tileSize)
+    , TilesX((width + tileSize - 1) / tileSize)
+    , TilesY((height + tileSize - 1) / tileSize)
+  {
+  }
+
+  int GetNumberOfTiles() const { return this->TilesX * this->TilesY; }
+
+  // Returns the extent of a tile as origin and size, in pixels.
+  void GetTile(vtkIdType tile, int& x, int& y, int& width, int& height) const
+  {
+    x = static_cast<int>(tile % this->TilesX) * this->TileSize;
+    y = static_cast<int>(tile / this->TilesX) * this->TileSize;
+    width = std::min(this->TileSize, this->Width - x);
+    height = std::min(this->TileSize, this->Height - y);
+  }
+
+  vtkIdType GetTileBytes(vtkIdType tile) const
+  {
+    int x, y, width, height;
+    this->GetTile(tile, x, y, width, height);
+    return static_cast<vtkIdType>(width) * height * this->NumberOfComponents;
+  }
+
+  vtkIdType GetOffset(int x, int y) const
+  {
+    return (static_cast<vtkIdType>(y) * this->Width + x) * this->NumberOfComponents;
+  }
+};
+
+class FindDirtyTiles
+{
+public:
+  const TileGeometry* Geometry;
+  const unsigned char* Image;
+  const unsigned char* Reference;
+  // Color mask repeated over a row of tile.
+  const unsigned char* RowMask;
+  std::vector<char>* Dirty;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      int x, y, width, height;
+      this->Geometry->GetTile(tile, x, y, width, height);
+      const int rowBytes = width * this->Geometry->NumberOfComponents;
+      unsigned char diff = 0;
+      for (int row = 0; row < height && diff == 0; ++row)
+      {
+        const vtkIdType offset = this->Geometry->GetOffset(x, y + row);
+        const unsigned char* a = this->Image + offset;
+        const unsigned char* b = this->Reference + offset;
+        for (int cc = 0; cc < rowBytes; ++cc)
+        {
+          diff |= (a[cc] ^ b[cc]) & this->RowMask[cc];
+        }
+      }
+      (*this->Dirty)[tile] = diff != 0 ? 1 : 0;
+    }
+  }
+};
+
+// Copies tiles between an image and the payload. When Gather is true, tiles
+// are copied from the image to the payload and to the reference; otherwise
+// tiles are copied from the payload to the reference.
+class CopyTiles
+{
+public:
+  const TileGeometry* Geometry;
+  bool Gather;
+  const unsigned char* Image;
+  unsigned char* Reference;
+  unsigned char* Payload;
+  const std::vector<vtkTypeInt32>* Tiles;
+  const std::vector<vtkIdType>* Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+    {
+      int x, y, width, height;
+      this->Geometry->GetTile((*this->Tiles)[cc], x, y, width, height);
+      const size_t rowBytes = static_cast<size_t>(width) * this->Geometry->NumberOfComponents;
+      unsigned char* payload = this->Payload + (*this->Offsets)[cc];
+      for (int row = 0; row < height; ++row, payload += rowBytes)
+      {
+        const vtkIdType offset = this->Geometry->GetOffset(x, y + row);
+        if (this->Gather)
+        {
+          memcpy(payload, this->Image + offset, rowBytes);
+          memcpy(this->Reference + offset, this->Image + offset, rowBytes);
+        }
+        else
+        {
+          memcpy(this->Reference + offset, payload, rowBytes);
+        }
+      }
+    }
+  }
+};
+}
+
+vtkStandardNewMacro(vtkDeltaImageCompressor);
+//----------------------------------------------------------------------------
+vtkDeltaImageCompressor::vtkDeltaImageCompressor()
+  : Quality(0)
+  , TileSize(32)
+  , KeyFrameInterval(60)
+  , Width(0)
+  , Height(0)
+  , FrameIndex(0)
+  , FramesSinceKeyFrame(0)
+  , LastFrameWasKeyFrame(false)
+  , LastNumberOfTiles(0)
+  , ReferenceWidth(0)
+  , ReferenceHeight(0)
+{
+  // The tiles are sent exactly, the color mask is only used to find them.
+  this->PayloadCompressor->SetQuality(0);
+  this->PayloadCompressor->SetLossLessMode(1);
+}
+
+//----------------------------------------------------------------------------
+vtkDeltaImageCompressor::~vtkDeltaImageCompressor()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SetImageResolution(int width, int height)
+{
+  this->Width = width;
+  this->Height = height;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::ForceKeyFrame()
+{
+  this->ReferenceWidth = 0;
+  this->ReferenceHeight = 0;
+  this->Reference->Initialize();
+}
+
+//----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Compress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot compress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  vtkUnsignedCharArray* input = this->Input;
+  const int numComps = input->GetNumberOfComponents();
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  int width = this->Width;
+  int height = this->Height;
+  if (static_cast<vtkIdType>(width) * height != numPixels)
+  {
+    // Resolution was not provided, treat the image as a single row.
+    width = static_cast<int>(numPixels);
+    height = numPixels > 0 ? 1 : 0;
+  }
+  const TileGeometry geometry(width, height, numComps, this->TileSize);
+  const int numTiles = geometry.GetNumberOfTiles();
+
+  bool keyframe = this->ReferenceWidth != width || this->ReferenceHeight != height ||
+    this->Reference->GetNumberOfComponents() != numComps ||
+    (this->KeyFrameInterval > 0 && this->FramesSinceKeyFrame >= this->KeyFrameInterval);
+
+  std::vector<vtkTypeInt32> tiles;
+  std::vector<vtkIdType> offsets;
+  vtkIdType payloadSize = 0;
+  if (!keyframe)
+  {
+    unsigned char compress_masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
+      { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
+      { 0xE0, 0xF0, 0xE0, 0xE0 } };
+    const int compress_level = this->LossLessMode ? 0 : this->Quality;
+    std::vector<unsigned char> rowMask(this->TileSize * numComps);
+    for (size_t cc = 0; cc < rowMask.size(); ++cc)
+    {
+      rowMask[cc] = compress_masks[compress_level][(cc % numComps) % 4];
+    }
+
+    std::vector<char> dirty(numTiles, 0);
+    FindDirtyTiles finder;
+    finder.Geometry = &geometry;
+    finder.Image = input->GetPointer(0);
+    finder.Reference = this->Reference->GetPointer(0);
+    finder.RowMask = &rowMask[0];
+    finder.Dirty = &dirty;
+    vtkSMPTools::For(0, numTiles, finder);
+
+    for (int tile = 0; tile < numTiles; ++tile)
+    {
+      if (dirty[tile])
+      {
+        tiles.push_back(tile);
+      }
+    }
+    // When most of the image changed, a keyframe is just as small and does
+    // not require the tile indices.
+    keyframe = 2 * tiles.size() > static_cast<size_t>(numTiles);
+  }
+
+  vtkTypeInt32 header[HEADER_LENGTH] = { keyframe ? KEYFRAME : DELTA, ++this->FrameIndex, width,
+    height, numComps, this->TileSize, 0, 0 };
+  vtkUnsignedCharArray* payload = this->Payload.Get();
+  if (keyframe)
+  {
+    payload = input;
+    payloadSize = numPixels * numComps;
+    header[6] = numTiles;
+    this->Reference->DeepCopy(input);
+    this->ReferenceWidth = width;
+    this->ReferenceHeight = height;
+    this->FramesSinceKeyFrame = 0;
+  }
+  else if (!tiles.empty())
+  {
+    payloadSize = tiles.size() * sizeof(vtkTypeInt32);
+    offsets.resize(tiles.size());
+    for (size_t cc = 0; cc < tiles.size(); ++cc)
+    {
+      offsets[cc] = payloadSize;
+      payloadSize += geometry.GetTileBytes(tiles[cc]);
+    }
+    this->Payload->SetNumberOfComponents(1);
+    this->Payload->SetNumberOfTuples(payloadSize);
+    memcpy(this->Payload->GetPointer(0), &tiles[0], tiles.size() * sizeof(vtkTypeInt32));
+
+    CopyTiles gather;
+    gather.Geometry = &geometry;
+    gather.Gather = true;
+    gather.Image = input->GetPointer(0);
+    gather.Reference = this->Reference->GetPointer(0);
+    gather.Payload = this->Payload->GetPointer(0);
+    gather.Tiles = &tiles;
+    gather.Offsets = &offsets;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(tiles.size()), gather);
+    header[6] = static_cast<vtkTypeInt32>(tiles.size());
+    ++this->FramesSinceKeyFrame;
+  }
+  else
+  {
+    ++this->FramesSinceKeyFrame;
+  }
+  header[7] = static_cast<vtkTypeInt32>(payloadSize);
+
+  vtkIdType compressedSize = 0;
+  if (payloadSize > 0)
+  {
+    this->PayloadCompressor->SetInput(payload);
+    this->PayloadCompressor->SetOutput(this->CompressedPayload.Get());
+    if (this->PayloadCompressor->Compress() != VTK_OK)
+    {
+      this->ForceKeyFrame();
+      vtkErrorMacro("Failed to compress image tiles.");
+      return VTK_ERROR;
+    }
+    this->PayloadCompressor->SetInput(NULL);
+    compressedSize = this->CompressedPayload->GetNumberOfTuples();
+  }
+
+  this->Output->SetNumberOfComponents(1);
+  unsigned char* output = this->Output->WritePointer(0, HEADER_SIZE + compressedSize);
+  memcpy(output, header, HEADER_SIZE);
+  if (compressedSize > 0)
+  {
+    memcpy(output + HEADER_SIZE, this->CompressedPayload->GetPointer(0), compressedSize);
+  }
+  this->Output->SetNumberOfTuples(HEADER_SIZE + compressedSize);
+
+  this->LastFrameWasKeyFrame = keyframe;
+  this->LastNumberOfTiles = header[6];
+  return VTK_OK;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeltaImageCompressor::Decompress()
+{
+  if (!(this->Input && this->Output))
+  {
+    vtkWarningMacro("Cannot decompress, empty input or output detected.");
+    return VTK_ERROR;
+  }
+
+  const vtkIdType inputSize = this->Input->GetNumberOfTuples() * this->Input->GetNumberOfComponents();
+  if (inputSize < HEADER_SIZE)
+  {
+    vtkErrorMacro("Invalid compressed image.");
+    return VTK_ERROR;
+  }
+
+  vtkTypeInt32 header[HEADER_LENGTH];
+  memcpy(header, this->Input->GetPointer(0), HEADER_SIZE);
+  const bool keyframe = header[0] == KEYFRAME;
+  const int width = header[2];
+  const int height = header[3];
+  const int numComps = header[4];
+  const int tileSize = header[5];
+  const int numTiles = header[6];
+  const vtkIdType payloadSize = header[7];
+  if ((header[0] != KEYFRAME && header[0] != DELTA) || width < 0 || height < 0 ||
+    tileSize <= 0 || numTiles < 0 || payloadSize < 0 ||
+    numComps != this->Output->GetNumberOfComponents() ||
+    static_cast<vtkIdType>(width) * height != this->Output->GetNumberOfTuples())
+  {
+    vtkErrorMacro("Compressed image does not match the output image.");
+    return VTK_ERROR;
+  }
+
+  if (!keyframe &&
+    (this->ReferenceWidth != width || this->ReferenceHeight != height ||
+      this->Reference->GetNumberOfComponents() != numComps || header[1] != this->FrameIndex + 1))
+  {
+    // The frame this delta applies to is missing, all deltas are rejected
+    // until the next keyframe.
+    this->ForceKeyFrame();
+    vtkErrorMacro("Missing reference frame, waiting for the next keyframe.");
+    return VTK_ERROR;
+  }
+
+  const TileGeometry geometry(width, height, numComps, tileSize);
+  if (payloadSize > 0)
+  {
+    // Decompress a keyframe directly into the output.
+    vtkUnsignedCharArray* payload = keyframe ? this->Output : this->Payload.Get();
+    if (!keyframe)
+    {
+      this->Payload->SetNumberOfComponents(1);
+      this->Payload->SetNumberOfTuples(payloadSize);
+    }
+    if (payload->GetNumberOfTuples() * payload->GetNumberOfComponents() != payloadSize)
+    {
+      vtkErrorMacro("Invalid compressed image payload.");
+      return VTK_ERROR;
+    }
+    this->CompressedPayload->SetArray(this->Input->GetPointer(0) + HEADER_SIZE,
+      inputSize - HEADER_SIZE, /*save=*/1);
+    this->PayloadCompressor->SetInput(this->CompressedPayload.Get());
+    this->PayloadCompressor->SetOutput(payload);
+    const int status = this->PayloadCompressor->Decompress();
+    this->PayloadCompressor->SetInput(NULL);
+    this->CompressedPayload->Initialize();
+    if (status != VTK_OK)
+    {
+      this->ForceKeyFrame();
+      vtkErrorMacro("Failed to decompress image tiles.");
+      return VTK_ERROR;
+    }
+  }
+
+  if (keyframe)
+  {
+    this->Reference->DeepCopy(this->Output);
+    this->ReferenceWidth = width;
+    this->ReferenceHeight = height;
+  }
+  else
+  {
+    std::vector<vtkTypeInt32> tiles(numTiles);
+    std::vector<vtkIdType> offsets(numTiles);
+    vtkIdType offset = numTiles * static_cast<vtkIdType>(sizeof(vtkTypeInt32));
+    if (numTiles > 0 && offset <= payloadSize)
+    {
+      memcpy(&tiles[0], this->Payload->GetPointer(0), offset);
+    }
+    for (int cc = 0; cc < numTiles && offset <= payloadSize; ++cc)
+    {
+      if (tiles[cc] < 0 || tiles[cc] >= geometry.GetNumberOfTiles())
+      {
+        offset = payloadSize + 1;
+        break;
+      }
+      offsets[cc] = offset;
+      offset += geometry.GetTileBytes(tiles[cc]);
+    }
+    if (offset != (numTiles > 0 ? payloadSize : 0))
+    {
+      this->ForceKeyFrame();
+      vtkErrorMacro("Invalid compressed image tiles.");
+      return VTK_ERROR;
+    }
+
+    CopyTiles scatter;
+    scatter.Geometry = &geometry;
+    scatter.Gather = false;
+    scatter.Image = NULL;
+    scatter.Reference = this->Reference->GetPointer(0);
+    scatter.Payload = this->Payload->GetPointer(0);
+    scatter.Tiles = &tiles;
+    scatter.Offsets = &offsets;
+    vtkSMPTools::For(0, numTiles, scatter);
+    memcpy(this->Output->GetPointer(0), this->Reference->GetPointer(0),
+      static_cast<size_t>(width) * height * numComps);
+  }
+
+  this->FrameIndex = header[1];
+  this->LastFrameWasKeyFrame = keyframe;
+  this->LastNumberOfTiles = numTiles;
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::SaveConfiguration(vtkMultiProcessStream* stream)
+{
+  this->Superclass::SaveConfiguration(stream);
+  *stream << this->Quality << this->TileSize << this->KeyFrameInterval;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDeltaImageCompressor::RestoreConfiguration(vtkMultiProcessStream* stream)
+{
+  if (this->Superclass::RestoreConfiguration(stream))
+  {
+    int quality, tileSize, interval;
+    *stream >> quality >> tileSize >> interval;
+    this->SetQuality(quality);
+    this->SetTileSize(tileSize);
+    this->SetKeyFrameInterval(interval);
+    this->ForceKeyFrame();
+    return true;
+  }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkDeltaImageCompressor::SaveConfiguration()
+{
+  std::ostringstream oss;
+  oss << this->Superclass::SaveConfiguration() << " " << this->Quality << " " << this->TileSize
+      << " " << this->KeyFrameInterval;
+  this->SetConfiguration(oss.str().c_str());
+  return this->Configuration;
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkDeltaImageCompressor::RestoreConfiguration(const char* stream)
+{
+  stream = this->Superclass::RestoreConfiguration(stream);
+  if (stream)
+  {
+    // Tile size and keyframe interval are optional.
+    std::istringstream iss(stream);
+    int quality = this->Quality, tileSize = this->TileSize, interval = this->KeyFrameInterval;
+    iss >> quality;
+    if (iss >> tileSize)
+    {
+      iss >> interval;
+    }
+    this->SetQuality(quality);
+    this->SetTileSize(tileSize);
+    this->SetKeyFrameInterval(interval);
+    this->ForceKeyFrame();
+    std::streamoff pos = iss.tellg();
+    return stream + (pos < 0 ? strlen(stream) : static_cast<size_t>(pos));
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaImageCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Quality: " << this->Quality << endl;
+  os << indent << "TileSize: " << this->TileSize << endl;
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << endl;
+  os << indent << "LastFrameWasKeyFrame: " << this->LastFrameWasKeyFrame << endl;
+  os << indent << "LastNumberOfTiles: " << this->LastNumberOfTiles << endl;
+}
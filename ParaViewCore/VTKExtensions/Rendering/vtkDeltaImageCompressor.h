@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkDeltaImageCompressor.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkDeltaImageCompressor
+ * @brief   Image compressor/decompressor that only sends the tiles that
+ * changed since the previous frame.
+ *
+ * vtkDeltaImageCompressor keeps the last transmitted frame on both the
+ * compressing and the decompressing side. Each image is split into square
+ * tiles of TileSize pixels and only the tiles that differ from the previous
+ * frame are sent, compressed using LZ4. This is most effective when small
+ * regions of the image change between frames, e.g. while progressively
+ * refining a still render or when only annotations are edited.
+ *
+ * A keyframe, containing the whole image, is sent for the first frame, when
+ * the image resolution or number of components changes, every
+ * KeyFrameInterval frames, after the configuration changes and whenever most
+ * of the tiles changed. Each frame carries its index so that the
+ * decompressor can detect a missing reference frame; such frames are rejected
+ * until the next keyframe is received.
+ *
+ * When not in LossLessMode, the Quality (0 to 5) controls a color mask similar
+ * to vtkSquirtCompressor used when comparing tiles: tiles whose masked colors
+ * are unchanged are not sent. Tiles that are sent are always exact, and the
+ * compressor tracks what the receiver has, so switching to LossLessMode
+ * resends any tile that is not exact on the receiving side.
+ *
+ * @sa vtkPVClientServerSynchronizedRenderers::ConfigureCompressor
+*/
+
+#ifndef vtkDeltaImageCompressor_h
+#define vtkDeltaImageCompressor_h
+
+#include "vtkImageCompressor.h"
+#include "vtkNew.h"                            // needed for vtkNew
+#include "vtkPVVTKExtensionsRenderingModule.h" // needed for export macro
+
+class vtkLZ4Compressor;
+class vtkMultiProcessStream;
+
+class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkDeltaImageCompressor : public vtkImageCompressor
+{
+public:
+  static vtkDeltaImageCompressor* New();
+  vtkTypeMacro(vtkDeltaImageCompressor, vtkImageCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Set the quality measure used to compare tiles when not in LossLessMode.
+   * The value can be between 0 and 5. 0 means any change to a tile is sent
+   * while 5 ignores the least significant bits of the colors.
+   */
+  vtkSetClampMacro(Quality, int, 0, 5);
+  vtkGetMacro(Quality, int);
+  //@}
+
+  //@{
+  /**
+   * Set the size, in pixels, of the side of the square tiles compared between
+   * frames. Default is 32.
+   */
+  vtkSetClampMacro(TileSize, int, 4, 1024);
+  vtkGetMacro(TileSize, int);
+  //@}
+
+  //@{
+  /**
+   * Set the number of frames after which a keyframe is sent even if the image
+   * resolution did not change. 0 disables periodic keyframes. Default is 60.
+   */
+  vtkSetClampMacro(KeyFrameInterval, int, 0, VTK_INT_MAX);
+  vtkGetMacro(KeyFrameInterval, int);
+  //@}
+
+  /**
+   * Forces the next compressed frame to be a keyframe.
+   */
+  void ForceKeyFrame();
+
+  //@{
+  /**
+   * Compress/Decompress data array on the objects input with results
+   * in the objects output. See also Set/GetInput/Output.
+   */
+  int Compress() VTK_OVERRIDE;
+  int Decompress() VTK_OVERRIDE;
+  //@}
+
+  /**
+   * Communicates the next expected image resolution.
+   */
+  void SetImageResolution(int width, int height) VTK_OVERRIDE;
+
+  //@{
+  /**
+   * Returns true if the last frame compressed or decompressed was a keyframe
+   * and the number of tiles it contained.
+   */
+  vtkGetMacro(LastFrameWasKeyFrame, bool);
+  vtkGetMacro(LastNumberOfTiles, int);
+  //@}
+
+  //@{
+  /**
+   * Serialize/Restore compressor configuration (but not the data) into the
+   * stream. Restoring the configuration resets the reference frame.
+   */
+  void SaveConfiguration(vtkMultiProcessStream* stream) VTK_OVERRIDE;
+  bool RestoreConfiguration(vtkMultiProcessStream* stream) VTK_OVERRIDE;
+  const char* SaveConfiguration() VTK_OVERRIDE;
+  const char* RestoreConfiguration(const char* stream) VTK_OVERRIDE;
+  //@}
+
+protected:
+  vtkDeltaImageCompressor();
+  ~vtkDeltaImageCompressor() override;
+
+  int Quality;
+  int TileSize;
+  int KeyFrameInterval;
+
+private:
+  vtkDeltaImageCompressor(const vtkDeltaImageCompressor&) = delete;
+  void operator=(const vtkDeltaImageCompressor&) = delete;
+
+  int Width;
+  int Height;
+  int FrameIndex;
+  int FramesSinceKeyFrame;
+  bool LastFrameWasKeyFrame;
+  int LastNumberOfTiles;
+
+  // The last frame sent or received, ReferenceWidth is 0 when there is none.
+  vtkNew<vtkUnsignedCharArray> Reference;
+  int ReferenceWidth;
+  int ReferenceHeight;
+
+  // Buffers used to compress the tiles.
+  vtkNew<vtkUnsignedCharArray> Payload;
+  vtkNew<vtkUnsignedCharArray> CompressedPayload;
+  vtkNew<vtkLZ4Compressor> PayloadCompressor;
+};
+
+#endif
@@ -16,11 +16,87 @@
 
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 
 #include "vtk_lz4.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <sstream>
+#include <vector>
+
+namespace
+{
+// Size in bytes of the tiles compressed independently. It is a multiple of 4
+// so that tiles never split an RGBA pixel.
+const int LZ4_TILE_SIZE = 262144;
+
+// Header layout: number of tiles and tile size, followed by the compressed
+// size of each tile (32-bit each).
+const size_t LZ4_HEADER_SIZE = 2 * sizeof(vtkTypeInt32);
+
+class CompressTiles
+{
+public:
+  const unsigned char* Input;
+  vtkIdType InputSize;
+  unsigned int Mask;
+  // When non-null, pixels are masked into this buffer before compression.
+  unsigned char* Masked;
+  char* Output;
+  int MaxTileSize;
+  std::vector<int>* Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      const vtkIdType offset = tile * LZ4_TILE_SIZE;
+      const int length =
+        static_cast<int>(std::min(static_cast<vtkIdType>(LZ4_TILE_SIZE), this->InputSize - offset));
+      const unsigned char* src = this->Input + offset;
+      if (this->Masked)
+      {
+        const unsigned int* in = reinterpret_cast<const unsigned int*>(src);
+        unsigned int* out = reinterpret_cast<unsigned int*>(this->Masked + offset);
+        for (int cc = 0, max = length / 4; cc < max; ++cc)
+        {
+          out[cc] = in[cc] & this->Mask;
+        }
+        src = this->Masked + offset;
+      }
+      (*this->Sizes)[tile] = LZ4_compress_fast(reinterpret_cast<const char*>(src),
+        this->Output + tile * this->MaxTileSize, length, this->MaxTileSize, 16);
+    }
+  }
+};
+
+class DecompressTiles
+{
+public:
+  const char* Input;
+  const std::vector<vtkIdType>* Offsets;
+  const std::vector<int>* Sizes;
+  char* Output;
+  vtkIdType OutputSize;
+  int TileSize;
+  std::vector<char>* Status;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      const vtkIdType offset = tile * this->TileSize;
+      const int length =
+        static_cast<int>(std::min(static_cast<vtkIdType>(this->TileSize), this->OutputSize - offset));
+      const int decompressedSize = LZ4_decompress_safe(this->Input + (*this->Offsets)[tile],
+        this->Output + offset, (*this->Sizes)[tile], length);
+      (*this->Status)[tile] = decompressedSize == length ? 1 : 0;
+    }
+  }
+};
+}
 
 vtkStandardNewMacro(vtkLZ4Compressor);
 //----------------------------------------------------------------------------
@@ -56,27 +132,49 @@ int vtkLZ4Compressor::Compress()
   memcpy(&compress_mask, &compress_masks[compress_level], 4);
 
   vtkUnsignedCharArray* input = this->Input;
-  int inputSize = input->GetNumberOfTuples() * input->GetNumberOfComponents();
+  const vtkIdType inputSize = input->GetNumberOfTuples() * input->GetNumberOfComponents();
+  const int numTiles = static_cast<int>((inputSize + LZ4_TILE_SIZE - 1) / LZ4_TILE_SIZE);
+  const int maxTileSize = LZ4_compressBound(LZ4_TILE_SIZE);
 
-  if (this->Quality > 0 && input->GetNumberOfComponents() == 4)
+  CompressTiles functor;
+  functor.Input = input->GetPointer(0);
+  functor.InputSize = inputSize;
+  functor.Mask = compress_mask;
+  functor.Masked = NULL;
+  if (compress_level > 0 && input->GetNumberOfComponents() == 4)
   {
     this->TemporaryBuffer->SetNumberOfComponents(input->GetNumberOfComponents());
     this->TemporaryBuffer->SetNumberOfTuples(input->GetNumberOfTuples());
-    const unsigned int* in = reinterpret_cast<const unsigned int*>(input->GetPointer(0));
-    unsigned int* out = reinterpret_cast<unsigned int*>(this->TemporaryBuffer->GetPointer(0));
-    for (vtkIdType cc = 0, max = this->Input->GetNumberOfTuples(); cc < max; ++cc)
+    functor.Masked = this->TemporaryBuffer->GetPointer(0);
+  }
+
+  // Tiles are compressed at fixed offsets past the header and then compacted.
+  const vtkIdType headerSize = LZ4_HEADER_SIZE + numTiles * sizeof(vtkTypeInt32);
+  char* output = reinterpret_cast<char*>(
+    this->Output->WritePointer(0, headerSize + static_cast<vtkIdType>(numTiles) * maxTileSize));
+  std::vector<int> sizes(numTiles, 0);
+  functor.Output = output + headerSize;
+  functor.MaxTileSize = maxTileSize;
+  functor.Sizes = &sizes;
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  vtkTypeInt32 header[2] = { numTiles, LZ4_TILE_SIZE };
+  memcpy(output, header, sizeof(header));
+  vtkIdType compressedSize = headerSize;
+  for (int tile = 0; tile < numTiles; ++tile)
+  {
+    if (sizes[tile] <= 0)
     {
-      out[cc] = in[cc] & compress_mask;
+      vtkErrorMacro("Failed to compress tile " << tile << ".");
+      return VTK_ERROR;
     }
-    input = this->TemporaryBuffer.Get();
+    const vtkTypeInt32 size = sizes[tile];
+    memcpy(output + LZ4_HEADER_SIZE + tile * sizeof(vtkTypeInt32), &size, sizeof(size));
+    memmove(output + compressedSize, output + headerSize + tile * maxTileSize, size);
+    compressedSize += size;
   }
-
-  int maxOutputSize = LZ4_compressBound(inputSize);
-  int compressedSize = LZ4_compress_fast(reinterpret_cast<const char*>(input->GetPointer(0)),
-    reinterpret_cast<char*>(this->Output->WritePointer(0, maxOutputSize)), inputSize, maxOutputSize,
-    16);
   this->Output->SetNumberOfTuples(compressedSize);
-  return compressedSize > 0 ? VTK_OK : VTK_ERROR;
+  return VTK_OK;
 }
 
 //----------------------------------------------------------------------------
@@ -88,20 +186,55 @@ int vtkLZ4Compressor::Decompress()
     return VTK_ERROR;
   }
 
-  int maxDecompressedSize =
+  const char* input = reinterpret_cast<const char*>(this->Input->GetPointer(0));
+  const vtkIdType inputSize = this->Input->GetNumberOfTuples();
+  const vtkIdType outputSize =
     this->Output->GetNumberOfComponents() * this->Output->GetNumberOfTuples();
-  int decompressedSize =
-    LZ4_decompress_safe(reinterpret_cast<const char*>(this->Input->GetPointer(0)),
-      reinterpret_cast<char*>(this->Output->GetPointer(0)), this->Input->GetNumberOfTuples(),
-      maxDecompressedSize);
-
-  //  // We use LZ4_decompress_safe for now since there seems to be some bug
-  //  // in LZ4_decompress_fast which is causing segfaults on Windows.
-  //  int decompressedSize = LZ4_decompress_fast(
-  //    reinterpret_cast<const char*>(this->Input->GetPointer(0)),
-  //    reinterpret_cast<char*>(this->Output->GetPointer(0)),
-  //    maxDecompressedSize);
-  return decompressedSize > 0 ? VTK_OK : VTK_ERROR;
+
+  vtkTypeInt32 header[2] = { 0, 0 };
+  if (inputSize >= static_cast<vtkIdType>(LZ4_HEADER_SIZE))
+  {
+    memcpy(header, input, sizeof(header));
+  }
+  const vtkTypeInt32 numTiles = header[0];
+  const vtkTypeInt32 tileSize = header[1];
+  if (numTiles <= 0 || tileSize <= 0 ||
+    inputSize < static_cast<vtkIdType>(LZ4_HEADER_SIZE + numTiles * sizeof(vtkTypeInt32)) ||
+    outputSize > static_cast<vtkIdType>(numTiles) * tileSize ||
+    outputSize <= static_cast<vtkIdType>(numTiles - 1) * tileSize)
+  {
+    vtkErrorMacro("Invalid compressed image header.");
+    return VTK_ERROR;
+  }
+
+  std::vector<int> sizes(numTiles);
+  std::vector<vtkIdType> offsets(numTiles);
+  vtkIdType offset = LZ4_HEADER_SIZE + numTiles * sizeof(vtkTypeInt32);
+  for (int tile = 0; tile < numTiles; ++tile)
+  {
+    vtkTypeInt32 size;
+    memcpy(&size, input + LZ4_HEADER_SIZE + tile * sizeof(vtkTypeInt32), sizeof(size));
+    sizes[tile] = size;
+    offsets[tile] = offset;
+    offset += size;
+    if (size <= 0 || offset > inputSize)
+    {
+      vtkErrorMacro("Truncated compressed image.");
+      return VTK_ERROR;
+    }
+  }
+
+  std::vector<char> status(numTiles, 0);
+  DecompressTiles functor;
+  functor.Input = input;
+  functor.Offsets = &offsets;
+  functor.Sizes = &sizes;
+  functor.Output = reinterpret_cast<char*>(this->Output->GetPointer(0));
+  functor.OutputSize = outputSize;
+  functor.TileSize = tileSize;
+  functor.Status = &status;
+  vtkSMPTools::For(0, numTiles, 1, functor);
+  return std::find(status.begin(), status.end(), 0) == status.end() ? VTK_OK : VTK_ERROR;
 }
 
 //-----------------------------------------------------------------------------
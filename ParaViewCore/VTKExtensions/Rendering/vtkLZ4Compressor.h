@@ -18,7 +18,10 @@
  * that uses LZ4 for fast lossless compression.
  *
  * vtkLZ4Compressor uses LZ4 for fast lossless compression and decompression on
- * data.
+ * data. The image is split into fixed size tiles that are compressed and
+ * decompressed independently using vtkSMPTools. The compressed buffer starts
+ * with the number of tiles, the tile size and the compressed size of each
+ * tile, followed by the compressed tiles.
 */
 
 #ifndef vtkLZ4Compressor_h
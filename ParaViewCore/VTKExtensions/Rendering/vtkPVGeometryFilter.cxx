@@ -37,6 +37,8 @@
 #include "vtkHierarchicalBoxDataSet.h"
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridGeometry.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationIntegerVectorKey.h"
@@ -51,10 +53,14 @@
 #include "vtkPVRecoverGeometryWireframe.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridOutlineFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSelectionNode.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -68,12 +74,14 @@
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridGeometryFilter.h"
+#include "vtkWeakPointer.h"
 
 #include <algorithm>
 #include <assert.h>
 #include <map>
 #include <math.h>
 #include <set>
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -134,6 +142,43 @@ public:
   int Commutative() override { return 1; }
 };
 
+//----------------------------------------------------------------------------
+struct vtkPVGeometryFilter::SurfaceCacheEntry
+{
+  // The objects defining the cells when the surface was extracted, and their
+  // modification times. Empty if the entry is empty.
+  std::vector<vtkWeakPointer<vtkObject> > TopologyObjects;
+  std::vector<vtkMTimeType> TopologyTimes;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  int NonlinearSubdivisionLevel;
+  int Triangulate;
+
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  vtkSmartPointer<vtkCellArray> Strips;
+  vtkSmartPointer<vtkIdTypeArray> OriginalPointIds;
+  vtkSmartPointer<vtkIdTypeArray> OriginalCellIds;
+
+  // Input ids of the output points and cells, to gather the arrays.
+  vtkSmartPointer<vtkIdList> SourcePointIds;
+  vtkSmartPointer<vtkIdList> SourceCellIds;
+
+  SurfaceCacheEntry()
+    : NumberOfPoints(0)
+    , NumberOfCells(0)
+    , NonlinearSubdivisionLevel(0)
+    , Triangulate(0)
+  {
+  }
+};
+
+class vtkPVGeometryFilter::SurfaceCacheMap
+  : public std::map<unsigned int, vtkPVGeometryFilter::SurfaceCacheEntry>
+{
+};
+
 //----------------------------------------------------------------------------
 vtkPVGeometryFilter::vtkPVGeometryFilter()
 {
@@ -179,6 +224,10 @@ vtkPVGeometryFilter::vtkPVGeometryFilter()
 
   this->HideInternalAMRFaces = true;
   this->UseNonOverlappingAMRMetaDataForOutlines = true;
+  this->UseThreads = false;
+  this->UseSurfaceCache = true;
+  this->SurfaceCache = new SurfaceCacheMap;
+  this->CurrentSurfaceCacheEntry = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -216,6 +265,7 @@ vtkPVGeometryFilter::~vtkPVGeometryFilter()
   }
   this->OutlineSource->Delete();
   this->SetController(0);
+  delete this->SurfaceCache;
 }
 
 //----------------------------------------------------------------------------
@@ -557,7 +607,12 @@ int vtkPVGeometryFilter::RequestData(
   }
   int* wholeExtent =
     vtkStreamingDemandDrivenPipeline::GetWholeExtent(inputVector[0]->GetInformationObject(0));
+
+  // Only the cached surface for a non-composite input is kept.
+  this->SurfaceCache->erase(this->SurfaceCache->upper_bound(0), this->SurfaceCache->end());
+  this->CurrentSurfaceCacheEntry = &(*this->SurfaceCache)[0];
   this->ExecuteBlock(input, output, 1, procid, numProcs, 0, wholeExtent);
+  this->CurrentSurfaceCacheEntry = NULL;
   this->CleanupOutputData(output, 1);
   return 1;
 }
@@ -883,6 +938,37 @@ int vtkPVGeometryFilter::RequestAMRData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Executes blocks using one vtkPVGeometryFilter per thread, since the internal
+// filters cannot be shared between threads.
+class vtkPVGeometryFilter::ExecuteBlocksFunctor
+{
+public:
+  vtkPVGeometryFilter* Self;
+  const std::vector<vtkDataObject*>* Blocks;
+  const std::vector<vtkSmartPointer<vtkPolyData> >* Outputs;
+  const std::vector<SurfaceCacheEntry*>* CacheEntries;
+  const int* WholeExtent;
+  vtkSMPThreadLocalObject<vtkPVGeometryFilter> Filters;
+
+  void Initialize() { this->Filters.Local()->CopyBlockSettings(this->Self); }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkPVGeometryFilter* filter = this->Filters.Local();
+    for (vtkIdType cc = begin; cc < end && !this->Self->GetAbortExecute(); ++cc)
+    {
+      vtkPolyData* output = (*this->Outputs)[cc];
+      filter->CurrentSurfaceCacheEntry = (*this->CacheEntries)[cc];
+      filter->ExecuteBlock((*this->Blocks)[cc], output, 0, 0, 1, 0, this->WholeExtent);
+      filter->CleanupOutputData(output, 0);
+    }
+    filter->CurrentSurfaceCacheEntry = NULL;
+  }
+
+  void Reduce() {}
+};
+
 //----------------------------------------------------------------------------
 int vtkPVGeometryFilter::RequestCompositeData(
   vtkInformation*, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
@@ -926,7 +1012,68 @@ int vtkPVGeometryFilter::RequestCompositeData(
     vtkStreamingDemandDrivenPipeline::GetWholeExtent(inputVector[0]->GetInformationObject(0));
   int numInputs = 0;
 
+  // Blocks are executed first, possibly concurrently, and then added to the
+  // output in traversal order.
+  // Cached surfaces are kept only for the blocks that are still present.
+  std::vector<vtkDataObject*> blocks;
+  std::vector<SurfaceCacheEntry*> cacheEntries;
+  blocks.reserve(totNumBlocks);
+  cacheEntries.reserve(totNumBlocks);
+  SurfaceCacheMap surfaceCache;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    const unsigned int flatIndex = iter->GetCurrentFlatIndex();
+    SurfaceCacheEntry& entry = surfaceCache[flatIndex];
+    SurfaceCacheMap::iterator previous = this->SurfaceCache->find(flatIndex);
+    if (previous != this->SurfaceCache->end())
+    {
+      std::swap(entry, previous->second);
+    }
+    blocks.push_back(iter->GetCurrentDataObject());
+    cacheEntries.push_back(&entry);
+  }
+  // Swapping keeps the addresses of the entries.
+  this->SurfaceCache->swap(surfaceCache);
+  std::vector<vtkSmartPointer<vtkPolyData> > outputs(blocks.size());
+  for (size_t cc = 0; cc < outputs.size(); ++cc)
+  {
+    outputs[cc] = vtkSmartPointer<vtkPolyData>::New();
+  }
+
+  const vtkIdType numBlocks = static_cast<vtkIdType>(blocks.size());
+  if (this->UseThreads && numBlocks > 1)
+  {
+    ExecuteBlocksFunctor functor;
+    functor.Self = this;
+    functor.Blocks = &blocks;
+    functor.Outputs = &outputs;
+    functor.CacheEntries = &cacheEntries;
+    functor.WholeExtent = wholeExtent;
+
+    // Blocks are split in a few batches to report progress.
+    const vtkIdType batchSize = std::max<vtkIdType>(numBlocks / 10, 1);
+    for (vtkIdType begin = 0; begin < numBlocks && !this->AbortExecute; begin += batchSize)
+    {
+      const vtkIdType end = std::min(begin + batchSize, numBlocks);
+      vtkSMPTools::For(begin, end, 1, functor);
+      this->UpdateProgress(static_cast<double>(end) / numBlocks);
+    }
+  }
+  else
+  {
+    for (vtkIdType cc = 0; cc < numBlocks; ++cc)
+    {
+      this->CurrentSurfaceCacheEntry = cacheEntries[cc];
+      this->ExecuteBlock(blocks[cc], outputs[cc], 0, 0, 1, 0, wholeExtent);
+      this->CleanupOutputData(outputs[cc], 0);
+      numInputs++;
+      this->UpdateProgress(static_cast<float>(numInputs) / totNumBlocks);
+    }
+    this->CurrentSurfaceCacheEntry = NULL;
+  }
+
   unsigned int block_id = 0;
+  size_t output_index = 0;
   iter->SkipEmptyNodesOff(); // since we want to a get an accurate block-id count to
                              // set vtkBlockColors correctly.
   for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem(), ++block_id)
@@ -937,9 +1084,7 @@ int vtkPVGeometryFilter::RequestCompositeData(
       continue;
     }
 
-    vtkPolyData* tmpOut = vtkPolyData::New();
-    this->ExecuteBlock(block, tmpOut, 0, 0, 1, 0, wholeExtent);
-    this->CleanupOutputData(tmpOut, 0);
+    vtkPolyData* tmpOut = outputs[output_index++];
     // skip empty nodes.
     if (tmpOut->GetNumberOfPoints() > 0)
     {
@@ -947,19 +1092,10 @@ int vtkPVGeometryFilter::RequestCompositeData(
       non_null_leaves.resize(current_flat_index + 1);
       non_null_leaves[current_flat_index] = 1;
       output->SetDataSet(iter, tmpOut);
-      tmpOut->FastDelete();
 
       this->AddCompositeIndex(tmpOut, current_flat_index);
       this->AddBlockColors(tmpOut, block_id);
     }
-    else
-    {
-      tmpOut->Delete();
-      tmpOut = NULL;
-    }
-
-    numInputs++;
-    this->UpdateProgress(static_cast<float>(numInputs) / totNumBlocks);
   }
   vtkTimerLog::MarkEndEvent("vtkPVGeometryFilter::ExecuteCompositeDataSet");
 
@@ -1367,6 +1503,371 @@ void vtkPVGeometryFilter::RectilinearGridExecute(vtkRectilinearGrid* input, vtkP
   output->CopyStructure(outline->GetOutput());
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Unstructured grids with fewer cells are handled by vtkDataSetSurfaceFilter.
+const vtkIdType vtkPVGeometryFilterMinimumThreadedCells = 100000;
+
+// Number of buckets the faces are sorted in. Each bucket is processed by a
+// single thread.
+const int vtkPVGeometryFilterNumberOfFaceBuckets = 256;
+
+// Faces of the linear 3D cells, using the same ordering as
+// vtkDataSetSurfaceFilter so that normals point outwards. Triangles end with
+// -1.
+struct vtkPVGeometryFilterCellFaces
+{
+  int NumberOfFaces;
+  int Faces[6][4];
+};
+
+const vtkPVGeometryFilterCellFaces* vtkPVGeometryFilterGetCellFaces(int cellType)
+{
+  static const vtkPVGeometryFilterCellFaces tetra = { 4,
+    { { 0, 1, 3, -1 }, { 0, 2, 1, -1 }, { 0, 3, 2, -1 }, { 1, 2, 3, -1 } } };
+  static const vtkPVGeometryFilterCellFaces voxel = { 6, { { 0, 4, 6, 2 }, { 1, 3, 7, 5 },
+                                                          { 0, 1, 5, 4 }, { 2, 6, 7, 3 },
+                                                          { 0, 2, 3, 1 }, { 4, 5, 7, 6 } } };
+  static const vtkPVGeometryFilterCellFaces hexahedron = { 6, { { 0, 4, 7, 3 }, { 1, 2, 6, 5 },
+                                                               { 0, 1, 5, 4 }, { 3, 7, 6, 2 },
+                                                               { 0, 3, 2, 1 }, { 4, 5, 6, 7 } } };
+  static const vtkPVGeometryFilterCellFaces wedge = { 5,
+    { { 0, 1, 2, -1 }, { 3, 5, 4, -1 }, { 0, 3, 4, 1 }, { 1, 4, 5, 2 }, { 2, 5, 3, 0 } } };
+  static const vtkPVGeometryFilterCellFaces pyramid = { 5,
+    { { 0, 3, 2, 1 }, { 0, 1, 4, -1 }, { 1, 2, 4, -1 }, { 2, 3, 4, -1 }, { 3, 0, 4, -1 } } };
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      return &tetra;
+    case VTK_VOXEL:
+      return &voxel;
+    case VTK_HEXAHEDRON:
+      return &hexahedron;
+    case VTK_WEDGE:
+      return &wedge;
+    case VTK_PYRAMID:
+      return &pyramid;
+    default:
+      return NULL;
+  }
+}
+
+// Number of cells handled together when the faces are counted and stored, so
+// that both passes give the same cells to the same chunk whatever the thread.
+const vtkIdType vtkPVGeometryFilterFaceChunkSize = 65536;
+
+// Faces are referred to by a single integer packing the cell id and the index
+// of the face in the cell, so that sorting them by this id sorts them in cell
+// order.
+inline vtkIdType vtkPVGeometryFilterPackFace(vtkIdType cellId, int faceId)
+{
+  return (cellId << 3) | faceId;
+}
+
+// Gets the sorted point ids of a face, the last one being -1 for triangles.
+void vtkPVGeometryFilterGetFaceKey(vtkUnstructuredGrid* input, vtkIdType face, vtkIdType key[4])
+{
+  vtkIdType npts;
+  vtkIdType* pts;
+  const vtkIdType cellId = face >> 3;
+  input->GetCellPoints(cellId, npts, pts);
+  const int* facePts =
+    vtkPVGeometryFilterGetCellFaces(input->GetCellType(cellId))->Faces[face & 7];
+  const int numFacePts = facePts[3] < 0 ? 3 : 4;
+  for (int cc = 0; cc < numFacePts; ++cc)
+  {
+    key[cc] = pts[facePts[cc]];
+  }
+  std::sort(key, key + numFacePts);
+  key[3] = numFacePts == 3 ? -1 : key[3];
+}
+
+// Buckets are chosen using the smallest point id of each face, so that the
+// faces shared by two cells are in the same bucket.
+inline int vtkPVGeometryFilterGetFaceBucket(const vtkIdType* pts, const int* facePts)
+{
+  const int numFacePts = facePts[3] < 0 ? 3 : 4;
+  vtkIdType smallest = pts[facePts[0]];
+  for (int cc = 1; cc < numFacePts; ++cc)
+  {
+    smallest = std::min(smallest, pts[facePts[cc]]);
+  }
+  return static_cast<int>(smallest % vtkPVGeometryFilterNumberOfFaceBuckets);
+}
+
+// Stores the faces of the cells of each chunk in Faces, grouped by bucket.
+// With Counts only, counts the faces of each chunk in each bucket instead.
+class vtkPVGeometryFilterBucketFaces
+{
+public:
+  vtkUnstructuredGrid* Input;
+  // Indexed by bucket, then by chunk.
+  std::vector<vtkIdType>* Counts;
+  std::vector<vtkIdType>* Faces;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType numCells = this->Input->GetNumberOfCells();
+    const vtkIdType numChunks = static_cast<vtkIdType>(this->Counts->size()) /
+      vtkPVGeometryFilterNumberOfFaceBuckets;
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      const vtkIdType lastCell =
+        std::min(numCells, (chunk + 1) * vtkPVGeometryFilterFaceChunkSize);
+      for (vtkIdType cellId = chunk * vtkPVGeometryFilterFaceChunkSize; cellId < lastCell;
+           ++cellId)
+      {
+        const vtkPVGeometryFilterCellFaces* faces =
+          vtkPVGeometryFilterGetCellFaces(this->Input->GetCellType(cellId));
+        this->Input->GetCellPoints(cellId, npts, pts);
+        for (int faceId = 0; faceId < faces->NumberOfFaces; ++faceId)
+        {
+          const int bucket = vtkPVGeometryFilterGetFaceBucket(pts, faces->Faces[faceId]);
+          vtkIdType& position = (*this->Counts)[bucket * numChunks + chunk];
+          if (this->Faces)
+          {
+            (*this->Faces)[position] = vtkPVGeometryFilterPackFace(cellId, faceId);
+          }
+          ++position;
+        }
+      }
+    }
+  }
+};
+
+// A face of a bucket, with a hash of its sorted point ids.
+struct vtkPVGeometryFilterHashedFace
+{
+  vtkTypeUInt64 Hash;
+  vtkIdType Face;
+
+  bool operator<(const vtkPVGeometryFilterHashedFace& other) const
+  {
+    return this->Hash < other.Hash || (this->Hash == other.Hash && this->Face < other.Face);
+  }
+};
+
+// Finds the faces of each bucket that are used by a single cell. Only the
+// faces of the buckets being processed are hashed, the faces used by several
+// cells are told apart from hash collisions using their point ids.
+class vtkPVGeometryFilterFindExternalFaces
+{
+public:
+  vtkUnstructuredGrid* Input;
+  const std::vector<vtkIdType>* Faces;
+  // Index of the first face of each bucket in Faces, followed by its size.
+  const std::vector<vtkIdType>* BucketOffsets;
+  vtkSMPThreadLocal<std::vector<vtkPVGeometryFilterHashedFace> > HashedFaces;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > External;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<vtkPVGeometryFilterHashedFace>& hashed = this->HashedFaces.Local();
+    std::vector<vtkIdType>& external = this->External.Local();
+    vtkIdType key[4], other[4];
+    for (vtkIdType bucket = begin; bucket < end; ++bucket)
+    {
+      const vtkIdType first = (*this->BucketOffsets)[bucket];
+      const vtkIdType last = (*this->BucketOffsets)[bucket + 1];
+      hashed.resize(last - first);
+      for (vtkIdType cc = first; cc < last; ++cc)
+      {
+        vtkPVGeometryFilterHashedFace& face = hashed[cc - first];
+        face.Face = (*this->Faces)[cc];
+        vtkPVGeometryFilterGetFaceKey(this->Input, face.Face, key);
+        face.Hash = 14695981039346656037ULL;
+        for (int k = 0; k < 4; ++k)
+        {
+          face.Hash = (face.Hash ^ static_cast<vtkTypeUInt64>(key[k])) * 1099511628211ULL;
+        }
+      }
+      std::sort(hashed.begin(), hashed.end());
+      for (size_t group = 0, groupEnd; group < hashed.size(); group = groupEnd)
+      {
+        for (groupEnd = group + 1;
+             groupEnd < hashed.size() && hashed[groupEnd].Hash == hashed[group].Hash; ++groupEnd)
+        {
+        }
+        if (groupEnd == group + 1)
+        {
+          external.push_back(hashed[group].Face);
+          continue;
+        }
+        // Colliding hashes, compare the point ids.
+        for (size_t cc = group; cc < groupEnd; ++cc)
+        {
+          vtkPVGeometryFilterGetFaceKey(this->Input, hashed[cc].Face, key);
+          bool shared = false;
+          for (size_t dd = group; dd < groupEnd && !shared; ++dd)
+          {
+            if (dd != cc)
+            {
+              vtkPVGeometryFilterGetFaceKey(this->Input, hashed[dd].Face, other);
+              shared = std::equal(key, key + 4, other);
+            }
+          }
+          if (!shared)
+          {
+            external.push_back(hashed[cc].Face);
+          }
+        }
+      }
+    }
+  }
+
+  void Initialize() {}
+  void Reduce() {}
+};
+
+// Extracts the external faces of an unstructured grid made only of linear 3D
+// cells, like vtkDataSetSurfaceFilter does, using several threads to match
+// the faces. Returns false if the input is not supported. Besides the output,
+// this uses 8 bytes per face of the cells, and 16 bytes per face of the
+// buckets being processed.
+bool vtkPVGeometryFilterExtractExternalFaces(
+  vtkUnstructuredGridBase* inputBase, vtkPolyData* output, bool passCellIds, bool passPointIds)
+{
+  vtkUnstructuredGrid* input = vtkUnstructuredGrid::SafeDownCast(inputBase);
+  if (!input || input->GetNumberOfCells() < vtkPVGeometryFilterMinimumThreadedCells ||
+    input->GetCellData()->GetArray(vtkDataSetAttributes::GhostArrayName()) ||
+    input->GetPointData()->GetArray(vtkDataSetAttributes::GhostArrayName()))
+  {
+    return false;
+  }
+  const vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (!vtkPVGeometryFilterGetCellFaces(input->GetCellType(cellId)))
+    {
+      return false;
+    }
+  }
+
+  // Count the faces of each chunk in each bucket, then store them all in a
+  // single array, grouped by bucket.
+  const vtkIdType numChunks =
+    (numCells + vtkPVGeometryFilterFaceChunkSize - 1) / vtkPVGeometryFilterFaceChunkSize;
+  std::vector<vtkIdType> counts(vtkPVGeometryFilterNumberOfFaceBuckets * numChunks, 0);
+  vtkPVGeometryFilterBucketFaces bucketFaces;
+  bucketFaces.Input = input;
+  bucketFaces.Counts = &counts;
+  bucketFaces.Faces = NULL;
+  vtkSMPTools::For(0, numChunks, 1, bucketFaces);
+
+  std::vector<vtkIdType> bucketOffsets(vtkPVGeometryFilterNumberOfFaceBuckets + 1, 0);
+  vtkIdType numFaces = 0;
+  for (int bucket = 0; bucket < vtkPVGeometryFilterNumberOfFaceBuckets; ++bucket)
+  {
+    bucketOffsets[bucket] = numFaces;
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+      vtkIdType& count = counts[bucket * numChunks + chunk];
+      const vtkIdType offset = numFaces;
+      numFaces += count;
+      count = offset;
+    }
+  }
+  bucketOffsets[vtkPVGeometryFilterNumberOfFaceBuckets] = numFaces;
+
+  std::vector<vtkIdType> allFaces(numFaces);
+  bucketFaces.Faces = &allFaces;
+  vtkSMPTools::For(0, numChunks, 1, bucketFaces);
+  std::vector<vtkIdType>().swap(counts);
+
+  vtkPVGeometryFilterFindExternalFaces findExternal;
+  findExternal.Input = input;
+  findExternal.Faces = &allFaces;
+  findExternal.BucketOffsets = &bucketOffsets;
+  vtkSMPTools::For(0, vtkPVGeometryFilterNumberOfFaceBuckets, 1, findExternal);
+  std::vector<vtkIdType>().swap(allFaces);
+
+  // Faces are added in cell order so that the output does not depend on the
+  // number of threads.
+  std::vector<vtkIdType> externalFaces;
+  for (vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator iter = findExternal.External.begin();
+       iter != findExternal.External.end(); ++iter)
+  {
+    externalFaces.insert(externalFaces.end(), iter->begin(), iter->end());
+    std::vector<vtkIdType>().swap(*iter);
+  }
+  std::sort(externalFaces.begin(), externalFaces.end());
+
+  const vtkIdType numInputPts = input->GetNumberOfPoints();
+  std::vector<vtkIdType> pointMap(numInputPts, -1);
+  std::vector<vtkIdType> originalPointIds;
+  vtkNew<vtkIdTypeArray> originalCellIds;
+  originalCellIds->SetName("vtkOriginalCellIds");
+  vtkNew<vtkCellArray> polys;
+  vtkIdType npts;
+  vtkIdType* pts;
+  vtkIdType facePts[4];
+  for (size_t cc = 0; cc < externalFaces.size(); ++cc)
+  {
+    const vtkIdType cellId = externalFaces[cc] >> 3;
+    const int* face =
+      vtkPVGeometryFilterGetCellFaces(input->GetCellType(cellId))->Faces[externalFaces[cc] & 7];
+    input->GetCellPoints(cellId, npts, pts);
+    const int numFacePts = face[3] < 0 ? 3 : 4;
+    for (int pt = 0; pt < numFacePts; ++pt)
+    {
+      vtkIdType& ptId = pointMap[pts[face[pt]]];
+      if (ptId < 0)
+      {
+        ptId = static_cast<vtkIdType>(originalPointIds.size());
+        originalPointIds.push_back(pts[face[pt]]);
+      }
+      facePts[pt] = ptId;
+    }
+    polys->InsertNextCell(numFacePts, facePts);
+    originalCellIds->InsertNextValue(cellId);
+  }
+
+  const vtkIdType numPts = static_cast<vtkIdType>(originalPointIds.size());
+  vtkNew<vtkPoints> points;
+  points->SetDataType(input->GetPoints()->GetDataType());
+  points->SetNumberOfPoints(numPts);
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(inPD, numPts);
+  for (vtkIdType cc = 0; cc < numPts; ++cc)
+  {
+    points->SetPoint(cc, input->GetPoint(originalPointIds[cc]));
+    outPD->CopyData(inPD, originalPointIds[cc], cc);
+  }
+
+  const vtkIdType numFaces = originalCellIds->GetNumberOfTuples();
+  vtkCellData* inCD = input->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(inCD, numFaces);
+  for (vtkIdType cc = 0; cc < numFaces; ++cc)
+  {
+    outCD->CopyData(inCD, originalCellIds->GetValue(cc), cc);
+  }
+
+  output->SetPoints(points.Get());
+  output->SetPolys(polys.Get());
+  if (passCellIds)
+  {
+    outCD->AddArray(originalCellIds.Get());
+  }
+  if (passPointIds)
+  {
+    vtkNew<vtkIdTypeArray> pointIds;
+    pointIds->SetName("vtkOriginalPointIds");
+    pointIds->SetNumberOfTuples(numPts);
+    std::copy(originalPointIds.begin(), originalPointIds.end(), pointIds->GetPointer(0));
+    outPD->AddArray(pointIds.Get());
+  }
+  output->Squeeze();
+  return true;
+}
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::UnstructuredGridExecute(
   vtkUnstructuredGridBase* input, vtkPolyData* output, int doCommunicate)
@@ -1375,6 +1876,11 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
   {
     this->OutlineFlag = 0;
 
+    if (this->ExecuteFromSurfaceCache(input, output))
+    {
+      return;
+    }
+
     bool handleSubdivision = (this->Triangulate != 0) && (input->GetNumberOfCells() > 0);
     if (!handleSubdivision && (this->NonlinearSubdivisionLevel > 0))
     {
@@ -1458,7 +1964,12 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
 
     if (input->GetNumberOfCells() > 0)
     {
-      this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      if (handleSubdivision || !this->UseThreads ||
+        !vtkPVGeometryFilterExtractExternalFaces(
+          input, output, this->PassThroughCellIds != 0, this->PassThroughPointIds != 0))
+      {
+        this->DataSetSurfaceFilter->UnstructuredGridExecute(input, output);
+      }
     }
 
     if (this->Triangulate && (output->GetNumberOfPolys() > 0))
@@ -1521,6 +2032,10 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
         output->GetPointData()->AddArray(polyPtIds2OriginalPtIds.Get());
       }
     }
+    else
+    {
+      this->UpdateSurfaceCache(input, output);
+    }
 
     output->GetCellData()->RemoveArray(vtkPVRecoverGeometryWireframe::ORIGINAL_FACE_IDS());
     return;
@@ -1531,6 +2046,162 @@ void vtkPVGeometryFilter::UnstructuredGridExecute(
   this->DataSetExecute(input, output, doCommunicate);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Collects the objects that define the cells of the grid, NULL for the
+// optional ones the grid does not have. Returns false if the cells cannot be
+// tracked.
+bool vtkPVGeometryFilterGetTopology(
+  vtkUnstructuredGridBase* input, std::vector<vtkObject*>& objects)
+{
+  objects.clear();
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (!grid || !grid->GetCells() || !grid->GetCellTypesArray() || !grid->GetCellLocationsArray())
+  {
+    return false;
+  }
+  objects.push_back(grid->GetCells());
+  objects.push_back(grid->GetCells()->GetData());
+  objects.push_back(grid->GetCellTypesArray());
+  objects.push_back(grid->GetCellLocationsArray());
+  objects.push_back(grid->GetFaces());
+  objects.push_back(grid->GetFaceLocations());
+  // Ghost cells affect which faces are extracted.
+  objects.push_back(grid->GetCellData()->GetArray(vtkDataSetAttributes::GhostArrayName()));
+  return true;
+}
+
+// Copies the tuples listed in ids from the arrays of in to the arrays of out,
+// which are allocated by CopyAllocate in the same order.
+void vtkPVGeometryFilterGatherArrays(
+  vtkDataSetAttributes* in, vtkDataSetAttributes* out, vtkIdList* ids)
+{
+  out->CopyGlobalIdsOn();
+  out->CopyAllocate(in, ids->GetNumberOfIds());
+  for (int inIdx = 0, outIdx = 0;
+       inIdx < in->GetNumberOfArrays() && outIdx < out->GetNumberOfArrays(); ++inIdx)
+  {
+    vtkAbstractArray* inArray = in->GetAbstractArray(inIdx);
+    vtkAbstractArray* outArray = out->GetAbstractArray(outIdx);
+    const char* inName = inArray->GetName();
+    const char* outName = outArray->GetName();
+    if ((inName == NULL) != (outName == NULL) || (inName && strcmp(inName, outName) != 0))
+    {
+      // Not copied by CopyAllocate.
+      continue;
+    }
+    outArray->SetNumberOfTuples(ids->GetNumberOfIds());
+    inArray->GetTuples(ids, outArray);
+    ++outIdx;
+  }
+}
+
+vtkSmartPointer<vtkIdList> vtkPVGeometryFilterNewIdList(vtkIdTypeArray* ids)
+{
+  vtkSmartPointer<vtkIdList> list = vtkSmartPointer<vtkIdList>::New();
+  const vtkIdType numIds = ids->GetNumberOfTuples();
+  list->SetNumberOfIds(numIds);
+  std::copy(ids->GetPointer(0), ids->GetPointer(0) + numIds, list->GetPointer(0));
+  return list;
+}
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVGeometryFilter::ExecuteFromSurfaceCache(
+  vtkUnstructuredGridBase* input, vtkPolyData* output)
+{
+  SurfaceCacheEntry* entry = this->CurrentSurfaceCacheEntry;
+  if (!entry || !this->UseSurfaceCache || entry->TopologyObjects.empty() ||
+    !this->PassThroughCellIds || !this->PassThroughPointIds || !input->GetPoints() ||
+    entry->NumberOfPoints != input->GetNumberOfPoints() ||
+    entry->NumberOfCells != input->GetNumberOfCells() ||
+    entry->NonlinearSubdivisionLevel != this->NonlinearSubdivisionLevel ||
+    entry->Triangulate != this->Triangulate)
+  {
+    return false;
+  }
+
+  // Each object defining the cells must be the same, and unmodified.
+  std::vector<vtkObject*> topology;
+  if (!vtkPVGeometryFilterGetTopology(input, topology) ||
+    topology.size() != entry->TopologyObjects.size())
+  {
+    return false;
+  }
+  for (size_t cc = 0; cc < topology.size(); ++cc)
+  {
+    if (topology[cc] != entry->TopologyObjects[cc].GetPointer() ||
+      (topology[cc] && topology[cc]->GetMTime() != entry->TopologyTimes[cc]))
+    {
+      return false;
+    }
+  }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataType(input->GetPoints()->GetDataType());
+  points->SetNumberOfPoints(entry->SourcePointIds->GetNumberOfIds());
+  input->GetPoints()->GetData()->GetTuples(entry->SourcePointIds, points->GetData());
+  output->SetPoints(points.Get());
+  output->SetVerts(entry->Verts);
+  output->SetLines(entry->Lines);
+  output->SetPolys(entry->Polys);
+  output->SetStrips(entry->Strips);
+
+  vtkPVGeometryFilterGatherArrays(
+    input->GetPointData(), output->GetPointData(), entry->SourcePointIds);
+  output->GetPointData()->AddArray(entry->OriginalPointIds);
+  vtkPVGeometryFilterGatherArrays(
+    input->GetCellData(), output->GetCellData(), entry->SourceCellIds);
+  output->GetCellData()->AddArray(entry->OriginalCellIds);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::UpdateSurfaceCache(vtkUnstructuredGridBase* input, vtkPolyData* output)
+{
+  SurfaceCacheEntry* entry = this->CurrentSurfaceCacheEntry;
+  if (!entry)
+  {
+    return;
+  }
+  *entry = SurfaceCacheEntry();
+
+  vtkIdTypeArray* pointIds =
+    vtkIdTypeArray::SafeDownCast(output->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(output->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!this->UseSurfaceCache || !pointIds || !cellIds ||
+    pointIds->GetNumberOfTuples() != output->GetNumberOfPoints() ||
+    cellIds->GetNumberOfTuples() != output->GetNumberOfCells())
+  {
+    return;
+  }
+
+  std::vector<vtkObject*> topology;
+  if (!vtkPVGeometryFilterGetTopology(input, topology))
+  {
+    return;
+  }
+  for (size_t cc = 0; cc < topology.size(); ++cc)
+  {
+    entry->TopologyObjects.push_back(topology[cc]);
+    entry->TopologyTimes.push_back(topology[cc] ? topology[cc]->GetMTime() : 0);
+  }
+  entry->NumberOfPoints = input->GetNumberOfPoints();
+  entry->NumberOfCells = input->GetNumberOfCells();
+  entry->NonlinearSubdivisionLevel = this->NonlinearSubdivisionLevel;
+  entry->Triangulate = this->Triangulate;
+  entry->Verts = output->GetVerts();
+  entry->Lines = output->GetLines();
+  entry->Polys = output->GetPolys();
+  entry->Strips = output->GetStrips();
+  entry->OriginalPointIds = pointIds;
+  entry->OriginalCellIds = cellIds;
+  entry->SourcePointIds = vtkPVGeometryFilterNewIdList(pointIds);
+  entry->SourceCellIds = vtkPVGeometryFilterNewIdList(cellIds);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVGeometryFilter::PolyDataExecute(
   vtkPolyData* input, vtkPolyData* output, int doCommunicate)
@@ -1697,6 +2368,28 @@ void vtkPVGeometryFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "PassThroughCellIds: " << (this->PassThroughCellIds ? "On\n" : "Off\n");
   os << indent << "PassThroughPointIds: " << (this->PassThroughPointIds ? "On\n" : "Off\n");
+  os << indent << "UseThreads: " << (this->UseThreads ? "On\n" : "Off\n");
+  os << indent << "UseSurfaceCache: " << (this->UseSurfaceCache ? "On\n" : "Off\n");
+}
+
+//----------------------------------------------------------------------------
+void vtkPVGeometryFilter::CopyBlockSettings(vtkPVGeometryFilter* other)
+{
+  this->UseOutline = other->UseOutline;
+  this->GenerateFeatureEdges = other->GenerateFeatureEdges;
+  this->GenerateCellNormals = other->GenerateCellNormals;
+  this->Triangulate = other->Triangulate;
+  this->GenerateProcessIds = other->GenerateProcessIds;
+  this->HideInternalAMRFaces = other->HideInternalAMRFaces;
+  this->UseNonOverlappingAMRMetaDataForOutlines = other->UseNonOverlappingAMRMetaDataForOutlines;
+  this->UseThreads = other->UseThreads;
+  this->UseSurfaceCache = other->UseSurfaceCache;
+  this->UseStrips = other->UseStrips;
+  this->DataSetSurfaceFilter->SetUseStrips(other->UseStrips);
+  this->SetNonlinearSubdivisionLevel(other->NonlinearSubdivisionLevel);
+  this->SetPassThroughCellIds(other->PassThroughCellIds);
+  this->SetPassThroughPointIds(other->PassThroughPointIds);
+  this->SetController(other->Controller);
 }
 
 //----------------------------------------------------------------------------
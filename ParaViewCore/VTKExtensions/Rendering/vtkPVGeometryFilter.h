@@ -206,6 +206,35 @@ public:
   vtkBooleanMacro(UseNonOverlappingAMRMetaDataForOutlines, bool);
   //@}
 
+  //@{
+  /**
+   * When on, the leaves of composite datasets other than AMR are processed
+   * concurrently using vtkSMPTools, and the external faces of large
+   * unstructured grids made of linear 3D cells are found using several
+   * threads. The latter takes 8 bytes per cell face, e.g. 48 bytes per
+   * hexahedron, on top of the output. The output does not depend on this
+   * setting. Off by default.
+   */
+  vtkSetMacro(UseThreads, bool);
+  vtkGetMacro(UseThreads, bool);
+  vtkBooleanMacro(UseThreads, bool);
+  //@}
+
+  //@{
+  /**
+   * When on (default), the surface extracted from an unstructured grid is
+   * cached along with the input point and cell each surface point and cell
+   * comes from. When the grid still uses the same, unmodified, cell arrays
+   * on the next execution, the points and the attribute arrays are only
+   * gathered through that mapping. The cache is used only when PassThroughCellIds and
+   * PassThroughPointIds are on, and not for nonlinear or triangulated
+   * surfaces.
+   */
+  vtkSetMacro(UseSurfaceCache, bool);
+  vtkGetMacro(UseSurfaceCache, bool);
+  vtkBooleanMacro(UseSurfaceCache, bool);
+  //@}
+
   // These keys are put in the output composite-data metadata for multipieces
   // since this filter merges multipieces together.
   static vtkInformationIntegerVectorKey* POINT_OFFSETS();
@@ -329,6 +358,8 @@ protected:
   bool HideInternalAMRFaces;
   bool UseNonOverlappingAMRMetaDataForOutlines;
   bool GenerateFeatureEdges;
+  bool UseThreads;
+  bool UseSurfaceCache;
 
 private:
   vtkPVGeometryFilter(const vtkPVGeometryFilter&) = delete;
@@ -346,6 +377,36 @@ private:
   void AddHierarchicalIndex(vtkPolyData* pd, unsigned int level, unsigned int index);
   class BoundsReductionOperation;
   //@}
+
+  /**
+   * Copies the settings of \c other that affect the geometry of a block. Used
+   * to configure the filters that process blocks in other threads.
+   */
+  void CopyBlockSettings(vtkPVGeometryFilter* other);
+  class ExecuteBlocksFunctor;
+
+  //@{
+  /**
+   * Surfaces cached for unstructured grids, indexed by the flat index of the
+   * block, or 0 when the input is not composite. CurrentSurfaceCacheEntry is
+   * the entry for the block being executed, if any.
+   */
+  struct SurfaceCacheEntry;
+  class SurfaceCacheMap;
+  SurfaceCacheMap* SurfaceCache;
+  SurfaceCacheEntry* CurrentSurfaceCacheEntry;
+  //@}
+
+  /**
+   * Builds the surface of \c input from CurrentSurfaceCacheEntry. Returns
+   * false if the entry cannot be used for this input.
+   */
+  bool ExecuteFromSurfaceCache(vtkUnstructuredGridBase* input, vtkPolyData* output);
+
+  /**
+   * Stores the surface extracted from \c input in CurrentSurfaceCacheEntry.
+   */
+  void UpdateSurfaceCache(vtkUnstructuredGridBase* input, vtkPolyData* output);
 };
 
 #endif
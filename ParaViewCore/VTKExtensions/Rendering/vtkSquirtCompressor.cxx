@@ -19,9 +19,225 @@
 #include "vtkSquirtCompressor.h"
 #include "vtkMultiProcessStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkUnsignedCharArray.h"
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <sstream>
+#include <vector>
+
+namespace
+{
+// Number of pixels encoded independently by a single task. Runs never cross
+// tile boundaries, so the compressed stream only depends on this value and
+// not on the number of threads used.
+const vtkIdType SQUIRT_TILE_SIZE = 65536;
+
+// Number of compressed words handled by a single decompression task.
+const vtkIdType SQUIRT_BLOCK_SIZE = 16384;
+
+// Longest run that can be encoded for RGBA and RGB pixels respectively.
+const int SQUIRT_MAX_RUN_RGBA = 0x0F;
+const int SQUIRT_MAX_RUN_RGB = 0xFF;
+
+inline unsigned char& ByteThree(unsigned int& word)
+{
+  return reinterpret_cast<unsigned char*>(&word)[3];
+}
+
+inline unsigned int LoadRGB(const unsigned char* rgb)
+{
+  unsigned int color = 0;
+  unsigned char* p = reinterpret_cast<unsigned char*>(&color);
+  p[0] = rgb[0];
+  p[1] = rgb[1];
+  p[2] = rgb[2];
+  return color;
+}
+
+// Returns the number of pixels following `next` that match `key` under
+// `mask`, up to SQUIRT_MAX_RUN_RGBA. When a full window is available the
+// comparisons are done branch free over a fixed length so that the compiler
+// can vectorize them; the run is then the number of trailing set bits.
+inline int RunLengthRGBA(
+  const unsigned int* next, vtkIdType available, unsigned int key, unsigned int mask)
+{
+  if (available >= SQUIRT_MAX_RUN_RGBA)
+  {
+    unsigned int matches = 0;
+    for (int cc = 0; cc < SQUIRT_MAX_RUN_RGBA; ++cc)
+    {
+      matches |= static_cast<unsigned int>((next[cc] & mask) == key) << cc;
+    }
+    int run = 0;
+    while (matches & 0x1)
+    {
+      matches >>= 1;
+      ++run;
+    }
+    return run;
+  }
+
+  int run = 0;
+  while (run < available && (next[run] & mask) == key)
+  {
+    ++run;
+  }
+  return run;
+}
+
+// Encodes pixels [begin, end) into `out`, returning the number of words
+// written. At most (end - begin) words are written.
+vtkIdType CompressRGBA(
+  const unsigned int* in, vtkIdType begin, vtkIdType end, unsigned int mask, unsigned int* out)
+{
+  vtkIdType comp_index = 0;
+  for (vtkIdType index = begin; index < end;)
+  {
+    unsigned int current_color = in[index++];
+    unsigned char opacity = ByteThree(current_color);
+    int count = RunLengthRGBA(in + index, end - index, current_color & mask, mask);
+    index += count;
+    if (opacity > 0)
+    {
+      // since we want to encode 8-bit opacity into 4 bits.
+      count |= (opacity / 16) << 4;
+    }
+    ByteThree(current_color) = static_cast<unsigned char>(count);
+    out[comp_index++] = current_color;
+  }
+  return comp_index;
+}
+
+vtkIdType CompressRGB(
+  const unsigned char* in, vtkIdType begin, vtkIdType end, unsigned int mask, unsigned int* out)
+{
+  vtkIdType comp_index = 0;
+  for (vtkIdType index = begin; index < end;)
+  {
+    unsigned int current_color = LoadRGB(in + 3 * index++);
+    const unsigned int key = current_color & mask;
+    int count = 0;
+    while (index < end && count < SQUIRT_MAX_RUN_RGB && (LoadRGB(in + 3 * index) & mask) == key)
+    {
+      ++index;
+      ++count;
+    }
+    ByteThree(current_color) = static_cast<unsigned char>(count);
+    out[comp_index++] = current_color;
+  }
+  return comp_index;
+}
+
+class CompressTiles
+{
+public:
+  const unsigned char* Input;
+  int NumberOfComponents;
+  vtkIdType NumberOfPixels;
+  unsigned int Mask;
+  unsigned int* Output;
+  std::vector<vtkIdType>* Sizes;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tile = begin; tile < end; ++tile)
+    {
+      // Each tile writes at its own pixel offset, the compressed size of a
+      // tile never exceeds the number of pixels in it.
+      const vtkIdType first = tile * SQUIRT_TILE_SIZE;
+      const vtkIdType last = std::min(first + SQUIRT_TILE_SIZE, this->NumberOfPixels);
+      (*this->Sizes)[tile] = this->NumberOfComponents == 4
+        ? CompressRGBA(reinterpret_cast<const unsigned int*>(this->Input), first, last, this->Mask,
+            this->Output + first)
+        : CompressRGB(this->Input, first, last, this->Mask, this->Output + first);
+    }
+  }
+};
+
+inline vtkIdType RunLength(unsigned int word, int numComps)
+{
+  const unsigned char count = ByteThree(word);
+  return 1 + (numComps == 4 ? (count & 0x0F) : count);
+}
+
+// First pass of the decompression: counts the pixels produced by each block of
+// compressed words so that blocks can be expanded independently.
+class CountPixels
+{
+public:
+  const unsigned int* Input;
+  vtkIdType NumberOfWords;
+  int NumberOfComponents;
+  std::vector<vtkIdType>* Counts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const vtkIdType first = block * SQUIRT_BLOCK_SIZE;
+      const vtkIdType last = std::min(first + SQUIRT_BLOCK_SIZE, this->NumberOfWords);
+      vtkIdType count = 0;
+      for (vtkIdType cc = first; cc < last; ++cc)
+      {
+        count += RunLength(this->Input[cc], this->NumberOfComponents);
+      }
+      (*this->Counts)[block] = count;
+    }
+  }
+};
+
+class ExpandBlocks
+{
+public:
+  const unsigned int* Input;
+  vtkIdType NumberOfWords;
+  unsigned char* Output;
+  int NumberOfComponents;
+  const std::vector<vtkIdType>* Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const vtkIdType first = block * SQUIRT_BLOCK_SIZE;
+      const vtkIdType last = std::min(first + SQUIRT_BLOCK_SIZE, this->NumberOfWords);
+      if (this->NumberOfComponents == 4)
+      {
+        unsigned int* out =
+          reinterpret_cast<unsigned int*>(this->Output) + (*this->Offsets)[block];
+        for (vtkIdType cc = first; cc < last; ++cc)
+        {
+          unsigned int current_color = this->Input[cc];
+          const int count = ByteThree(current_color) & 0x0F;
+          // the upper 4 bits hold the opacity.
+          ByteThree(current_color) &= 0xF0;
+          std::fill(out, out + count + 1, current_color);
+          out += count + 1;
+        }
+      }
+      else
+      {
+        unsigned char* out = this->Output + 3 * (*this->Offsets)[block];
+        for (vtkIdType cc = first; cc < last; ++cc)
+        {
+          unsigned int current_color = this->Input[cc];
+          const int count = ByteThree(current_color);
+          const unsigned char* rgb = reinterpret_cast<const unsigned char*>(&current_color);
+          for (int j = 0; j <= count; ++j)
+          {
+            out[0] = rgb[0];
+            out[1] = rgb[1];
+            out[2] = rgb[2];
+            out += 3;
+          }
+        }
+      }
+    }
+  }
+};
+}
 
 vtkStandardNewMacro(vtkSquirtCompressor);
 
@@ -53,12 +269,7 @@ int vtkSquirtCompressor::Compress()
     return VTK_ERROR;
   }
 
-  int count = 0;
-  int index = 0;
-  int comp_index = 0;
-  int end_index;
   int compress_level = this->LossLessMode ? 0 : this->SquirtLevel;
-  unsigned int current_color;
   unsigned char compress_masks[6][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { 0xFE, 0xFF, 0xFE, 0xFE },
     { 0xFC, 0xFE, 0xFC, 0xFC }, { 0xF8, 0xFC, 0xF8, 0xF8 }, { 0xF0, 0xF8, 0xF0, 0xF0 },
     { 0xE0, 0xF0, 0xE0, 0xE0 } };
@@ -73,100 +284,41 @@ int vtkSquirtCompressor::Compress()
   unsigned int compress_mask;
   // I shifted the level by one so that 0 means no compression.
   memcpy(&compress_mask, &compress_masks[compress_level], 4);
-
-  // Access raw arrays directly
-  if (input->GetNumberOfComponents() == 4)
+  if (input->GetNumberOfComponents() == 3)
   {
-    unsigned int* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned int*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0, numPixels * 4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while ((index < end_index) && (comp_index < end_index))
-    {
-
-      // Record color
-      current_color = _rawCompressedBuffer[comp_index] = _rawColorBuffer[index];
-      unsigned char opacity = *(((unsigned char*)&current_color) + 3);
-      index++;
-
-      // Compute Run
-      while ((index < end_index) && (count < 0x0F) &&
-        ((current_color & compress_mask) == (_rawColorBuffer[index] & compress_mask)))
-      {
-        index++;
-        count++;
-      }
-      if (opacity > 0)
-      {
-        opacity /= 16; // since we want to encode 8-bit opacity into 4 bits.
-        opacity = opacity << 4;
-        count |= opacity;
-      }
-
-      // Record Run length
-      *((unsigned char*)_rawCompressedBuffer + comp_index * 4 + 3) = (unsigned char)count;
-      comp_index++;
-
-      count = 0;
-    }
+    // the 4th byte holds the run length for RGB.
+    ByteThree(compress_mask) = 0;
   }
-  else if (input->GetNumberOfComponents() == 3)
+
+  // The image is split in tiles that are encoded in parallel, each at its
+  // own offset in the output buffer. The tiles are then compacted.
+  const vtkIdType numPixels = input->GetNumberOfTuples();
+  const vtkIdType numTiles = (numPixels + SQUIRT_TILE_SIZE - 1) / SQUIRT_TILE_SIZE;
+  unsigned int* _rawCompressedBuffer =
+    reinterpret_cast<unsigned int*>(this->Output->WritePointer(0, numPixels * 4));
+  std::vector<vtkIdType> sizes(numTiles, 0);
+
+  CompressTiles functor;
+  functor.Input = input->GetPointer(0);
+  functor.NumberOfComponents = input->GetNumberOfComponents();
+  functor.NumberOfPixels = numPixels;
+  functor.Mask = compress_mask;
+  functor.Output = _rawCompressedBuffer;
+  functor.Sizes = &sizes;
+  vtkSMPTools::For(0, numTiles, 1, functor);
+
+  vtkIdType comp_index = 0;
+  for (vtkIdType tile = 0; tile < numTiles; ++tile)
   {
-    unsigned char* _rawColorBuffer;
-    unsigned int* _rawCompressedBuffer;
-    int numPixels = input->GetNumberOfTuples();
-    _rawColorBuffer = (unsigned char*)input->GetPointer(0);
-    _rawCompressedBuffer = (unsigned int*)this->Output->WritePointer(0, numPixels * 4);
-    end_index = numPixels;
-
-    // Go through color buffer and put RLE format into compressed buffer
-    while ((index < 3 * numPixels) && (comp_index < end_index))
+    // comp_index never exceeds the offset of the tile, so tiles that are
+    // yet to be moved are not overwritten.
+    const vtkIdType offset = tile * SQUIRT_TILE_SIZE;
+    if (offset != comp_index)
     {
-
-      int next_color = 0;
-      // Record color
-      unsigned char* p = (unsigned char*)&current_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index + 1];
-      *p++ = _rawColorBuffer[index + 2];
-      *p = 0x0;
-
-      _rawCompressedBuffer[comp_index] = current_color;
-      index += 3;
-
-      p = (unsigned char*)&next_color;
-      *p++ = _rawColorBuffer[index];
-      *p++ = _rawColorBuffer[index + 1];
-      *p++ = _rawColorBuffer[index + 2];
-      *p = 0x0;
-
-      // Compute Run
-      while (((current_color & compress_mask) == (next_color & compress_mask)) &&
-        (index < 3 * numPixels) && (count < 255))
-      {
-        index += 3;
-        count++;
-        if (index < 3 * numPixels)
-        {
-          p = (unsigned char*)&next_color;
-          *p++ = _rawColorBuffer[index];
-          *p++ = _rawColorBuffer[index + 1];
-          *p++ = _rawColorBuffer[index + 2];
-          *p = 0x0;
-        }
-      }
-
-      // Record Run length
-      reinterpret_cast<unsigned char*>(_rawCompressedBuffer)[comp_index * 4 + 3] =
-        static_cast<unsigned char>(count);
-      comp_index++;
-
-      count = 0;
+      memmove(_rawCompressedBuffer + comp_index, _rawCompressedBuffer + offset,
+        sizes[tile] * sizeof(unsigned int));
     }
+    comp_index += sizes[tile];
   }
 
   // Back to vtk arrays :)
@@ -205,99 +357,60 @@ int vtkSquirtCompressor::Decompress()
 //-----------------------------------------------------------------------------
 int vtkSquirtCompressor::DecompressRGBA()
 {
-  vtkUnsignedCharArray* in = this->GetInput();
-  vtkUnsignedCharArray* out = this->GetOutput();
-  assert(out->GetNumberOfComponents() == 4);
-
-  int count = 0;
-  int index = 0;
-  unsigned int current_color;
-  unsigned int* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
-
-  // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
-
-  // Access raw arrays directly
-  _rawColorBuffer = (unsigned int*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
-
-  // Go through compress buffer and extract RLE format into color buffer
-  for (int i = 0; i < CompSize; i++)
-  {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
-
-    // Get run length count;
-    count = *((unsigned char*)&current_color + 3);
-
-    if (count > 0x0f)
-    {
-      // we have some opacity.
-      unsigned char opacity = (count & 0xF0);
-      opacity = opacity >> 4;
-      opacity *= 16;
-      *((unsigned char*)&current_color + 3) = opacity;
-    }
-    else
-    {
-      *((unsigned char*)&current_color + 3) = 0;
-    }
-    count &= 0x0F;
-
-    // Set color
-    _rawColorBuffer[index++] = current_color;
-
-    // Blast color into color buffer
-    for (int j = 0; j < count; j++)
-    {
-      _rawColorBuffer[index++] = current_color;
-    }
-  }
-  return VTK_OK;
+  assert(this->GetOutput()->GetNumberOfComponents() == 4);
+  return this->DecompressBlocks();
 }
 
 //-----------------------------------------------------------------------------
 int vtkSquirtCompressor::DecompressRGB()
+{
+  assert(this->GetOutput()->GetNumberOfComponents() == 3);
+  return this->DecompressBlocks();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSquirtCompressor::DecompressBlocks()
 {
   vtkUnsignedCharArray* in = this->GetInput();
   vtkUnsignedCharArray* out = this->GetOutput();
-  assert(out->GetNumberOfComponents() == 3);
-
-  int count = 0;
-  unsigned int current_color;
-  unsigned char* _rawColorBuffer;
-  unsigned int* _rawCompressedBuffer;
 
   // Get compressed buffer size
-  int CompSize = in->GetNumberOfTuples() / 4; /// NOTE 1->4
-
-  // Access raw arrays directly
-  _rawColorBuffer = (unsigned char*)out->GetPointer(0);
-  _rawCompressedBuffer = (unsigned int*)in->GetPointer(0);
-
-  // Go through compress buffer and extract RLE format into color buffer
-  for (int i = 0; i < CompSize; i++)
+  const vtkIdType numWords = in->GetNumberOfTuples() / 4; /// NOTE 1->4
+  const vtkIdType numBlocks = (numWords + SQUIRT_BLOCK_SIZE - 1) / SQUIRT_BLOCK_SIZE;
+  const unsigned int* _rawCompressedBuffer =
+    reinterpret_cast<const unsigned int*>(in->GetPointer(0));
+
+  // Count the pixels in each block then expand the blocks in parallel at the
+  // offsets given by the exclusive scan of the counts.
+  std::vector<vtkIdType> offsets(numBlocks + 1, 0);
+  CountPixels counter;
+  counter.Input = _rawCompressedBuffer;
+  counter.NumberOfWords = numWords;
+  counter.NumberOfComponents = out->GetNumberOfComponents();
+  counter.Counts = &offsets;
+  vtkSMPTools::For(0, numBlocks, 1, counter);
+
+  vtkIdType total = 0;
+  for (vtkIdType block = 0; block <= numBlocks; ++block)
   {
-    // Get color and count
-    current_color = _rawCompressedBuffer[i];
-
-    // Get run length count;
-    count = *((unsigned char*)&current_color + 3);
-
-    *((unsigned char*)&current_color + 3) = 0xff;
-
-    unsigned char current_color_rgb[3];
-    std::copy(reinterpret_cast<const unsigned char*>(&current_color),
-      reinterpret_cast<const unsigned char*>(&current_color) + 3, current_color_rgb);
-    std::copy(current_color_rgb, current_color_rgb + 3, _rawColorBuffer);
-    _rawColorBuffer += 3;
-    for (int j = 0; j < count; j++)
-    {
-      std::copy(current_color_rgb, current_color_rgb + 3, _rawColorBuffer);
-      _rawColorBuffer += 3;
-    }
+    const vtkIdType count = offsets[block];
+    offsets[block] = total;
+    total += count;
   }
+  if (total > out->GetNumberOfTuples())
+  {
+    vtkErrorMacro("Compressed image (" << total << " pixels) does not fit in the output ("
+                                       << out->GetNumberOfTuples() << " pixels).");
+    return VTK_ERROR;
+  }
+
+  ExpandBlocks expander;
+  expander.Input = _rawCompressedBuffer;
+  expander.NumberOfWords = numWords;
+  expander.Output = out->GetPointer(0);
+  expander.NumberOfComponents = out->GetNumberOfComponents();
+  expander.Offsets = &offsets;
+  vtkSMPTools::For(0, numBlocks, 1, expander);
   return VTK_OK;
 }
 
@@ -41,6 +41,11 @@
  * example when a run starts in one actor whose reduced color matches the
  * background the background is colored with the actor color.
  *
+ * Compression and decompression are multithreaded using vtkSMPTools. The
+ * image is encoded in fixed size tiles of pixels and runs do not cross tile
+ * boundaries; the result is a regular SQUIRT stream that does not depend on
+ * the number of threads used.
+ *
  * The compressor uses a modified SQUIRT implementation where encode 4-bit
  * opacity information as well. This is needed to improve background color
  * blending for translucent renderings in ParaView.
@@ -98,6 +103,7 @@ protected:
   ~vtkSquirtCompressor() override;
   int DecompressRGB();
   int DecompressRGBA();
+  int DecompressBlocks();
 
   int SquirtLevel;
 
@@ -16,14 +16,108 @@
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkExtractHistogram.h"
+#include "vtkFloatArray.h"
 #include "vtkIntArray.h"
+#include "vtkMathUtilities.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
 #include "vtkSphereSource.h"
 #include "vtkTable.h"
 
+#include <vector>
+
+/// Compare the bins and the averages of a large array to a simple loop.
+static int TestExtractHistogramAverages()
+{
+  const vtkIdType num_values = 100000;
+  const int bin_count = 10;
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(num_values);
+  vtkSmartPointer<vtkDoubleArray> values = vtkSmartPointer<vtkDoubleArray>::New();
+  values->SetName("values");
+  values->SetNumberOfTuples(num_values);
+  vtkSmartPointer<vtkFloatArray> other = vtkSmartPointer<vtkFloatArray>::New();
+  other->SetName("other");
+  other->SetNumberOfComponents(2);
+  other->SetNumberOfTuples(num_values);
+
+  std::vector<int> expected_values(bin_count, 0);
+  std::vector<double> expected_totals(2 * bin_count, 0.0);
+  for (vtkIdType i = 0; i < num_values; ++i)
+  {
+    points->SetPoint(i, 0, 0, 0);
+    // Values outside of [0, 1] go to the first or the last bin.
+    const double value = ((i * 7919) % 1200) / 1000.0 - 0.1;
+    values->SetValue(i, value);
+    other->SetTypedComponent(i, 0, static_cast<float>(i % 3));
+    other->SetTypedComponent(i, 1, static_cast<float>(i % 5));
+
+    int bin = static_cast<int>(value / (1.0 / bin_count));
+    bin = bin < 0 ? 0 : (bin > bin_count - 1 ? bin_count - 1 : bin);
+    ++expected_values[bin];
+    expected_totals[2 * bin] += i % 3;
+    expected_totals[2 * bin + 1] += i % 5;
+  }
+
+  vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->GetPointData()->AddArray(values);
+  pd->GetPointData()->AddArray(other);
+
+  vtkSmartPointer<vtkExtractHistogram> extraction = vtkSmartPointer<vtkExtractHistogram>::New();
+  extraction->SetInputData(pd);
+  extraction->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "values");
+  extraction->SetBinCount(bin_count);
+  extraction->SetUseCustomBinRanges(true);
+  extraction->SetCustomBinRanges(0.0, 1.0);
+  extraction->SetCalculateAverages(true);
+  extraction->Update();
+
+  vtkTable* const histogram = extraction->GetOutput();
+  vtkIntArray* const bin_values =
+    vtkIntArray::SafeDownCast(histogram->GetRowData()->GetArray("bin_values"));
+  vtkDataArray* const totals = histogram->GetRowData()->GetArray("other_total");
+  vtkDataArray* const averages = histogram->GetRowData()->GetArray("other_average");
+  if (!bin_values || !totals || !averages || totals->GetNumberOfComponents() != 2 ||
+    totals->GetNumberOfTuples() != bin_count)
+  {
+    vtkGenericWarningMacro("Missing arrays for averages.");
+    return 1;
+  }
+
+  for (int bin = 0; bin < bin_count; ++bin)
+  {
+    if (bin_values->GetValue(bin) != expected_values[bin])
+    {
+      vtkGenericWarningMacro("incorrect bin value for bin " << bin << ".");
+      return 1;
+    }
+    for (int comp = 0; comp < 2; ++comp)
+    {
+      const double total = expected_totals[2 * bin + comp];
+      if (!vtkMathUtilities::FuzzyCompare(totals->GetComponent(bin, comp), total) ||
+        !vtkMathUtilities::FuzzyCompare(
+          averages->GetComponent(bin, comp), total / expected_values[bin], 1e-12))
+      {
+        vtkGenericWarningMacro("incorrect total or average for bin " << bin << ".");
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
 /// Test the output of the vtkExtractHistogram filter in a simple serial case
 int TestExtractHistogram(int, char* [])
 {
+  if (TestExtractHistogramAverages() != 0)
+  {
+    return 1;
+  }
+
   vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
   vtkSmartPointer<vtkExtractHistogram> extraction = vtkSmartPointer<vtkExtractHistogram>::New();
 
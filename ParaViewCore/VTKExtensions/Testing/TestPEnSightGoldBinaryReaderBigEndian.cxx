@@ -0,0 +1,381 @@
+// Checks that vtkPEnSightGoldBinaryReader reads big-endian C and Fortran
+// binary cases whose coordinate records are larger than the 1000 vectors the
+// reader used to read at a time, and larger than its float buffer, and that
+// the cells it inserts a section at a time use the right points.
+
+#include "vtkCellType.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPGenericEnSightReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkType.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// A section of elements of a part, with the 1-based node ids of the file.
+struct Section
+{
+  const char* Name;
+  int CellType;
+  int NodesPerElement; // 0 for nsided, see Counts.
+  std::vector<int> Counts;
+  std::vector<int> Nodes;
+  std::vector<int> Order; // The node of the element for each point of the cell.
+};
+
+struct Part
+{
+  int Id;
+  const char* Name;
+  int NumberOfNodes;
+  std::vector<Section> Sections;
+};
+
+float ExpectedCoordinate(int node, int component)
+{
+  return component == 0 ? 0.25f * node : (component == 1 ? -1.0f * node : 1.0f * (node % 7));
+}
+
+float ExpectedScalar(int node)
+{
+  return 2.0f * node + 1.0f;
+}
+
+// Writes the words of an EnSight binary file in big-endian order, wrapped in
+// record markers for Fortran files.
+class BigEndianWriter
+{
+public:
+  BigEndianWriter(const std::string& fname, bool fortran)
+    : Stream(fname.c_str(), ios::binary | ios::out | ios::trunc)
+    , Fortran(fortran)
+  {
+  }
+
+  bool Good() { return this->Stream.good(); }
+
+  void Line(const char* text)
+  {
+    char line[80];
+    memset(line, 0, 80);
+    strncpy(line, text, 79);
+    this->Marker(80);
+    this->Stream.write(line, 80);
+    this->Marker(80);
+  }
+
+  void Int(int value) { this->Ints(std::vector<int>(1, value)); }
+
+  void Ints(const std::vector<int>& values)
+  {
+    this->Marker(4 * values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      this->Word(static_cast<vtkTypeUInt32>(values[i]));
+    }
+    this->Marker(4 * values.size());
+  }
+
+  void Floats(const std::vector<float>& values)
+  {
+    this->Marker(4 * values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      vtkTypeUInt32 word;
+      memcpy(&word, &values[i], 4);
+      this->Word(word);
+    }
+    this->Marker(4 * values.size());
+  }
+
+private:
+  void Marker(size_t size)
+  {
+    if (this->Fortran)
+    {
+      this->Word(static_cast<vtkTypeUInt32>(size));
+    }
+  }
+
+  void Word(vtkTypeUInt32 word)
+  {
+    char bytes[4] = { static_cast<char>(word >> 24), static_cast<char>(word >> 16),
+      static_cast<char>(word >> 8), static_cast<char>(word) };
+    this->Stream.write(bytes, 4);
+  }
+
+  std::ofstream Stream;
+  bool Fortran;
+};
+
+std::vector<Part> MakeParts()
+{
+  std::vector<Part> parts(2);
+
+  // A grid of quads, with quadratic edges and polygons over its nodes.
+  const int size = 50;
+  Part& grid = parts[0];
+  grid.Id = 1;
+  grid.Name = "grid";
+  grid.NumberOfNodes = size * size;
+  grid.Sections.resize(3);
+  Section& quads = grid.Sections[0];
+  quads.Name = "quad4";
+  quads.CellType = VTK_QUAD;
+  quads.NodesPerElement = 4;
+  for (int j = 0; j + 1 < size; ++j)
+  {
+    for (int i = 0; i + 1 < size; ++i)
+    {
+      int node = j * size + i + 1;
+      int quad[4] = { node, node + 1, node + size + 1, node + size };
+      quads.Nodes.insert(quads.Nodes.end(), quad, quad + 4);
+    }
+  }
+  quads.Order.push_back(0);
+  quads.Order.push_back(1);
+  quads.Order.push_back(2);
+  quads.Order.push_back(3);
+
+  // EnSight lists the middle node of bar3 last, VTK second.
+  Section& edges = grid.Sections[1];
+  edges.Name = "bar3";
+  edges.CellType = VTK_QUADRATIC_EDGE;
+  edges.NodesPerElement = 3;
+  for (int i = 0; i + 2 < size; i += 2)
+  {
+    edges.Nodes.push_back(i + 1);
+    edges.Nodes.push_back(i + 3);
+    edges.Nodes.push_back(i + 2);
+  }
+  edges.Order.push_back(0);
+  edges.Order.push_back(2);
+  edges.Order.push_back(1);
+
+  Section& polygons = grid.Sections[2];
+  polygons.Name = "nsided";
+  polygons.CellType = VTK_POLYGON;
+  polygons.NodesPerElement = 0;
+  for (int count = 3; count < 8; ++count)
+  {
+    polygons.Counts.push_back(count);
+    for (int k = 0; k < count; ++k)
+    {
+      polygons.Nodes.push_back(count * size + k + 1);
+    }
+  }
+
+  // A cloud of vertices with more nodes than the float buffer of the reader.
+  Part& cloud = parts[1];
+  cloud.Id = 2;
+  cloud.Name = "cloud";
+  cloud.NumberOfNodes = 140000;
+  cloud.Sections.resize(1);
+  Section& vertices = cloud.Sections[0];
+  vertices.Name = "point";
+  vertices.CellType = VTK_VERTEX;
+  vertices.NodesPerElement = 1;
+  for (int node = 1; node <= cloud.NumberOfNodes; ++node)
+  {
+    vertices.Nodes.push_back(node);
+  }
+  vertices.Order.push_back(0);
+  return parts;
+}
+
+int GetNumberOfElements(const Section& section)
+{
+  return section.NodesPerElement
+    ? static_cast<int>(section.Nodes.size()) / section.NodesPerElement
+    : static_cast<int>(section.Counts.size());
+}
+
+bool WriteCase(const std::string& dir, const std::string& name, bool fortran,
+  const std::vector<Part>& parts)
+{
+  BigEndianWriter geometry(dir + "/" + name + ".geo", fortran);
+  geometry.Line(fortran ? "Fortran Binary" : "C Binary");
+  geometry.Line("big-endian geometry");
+  geometry.Line("with large coordinate records");
+  geometry.Line("node id off");
+  geometry.Line("element id off");
+  for (size_t p = 0; p < parts.size(); ++p)
+  {
+    const Part& part = parts[p];
+    geometry.Line("part");
+    geometry.Int(part.Id);
+    geometry.Line(part.Name);
+    geometry.Line("coordinates");
+    geometry.Int(part.NumberOfNodes);
+    for (int component = 0; component < 3; ++component)
+    {
+      std::vector<float> coordinates(part.NumberOfNodes);
+      for (int node = 0; node < part.NumberOfNodes; ++node)
+      {
+        coordinates[node] = ExpectedCoordinate(node, component);
+      }
+      geometry.Floats(coordinates);
+    }
+    for (size_t s = 0; s < part.Sections.size(); ++s)
+    {
+      const Section& section = part.Sections[s];
+      geometry.Line(section.Name);
+      geometry.Int(GetNumberOfElements(section));
+      if (!section.NodesPerElement)
+      {
+        geometry.Ints(section.Counts);
+      }
+      geometry.Ints(section.Nodes);
+    }
+  }
+
+  BigEndianWriter scalars(dir + "/" + name + ".scl", fortran);
+  scalars.Line("temperature");
+  for (size_t p = 0; p < parts.size(); ++p)
+  {
+    scalars.Line("part");
+    scalars.Int(parts[p].Id);
+    scalars.Line("coordinates");
+    std::vector<float> values(parts[p].NumberOfNodes);
+    for (int node = 0; node < parts[p].NumberOfNodes; ++node)
+    {
+      values[node] = ExpectedScalar(node);
+    }
+    scalars.Floats(values);
+  }
+
+  std::ofstream caseFile((dir + "/" + name + ".case").c_str(), ios::out | ios::trunc);
+  caseFile << "FORMAT\n"
+           << "type: ensight gold\n\n"
+           << "GEOMETRY\n"
+           << "model: " << name << ".geo\n\n"
+           << "VARIABLE\n"
+           << "scalar per node: temperature " << name << ".scl\n";
+  caseFile.close();
+  return geometry.Good() && scalars.Good() && caseFile.good();
+}
+
+// Compares a part read from the case with what was written, through the
+// global node ids of its points.
+bool CheckPart(vtkUnstructuredGrid* grid, const Part& part, const std::string& name)
+{
+  vtkDataArray* globalIds = grid->GetPointData()->GetGlobalIds();
+  vtkDataArray* temperature = grid->GetPointData()->GetArray("temperature");
+  if (grid->GetNumberOfPoints() != part.NumberOfNodes || !globalIds || !temperature)
+  {
+    cerr << "ERROR: " << name << ": part " << part.Name << " has "
+         << grid->GetNumberOfPoints() << " points instead of " << part.NumberOfNodes << endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+  {
+    int node = static_cast<int>(globalIds->GetTuple1(ptId));
+    double point[3];
+    grid->GetPoint(ptId, point);
+    if (point[0] != ExpectedCoordinate(node, 0) || point[1] != ExpectedCoordinate(node, 1) ||
+      point[2] != ExpectedCoordinate(node, 2) ||
+      temperature->GetTuple1(ptId) != ExpectedScalar(node))
+    {
+      cerr << "ERROR: " << name << ": wrong point for node " << node << " of part " << part.Name
+           << endl;
+      return false;
+    }
+  }
+
+  vtkIdType cellId = 0;
+  vtkNew<vtkIdList> cellPoints;
+  for (size_t s = 0; s < part.Sections.size(); ++s)
+  {
+    const Section& section = part.Sections[s];
+    const int* nodes = &section.Nodes[0];
+    for (int e = 0; e < GetNumberOfElements(section); ++e, ++cellId)
+    {
+      int count = section.NodesPerElement ? section.NodesPerElement : section.Counts[e];
+      if (cellId >= grid->GetNumberOfCells() || grid->GetCellType(cellId) != section.CellType)
+      {
+        cerr << "ERROR: " << name << ": missing " << section.Name << " element " << e << endl;
+        return false;
+      }
+      grid->GetCellPoints(cellId, cellPoints.Get());
+      bool same = cellPoints->GetNumberOfIds() == count;
+      for (int k = 0; same && k < count; ++k)
+      {
+        int node = nodes[section.Order.empty() ? k : section.Order[k]] - 1;
+        same = globalIds->GetTuple1(cellPoints->GetId(k)) == node;
+      }
+      if (!same)
+      {
+        cerr << "ERROR: " << name << ": wrong points for " << section.Name << " element " << e
+             << endl;
+        return false;
+      }
+      nodes += count;
+    }
+  }
+  if (cellId != grid->GetNumberOfCells())
+  {
+    cerr << "ERROR: " << name << ": part " << part.Name << " has too many cells" << endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestCase(const std::string& dir, const std::string& name, bool fortran)
+{
+  std::vector<Part> parts = MakeParts();
+  if (!WriteCase(dir, name, fortran, parts))
+  {
+    cerr << "ERROR: cannot write " << name << " in " << dir << endl;
+    return false;
+  }
+
+  vtkNew<vtkPGenericEnSightReader> reader;
+  reader->SetFilePath(dir.c_str());
+  reader->SetCaseFileName((name + ".case").c_str());
+  reader->Update();
+
+  std::vector<vtkUnstructuredGrid*> grids;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(reader->GetOutput()->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    grids.push_back(vtkUnstructuredGrid::SafeDownCast(iter->GetCurrentDataObject()));
+  }
+  if (grids.size() != parts.size())
+  {
+    cerr << "ERROR: " << name << ": read " << grids.size() << " parts instead of "
+         << parts.size() << endl;
+    return false;
+  }
+
+  bool success = true;
+  for (size_t p = 0; p < parts.size(); ++p)
+  {
+    success &= grids[p] && CheckPart(grids[p], parts[p], name);
+  }
+  return success;
+}
+}
+
+int TestPEnSightGoldBinaryReaderBigEndian(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string dir = tempDir;
+  delete[] tempDir;
+
+  bool success = TestCase(dir, "TestPEnSightGoldBinaryReaderBigEndianC", false);
+  success &= TestCase(dir, "TestPEnSightGoldBinaryReaderBigEndianFortran", true);
+  return success ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+// Checks the time step index vtkPEnSightReader writes next to the files of
+// file sets when UseTimeStepIndex is on: a new reader seeks to the offsets
+// of the index, an index is ignored and rewritten once the size or the
+// modification time of its data file changed, and it is written through a
+// temporary file that is renamed.
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPGenericEnSightReader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkType.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace
+{
+const int NumberOfTimeSteps = 3;
+
+bool Check(bool condition, const char* message)
+{
+  if (!condition)
+  {
+    cerr << "ERROR: " << message << endl;
+  }
+  return condition;
+}
+
+// An ASCII case with a triangle, and a temperature of 10 * time step + node
+// at its nodes, both in file sets with a time step per time value.
+bool WriteCase(const std::string& dir, const std::string& name)
+{
+  std::ofstream geometry((dir + "/" + name + ".geo").c_str(), ios::out | ios::trunc);
+  std::ofstream scalars((dir + "/" + name + ".scl").c_str(), ios::out | ios::trunc);
+  for (int step = 0; step < NumberOfTimeSteps; ++step)
+  {
+    geometry << "BEGIN TIME STEP\n"
+             << "time step index geometry\n"
+             << "time step " << step << "\n"
+             << "node id off\n"
+             << "element id off\n"
+             << "part\n"
+             << "         1\n"
+             << "triangle\n"
+             << "coordinates\n"
+             << "         3\n"
+             << " 0.00000e+00\n 1.00000e+00\n 0.00000e+00\n"
+             << " 0.00000e+00\n 0.00000e+00\n 1.00000e+00\n"
+             << " 0.00000e+00\n 0.00000e+00\n 0.00000e+00\n"
+             << "tria3\n"
+             << "         1\n"
+             << "         1         2         3\n"
+             << "END TIME STEP\n";
+    scalars << "BEGIN TIME STEP\n"
+            << "temperature\n"
+            << "part\n"
+            << "         1\n"
+            << "coordinates\n";
+    for (int node = 0; node < 3; ++node)
+    {
+      scalars << " " << 10 * step + node << "\n";
+    }
+    scalars << "END TIME STEP\n";
+  }
+
+  std::ofstream caseFile((dir + "/" + name + ".case").c_str(), ios::out | ios::trunc);
+  caseFile << "FORMAT\n"
+           << "type: ensight gold\n\n"
+           << "GEOMETRY\n"
+           << "model: 1 1 " << name << ".geo\n\n"
+           << "VARIABLE\n"
+           << "scalar per node: 1 1 temperature " << name << ".scl\n\n"
+           << "TIME\n"
+           << "time set: 1\n"
+           << "number of steps: " << NumberOfTimeSteps << "\n"
+           << "time values: 0 1 2\n\n"
+           << "FILE\n"
+           << "file set: 1\n"
+           << "number of steps: " << NumberOfTimeSteps << "\n";
+  return geometry.good() && scalars.good() && caseFile.good();
+}
+
+// Reads the case at a time value with a new reader and returns the time step
+// the temperature it read belongs to, -1 if it could not be read.
+int ReadTimeStep(const std::string& dir, const std::string& name, double time)
+{
+  vtkNew<vtkPGenericEnSightReader> reader;
+  reader->SetFilePath(dir.c_str());
+  reader->SetCaseFileName((name + ".case").c_str());
+  reader->UseTimeStepIndexOn();
+  reader->UpdateInformation();
+  reader->UpdateTimeStep(time);
+
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(reader->GetOutput()->NewIterator());
+  iter->InitTraversal();
+  vtkDataSet* ds =
+    iter->IsDoneWithTraversal() ? NULL : vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+  vtkDataArray* globalIds = ds ? ds->GetPointData()->GetGlobalIds() : NULL;
+  vtkDataArray* temperature = ds ? ds->GetPointData()->GetArray("temperature") : NULL;
+  if (!globalIds || !temperature || ds->GetNumberOfPoints() != 3)
+  {
+    return -1;
+  }
+  int step = static_cast<int>(temperature->GetTuple1(0) - globalIds->GetTuple1(0)) / 10;
+  for (vtkIdType ptId = 1; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    if (temperature->GetTuple1(ptId) - globalIds->GetTuple1(ptId) != 10 * step)
+    {
+      return -1;
+    }
+  }
+  return step;
+}
+
+struct Index
+{
+  std::string Header;
+  vtkTypeInt64 Size;
+  vtkTypeInt64 Modified;
+  std::map<int, long> Offsets;
+};
+
+// Reads the header and the time step offsets of an index, the part offsets
+// are skipped.
+bool ReadIndex(const std::string& fname, Index& index)
+{
+  std::ifstream ifs(fname.c_str());
+  std::string version;
+  if (!std::getline(ifs, index.Header))
+  {
+    return false;
+  }
+  std::istringstream header(index.Header);
+  if (!(header >> version >> version >> index.Size >> index.Modified))
+  {
+    return false;
+  }
+  index.Offsets.clear();
+  std::string entry;
+  while (ifs >> entry)
+  {
+    int timeStep, partId;
+    long offset;
+    if (entry == "part")
+    {
+      ifs >> timeStep >> partId >> offset;
+    }
+    else if (ifs >> offset)
+    {
+      index.Offsets[atoi(entry.c_str())] = offset;
+    }
+  }
+  return true;
+}
+
+bool WriteIndex(const std::string& fname, const Index& index)
+{
+  std::ofstream ofs(fname.c_str(), ios::out | ios::trunc);
+  ofs << index.Header << "\n";
+  std::map<int, long>::const_iterator offset;
+  for (offset = index.Offsets.begin(); offset != index.Offsets.end(); ++offset)
+  {
+    ofs << offset->first << " " << offset->second << "\n";
+  }
+  return ofs.good();
+}
+
+// Checks that the index of a data file was renamed from its temporary file,
+// that it matches the data file, and that it has the offsets of all the time
+// steps after the first one.
+bool CheckIndex(const std::string& dataFileName, Index& index)
+{
+  const std::string indexFileName = dataFileName + ".pvtsi";
+  vtksys::SystemTools::Stat_t fs;
+  if (!Check(!vtksys::SystemTools::FileExists(indexFileName + ".tmp"),
+        "the temporary index was not renamed") ||
+    !Check(ReadIndex(indexFileName, index), "cannot read the index") ||
+    !Check(vtksys::SystemTools::Stat(dataFileName.c_str(), &fs) == 0, "cannot stat the data"))
+  {
+    return false;
+  }
+  bool ok = Check(index.Size == static_cast<vtkTypeInt64>(fs.st_size) &&
+      index.Modified == static_cast<vtkTypeInt64>(fs.st_mtime),
+    "the index does not match its data file");
+  for (int step = 1; step < NumberOfTimeSteps; ++step)
+  {
+    ok &= Check(index.Offsets.find(step) != index.Offsets.end(), "missing time step offset");
+  }
+  return ok;
+}
+}
+
+int TestPEnSightReaderTimeStepIndex(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string dir = tempDir;
+  delete[] tempDir;
+  const std::string name = "TestPEnSightReaderTimeStepIndex";
+  const std::string scalarsFileName = dir + "/" + name + ".scl";
+  const std::string indexFileName = scalarsFileName + ".pvtsi";
+  if (!Check(WriteCase(dir, name), "cannot write the case"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtksys::SystemTools::RemoveFile(dir + "/" + name + ".geo.pvtsi");
+  vtksys::SystemTools::RemoveFile(indexFileName);
+
+  // Reading the last time step indexes the time steps on the way.
+  bool ok = Check(ReadTimeStep(dir, name, 2.0) == 2, "wrong last time step");
+  ok &= Check(vtksys::SystemTools::FileExists(indexFileName), "no index was written");
+  Index index;
+  if (!ok || !CheckIndex(scalarsFileName, index))
+  {
+    return EXIT_FAILURE;
+  }
+  const std::map<int, long> offsets = index.Offsets;
+
+  // A new reader seeks to the offsets of the index: point the last time step
+  // to the previous one.
+  index.Offsets[2] = index.Offsets[1];
+  ok &= Check(WriteIndex(indexFileName, index), "cannot write the index");
+  ok &= Check(ReadTimeStep(dir, name, 2.0) == 1, "the offsets of the index were not used");
+
+  // Once the size of the data file changed, the index is ignored and written
+  // again over the previous one.
+  {
+    std::ofstream scalars(scalarsFileName.c_str(), ios::out | ios::app);
+    scalars << "\n";
+  }
+  ok &= Check(ReadTimeStep(dir, name, 2.0) == 2, "the index was used after a size change");
+  ok &= CheckIndex(scalarsFileName, index) && Check(index.Offsets == offsets, "wrong offsets");
+
+  // Same once the modification time changed. Wait for it to be different at
+  // the resolution of the file system.
+  index.Offsets[2] = index.Offsets[1];
+  ok &= Check(WriteIndex(indexFileName, index), "cannot write the index");
+  vtksys::SystemTools::Delay(2000);
+  ok &= Check(vtksys::SystemTools::Touch(scalarsFileName, false), "cannot touch the data");
+  ok &= Check(ReadTimeStep(dir, name, 2.0) == 2, "the index was used after a time change");
+  ok &= CheckIndex(scalarsFileName, index) && Check(index.Offsets == offsets, "wrong offsets");
+
+  // The index of the geometry file set is written the same way.
+  ok &= CheckIndex(dir + "/" + name + ".geo", index);
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
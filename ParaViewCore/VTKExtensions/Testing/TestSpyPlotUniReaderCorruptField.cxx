@@ -0,0 +1,134 @@
+// Checks that a field vtkSpyPlotUniReader fails to read is not kept: the file
+// is truncated in the fields of the last time step, then restored, and the
+// fields read again must match the ones read from the intact file.
+
+#include "vtkDataArray.h"
+#include "vtkDataArraySelection.h"
+#include "vtkNew.h"
+#include "vtkSpyPlotUniReader.h"
+#include "vtkTestUtilities.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+bool WriteFile(const std::string& fname, const std::vector<char>& bytes, size_t length)
+{
+  std::ofstream ofs(fname.c_str(), ios::binary | ios::out | ios::trunc);
+  ofs.write(bytes.empty() ? NULL : &bytes[0], static_cast<std::streamsize>(length));
+  return ofs.good();
+}
+
+// Opens fname at the last time step with all the fields enabled.
+bool OpenReader(vtkSpyPlotUniReader* reader, vtkDataArraySelection* selection,
+  const std::string& fname, int useMemoryMapping)
+{
+  reader->SetFileName(fname.c_str());
+  reader->SetCellArraySelection(selection);
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  if (!reader->ReadInformation())
+  {
+    return false;
+  }
+  selection->EnableAllArrays();
+  return reader->SetCurrentTimeStep(reader->GetTimeStepRange()[1]) != 0;
+}
+
+bool SameFields(vtkSpyPlotUniReader* reader, vtkSpyPlotUniReader* expected)
+{
+  for (int field = 0; field < expected->GetNumberOfCellFields(); ++field)
+  {
+    for (int block = 0; block < expected->GetNumberOfDataBlocks(); ++block)
+    {
+      int fixed;
+      vtkDataArray* values = reader->GetCellFieldData(block, field, &fixed);
+      vtkDataArray* expectedValues = expected->GetCellFieldData(block, field, &fixed);
+      if (!expectedValues)
+      {
+        continue;
+      }
+      if (!values || values->GetNumberOfTuples() != expectedValues->GetNumberOfTuples())
+      {
+        cerr << "ERROR: field " << expected->GetCellFieldName(field) << " of block " << block
+             << " is missing" << endl;
+        return false;
+      }
+      for (vtkIdType cc = 0; cc < values->GetNumberOfTuples(); ++cc)
+      {
+        if (values->GetTuple1(cc) != expectedValues->GetTuple1(cc))
+        {
+          cerr << "ERROR: field " << expected->GetCellFieldName(field) << " of block " << block
+               << " differs at " << cc << endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestCorruptField(const std::string& source, const std::string& copy, int useMemoryMapping)
+{
+  std::ifstream ifs(source.c_str(), ios::binary | ios::in);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+  vtkNew<vtkDataArraySelection> expectedSelection;
+  vtkNew<vtkSpyPlotUniReader> expected;
+  if (!OpenReader(expected.Get(), expectedSelection.Get(), source, useMemoryMapping) ||
+    !expected->MakeCurrent())
+  {
+    cerr << "ERROR: cannot read " << source << endl;
+    return false;
+  }
+
+  // The fields of the last time step are at the end of the file, so the first
+  // truncation MakeCurrent() fails on, going back from the end, is in a field.
+  for (size_t cut = 1; cut < bytes.size(); cut *= 2)
+  {
+    vtkNew<vtkDataArraySelection> selection;
+    vtkNew<vtkSpyPlotUniReader> reader;
+    if (!WriteFile(copy, bytes, bytes.size()) ||
+      !OpenReader(reader.Get(), selection.Get(), copy, useMemoryMapping) ||
+      !WriteFile(copy, bytes, bytes.size() - cut))
+    {
+      cerr << "ERROR: cannot write " << copy << endl;
+      return false;
+    }
+    if (reader->MakeCurrent())
+    {
+      continue;
+    }
+
+    // Read the intact file again, the failed field must not be cached.
+    if (!WriteFile(copy, bytes, bytes.size()) || !reader->MakeCurrent())
+    {
+      cerr << "ERROR: cannot read the restored file" << endl;
+      return false;
+    }
+    return SameFields(reader.Get(), expected.Get());
+  }
+  cerr << "ERROR: no truncation of " << source << " failed to read" << endl;
+  return false;
+}
+}
+
+int TestSpyPlotUniReaderCorruptField(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(argc, argv, "Data/SPCTH/ball_and_box.spcth");
+  const std::string source = fname;
+  delete[] fname;
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string copy = std::string(tempDir) + "/TestSpyPlotUniReaderCorruptField.spcth";
+  delete[] tempDir;
+
+  bool success = true;
+  for (int useMemoryMapping = 0; useMemoryMapping < 2; ++useMemoryMapping)
+  {
+    success &= TestCorruptField(source, copy, useMemoryMapping);
+  }
+  return success ? 0 : 1;
+}
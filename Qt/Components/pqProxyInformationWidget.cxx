@@ -413,7 +413,7 @@ void pqProxyInformationWidget::fillDataInformation(vtkPVDataInformation* dataInf
         int numComponents = arrayInfo->GetNumberOfComponents();
         QString dataRange;
         double range[2];
-        for (int j = 0; j < numComponents; j++)
+        for (int j = 0; j < numComponents && arrayInfo->GetHasRanges(); j++)
         {
           if (j != 0)
           {
@@ -423,6 +423,11 @@ void pqProxyInformationWidget::fillDataInformation(vtkPVDataInformation* dataInf
           QString componentRange = QString("[%1, %2]").arg(range[0]).arg(range[1]);
           dataRange.append(componentRange);
         }
+        if (!arrayInfo->GetHasRanges())
+        {
+          // see vtkSMOutputPort::SetGatherArrayRanges().
+          dataRange = tr("not computed");
+        }
         item->setData(2, Qt::DisplayRole, dataType == "string" ? tr("NA") : dataRange);
         item->setData(2, Qt::ToolTipRole, dataRange);
         item->setFlags(item->flags() | Qt::ItemIsEditable);
@@ -47,6 +47,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
+#include <thread>
 
 #include "CosmoHaloFinder.h"
 
@@ -58,11 +59,21 @@ using namespace std;
 
 namespace cosmotk {
 
+// Branches of the k-d tree with fewer particles are not split across threads
+static const int MIN_THREAD_PARTICLES = 16384;
+
+// Returns whether a branch of len particles is split across threads
+static bool SplitBranch(int len, int threads)
+{
+  return threads > 1 && len >= 2 * MIN_THREAD_PARTICLES;
+}
+
 /****************************************************************************/
 CosmoHaloFinder::CosmoHaloFinder()
 {
 
   nmin = 1;
+  nthreads = 1;
 }
 
 /****************************************************************************/
@@ -303,7 +314,7 @@ void CosmoHaloFinder::Finding()
   for (int i = 0; i < npart; i++)
     seq[i] = i;
 
-  Reorder(seq.begin(), seq.end(), dataX);
+  Reorder(seq.begin(), seq.end(), dataX, nthreads);
 
 #ifdef DEBUG
   gettimeofday(&tim, NULL);
@@ -322,7 +333,7 @@ void CosmoHaloFinder::Finding()
   lbound = new POSVEL_T[npart];
   ubound = new POSVEL_T[npart];
   POSVEL_T lb1[numDataDims], ub1[numDataDims];
-  ComputeLU(0, npart, dataX, lb1, ub1);
+  ComputeLU(0, npart, dataX, lb1, ub1, nthreads);
 
 #ifdef DEBUG
   gettimeofday(&tim, NULL);
@@ -344,7 +355,7 @@ void CosmoHaloFinder::Finding()
     nextp[i] = -1;
   }
 
-  myFOF(0, npart, dataX);
+  myFOF(0, npart, dataX, nthreads);
 
 #ifdef DEBUG
   gettimeofday(&tim, NULL);
@@ -367,7 +378,8 @@ void CosmoHaloFinder::Finding()
 void CosmoHaloFinder::Reorder(
                         vector<int>::iterator first,
                         vector<int>::iterator last,
-                        int axis)
+                        int axis,
+                        int threads)
 {
     int length = std::distance(first, last);
     vector<int>::iterator middle = first + length/2;
@@ -377,6 +389,15 @@ void CosmoHaloFinder::Reorder(
 
     nth_element(first, middle, last, kdCompare(data[axis]));
 
+    if (SplitBranch(length, threads)) {
+      // the halves are disjoint ranges of seq
+      thread lower(&CosmoHaloFinder::Reorder, this,
+                   first, middle, (axis+1) % numDataDims, threads/2);
+      Reorder(middle, last, (axis+1) % numDataDims, threads - threads/2);
+      lower.join();
+      return;
+    }
+
     Reorder(first, middle, (axis+1) % numDataDims);
     Reorder(middle, last, (axis+1) % numDataDims);
 }
@@ -387,7 +408,8 @@ void CosmoHaloFinder::ComputeLU(
                         int last,
                         int axis,
                         POSVEL_T* ret_lb,
-                        POSVEL_T* ret_ub)
+                        POSVEL_T* ret_ub,
+                        int threads)
 {
   int len = last - first;
 
@@ -438,8 +460,17 @@ void CosmoHaloFinder::ComputeLU(
 
   // non-base cases
 
-  ComputeLU(first, middle, (axis + 1) % numDataDims, lb1, ub1);
-  ComputeLU(middle,  last, (axis + 1) % numDataDims, lb2, ub2);
+  if (SplitBranch(len, threads)) {
+    // each half only sets the bounds of its own middles
+    thread lower(&CosmoHaloFinder::ComputeLU, this,
+                 first, middle, (axis + 1) % numDataDims, lb1, ub1, threads/2);
+    ComputeLU(middle, last, (axis + 1) % numDataDims, lb2, ub2,
+              threads - threads/2);
+    lower.join();
+  } else {
+    ComputeLU(first, middle, (axis + 1) % numDataDims, lb1, ub1);
+    ComputeLU(middle,  last, (axis + 1) % numDataDims, lb2, ub2);
+  }
 
   // compute LU at the bottom-up pass
   lbound[middle] = min(lb1[useDim], lb2[useDim]);
@@ -461,7 +492,8 @@ void CosmoHaloFinder::ComputeLU(
 void CosmoHaloFinder::myFOF(
                         int first,
                         int last,
-                        int dataFlag)
+                        int dataFlag,
+                        int threads)
 {
   int len = last - first;
 
@@ -474,8 +506,17 @@ void CosmoHaloFinder::myFOF(
   // divide
   int middle = first + len/2;
 
-  myFOF(first, middle, (dataFlag+1) % numDataDims);
-  myFOF(middle,  last, (dataFlag+1) % numDataDims);
+  if (SplitBranch(len, threads)) {
+    // the halos of each half only link particles of that half, so the
+    // halves update disjoint entries of ht[], halo[] and nextp[]
+    thread lower(&CosmoHaloFinder::myFOF, this,
+                 first, middle, (dataFlag+1) % numDataDims, threads/2);
+    myFOF(middle, last, (dataFlag+1) % numDataDims, threads - threads/2);
+    lower.join();
+  } else {
+    myFOF(first, middle, (dataFlag+1) % numDataDims);
+    myFOF(middle,  last, (dataFlag+1) % numDataDims);
+  }
 
   // recursive merge
   Merge(first, middle, middle, last, dataFlag);
@@ -102,6 +102,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // particle is constantly altered so that each particle knows what halo it
 // is part of, and that halo tag is the id of the lowest particle in the halo.
 //
+// With nthreads > 1 the top levels of the recursions of Reorder(), ComputeLU()
+// and myFOF() run the two halves of the k-d tree on separate threads.  The
+// halves hold disjoint particles, and the halos found in a half only contain
+// particles of that half, so the threads never touch the same entries of
+// seq[], lbound[], ubound[], ht[], halo[] or nextp[].  The Merge() of the two
+// halves happens once both threads are done, so the halos are exactly the
+// ones found serially.
+//
 
 #ifndef CosmoHaloFinder_h
 #define CosmoHaloFinder_h
@@ -194,6 +202,7 @@ public:
   int nmin;
   int pmin;
   bool periodic;
+  int nthreads;         // Number of threads to find the halos with
   const char *infile;
   const char *outfile;
   const char *textmode;
@@ -222,15 +231,16 @@ private:
   void Reorder(
          vector<int>::iterator first,
          vector<int>::iterator last,
-         int axis);
+         int axis,
+         int threads = 1);
 
   // Calculates a lower and upper bound for each particle so that the
   // mergeing step can prune parts of the k-d tree
   POSVEL_T *lbound, *ubound;
-  void ComputeLU(int, int, int, POSVEL_T*, POSVEL_T*);
+  void ComputeLU(int, int, int, POSVEL_T*, POSVEL_T*, int threads = 1);
 
   // Recurses through the k-d tree merging particles to create halos
-  void myFOF(int, int, int);
+  void myFOF(int, int, int, int threads = 1);
   void Merge(int, int, int, int, int);
 };
 
@@ -107,6 +107,9 @@ public:
                                 // which define a single halo
         int nmin = 1);          // The minimum number of neighbors for linking
 
+  // Set the number of threads the serial halo finder uses on this processor
+  void setNumberOfThreads(int n) { this->haloFinder.nthreads = n < 1 ? 1 : n; }
+
   // Execute the serial halo finder for this processor
   void executeHaloFinder();
 
@@ -1482,6 +1482,12 @@ class ArrayInformation(object):
     def GetRange(self, component=0):
         """Given a component, returns its value range as a tuple of 2 values."""
         array = self.FieldData.GetFieldData().GetArrayInformation(self.Name)
+        if not array.GetHasRanges():
+            # the data information was gathered without the array ranges.
+            port = self.Proxy.SMProxy.GetOutputPort(self.FieldData.OutputPort)
+            info = port.GetRangedDataInformation(self.Name)
+            array = getattr(info, "Get%sInformation" % self.FieldData.FieldData)() \
+                .GetArrayInformation(self.Name)
         range = array.GetComponentRange(component)
         return (range[0], range[1])
 
@@ -2054,6 +2060,30 @@ def LoadState(filename, connection=None):
             view.GetRenderWindow().SetSize(view.ViewSize[0], \
                                            view.ViewSize[1])
 
+class Batch(object):
+    """Context manager that batches the messages sent to the server while
+    creating and modifying proxies on a connection. The messages are sent
+    together when the outermost batch ends, or earlier when a reply from the
+    server is needed (e.g. to fetch data information). Example:
+
+      with servermanager.Batch():
+          for i in range(200):
+              shrink = simple.Shrink(ShrinkFactor=0.1 * (i % 10))
+    """
+    def __init__(self, connection=None):
+        if not connection:
+            connection = ActiveConnection
+        if not connection:
+            raise RuntimeError ("Cannot batch messages without a connection")
+        self.Session = connection.Session
+
+    def __enter__(self):
+        self.Session.BeginBatch()
+        return self
+
+    def __exit__(self, *args):
+        self.Session.EndBatch()
+
 def Connect(ds_host=None, ds_port=11111, rs_host=None, rs_port=22221, timeout=60):
     """
     Use this function call to create a new session. On success,